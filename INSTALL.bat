@@ -1,5 +1,8 @@
 copy src\wpm\WeightedPerfectMatchingCLib.h install-win32\include\wpm\
 copy src\wpm\WeightedPerfectMatchingLib.h install-win32\include\wpm\
+copy src\wpm\NonMatchingGraph.h install-win32\include\wpm\
+copy src\wpm\NonMatchingGraphDelta.h install-win32\include\wpm\
+copy src\wpm\Tracing.h install-win32\include\wpm\
 copy build\WeightedPerfectMatchingLib-Release\WeightedPerfectMatchingLib.lib install-win32\lib
 copy build\WeightedPerfectMatchingLib-Debug\WeightedPerfectMatchingLib-Debug.lib install-win32\lib
 copy build\WeightedPerfectMatchingLib-Debug\WeightedPerfectMatchingLib-Debug.pdb install-win32\lib
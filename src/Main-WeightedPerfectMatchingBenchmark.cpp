@@ -0,0 +1,495 @@
+/* Main-WeightedPerfectMatchingBenchmark.cpp */
+
+// Benchmark of the WeightedPerfectMatchingLib: synthetic graphs of several workload shapes are generated for increasing
+// numbers of vertices, and each stage of the matching pipeline is timed separately over several rounds, as they run in
+// the library (deserialization of the graph, conversion into a bipartite matching graph, search of the perfect matching,
+// update of the constraints, serialization of the updated graph, or of its changes only). The results are written in JSON,
+// with the sizes of the updated graph and of its changes, so that they may be compared between releases. Unlike the
+// tests, this executable only uses standard C++ and builds on any platform.
+//
+// Usage: WeightedPerfectMatchingBenchmark [options]
+//   --sizes n1,n2,...        Numbers of vertices of the graphs (default: 8,64,512,4096,50000).
+//   --generators g1,g2,...   Generators among christmas, sparse, dense and adversarial (default: all of them).
+//   --engine name            Engine among hungarian, sap and auction (default: hungarian).
+//   --rounds r               Number of rounds of the pipeline for each graph (default: 3).
+//   --seed s                 Seed of the generators and of the perfect matching finder (default: 1).
+//   --max-constraints m      Maximal number of constraints of a generated graph, larger graphs are skipped (default: 4000000).
+//   --threads t1,t2,...      Numbers of threads of the auction scaling entries, timed on sparse bipartite matching graphs
+//                            of each size, whose speedups are relative to the first one (default: none, not measured).
+//   --output path            Path of the JSON file to write (default: standard output).
+
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "wpm/NonMatchingGraph.h"
+#include "wpm/NonMatchingGraphDelta.h"
+#include "wpm/BipartiteMatchingGraph.h"
+#include "wpm/ImplicitBipartiteMatchingGraph.h"
+#include "wpm/MatchingGraphConverter.h"
+#include "wpm/PerfectMatchingFinder.h"
+#include "wpm/RandomEngine.h"
+
+
+
+namespace impl {
+
+//! Number of vertices from which the graphs are converted into an ImplicitBipartiteMatchingGraph, as in the PerfectMatchingFinder.
+const unsigned int IMPLICIT_GRAPH_MIN_NVERTICES = 1000;
+
+//! Names of the timed stages of the pipeline, in the order in which they run in a round.
+const unsigned int NSTAGES = 6;
+const char *STAGE_NAMES[NSTAGES] = { "deserialize", "toBipartiteMatchingGraph", "findRandomPerfectMatching", "updateConstraints", "serialize", "serializeDelta" };
+
+//! Settings of the benchmark, parsed from the command line.
+struct BenchmarkSettings
+{
+	std::vector<unsigned int> sizes;
+	std::vector<std::string> generators;
+	std::string engine_name;
+	wpm::PerfectMatchingFinder::Engine engine;
+	unsigned int nrounds;
+	unsigned long long seed;
+	unsigned long long max_constraints;
+	std::vector<unsigned int> thread_counts;
+	std::string output_path;
+};
+
+//! Result of the benchmark for one graph, with the durations of each stage for each round, in milliseconds.
+struct BenchmarkResult
+{
+	std::string generator;
+	unsigned int nvertices;
+	unsigned long long nconstraints;
+	std::string skip_reason;
+	std::string representation;
+	bool success;
+	std::vector<double> durations[NSTAGES];
+	size_t graph_bytes;		//!< Size of the updated graph string of the last round.
+	size_t delta_bytes;		//!< Size of the delta string of the last round (see NonMatchingGraphDelta).
+};
+
+//! Result of the auction scaling for one size, with the median duration for each number of threads of the settings, in milliseconds.
+struct ScalingResult
+{
+	unsigned int nvertices;
+	unsigned long long nedges;
+	std::vector<double> durations;
+};
+
+//! Adds the constraints forbidding the two members of each couple (2k,2k+1) to be matched, as in a Christmas gift exchange.
+void addCoupleConstraints(unsigned int nvertices, wpm::NonMatchingGraph &nmg)
+{
+	for(unsigned int id=0; id+1<nvertices; id+=2)
+		nmg.addUndirectedEdge(id, id+1, (unsigned int)(-1));
+}
+
+//! Generates a Christmas gift exchange after several years: couples cannot be matched, and each vertex keeps the costs of
+//! its recipients of the previous years, the most recent ones being the most costly.
+void generateChristmasGraph(unsigned int nvertices, unsigned int nyears, wpm::RandomEngine &engine, wpm::NonMatchingGraph &nmg)
+{
+	nmg.startNewGraph(nvertices);
+	addCoupleConstraints(nvertices, nmg);
+	for(unsigned int year=0; year<nyears; ++year) {
+		// Each year is a random derangement of the vertices avoiding the couples, which is simply a rotation of a random permutation
+		std::vector<unsigned int> order(nvertices);
+		for(unsigned int id=0; id<nvertices; ++id)
+			order[id] = id;
+		engine.shuffle(order.begin(), order.end());
+		for(unsigned int i=0; i<nvertices; ++i) {
+			const unsigned int id_source = order[i], id_target = order[(i+1)%nvertices];
+			if(id_source/2!=id_target/2)
+				nmg.addDirectedEdge(id_source, id_target, nvertices-(nyears-1-year)*(nvertices/(2*nyears)));
+		}
+	}
+}
+
+//! Generates a graph with a few random constraints per vertex, with random finite costs, in addition to the couples.
+void generateSparseGraph(unsigned int nvertices, unsigned int nconstraints_per_vertex, wpm::RandomEngine &engine, wpm::NonMatchingGraph &nmg)
+{
+	nmg.startNewGraph(nvertices);
+	addCoupleConstraints(nvertices, nmg);
+	for(unsigned int id_source=0; id_source<nvertices; ++id_source) {
+		for(unsigned int k=0; k<nconstraints_per_vertex; ++k) {
+			const unsigned int id_target = engine.uniform(nvertices);
+			if(id_source/2!=id_target/2)
+				nmg.addDirectedEdge(id_source, id_target, 1+engine.uniform(nvertices));
+		}
+	}
+}
+
+//! Generates a graph where each pair of different vertices has a random finite cost.
+void generateDenseGraph(unsigned int nvertices, unsigned int max_cost, wpm::RandomEngine &engine, wpm::NonMatchingGraph &nmg)
+{
+	nmg.startNewGraph(nvertices);
+	for(unsigned int id_source=0; id_source<nvertices; ++id_source) {
+		for(unsigned int id_target=0; id_target<nvertices; ++id_target) {
+			if(id_source!=id_target)
+				nmg.addDirectedEdge(id_source, id_target, 1+engine.uniform(max_cost));
+		}
+	}
+}
+
+//! Generates the worst case of the Hungarian algorithm given by Machol and Wien, where the cost of the pair (i,j) is i*j:
+//! every permutation has a different cost, and the labels change for almost all the vertices at each augmentation.
+void generateAdversarialGraph(unsigned int nvertices, wpm::NonMatchingGraph &nmg)
+{
+	nmg.startNewGraph(nvertices);
+	for(unsigned int id_source=0; id_source<nvertices; ++id_source) {
+		for(unsigned int id_target=0; id_target<nvertices; ++id_target) {
+			if(id_source!=id_target)
+				nmg.addDirectedEdge(id_source, id_target, 1+id_source*id_target);
+		}
+	}
+}
+
+//! Returns true if the specified name is the name of a generator.
+bool isGenerator(const std::string &generator)
+{
+	return (generator=="christmas" || generator=="sparse" || generator=="dense" || generator=="adversarial");
+}
+
+//! Returns the number of constraints of a graph generated by the specified generator, to skip the graphs which are too large.
+unsigned long long getNumberGeneratedConstraints(const std::string &generator, unsigned int nvertices)
+{
+	if(generator=="christmas")
+		return 6ULL*nvertices;
+	if(generator=="sparse")
+		return 9ULL*nvertices;
+	return (unsigned long long)nvertices*(nvertices-1);
+}
+
+//! Generates the graph of the specified generator.
+void generateGraph(const std::string &generator, unsigned int nvertices, wpm::RandomEngine &engine, wpm::NonMatchingGraph &nmg)
+{
+	if(generator=="christmas")
+		generateChristmasGraph(nvertices, 5, engine, nmg);
+	else if(generator=="sparse")
+		generateSparseGraph(nvertices, 8, engine, nmg);
+	else if(generator=="dense")
+		generateDenseGraph(nvertices, 1000, engine, nmg);
+	else generateAdversarialGraph(nvertices, nmg);
+}
+
+//! Returns the number of milliseconds elapsed since the specified time point.
+inline double getElapsedMilliseconds(const std::chrono::steady_clock::time_point &start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+}
+
+//! Runs the rounds of the pipeline on the specified graph, which is updated after each round.
+void runPipeline(const BenchmarkSettings &settings, wpm::NonMatchingGraph &nmg, wpm::PerfectMatchingFinder &pmfinder, BenchmarkResult &result)
+{
+	const unsigned int nvertices = nmg.getNumberVertices();
+	const bool is_implicit = (nvertices>=IMPLICIT_GRAPH_MIN_NVERTICES);
+	result.representation = (is_implicit ? "implicit" : "explicit");
+	result.success = true;
+	result.graph_bytes = result.delta_bytes = 0;
+	wpm::MatchingGraphConverter gconverter;
+	std::vector<unsigned int> matching;
+	std::string graph_str;
+	{
+		std::ostringstream os;
+		nmg.serialize(os);
+		graph_str = os.str();
+	}
+	for(unsigned int round=0; round<settings.nrounds && result.success; ++round) {
+		// Deserialize the graph of the previous round
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		wpm::NonMatchingGraph round_nmg;
+		result.success = round_nmg.deserialize(graph_str.data(), graph_str.size());
+		result.durations[0].push_back(getElapsedMilliseconds(start));
+		// Convert it into the bipartite matching graph used for this number of vertices
+		start = std::chrono::steady_clock::now();
+		if(is_implicit) {
+			wpm::ImplicitBipartiteMatchingGraph ibmg;
+			gconverter.toImplicitBipartiteMatchingGraph(round_nmg, ibmg);
+		}
+		else {
+			wpm::BipartiteMatchingGraph bmg;
+			gconverter.toBipartiteMatchingGraph(round_nmg, bmg);
+		}
+		result.durations[1].push_back(getElapsedMilliseconds(start));
+		// Find the perfect matching, which converts the graph again, as in the library
+		start = std::chrono::steady_clock::now();
+		result.success = (result.success && pmfinder.findRandomPerfectMatching(round_nmg, matching));
+		result.durations[2].push_back(getElapsedMilliseconds(start));
+		if(!result.success)
+			break;
+		// Update the constraints with the matching, recording the changes
+		start = std::chrono::steady_clock::now();
+		wpm::NonMatchingGraphDelta delta;
+		delta.startNewDelta(nvertices);
+		round_nmg.updateConstraints(matching, true, &delta);
+		result.durations[3].push_back(getElapsedMilliseconds(start));
+		// Serialize the updated graph for the next round
+		start = std::chrono::steady_clock::now();
+		std::ostringstream os;
+		round_nmg.serialize(os);
+		graph_str = os.str();
+		result.durations[4].push_back(getElapsedMilliseconds(start));
+		// Serialize the changes instead, as sent in place of the updated graph
+		start = std::chrono::steady_clock::now();
+		std::ostringstream delta_os;
+		delta.serialize(delta_os);
+		const std::string delta_str = delta_os.str();
+		result.durations[5].push_back(getElapsedMilliseconds(start));
+		result.graph_bytes = graph_str.size();
+		result.delta_bytes = delta_str.size();
+	}
+}
+
+//! Generates a sparse bipartite matching graph, where each source vertex has a few edges to random target vertices with random scores,
+//! in addition to the edges of a random cycle which guarantee a perfect matching. The NonMatchingGraphs are converted into complete
+//! bipartite graphs, hence they cannot reach the sizes at which the auction engine is parallelized.
+void generateSparseBipartiteGraph(unsigned int nvertices, unsigned int nedges_per_vertex, wpm::RandomEngine &engine, wpm::BipartiteMatchingGraph &bmg)
+{
+	std::vector<unsigned int> cycle(nvertices);
+	for(unsigned int cid=0; cid<nvertices; ++cid)
+		cycle[cid] = cid;
+	engine.shuffle(cycle.begin(), cycle.end());
+	bmg.startNewGraph(nvertices);
+	std::vector<unsigned int> targets;
+	for(unsigned int i=0; i<nvertices; ++i) {
+		targets.assign(1, cycle[(i+1)%nvertices]);
+		for(unsigned int k=0; k<nedges_per_vertex; ++k)
+			targets.push_back(engine.uniform(nvertices));
+		std::sort(targets.begin(), targets.end());
+		targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+		for(size_t k=0; k<targets.size(); ++k) {
+			if(targets[k]!=cycle[i])
+				bmg.addDirectedEdge(cycle[i], targets[k], -(int)engine.uniform(1001));
+		}
+	}
+	bmg.finalize();
+}
+
+//! Times the auction engine on a sparse bipartite matching graph of the specified size with each number of threads of the settings.
+void runAuctionScaling(const BenchmarkSettings &settings, unsigned int nvertices, ScalingResult &result)
+{
+	wpm::RandomEngine engine(wpm::RandomEngine::deriveSeed(settings.seed, 0xA0C7100000000ULL+nvertices));
+	wpm::BipartiteMatchingGraph bmg;
+	generateSparseBipartiteGraph(nvertices, 8, engine, bmg);
+	result.nvertices = nvertices;
+	result.nedges = bmg.getSourceAdjacencyEnd(nvertices-1);
+	for(size_t t=0; t<settings.thread_counts.size(); ++t) {
+		std::vector<double> durations;
+		for(unsigned int round=0; round<settings.nrounds; ++round) {
+			wpm::PerfectMatchingFinder pmfinder(wpm::PerfectMatchingFinder::Engine_Auction);
+			pmfinder.setNumberThreads(settings.thread_counts[t]);
+			pmfinder.setSeed(settings.seed);
+			std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching;
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			pmfinder.findRandomPerfectMatching(bmg, matching);
+			durations.push_back(getElapsedMilliseconds(start));
+		}
+		std::sort(durations.begin(), durations.end());
+		result.durations.push_back(durations[durations.size()/2]);
+	}
+}
+
+//! Writes the statistics of the specified durations as a JSON object.
+void writeDurationStatistics(std::ostream &os, std::vector<double> durations)
+{
+	os << "{ \"nsamples\": " << durations.size();
+	if(!durations.empty()) {
+		std::sort(durations.begin(), durations.end());
+		double sum = 0.0;
+		for(size_t i=0; i<durations.size(); ++i)
+			sum += durations[i];
+		const size_t mid = durations.size()/2;
+		const double median = (durations.size()%2!=0 ? durations[mid] : 0.5*(durations[mid-1]+durations[mid]));
+		os << ", \"min_ms\": " << durations.front() << ", \"median_ms\": " << median
+		   << ", \"mean_ms\": " << sum/durations.size() << ", \"max_ms\": " << durations.back();
+	}
+	os << " }";
+}
+
+//! Writes the results of the benchmark as a JSON document.
+void writeResults(std::ostream &os, const BenchmarkSettings &settings, const std::vector<BenchmarkResult> &results, const std::vector<ScalingResult> &scaling_results)
+{
+	os << std::setprecision(6);
+	os << "{\n";
+	os << "  \"benchmark\": \"WeightedPerfectMatchingBenchmark\",\n";
+	os << "  \"engine\": \"" << settings.engine_name << "\",\n";
+	os << "  \"rounds\": " << settings.nrounds << ",\n";
+	os << "  \"seed\": " << settings.seed << ",\n";
+	os << "  \"results\": [";
+	for(size_t i=0; i<results.size(); ++i) {
+		const BenchmarkResult &result = results[i];
+		os << (i==0 ? "\n" : ",\n");
+		os << "    { \"generator\": \"" << result.generator << "\", \"nvertices\": " << result.nvertices << ", \"nconstraints\": " << result.nconstraints;
+		if(!result.skip_reason.empty()) {
+			os << ", \"skipped\": \"" << result.skip_reason << "\" }";
+			continue;
+		}
+		os << ", \"representation\": \"" << result.representation << "\", \"success\": " << (result.success ? "true" : "false")
+		   << ", \"graph_bytes\": " << result.graph_bytes << ", \"delta_bytes\": " << result.delta_bytes << ",\n";
+		os << "      \"stages\": {";
+		for(unsigned int s=0; s<NSTAGES; ++s) {
+			os << (s==0 ? "\n" : ",\n") << "        \"" << STAGE_NAMES[s] << "\": ";
+			writeDurationStatistics(os, result.durations[s]);
+		}
+		os << "\n      } }";
+	}
+	os << "\n  ]";
+	if(!scaling_results.empty()) {
+		os << ",\n  \"auction_scaling\": [";
+		for(size_t i=0; i<scaling_results.size(); ++i) {
+			const ScalingResult &result = scaling_results[i];
+			os << (i==0 ? "\n" : ",\n");
+			os << "    { \"nvertices\": " << result.nvertices << ", \"nedges\": " << result.nedges << ", \"threads\": [";
+			for(size_t t=0; t<result.durations.size(); ++t) {
+				os << (t==0 ? "\n" : ",\n") << "        { \"nthreads\": " << settings.thread_counts[t] << ", \"median_ms\": " << result.durations[t]
+				   << ", \"speedup\": " << (result.durations[t]>0.0 ? result.durations[0]/result.durations[t] : 0.0) << " }";
+			}
+			os << "\n      ] }";
+		}
+		os << "\n  ]";
+	}
+	os << "\n}\n";
+}
+
+//! Splits a comma-separated list.
+std::vector<std::string> splitList(const std::string &list)
+{
+	std::vector<std::string> items;
+	std::istringstream is(list);
+	std::string item;
+	while(std::getline(is, item, ','))
+		if(!item.empty())
+			items.push_back(item);
+	return items;
+}
+
+//! Parses the command line into the benchmark settings, returns false if an option is invalid.
+bool parseSettings(int argc, char **argv, BenchmarkSettings &settings)
+{
+	const unsigned int default_sizes[] = { 8, 64, 512, 4096, 50000 };
+	settings.sizes.assign(default_sizes, default_sizes+sizeof(default_sizes)/sizeof(default_sizes[0]));
+	const char *default_generators[] = { "christmas", "sparse", "dense", "adversarial" };
+	settings.generators.assign(default_generators, default_generators+sizeof(default_generators)/sizeof(default_generators[0]));
+	settings.engine_name = "hungarian";
+	settings.engine = wpm::PerfectMatchingFinder::Engine_Hungarian;
+	settings.nrounds = 3;
+	settings.seed = 1;
+	settings.max_constraints = 4000000;
+	for(int i=1; i<argc; ++i) {
+		const std::string option = argv[i];
+		if(i+1>=argc)
+			return false;
+		const std::string value = argv[++i];
+		if(option=="--sizes") {
+			settings.sizes.clear();
+			std::vector<std::string> items = splitList(value);
+			for(size_t k=0; k<items.size(); ++k) {
+				const unsigned int nvertices = (unsigned int)std::strtoul(items[k].c_str(), NULL, 10);
+				if(nvertices<2)
+					return false;
+				settings.sizes.push_back(nvertices);
+			}
+		}
+		else if(option=="--generators") {
+			settings.generators = splitList(value);
+			for(size_t k=0; k<settings.generators.size(); ++k) {
+				if(!isGenerator(settings.generators[k]))
+					return false;
+			}
+		}
+		else if(option=="--engine") {
+			settings.engine_name = value;
+			if(value=="hungarian")
+				settings.engine = wpm::PerfectMatchingFinder::Engine_Hungarian;
+			else if(value=="sap")
+				settings.engine = wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath;
+			else if(value=="auction")
+				settings.engine = wpm::PerfectMatchingFinder::Engine_Auction;
+			else return false;
+		}
+		else if(option=="--rounds")
+			settings.nrounds = (unsigned int)std::strtoul(value.c_str(), NULL, 10);
+		else if(option=="--seed")
+			settings.seed = std::strtoull(value.c_str(), NULL, 10);
+		else if(option=="--max-constraints")
+			settings.max_constraints = std::strtoull(value.c_str(), NULL, 10);
+		else if(option=="--threads") {
+			settings.thread_counts.clear();
+			std::vector<std::string> items = splitList(value);
+			for(size_t k=0; k<items.size(); ++k) {
+				const unsigned int nthreads = (unsigned int)std::strtoul(items[k].c_str(), NULL, 10);
+				if(nthreads<1)
+					return false;
+				settings.thread_counts.push_back(nthreads);
+			}
+		}
+		else if(option=="--output")
+			settings.output_path = value;
+		else return false;
+	}
+	return (!settings.sizes.empty() && !settings.generators.empty() && settings.nrounds>0);
+}
+
+}
+
+
+
+// Main function
+int main(int argc, char **argv)
+{
+	impl::BenchmarkSettings settings;
+	if(!impl::parseSettings(argc, argv, settings)) {
+		std::cerr << "Usage: " << argv[0] << " [--sizes n1,n2,...] [--generators christmas,sparse,dense,adversarial]"
+				  << " [--engine hungarian|sap|auction] [--rounds r] [--seed s] [--max-constraints m] [--threads t1,t2,...] [--output path]" << std::endl;
+		return 1;
+	}
+	std::vector<impl::BenchmarkResult> results;
+	for(size_t g=0; g<settings.generators.size(); ++g) {
+		for(size_t k=0; k<settings.sizes.size(); ++k) {
+			impl::BenchmarkResult result;
+			result.generator = settings.generators[g];
+			result.nvertices = settings.sizes[k];
+			result.nconstraints = impl::getNumberGeneratedConstraints(result.generator, result.nvertices);
+			result.success = false;
+			std::cerr << "Running " << result.generator << " with " << result.nvertices << " vertices..." << std::endl;
+			if(result.nconstraints>settings.max_constraints) {
+				result.skip_reason = "too many constraints";
+				results.push_back(result);
+				continue;
+			}
+			// Each graph has its own random stream, so that the graph of a given size does not depend on the other options
+			wpm::RandomEngine engine(wpm::RandomEngine::deriveSeed(settings.seed, (unsigned long long)g*0x100000000ULL+result.nvertices));
+			wpm::NonMatchingGraph nmg;
+			impl::generateGraph(result.generator, result.nvertices, engine, nmg);
+			wpm::PerfectMatchingFinder pmfinder(settings.engine);
+			pmfinder.setSeed(settings.seed);
+			impl::runPipeline(settings, nmg, pmfinder, result);
+			results.push_back(result);
+		}
+	}
+	std::vector<impl::ScalingResult> scaling_results;
+	for(size_t k=0; k<settings.sizes.size() && !settings.thread_counts.empty(); ++k) {
+		std::cerr << "Running the auction scaling with " << settings.sizes[k] << " vertices..." << std::endl;
+		scaling_results.push_back(impl::ScalingResult());
+		impl::runAuctionScaling(settings, settings.sizes[k], scaling_results.back());
+	}
+	if(settings.output_path.empty())
+		impl::writeResults(std::cout, settings, results, scaling_results);
+	else {
+		std::ofstream os(settings.output_path.c_str(), std::ios::out|std::ios::trunc);
+		if(!os.is_open()) {
+			std::cerr << "Cannot open the output file '" << settings.output_path << "'!" << std::endl;
+			return 1;
+		}
+		impl::writeResults(os, settings, results, scaling_results);
+	}
+	return 0;
+}
@@ -149,27 +149,21 @@ void main()
 	pg.addImpossibleMutualAssignment(4, 5);
 	pg.addImpossibleMutualAssignment(6, 7);
 
-	// Initialize the successive assignments
+	// Compute the successive assignments of all the years at once, without going through the graph string between them
 	std::string graph_str = pg.getParticipantGraphString();
 	unsigned int nyears = 10;
-
-	// Simulate an assingment by year
-	unsigned int iyear = 0;
+	std::vector< std::vector<unsigned int> > matchings;
+	std::string updated_graph_str;
 	std::string error_msg;
-	ResultCode rescode;
-	while(iyear<nyears) {
-
-		// Compute the matching
-		std::vector<unsigned int> matching;
-		std::string updated_graph_str;
-		rescode = findBestPerfectMatching(graph_str, matching, updated_graph_str);
-		if(rescode!=ResCode_Success) {
-			if(rescode==ResCode_KnownException)
-				error_msg = updated_graph_str;
-			break;
-		}
+	ResultCode rescode = findBestPerfectMatchingRounds(graph_str, nyears, matchings, updated_graph_str);
+	if(rescode==ResCode_KnownException)
+		error_msg = updated_graph_str;
+
+	// Display the assignment of each year
+	for(unsigned int iyear=0; iyear<matchings.size(); ++iyear) {
 
 		// Reverse the matching
+		const std::vector<unsigned int> &matching = matchings[iyear];
 		unsigned int nids = matching.size();
 		std::vector<unsigned int> matching_inv(nids);
 		for(unsigned int id=0; id<nids; ++id)
@@ -177,14 +171,9 @@ void main()
 
 		// Display the matching
 		std::cout << "Year #" << iyear << ":" << std::endl;
-		//std::cout << "Graph: '" << graph_str << "'" << std::endl;
 		for(unsigned int id=0; id<nids; ++id)
 			std::cout << pg.getParticipant(id).getName() << " offers to " << pg.getParticipant(matching[id]).getName() << " and receives from " << pg.getParticipant(matching_inv[id]).getName() << std::endl;
 		std::cout << std::endl;
-
-		// Prepare next iteration
-		++iyear;
-		graph_str = updated_graph_str;
 	}
 
 	// Display feedback in case of failure
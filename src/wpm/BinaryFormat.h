@@ -0,0 +1,148 @@
+/* BinaryFormat.h
+ * This file defines the helpers shared by the binary serialization of the graph classes. */
+
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+
+
+namespace wpm {
+namespace impl {
+
+
+
+/*! The binary graph files start with a header made of a 4-character magic string identifying the graph class, followed by
+ *  the format version and two counts, all of them stored as 32-bit unsigned integers. All the integers in the binary
+ *  files are stored in little-endian order, whatever the endianness of the machine which wrote them.
+ */
+const size_t BINARY_HEADER_SIZE = 16;
+//! Current version of the binary format, to be incremented whenever the layout of the binary files changes.
+const unsigned int BINARY_FORMAT_VERSION = 1;
+//! Size of the chunks in which the binary graph files are written, so that the whole file is never built in memory.
+const size_t BINARY_CHUNK_SIZE = 65536;
+//! Magic string of the binary NonMatchingGraph files.
+const char NON_MATCHING_GRAPH_BINARY_MAGIC[4] = {'W', 'P', 'M', 'N'};
+//! Magic string of the binary BipartiteMatchingGraph files, with 32-bit integer scores.
+const char BIPARTITE_MATCHING_GRAPH_BINARY_MAGIC[4] = {'W', 'P', 'M', 'B'};
+//! Magic string of the binary BasicBipartiteMatchingGraph<long long> files, with 64-bit integer scores.
+const char BIPARTITE_MATCHING_GRAPH_INT64_BINARY_MAGIC[4] = {'W', 'P', 'M', 'L'};
+//! Magic string of the binary BasicBipartiteMatchingGraph<double> files, with 64-bit floating-point scores.
+const char BIPARTITE_MATCHING_GRAPH_FLOAT64_BINARY_MAGIC[4] = {'W', 'P', 'M', 'D'};
+
+//! Function to read a little-endian 32-bit unsigned integer.
+inline unsigned int readUInt32LE(const char *data)
+{
+	const unsigned char *bytes = (const unsigned char*)data;
+	return (unsigned int)bytes[0] | ((unsigned int)bytes[1]<<8) | ((unsigned int)bytes[2]<<16) | ((unsigned int)bytes[3]<<24);
+}
+
+//! Function to read a little-endian 32-bit signed integer, stored in two's complement.
+inline int readInt32LE(const char *data)
+{
+	const unsigned int value = readUInt32LE(data);
+	int signed_value;
+	std::memcpy(&signed_value, &value, sizeof(int));
+	return signed_value;
+}
+
+//! Function to read a little-endian 64-bit signed integer, stored in two's complement.
+inline long long readInt64LE(const char *data)
+{
+	const unsigned long long value = (unsigned long long)readUInt32LE(data) | ((unsigned long long)readUInt32LE(data+4)<<32);
+	long long signed_value;
+	std::memcpy(&signed_value, &value, sizeof(long long));
+	return signed_value;
+}
+
+//! Function to read a little-endian 64-bit IEEE 754 floating-point number.
+inline double readFloat64LE(const char *data)
+{
+	const long long bits = readInt64LE(data);
+	double value;
+	std::memcpy(&value, &bits, sizeof(double));
+	return value;
+}
+
+//! Function to append a 32-bit unsigned integer in little-endian order to the specified buffer.
+inline void appendUInt32LE(std::vector<char> &buffer, unsigned int value)
+{
+	buffer.push_back((char)(value&0xFF));
+	buffer.push_back((char)((value>>8)&0xFF));
+	buffer.push_back((char)((value>>16)&0xFF));
+	buffer.push_back((char)((value>>24)&0xFF));
+}
+
+//! Function to append a 32-bit signed integer in little-endian order (two's complement) to the specified buffer.
+inline void appendInt32LE(std::vector<char> &buffer, int value)
+{
+	unsigned int unsigned_value;
+	std::memcpy(&unsigned_value, &value, sizeof(int));
+	appendUInt32LE(buffer, unsigned_value);
+}
+
+//! Function to append a 64-bit signed integer in little-endian order (two's complement) to the specified buffer.
+inline void appendInt64LE(std::vector<char> &buffer, long long value)
+{
+	unsigned long long unsigned_value;
+	std::memcpy(&unsigned_value, &value, sizeof(long long));
+	appendUInt32LE(buffer, (unsigned int)(unsigned_value&0xFFFFFFFFULL));
+	appendUInt32LE(buffer, (unsigned int)(unsigned_value>>32));
+}
+
+//! Function to append a 64-bit IEEE 754 floating-point number in little-endian order to the specified buffer.
+inline void appendFloat64LE(std::vector<char> &buffer, double value)
+{
+	long long bits;
+	std::memcpy(&bits, &value, sizeof(double));
+	appendInt64LE(buffer, bits);
+}
+
+//! Function to append the header of a binary graph file to the specified buffer.
+inline void appendBinaryHeader(std::vector<char> &buffer, const char magic[4], unsigned int count1, unsigned int count2)
+{
+	buffer.insert(buffer.end(), magic, magic+4);
+	appendUInt32LE(buffer, BINARY_FORMAT_VERSION);
+	appendUInt32LE(buffer, count1);
+	appendUInt32LE(buffer, count2);
+}
+
+/*! Function to write the content of the specified buffer to the stream and clear it, once it holds at least a chunk, or
+ *  whatever it holds if flush_all is true. The buffer should reserve a chunk and the size of the largest appended value.
+ *  Returns false if the stream is bad.
+ */
+inline bool writeBinaryChunk(std::ostream &os, std::vector<char> &buffer, bool flush_all=false)
+{
+	if(buffer.empty() || (buffer.size()<BINARY_CHUNK_SIZE && !flush_all))
+		return true;
+	os.write(&buffer[0], buffer.size());
+	buffer.clear();
+	return !os.bad();
+}
+
+//! Function to read the header of a binary graph file, and return false if the magic string or the version does not match.
+inline bool readBinaryHeader(const char *data, size_t size, const char magic[4], unsigned int &count1, unsigned int &count2)
+{
+	if(data==NULL || size<BINARY_HEADER_SIZE || std::memcmp(data, magic, 4)!=0)
+		return false;
+	if(readUInt32LE(data+4)!=BINARY_FORMAT_VERSION)
+		return false;
+	count1 = readUInt32LE(data+8);
+	count2 = readUInt32LE(data+12);
+	return true;
+}
+
+
+
+}	// namespace impl
+}	// namespace wpm
+
+
+
+#endif //BINARY_FORMAT_H
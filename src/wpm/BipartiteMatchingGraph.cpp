@@ -4,7 +4,11 @@
 
 #include <algorithm>
 #include <fstream>
-#include "WPMASSERT.h"
+#include "WPMAssert.h"
+#include "BinaryFormat.h"
+#include "MappedFile.h"
+#include "TextParser.h"
+#include "RandomEngine.h"
 #include "BipartiteMatchingGraph.h"
 
 
@@ -17,30 +21,119 @@ namespace wpm {
 
 
 
-BipartiteMatchingGraph::Edge::Edge()
+namespace impl {
+
+//! Function to write a score into a text stream (the floating-point scores are written with enough digits to be read back exactly).
+template<class Score>
+inline void writeScore(std::ostream &os, Score score)
+{
+	os << score;
+}
+
+template<>
+inline void writeScore<double>(std::ostream &os, double score)
+{
+	const std::streamsize precision = os.precision(std::numeric_limits<double>::max_digits10);
+	os << score;
+	os.precision(precision);
+}
+
+// Functions to parse a score at the current position of a text buffer
+inline bool parseScore(const char *&ptr, const char *end, int &score) { return parseInt(ptr, end, score); }
+inline bool parseScore(const char *&ptr, const char *end, long long &score) { return parseSignedInteger(ptr, end, score); }
+inline bool parseScore(const char *&ptr, const char *end, double &score) { return parseDouble(ptr, end, score); }
+
+//! Function to read a score from a text stream.
+template<class Score>
+inline void readScore(std::istream &is, Score &score)
+{
+	is >> std::noskipws >> score;
+}
+
+//! Function to read a floating-point score from a text stream, with the same syntax as parseDouble (the streams do not read the infinite values).
+template<>
+inline void readScore<double>(std::istream &is, double &score)
+{
+	char token[64];
+	size_t length = 0;
+	while(length<sizeof(token)-1 && is.peek()!=std::char_traits<char>::eof() && is.peek()!='\0' && std::strchr("+-.0123456789eEinfINF", (char)is.peek())!=NULL)
+		token[length++] = (char)is.get();
+	const char *ptr = token;
+	if(!parseDouble(ptr, token+length, score) || ptr!=token+length)
+		is.setstate(std::ios::failbit);
+}
+
+/*! Binary layout of the scores, whose width depends on the score type. Each score type has its own magic string, so that
+ *  a binary file is never read as a graph with another score type.
+ */
+template<class Score>
+struct BinaryScoreLayout;
+
+template<>
+struct BinaryScoreLayout<int>
+{
+	static const size_t size = 4;
+	static inline const char* magic() { return BIPARTITE_MATCHING_GRAPH_BINARY_MAGIC; }
+	static inline void append(std::vector<char> &buffer, int score) { appendInt32LE(buffer, score); }
+	static inline int read(const char *data) { return readInt32LE(data); }
+};
+
+template<>
+struct BinaryScoreLayout<long long>
+{
+	static const size_t size = 8;
+	static inline const char* magic() { return BIPARTITE_MATCHING_GRAPH_INT64_BINARY_MAGIC; }
+	static inline void append(std::vector<char> &buffer, long long score) { appendInt64LE(buffer, score); }
+	static inline long long read(const char *data) { return readInt64LE(data); }
+};
+
+template<>
+struct BinaryScoreLayout<double>
+{
+	static const size_t size = 8;
+	static inline const char* magic() { return BIPARTITE_MATCHING_GRAPH_FLOAT64_BINARY_MAGIC; }
+	static inline void append(std::vector<char> &buffer, double score) { appendFloat64LE(buffer, score); }
+	static inline double read(const char *data) { return readFloat64LE(data); }
+};
+
+}	// namespace impl
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::Edge::Edge()
 	: v_source(NULL)
 	, v_target(NULL)
 {
 }
 
-BipartiteMatchingGraph::Edge::Edge(Vertex* v_source, Vertex* v_target, int score)
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::Edge::Edge(Vertex* v_source, Vertex* v_target, Score score)
 	: score(score)
 	, v_source(v_source)
 	, v_target(v_target)
 {
 }
 
-bool BipartiteMatchingGraph::Edge::serialize(std::ostream &os) const
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::Edge::serialize(std::ostream &os) const
 {
-	os << "e " << v_source->parent->cid << " " << v_target->parent->cid << " " << score << "\n";
+	os << "e " << v_source->parent->cid << " " << v_target->parent->cid << " ";
+	impl::writeScore(os, score);
+	os << "\n";
 	return true;
 }
 
-bool BipartiteMatchingGraph::Edge::deserialize(std::istream &is, std::vector<Clique> &cliques)
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::Edge::deserialize(std::istream &is, std::vector<Clique> &cliques)
 {
 	// First read the source and target IDs
 	char c[2];
-	int s;
+	Score s;
 	unsigned int cid_source, cid_target;
 	is.read(c, 2);
 	if(c[0]!='e' || c[1]!=' ' || is.bad()) return false;
@@ -50,7 +143,7 @@ bool BipartiteMatchingGraph::Edge::deserialize(std::istream &is, std::vector<Cli
 	is >> std::noskipws >> cid_target;
 	is.read(c, 1);
 	if(c[0]!=' ' || is.bad()) return false;
-	is >> std::noskipws >> s;
+	impl::readScore(is, s);
 	is.read(c, 1);
 	if(c[0]!='\n' || is.bad()) return false;
 	if(cid_source>=cliques.size()) return false;
@@ -62,20 +155,42 @@ bool BipartiteMatchingGraph::Edge::deserialize(std::istream &is, std::vector<Cli
 	return true;
 }
 
-BipartiteMatchingGraph::Vertex::Vertex(Clique *parent)
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::Edge::deserialize(const char *&ptr, const char *end, std::vector<Clique> &cliques)
+{
+	// First read the source and target IDs, then the score
+	unsigned int cid_source, cid_target;
+	Score s;
+	if(!impl::parseChar(ptr, end, 'e') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, cid_source) || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, cid_target) || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseScore(ptr, end, s) || !impl::parseEndOfLine(ptr, end)) return false;
+	if(cid_source>=cliques.size()) return false;
+	if(cid_target>=cliques.size()) return false;
+	// Then define the member pointers
+	v_source = &cliques[cid_source].v_source;
+	v_target = &cliques[cid_target].v_target;
+	score = s;
+	return true;
+}
+
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::Vertex::Vertex(Clique *parent)
 	: parent(parent)
 {
 	// /!\ parent pointer should not be used in the Vertex constructor, because the pointed clique may not be fully constructed yet.
 }
 
-BipartiteMatchingGraph::Clique::Clique(unsigned int cid)
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::Clique::Clique(unsigned int cid)
 	: cid(cid)
 	, v_source(this)
 	, v_target(this)
 {
 }
 
-BipartiteMatchingGraph::Clique::Clique(const Clique &c)
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::Clique::Clique(const Clique &c)
 	: cid(c.cid)
 	, v_source(this)
 	, v_target(this)
@@ -88,44 +203,50 @@ BipartiteMatchingGraph::Clique::Clique(const Clique &c)
 
 
 
-BipartiteMatchingGraph::BipartiteMatchingGraph()
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::BasicBipartiteMatchingGraph()
+	: _is_finalized(false)
 {
 }
 
-BipartiteMatchingGraph::~BipartiteMatchingGraph()
+template<class Score>
+BasicBipartiteMatchingGraph<Score>::~BasicBipartiteMatchingGraph()
 {
 }
 
-bool BipartiteMatchingGraph::save(const std::string &filepath) const
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::save(const std::string &filepath) const
 {
-	std::ofstream os(filepath, std::ios::out+std::ios::trunc);
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc|std::ios::binary);
 	if(!os.is_open()) return false;
 	if(!serialize(os)) return false;
 	os.close();
 	return true;
 }
 
-bool BipartiteMatchingGraph::serialize(std::ostream &os) const
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::serialize(std::ostream &os) const
 {
 	os << "nc " << _cliques.size() << "\n";
 	os << "ne " << _edges.size() << "\n";
-	for(std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
 		if(!it_e->serialize(os))
 			return false;
 	}
 	return true;
 }
 
-bool BipartiteMatchingGraph::load(const std::string &filepath)
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::load(const std::string &filepath)
 {
-	std::ifstream is(filepath, std::ios::in);
-	if(!is.is_open()) return false;
-	if(!deserialize(is)) return false;
-	is.close();
-	return true;
+	// The file is mapped in memory and parsed as a single buffer
+	MappedFile file;
+	if(!file.open(filepath)) return false;
+	return deserialize(file.getData(), file.getSize());
 }
 
-bool BipartiteMatchingGraph::deserialize(std::istream &is)
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::deserialize(std::istream &is)
 {
 	// First read the number of cliques
 	char c[3];
@@ -154,22 +275,128 @@ bool BipartiteMatchingGraph::deserialize(std::istream &is)
 		}
 		_addEdge(e);
 	}
+	finalize();
 	return true;
 }
 
-void BipartiteMatchingGraph::startNewGraph(unsigned int ncliques)
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::deserialize(const char *data, size_t size)
 {
-	// Clear the graph
-	_cliques.clear();
+	const char *ptr = data;
+	const char *end = data+size;
+	// First read the number of cliques, then the number of edges
+	unsigned int ncliques, nedges;
+	if(!impl::parseChar(ptr, end, 'n') || !impl::parseChar(ptr, end, 'c') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, ncliques) || !impl::parseEndOfLine(ptr, end)) return false;
+	if(!impl::parseChar(ptr, end, 'n') || !impl::parseChar(ptr, end, 'e') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, nedges) || !impl::parseEndOfLine(ptr, end)) return false;
+	// Start a new graph with the specified number of cliques
+	startNewGraph(ncliques);
+	// Then deserialize each edge, without reserving more edges than the buffer can contain
+	_edges.reserve(std::min<size_t>(nedges, size/8));
+	for(unsigned int n=0; n<nedges; ++n) {
+		Edge e;
+		if(!e.deserialize(ptr, end, _cliques)) {
+			startNewGraph(0);
+			return false;
+		}
+		_addEdge(e);
+	}
+	finalize();
+	return true;
+}
+
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::saveBinary(const std::string &filepath) const
+{
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc|std::ios::binary);
+	if(!os.is_open()) return false;
+	if(!serializeBinary(os)) return false;
+	os.close();
+	return true;
+}
+
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::serializeBinary(std::ostream &os) const
+{
+	// The binary layout is the header, followed by the source clique IDs, the target clique IDs and the scores of
+	// all the edges, in their insertion order, written in chunks
+	const unsigned int nedges = _edges.size();
+	std::vector<char> buffer;
+	buffer.reserve(impl::BINARY_CHUNK_SIZE+impl::BINARY_HEADER_SIZE);
+	impl::appendBinaryHeader(buffer, impl::BinaryScoreLayout<Score>::magic(), _cliques.size(), nedges);
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
+		impl::appendUInt32LE(buffer, it_e->v_source->parent->cid);
+		if(!impl::writeBinaryChunk(os, buffer)) return false;
+	}
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
+		impl::appendUInt32LE(buffer, it_e->v_target->parent->cid);
+		if(!impl::writeBinaryChunk(os, buffer)) return false;
+	}
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
+		impl::BinaryScoreLayout<Score>::append(buffer, it_e->score);
+		if(!impl::writeBinaryChunk(os, buffer)) return false;
+	}
+	return impl::writeBinaryChunk(os, buffer, true);
+}
+
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::loadBinary(const std::string &filepath)
+{
+	// The file is mapped in memory and decoded in place, without being read through a stream
+	MappedFile file;
+	if(!file.open(filepath)) return false;
+	return deserializeBinary(file.getData(), file.getSize());
+}
+
+template<class Score>
+bool BasicBipartiteMatchingGraph<Score>::deserializeBinary(const char *data, size_t size)
+{
+	// Read the header, and check that the size of the buffer matches the counts before allocating anything
+	unsigned int ncliques, nedges;
+	if(!impl::readBinaryHeader(data, size, impl::BinaryScoreLayout<Score>::magic(), ncliques, nedges))
+		return false;
+	if((unsigned long long)size!=impl::BINARY_HEADER_SIZE+(8ULL+impl::BinaryScoreLayout<Score>::size)*nedges)
+		return false;
+	const char *sources = data+impl::BINARY_HEADER_SIZE;
+	const char *targets = sources+4*(size_t)nedges;
+	const char *scores = targets+4*(size_t)nedges;
+	// Start a new graph with the specified number of cliques, then create all the edges at once
+	startNewGraph(ncliques);
+	_edges.reserve(nedges);
+	for(unsigned int eid=0; eid<nedges; ++eid) {
+		const unsigned int cid_source = impl::readUInt32LE(sources+4*(size_t)eid);
+		const unsigned int cid_target = impl::readUInt32LE(targets+4*(size_t)eid);
+		if(cid_source>=ncliques || cid_target>=ncliques) {
+			startNewGraph(0);
+			return false;
+		}
+		_addEdge(Edge(&_cliques[cid_source].v_source, &_cliques[cid_target].v_target, impl::BinaryScoreLayout<Score>::read(scores+impl::BinaryScoreLayout<Score>::size*eid)));
+	}
+	finalize();
+	return true;
+}
+
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::startNewGraph(unsigned int ncliques)
+{
+	// Clear the graph, keeping the memory of the previous graph so that a graph rebuilt with the same size does not allocate
 	_edges.clear();
-	// Start a new graph
-	_cliques.reserve(ncliques);
-	for(unsigned int cid=0; cid<ncliques; ++cid)
-		_cliques.push_back(Clique(cid));
-	_edges.reserve(ncliques*ncliques);
+	_source_offsets.clear();
+	_source_adjacency.clear();
+	_source_edge_ids.clear();
+	_is_finalized = false;
+	// Start a new graph, reusing the existing cliques and the edge arrays of their vertices
+	_cliques.resize(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		_cliques[cid].cid = cid;
+		_cliques[cid].v_source.edges.clear();
+		_cliques[cid].v_target.edges.clear();
+	}
 }
 
-void BipartiteMatchingGraph::addDirectedEdge(unsigned int cid_source, unsigned int cid_target, int score)
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::addDirectedEdge(unsigned int cid_source, unsigned int cid_target, Score score)
 {
 	WPMASSERT(cid_source<_cliques.size() && cid_target<_cliques.size(), "Input clique ID does not exist!");
 	WPMASSERT(cid_source!=cid_target,"A clique cannot be matched to itself!");
@@ -177,66 +404,121 @@ void BipartiteMatchingGraph::addDirectedEdge(unsigned int cid_source, unsigned i
 	_addEdge(e);
 }
 
-unsigned int BipartiteMatchingGraph::getNumberCliques() const
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::finalize()
+{
+	const unsigned int ncliques = _cliques.size();
+	const unsigned int nedges = _edges.size();
+	// Count the edges of each source vertex, to compute the offsets of the compressed sparse row layout
+	_source_offsets.assign(ncliques+1, 0);
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e)
+		++_source_offsets[it_e->v_source->parent->cid+1];
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		_source_offsets[cid+1] += _source_offsets[cid];
+	// Store the edges of each source vertex contiguously, in their insertion order. The offsets are used as fill
+	// positions, which shifts them by one source vertex, and are shifted back afterwards
+	_source_adjacency.resize(nedges);
+	_source_edge_ids.resize(nedges);
+	for(unsigned int eid=0; eid<nedges; ++eid) {
+		const unsigned int index = _source_offsets[_edges[eid].v_source->parent->cid]++;
+		_source_adjacency[index].target_cid = _edges[eid].v_target->parent->cid;
+		_source_adjacency[index].score = _edges[eid].score;
+		_source_edge_ids[index] = eid;
+	}
+	for(unsigned int cid=ncliques; cid>0; --cid)
+		_source_offsets[cid] = _source_offsets[cid-1];
+	_source_offsets[0] = 0;
+	// Build the pointer-based view of the incident edges of each vertex, which is only valid once no edge is added anymore
+	for(typename std::vector<Clique>::iterator it_c=_cliques.begin(); it_c!=_cliques.end(); ++it_c) {
+		it_c->v_source.edges.clear();
+		it_c->v_source.edges.reserve(_source_offsets[it_c->cid+1]-_source_offsets[it_c->cid]);
+		it_c->v_target.edges.clear();
+	}
+	for(typename std::vector<Edge>::iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e) {
+		it_e->v_source->edges.push_back(&(*it_e));
+		it_e->v_target->edges.push_back(&(*it_e));
+	}
+	_is_finalized = true;
+}
+
+template<class Score>
+unsigned int BasicBipartiteMatchingGraph<Score>::getNumberCliques() const
 {
 	return _cliques.size();
 }
 
-unsigned int BipartiteMatchingGraph::getNumberVertices() const
+template<class Score>
+unsigned int BasicBipartiteMatchingGraph<Score>::getNumberVertices() const
 {
 	return 2*_cliques.size();	// There are two vertices per clique
 }
 
-void BipartiteMatchingGraph::getEdgeIterators(std::vector<Edge>::const_iterator &ibegin, std::vector<Edge>::const_iterator &iend) const
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getEdgeIterators(typename std::vector<Edge>::const_iterator &ibegin, typename std::vector<Edge>::const_iterator &iend) const
 {
 	ibegin = _edges.begin();
 	iend = _edges.end();
 }
 
-void BipartiteMatchingGraph::getEdgeIterators(std::vector<Edge>::iterator &ibegin, std::vector<Edge>::iterator &iend)
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getEdgeIterators(typename std::vector<Edge>::iterator &ibegin, typename std::vector<Edge>::iterator &iend)
 {
 	ibegin = _edges.begin();
 	iend = _edges.end();
 }
 
-void BipartiteMatchingGraph::getEdgesInRandomOrder(std::vector<const Edge*> &shuffled_edges) const
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getEdgesInRandomOrder(std::vector<const Edge*> &shuffled_edges, RandomEngine &random_engine) const
 {
+	shuffled_edges.clear();
 	shuffled_edges.reserve(_edges.size());
-	for(std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e)
+	for(typename std::vector<Edge>::const_iterator it_e=_edges.begin(); it_e!=_edges.end(); ++it_e)
 		shuffled_edges.push_back(&(*it_e));
-	std::random_shuffle(shuffled_edges.begin(), shuffled_edges.end());
+	random_engine.shuffle(shuffled_edges.begin(), shuffled_edges.end());
 }
 
-void BipartiteMatchingGraph::getCliqueIterators(std::vector<Clique>::const_iterator &ibegin, std::vector<Clique>::const_iterator &iend) const
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getCliqueIterators(typename std::vector<Clique>::const_iterator &ibegin, typename std::vector<Clique>::const_iterator &iend) const
 {
 	ibegin = _cliques.begin();
 	iend = _cliques.end();
 }
 
-void BipartiteMatchingGraph::getCliqueIterators(std::vector<Clique>::iterator &ibegin, std::vector<Clique>::iterator &iend)
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getCliqueIterators(typename std::vector<Clique>::iterator &ibegin, typename std::vector<Clique>::iterator &iend)
 {
 	ibegin = _cliques.begin();
 	iend = _cliques.end();
 }
 
-void BipartiteMatchingGraph::getCliquesInRandomOrder(std::vector<const Clique*> &shuffled_cliques) const
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::getCliquesInRandomOrder(std::vector<const Clique*> &shuffled_cliques, RandomEngine &random_engine) const
 {
+	shuffled_cliques.clear();
 	shuffled_cliques.reserve(_cliques.size());
-	for(std::vector<Clique>::const_iterator it_c=_cliques.begin(); it_c!=_cliques.end(); ++it_c)
+	for(typename std::vector<Clique>::const_iterator it_c=_cliques.begin(); it_c!=_cliques.end(); ++it_c)
 		shuffled_cliques.push_back(&(*it_c));
-	std::random_shuffle(shuffled_cliques.begin(), shuffled_cliques.end());
+	random_engine.shuffle(shuffled_cliques.begin(), shuffled_cliques.end());
 }
 
-const BipartiteMatchingGraph::Clique* BipartiteMatchingGraph::getClique(unsigned int cid) const
+template<class Score>
+const typename BasicBipartiteMatchingGraph<Score>::Clique* BasicBipartiteMatchingGraph<Score>::getClique(unsigned int cid) const
 {
 	return &_cliques[cid];
 }
 
-void BipartiteMatchingGraph::_addEdge(Edge &edge)
+template<class Score>
+unsigned int BasicBipartiteMatchingGraph<Score>::getNumberEdges() const
+{
+	return _edges.size();
+}
+
+template<class Score>
+void BasicBipartiteMatchingGraph<Score>::_addEdge(const Edge &edge)
 {
+	// The vertex edges are not updated here, since adding edges may reallocate _edges and invalidate the pointers
 	_edges.push_back(edge);
-	edge.v_source->edges.push_back(&_edges.back());
-	edge.v_target->edges.push_back(&_edges.back());
+	_is_finalized = false;
 }
 
 
@@ -245,13 +527,15 @@ void BipartiteMatchingGraph::_addEdge(Edge &edge)
 
 
 
-std::istream& operator>>(std::istream &is, BipartiteMatchingGraph &bmgraph)
+template<class Score>
+std::istream& operator>>(std::istream &is, BasicBipartiteMatchingGraph<Score> &bmgraph)
 {
 	bmgraph.deserialize(is);
 	return is;
 }
 
-std::ostream& operator<<(std::ostream &os, const BipartiteMatchingGraph &bmgraph)
+template<class Score>
+std::ostream& operator<<(std::ostream &os, const BasicBipartiteMatchingGraph<Score> &bmgraph)
 {
 	bmgraph.serialize(os);
 	return os;
@@ -259,4 +543,21 @@ std::ostream& operator<<(std::ostream &os, const BipartiteMatchingGraph &bmgraph
 
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+template class BasicBipartiteMatchingGraph<int>;
+template class BasicBipartiteMatchingGraph<long long>;
+template class BasicBipartiteMatchingGraph<double>;
+template std::istream& operator>>(std::istream &is, BasicBipartiteMatchingGraph<int> &bmgraph);
+template std::istream& operator>>(std::istream &is, BasicBipartiteMatchingGraph<long long> &bmgraph);
+template std::istream& operator>>(std::istream &is, BasicBipartiteMatchingGraph<double> &bmgraph);
+template std::ostream& operator<<(std::ostream &os, const BasicBipartiteMatchingGraph<int> &bmgraph);
+template std::ostream& operator<<(std::ostream &os, const BasicBipartiteMatchingGraph<long long> &bmgraph);
+template std::ostream& operator<<(std::ostream &os, const BasicBipartiteMatchingGraph<double> &bmgraph);
+
+
+
 } //namespace wpm
@@ -5,8 +5,10 @@
 
 
 
+#include <iosfwd>
 #include <string>
 #include <vector>
+#include "ScoreTraits.h"
 
 
 
@@ -14,12 +16,29 @@ namespace wpm {
 
 
 
-/*! BipartiteMatchingGraph class, representing a set of cliques to be matched. Each clique contains one source and one target
- *  vertices. The edges of the graph, which represent possible clique matches, link one source vertex to one target vertex of
- *  two different cliques.
+// Forward declarations
+class RandomEngine;
+template<class Score> class BasicMatchingGraphReducer;
+
+
+
+/*! BasicBipartiteMatchingGraph class, representing a set of cliques to be matched. Each clique contains one source and one
+ *  target vertices. The edges of the graph, which represent possible clique matches, link one source vertex to one target
+ *  vertex of two different cliques.
+ *  Once all the edges are added, the graph must be finalized, which stores the edges of each source vertex contiguously
+ *  as (target clique ID, score) pairs (compressed sparse row layout) and builds the pointer-based view of the incident
+ *  edges of each vertex (see Vertex::edges). The searches, reductions and samplings of a graph which is not finalized
+ *  fail with an assertion in debug builds, and return false in release builds, where the finder reports no Hall violator
+ *  (unlike for a graph without perfect matching).
+ *  The class is templated on the type of the scores (see ScoreTraits), and is only instantiated for int, long long and
+ *  double. BipartiteMatchingGraph is the graph with int scores.
  */
-class BipartiteMatchingGraph
+template<class Score>
+class BasicBipartiteMatchingGraph
 {
+	// The reducer builds graphs where an edge may link the two vertices of a clique (see BasicMatchingGraphReducer)
+	friend class BasicMatchingGraphReducer<Score>;
+
 public:
 
 	// Nested classes
@@ -33,25 +52,26 @@ public:
 	 */
 	struct Edge
 	{
-		friend class BipartiteMatchingGraph;
+		friend class BasicBipartiteMatchingGraph;
 
-		int score;				//!< Score of the edge, related to the interest of matching these two vertices.
+		Score score;			//!< Score of the edge, related to the interest of matching these two vertices.
 		Vertex* v_source;		//!< Pointer to the source vertex.
 		Vertex* v_target;		//!< Pointer to the target vertex.
 
 		Edge();
-		Edge(Vertex* v_source, Vertex* v_target, int score);
+		Edge(Vertex* v_source, Vertex* v_target, Score score);
 
 	private:
 		bool serialize(std::ostream &os) const;
 		bool deserialize(std::istream &is, std::vector<Clique> &cliques);
+		bool deserialize(const char *&ptr, const char *end, std::vector<Clique> &cliques);
 	};
 
 	//! Vertex structure.
 	struct Vertex
 	{
 		Clique *parent;				//!< Parent clique for this vertex.
-		std::vector<Edge*> edges;	//!< Set of all edges incident to this vertex.
+		std::vector<Edge*> edges;	//!< Set of all edges incident to this vertex (built when the graph is finalized).
 
 		Vertex(Clique *parent=NULL);
 	};
@@ -67,18 +87,29 @@ public:
 		Clique(const Clique &c);
 	};
 
+	//! Adjacent edge structure, representing an edge in the compressed sparse row layout of the edges of a source vertex.
+	struct AdjacentEdge
+	{
+		unsigned int target_cid;	//!< Clique ID of the target vertex.
+		Score score;				//!< Score of the edge.
+	};
+
 private:
 
-	// BipartiteMatchingGraph data members
-	std::vector<Clique> _cliques;	//!< Set of cliques in the graph.
-	std::vector<Edge> _edges;		//!< Set of edges in the graph.
+	// BasicBipartiteMatchingGraph data members
+	std::vector<Clique> _cliques;					//!< Set of cliques in the graph.
+	std::vector<Edge> _edges;						//!< Set of edges in the graph.
+	std::vector<unsigned int> _source_offsets;		//!< Array containing, for each source vertex, the index of its first adjacent edge in _source_adjacency.
+	std::vector<AdjacentEdge> _source_adjacency;	//!< Adjacent edges of all the source vertices, grouped by source vertex in the insertion order of the edges.
+	std::vector<unsigned int> _source_edge_ids;		//!< Array containing, for each adjacent edge in _source_adjacency, the index of the edge in _edges.
+	bool _is_finalized;								//!< Flag indicating whether the compressed sparse row layout and the vertex edges are up to date.
 
 public:
 
 	//! Default constructor.
-	BipartiteMatchingGraph();
+	BasicBipartiteMatchingGraph();
 	//! Destructor.
-	~BipartiteMatchingGraph();
+	~BasicBipartiteMatchingGraph();
 
 	// Graph I/O functions
 
@@ -86,36 +117,65 @@ public:
 	bool serialize(std::ostream &os) const;
 	bool load(const std::string &filepath);
 	bool deserialize(std::istream &is);
+	//! Function to deserialize the graph from a text buffer, with the same format and validation than deserialize(std::istream&) but much faster, where the lines may end with "\r\n".
+	bool deserialize(const char *data, size_t size);
+
+	// Binary graph I/O functions (versioned little-endian format, see BinaryFormat.h)
+
+	bool saveBinary(const std::string &filepath) const;
+	bool serializeBinary(std::ostream &os) const;
+	bool loadBinary(const std::string &filepath);
+	bool deserializeBinary(const char *data, size_t size);
 
 	// Graph modification functions
 
 	void startNewGraph(unsigned int ncliques);
-	void addDirectedEdge(unsigned int cid_source, unsigned int cid_target, int score);
+	void addDirectedEdge(unsigned int cid_source, unsigned int cid_target, Score score);
+	void finalize();
 
 	// Graph getter functions
 
 	unsigned int getNumberCliques() const;
 	unsigned int getNumberVertices() const;
-	void getEdgeIterators(std::vector<Edge>::const_iterator &ibegin, std::vector<Edge>::const_iterator &iend) const;
-	void getEdgeIterators(std::vector<Edge>::iterator &ibegin, std::vector<Edge>::iterator &iend);
-	void getEdgesInRandomOrder(std::vector<const Edge*> &shuffled_edges) const;
-	void getCliqueIterators(std::vector<Clique>::const_iterator &ibegin, std::vector<Clique>::const_iterator &iend) const;
-	void getCliqueIterators(std::vector<Clique>::iterator &ibegin, std::vector<Clique>::iterator &iend);
-	void getCliquesInRandomOrder(std::vector<const Clique*> &shuffled_cliques) const;
-	const BipartiteMatchingGraph::Clique* getClique(unsigned int cid) const;
+	void getEdgeIterators(typename std::vector<Edge>::const_iterator &ibegin, typename std::vector<Edge>::const_iterator &iend) const;
+	void getEdgeIterators(typename std::vector<Edge>::iterator &ibegin, typename std::vector<Edge>::iterator &iend);
+	void getEdgesInRandomOrder(std::vector<const Edge*> &shuffled_edges, RandomEngine &random_engine) const;
+	void getCliqueIterators(typename std::vector<Clique>::const_iterator &ibegin, typename std::vector<Clique>::const_iterator &iend) const;
+	void getCliqueIterators(typename std::vector<Clique>::iterator &ibegin, typename std::vector<Clique>::iterator &iend);
+	void getCliquesInRandomOrder(std::vector<const Clique*> &shuffled_cliques, RandomEngine &random_engine) const;
+	const Clique* getClique(unsigned int cid) const;
+	unsigned int getNumberEdges() const;
+	//! Function to indicate whether the graph was finalized since the last added edge.
+	inline bool isFinalized() const { return _is_finalized; }
+
+	// Compressed sparse row getter functions (the graph must be finalized)
+
+	//! Function to return the index of the first adjacent edge of the specified source vertex.
+	inline unsigned int getSourceAdjacencyBegin(unsigned int cid_source) const { return _source_offsets[cid_source]; }
+	//! Function to return the index following the last adjacent edge of the specified source vertex.
+	inline unsigned int getSourceAdjacencyEnd(unsigned int cid_source) const { return _source_offsets[cid_source+1]; }
+	//! Function to return the adjacent edge with the specified index.
+	inline const AdjacentEdge& getAdjacentEdge(unsigned int index) const { return _source_adjacency[index]; }
+	//! Function to return the pointer to the graph edge corresponding to the adjacent edge with the specified index.
+	inline const Edge* getAdjacentEdgePointer(unsigned int index) const { return &_edges[_source_edge_ids[index]]; }
 
 private:
 
 	//! Private function to append a new edge to the graph.
-	void _addEdge(Edge &e);
+	void _addEdge(const Edge &e);
 
 };
 
 
 
-// Serialization operators for BipartiteMatchingGraph
-std::istream& operator>>(std::istream &is, BipartiteMatchingGraph &bmgraph);
-std::ostream& operator<<(std::ostream &os, const BipartiteMatchingGraph &bmgraph);
+//! Bipartite matching graph with int scores, used by default.
+typedef BasicBipartiteMatchingGraph<int> BipartiteMatchingGraph;
+
+// Serialization operators for BasicBipartiteMatchingGraph
+template<class Score>
+std::istream& operator>>(std::istream &is, BasicBipartiteMatchingGraph<Score> &bmgraph);
+template<class Score>
+std::ostream& operator<<(std::ostream &os, const BasicBipartiteMatchingGraph<Score> &bmgraph);
 
 
 
@@ -0,0 +1,38 @@
+/* BitOperations.h
+ * This file defines the bit manipulation helpers shared by the solvers and the parsers. */
+
+#ifndef BIT_OPERATIONS_H
+#define BIT_OPERATIONS_H
+
+
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+
+namespace wpm {
+namespace impl {
+
+
+
+//! Function to return the index of the lowest set bit of a non-zero 64-bit mask.
+inline unsigned int findLowestSetBit(unsigned long long mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return (unsigned int)index;
+#else
+	return (unsigned int)__builtin_ctzll(mask);
+#endif
+}
+
+
+}	// namespace impl
+}	// namespace wpm
+
+
+
+#endif //BIT_OPERATIONS_H
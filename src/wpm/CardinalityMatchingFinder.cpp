@@ -0,0 +1,288 @@
+/* CardinalityMatchingFinder.cpp */
+
+
+
+#include <algorithm>
+#include <limits>
+#include "WPMAssert.h"
+#include "BipartiteMatchingGraph.h"
+#include "ImplicitBipartiteMatchingGraph.h"
+#include "CardinalityMatchingFinder.h"
+
+
+
+namespace wpm {
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+namespace impl {
+
+//! Adjacency of the source vertices of a BipartiteMatchingGraph, iterated along its compressed sparse row layout.
+template<class Score>
+class ExplicitAdjacency
+{
+private:
+
+	const BasicBipartiteMatchingGraph<Score> &_bmgraph;	//!< Considered graph.
+
+public:
+
+	//! Constructor.
+	ExplicitAdjacency(const BasicBipartiteMatchingGraph<Score> &bmgraph) : _bmgraph(bmgraph) {}
+
+	//! Function to return the number of cliques in the graph.
+	inline unsigned int getNumberCliques() const { return _bmgraph.getNumberCliques(); }
+
+	//! Function to place the cursors before the first target vertex linked to the specified source vertex.
+	inline void resetCursors(unsigned int source_cid, unsigned int &cursor, unsigned int &explicit_cursor) const
+	{
+		cursor = _bmgraph.getSourceAdjacencyBegin(source_cid);
+		explicit_cursor = 0;
+	}
+
+	//! Function to return the next target vertex linked to the specified source vertex and advance the cursors, or return -1 if there is none.
+	inline unsigned int nextTarget(unsigned int source_cid, unsigned int &cursor, unsigned int &/*explicit_cursor*/) const
+	{
+		if(cursor>=_bmgraph.getSourceAdjacencyEnd(source_cid))
+			return (unsigned int)(-1);
+		return _bmgraph.getAdjacentEdge(cursor++).target_cid;
+	}
+};
+
+/*! Adjacency of the source vertices of an ImplicitBipartiteMatchingGraph, where every source vertex is linked to the target
+ *  vertex of every other clique, except those whose explicit score indicates that they cannot be matched. The explicit
+ *  edges are sorted by target clique ID, hence they are merged with the target vertices in increasing order.
+ */
+template<class Score>
+class ImplicitAdjacency
+{
+private:
+
+	const BasicImplicitBipartiteMatchingGraph<Score> &_ibmgraph;	//!< Considered graph.
+
+public:
+
+	//! Constructor.
+	ImplicitAdjacency(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph) : _ibmgraph(ibmgraph) {}
+
+	//! Function to return the number of cliques in the graph.
+	inline unsigned int getNumberCliques() const { return _ibmgraph.getNumberCliques(); }
+
+	//! Function to place the cursors before the first target vertex linked to the specified source vertex.
+	inline void resetCursors(unsigned int /*source_cid*/, unsigned int &cursor, unsigned int &explicit_cursor) const
+	{
+		cursor = 0;
+		explicit_cursor = 0;
+	}
+
+	//! Function to return the next target vertex linked to the specified source vertex and advance the cursors, or return -1 if there is none.
+	inline unsigned int nextTarget(unsigned int source_cid, unsigned int &cursor, unsigned int &explicit_cursor) const
+	{
+		const unsigned int *targets;
+		const Score *scores;
+		unsigned int nedges;
+		_ibmgraph.getSourceExplicitEdges(source_cid, targets, scores, nedges);
+		for(; cursor<_ibmgraph.getNumberCliques(); ++cursor) {
+			if(cursor==source_cid)
+				continue;	// A clique can never be matched with itself
+			while(explicit_cursor<nedges && targets[explicit_cursor]<cursor)
+				++explicit_cursor;
+			if(explicit_cursor<nedges && targets[explicit_cursor]==cursor && ScoreTraits<Score>::isForbidden(scores[explicit_cursor]))
+				continue;	// These two cliques cannot be matched
+			return cursor++;
+		}
+		return (unsigned int)(-1);
+	}
+};
+
+}	// namespace impl
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+CardinalityMatchingFinder::CardinalityMatchingFinder()
+{
+}
+
+CardinalityMatchingFinder::~CardinalityMatchingFinder()
+{
+}
+
+template<class Score>
+bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph)
+{
+	return _findMaximumCardinalityMatching(impl::ExplicitAdjacency<Score>(bmgraph));
+}
+
+template<class Score>
+bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph)
+{
+	return _findMaximumCardinalityMatching(impl::ImplicitAdjacency<Score>(ibmgraph));
+}
+
+template<class Adjacency>
+bool CardinalityMatchingFinder::_findMaximumCardinalityMatching(const Adjacency &adjacency)
+{
+	// Initialize the search (the memory is reused from one graph to the next)
+	const unsigned int ncliques = adjacency.getNumberCliques();
+	_source_matches.assign(ncliques, (unsigned int)(-1));
+	_target_matches.assign(ncliques, (unsigned int)(-1));
+	_hall_violator_sources.clear();
+	_hall_violator_targets.clear();
+	_layers.resize(ncliques);
+	_cursors.resize(ncliques);
+	_explicit_cursors.resize(ncliques);
+	_queue.reserve(ncliques);
+	_path_sources.reserve(ncliques);
+	_path_targets.reserve(ncliques);
+	// Start from a greedy matching, which is usually almost perfect
+	unsigned int nmatches = 0;
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+		unsigned int cursor, explicit_cursor;
+		adjacency.resetCursors(source_cid, cursor, explicit_cursor);
+		for(unsigned int target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor); target_cid!=(unsigned int)(-1); target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor)) {
+			if(_target_matches[target_cid]==(unsigned int)(-1)) {
+				_source_matches[source_cid] = target_cid;
+				_target_matches[target_cid] = source_cid;
+				++nmatches;
+				break;
+			}
+		}
+	}
+	// Each phase augments the matching along a maximal set of vertex-disjoint shortest augmenting paths
+	while(nmatches<ncliques && _computeLayers(adjacency)) {
+		for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid)
+			adjacency.resetCursors(source_cid, _cursors[source_cid], _explicit_cursors[source_cid]);
+		for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+			if(_source_matches[source_cid]==(unsigned int)(-1) && _augmentAlongLayers(adjacency, source_cid))
+				++nmatches;
+		}
+	}
+	if(nmatches==ncliques)
+		return true;
+	// The matching has maximal cardinality but is not perfect, hence build the Hall violator from its first exposed source vertex
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+		if(_source_matches[source_cid]==(unsigned int)(-1)) {
+			_buildHallViolator(adjacency, source_cid);
+			break;
+		}
+	}
+	return false;
+}
+
+template<class Adjacency>
+bool CardinalityMatchingFinder::_computeLayers(const Adjacency &adjacency)
+{
+	const unsigned int ncliques = adjacency.getNumberCliques();
+	_queue.clear();
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+		_layers[source_cid] = (_source_matches[source_cid]==(unsigned int)(-1) ? 0 : (unsigned int)(-1));
+		if(_layers[source_cid]==0)
+			_queue.push_back(source_cid);
+	}
+	unsigned int exposed_target_layer = (unsigned int)(-1);
+	for(size_t i=0; i<_queue.size(); ++i) {
+		const unsigned int source_cid = _queue[i];
+		if(_layers[source_cid]>=exposed_target_layer)
+			break;	// The shortest augmenting paths cannot go through the next layers
+		unsigned int cursor, explicit_cursor;
+		adjacency.resetCursors(source_cid, cursor, explicit_cursor);
+		for(unsigned int target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor); target_cid!=(unsigned int)(-1); target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor)) {
+			const unsigned int matched_source_cid = _target_matches[target_cid];
+			if(matched_source_cid==(unsigned int)(-1))
+				exposed_target_layer = _layers[source_cid];
+			else if(_layers[matched_source_cid]==(unsigned int)(-1)) {
+				_layers[matched_source_cid] = _layers[source_cid]+1;
+				_queue.push_back(matched_source_cid);
+			}
+		}
+	}
+	return (exposed_target_layer!=(unsigned int)(-1));
+}
+
+template<class Adjacency>
+bool CardinalityMatchingFinder::_augmentAlongLayers(const Adjacency &adjacency, unsigned int root_source_cid)
+{
+	// Iterative depth-first search, where the source vertices from which no augmenting path exists are marked as dead ends
+	_path_sources.clear();
+	_path_targets.clear();
+	_path_sources.push_back(root_source_cid);
+	while(!_path_sources.empty()) {
+		const unsigned int source_cid = _path_sources.back();
+		const unsigned int target_cid = adjacency.nextTarget(source_cid, _cursors[source_cid], _explicit_cursors[source_cid]);
+		if(target_cid==(unsigned int)(-1)) {
+			_layers[source_cid] = (unsigned int)(-1);
+			_path_sources.pop_back();
+			if(!_path_targets.empty())
+				_path_targets.pop_back();
+			continue;
+		}
+		const unsigned int matched_source_cid = _target_matches[target_cid];
+		if(matched_source_cid==(unsigned int)(-1)) {
+			// An augmenting path is found, hence swap the edges along the path
+			_path_targets.push_back(target_cid);
+			for(size_t i=0; i<_path_sources.size(); ++i) {
+				_source_matches[_path_sources[i]] = _path_targets[i];
+				_target_matches[_path_targets[i]] = _path_sources[i];
+			}
+			return true;
+		}
+		if(_layers[matched_source_cid]!=(unsigned int)(-1) && _layers[matched_source_cid]==_layers[source_cid]+1) {
+			_path_targets.push_back(target_cid);
+			_path_sources.push_back(matched_source_cid);
+		}
+	}
+	return false;
+}
+
+template<class Adjacency>
+void CardinalityMatchingFinder::_buildHallViolator(const Adjacency &adjacency, unsigned int root_source_cid)
+{
+	// Since the matching has maximal cardinality, every target vertex reachable along alternating paths is matched, and
+	// the reached source vertices are the root and the matched source vertices of the reached target vertices
+	const unsigned int ncliques = adjacency.getNumberCliques();
+	_is_reached_target.assign(ncliques, 0);
+	_queue.clear();
+	_queue.push_back(root_source_cid);
+	for(size_t i=0; i<_queue.size(); ++i) {
+		const unsigned int source_cid = _queue[i];
+		unsigned int cursor, explicit_cursor;
+		adjacency.resetCursors(source_cid, cursor, explicit_cursor);
+		for(unsigned int target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor); target_cid!=(unsigned int)(-1); target_cid=adjacency.nextTarget(source_cid, cursor, explicit_cursor)) {
+			if(_is_reached_target[target_cid])
+				continue;
+			_is_reached_target[target_cid] = 1;
+			_hall_violator_targets.push_back(target_cid);
+			WPMASSERT(_target_matches[target_cid]!=(unsigned int)(-1), "An augmenting path exists from the root of the Hall violator!");
+			_queue.push_back(_target_matches[target_cid]);
+		}
+	}
+	_hall_violator_sources.assign(_queue.begin(), _queue.end());
+	std::sort(_hall_violator_sources.begin(), _hall_violator_sources.end());
+	std::sort(_hall_violator_targets.begin(), _hall_violator_targets.end());
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicBipartiteMatchingGraph<int> &bmgraph);
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicBipartiteMatchingGraph<long long> &bmgraph);
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicBipartiteMatchingGraph<double> &bmgraph);
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicImplicitBipartiteMatchingGraph<int> &ibmgraph);
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicImplicitBipartiteMatchingGraph<long long> &ibmgraph);
+template bool CardinalityMatchingFinder::findMaximumCardinalityMatching(const BasicImplicitBipartiteMatchingGraph<double> &ibmgraph);
+
+
+
+}	// namespace wpm
@@ -0,0 +1,91 @@
+/* CardinalityMatchingFinder.h */
+
+#ifndef CARDINALITY_MATCHING_FINDER_H
+#define CARDINALITY_MATCHING_FINDER_H
+
+
+
+#include <vector>
+
+
+
+namespace wpm {
+
+
+
+// Forward declarations
+template<class Score> class BasicBipartiteMatchingGraph;
+template<class Score> class BasicImplicitBipartiteMatchingGraph;
+
+
+
+/*! CardinalityMatchingFinder class, in charge of finding a matching with maximal cardinality in a bipartite graph, whatever
+ *  the scores of its edges, with the algorithm of Hopcroft and Karp in O(E*sqrt(V)). It is used to check that a graph has a
+ *  perfect matching before running the weighted engines, which only find out late that a graph has none.
+ *  When the graph has no perfect matching, a minimal Hall violator is computed: a set of source vertices which are linked
+ *  to strictly fewer target vertices than their number, such that no strict subset is also a violator. It is the set of
+ *  source vertices reachable along alternating paths from an exposed source vertex of the maximal matching.
+ */
+class CardinalityMatchingFinder
+{
+private:
+
+	std::vector<unsigned int> _source_matches;			//!< Array containing, for each source vertex, the clique ID of the matched target vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _target_matches;			//!< Array containing, for each target vertex, the clique ID of the matched source vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _hall_violator_sources;	//!< Source vertices of the Hall violator, sorted by clique ID (empty if the graph has a perfect matching).
+	std::vector<unsigned int> _hall_violator_targets;	//!< Target vertices linked to the source vertices of the Hall violator, sorted by clique ID.
+	// Workspace of the search
+	std::vector<unsigned int> _layers;					//!< Array containing, for each source vertex, its layer in the current phase (-1 if it is not reached or if it is a dead end).
+	std::vector<unsigned int> _queue;					//!< Source vertices in breadth-first order.
+	std::vector<unsigned int> _cursors;					//!< Array containing, for each source vertex, the position of the next edge to try in the depth-first search.
+	std::vector<unsigned int> _explicit_cursors;		//!< Array containing, for each source vertex of an implicit graph, the position of the next explicit edge.
+	std::vector<unsigned int> _path_sources;			//!< Source vertices along the current depth-first search path.
+	std::vector<unsigned int> _path_targets;			//!< Target vertices along the current depth-first search path.
+	std::vector<unsigned char> _is_reached_target;		//!< Array containing, for each target vertex, a flag indicating whether it was reached while building the Hall violator.
+
+public:
+
+	//! Default constructor.
+	CardinalityMatchingFinder();
+	//! Destructor.
+	~CardinalityMatchingFinder();
+
+	//! Function to find a matching with maximal cardinality in a BipartiteMatchingGraph, and return whether it is perfect.
+	template<class Score>
+	bool findMaximumCardinalityMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph);
+	//! Function to find a matching with maximal cardinality in an ImplicitBipartiteMatchingGraph, and return whether it is perfect.
+	template<class Score>
+	bool findMaximumCardinalityMatching(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph);
+
+	//! Function to return, for each source vertex, the clique ID of the matched target vertex in the last matching found, or -1 if it is exposed.
+	inline const std::vector<unsigned int>& getSourceMatches() const { return _source_matches; }
+	//! Function to indicate whether the last graph has a perfect matching.
+	inline bool isPerfect() const { return _hall_violator_sources.empty(); }
+	//! Function to return the source vertices of the Hall violator of the last graph (empty if it has a perfect matching).
+	inline const std::vector<unsigned int>& getHallViolatorSources() const { return _hall_violator_sources; }
+	//! Function to return the target vertices linked to the source vertices of the Hall violator, which are one less than them.
+	inline const std::vector<unsigned int>& getHallViolatorTargets() const { return _hall_violator_targets; }
+
+private:
+
+	//! Function to run the algorithm of Hopcroft and Karp on the specified graph adjacency, and build the Hall violator if the matching is not perfect.
+	template<class Adjacency>
+	bool _findMaximumCardinalityMatching(const Adjacency &adjacency);
+	//! Function to compute the layers of the source vertices by a breadth-first search from the exposed ones, and return whether an exposed target vertex is reachable.
+	template<class Adjacency>
+	bool _computeLayers(const Adjacency &adjacency);
+	//! Function to search for an augmenting path from the specified exposed source vertex along the layers, and augment the matching if one is found.
+	template<class Adjacency>
+	bool _augmentAlongLayers(const Adjacency &adjacency, unsigned int root_source_cid);
+	//! Function to build the Hall violator from the specified exposed source vertex of a matching with maximal cardinality.
+	template<class Adjacency>
+	void _buildHallViolator(const Adjacency &adjacency, unsigned int root_source_cid);
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //CARDINALITY_MATCHING_FINDER_H
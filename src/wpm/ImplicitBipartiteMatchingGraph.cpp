@@ -0,0 +1,172 @@
+/* ImplicitBipartiteMatchingGraph.cpp */
+
+
+
+#include <algorithm>
+#include <limits>
+#include "WPMAssert.h"
+#include "ImplicitBipartiteMatchingGraph.h"
+
+
+
+namespace wpm {
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+template<class Score>
+BasicImplicitBipartiteMatchingGraph<Score>::BasicImplicitBipartiteMatchingGraph()
+	: _ncliques(0)
+	, _building_cid(0)
+{
+	startNewGraph(0);
+}
+
+template<class Score>
+BasicImplicitBipartiteMatchingGraph<Score>::~BasicImplicitBipartiteMatchingGraph()
+{
+}
+
+template<class Score>
+void BasicImplicitBipartiteMatchingGraph<Score>::startNewGraph(unsigned int ncliques)
+{
+	// Clear the graph
+	_source_offsets.clear();
+	_source_targets.clear();
+	_source_scores.clear();
+	_target_offsets.clear();
+	_target_sources.clear();
+	_target_scores.clear();
+	// Start a new graph, without any explicit edge
+	_ncliques = ncliques;
+	_building_cid = 0;
+	_source_offsets.resize(ncliques+1, 0);
+	_target_offsets.resize(ncliques+1, 0);
+}
+
+template<class Score>
+void BasicImplicitBipartiteMatchingGraph<Score>::setDirectedEdgeScore(unsigned int cid_source, unsigned int cid_target, Score score)
+{
+	WPMASSERT(cid_source<_ncliques && cid_target<_ncliques, "Input clique ID does not exist!");
+	WPMASSERT(cid_source!=cid_target, "A clique cannot be matched to itself!");
+	WPMASSERT(cid_source>=_building_cid, "Explicit edges must be set by increasing source clique ID!");
+	// Close the rows of the previous source vertices, and append the edge to the row of the current one
+	while(_building_cid<cid_source)
+		_source_offsets[++_building_cid] = _source_targets.size();
+	_source_targets.push_back(cid_target);
+	_source_scores.push_back(score);
+}
+
+template<class Score>
+void BasicImplicitBipartiteMatchingGraph<Score>::finalize()
+{
+	// Close the rows of the remaining source vertices
+	while(_building_cid<_ncliques)
+		_source_offsets[++_building_cid] = _source_targets.size();
+	// Sort the explicit edges of each source vertex by target clique ID, keeping the last score set for each pair and
+	// removing the edges which have the default score
+	std::vector< std::pair<unsigned int, unsigned int> > &row = _sorted_row;
+	std::vector<Score> &scores = _sorted_row_scores;
+	unsigned int nkept = 0;
+	for(unsigned int cid_source=0; cid_source<_ncliques; ++cid_source) {
+		const unsigned int begin = _source_offsets[cid_source], end = _source_offsets[cid_source+1];
+		row.clear();
+		for(unsigned int e=begin; e<end; ++e)
+			row.push_back(std::make_pair(_source_targets[e], e));
+		std::sort(row.begin(), row.end());
+		scores.resize(end-begin);
+		for(unsigned int e=begin; e<end; ++e)
+			scores[e-begin] = _source_scores[e];
+		_source_offsets[cid_source] = nkept;
+		for(unsigned int k=0; k<row.size(); ++k) {
+			if(k+1<row.size() && row[k+1].first==row[k].first)
+				continue;	// A more recent score was set for this pair of cliques
+			const Score score = scores[row[k].second-begin];
+			if(score==getDefaultScore())
+				continue;
+			_source_targets[nkept] = row[k].first;
+			_source_scores[nkept] = score;
+			++nkept;
+		}
+	}
+	_source_offsets[_ncliques] = nkept;
+	_source_targets.resize(nkept);
+	_source_scores.resize(nkept);
+	// Build the transposed storage, sorted by target clique ID and then by source clique ID
+	std::fill(_target_offsets.begin(), _target_offsets.end(), 0);
+	for(unsigned int e=0; e<nkept; ++e)
+		++_target_offsets[_source_targets[e]+1];
+	for(unsigned int cid=0; cid<_ncliques; ++cid)
+		_target_offsets[cid+1] += _target_offsets[cid];
+	// The transposed arrays keep the capacity of the source arrays, which grow geometrically, so that a graph growing from one
+	// conversion to the next does not reallocate them each time
+	_target_sources.reserve(_source_targets.capacity());
+	_target_scores.reserve(_source_scores.capacity());
+	_target_sources.resize(nkept);
+	_target_scores.resize(nkept);
+	// The offsets are used as fill positions, which shifts them by one target vertex, and are shifted back afterwards
+	for(unsigned int cid_source=0; cid_source<_ncliques; ++cid_source) {
+		for(unsigned int e=_source_offsets[cid_source]; e<_source_offsets[cid_source+1]; ++e) {
+			unsigned int &f = _target_offsets[_source_targets[e]];
+			_target_sources[f] = cid_source;
+			_target_scores[f] = _source_scores[e];
+			++f;
+		}
+	}
+	for(unsigned int cid=_ncliques; cid>0; --cid)
+		_target_offsets[cid] = _target_offsets[cid-1];
+	_target_offsets[0] = 0;
+}
+
+template<class Score>
+Score BasicImplicitBipartiteMatchingGraph<Score>::getScore(unsigned int cid_source, unsigned int cid_target) const
+{
+	if(cid_source==cid_target)
+		return ScoreTraits<Score>::forbidden();
+	const unsigned int* begin = _source_targets.empty() ? NULL : &_source_targets[0]+_source_offsets[cid_source];
+	const unsigned int* end = _source_targets.empty() ? NULL : &_source_targets[0]+_source_offsets[cid_source+1];
+	const unsigned int* it = std::lower_bound(begin, end, cid_target);
+	if(it!=end && *it==cid_target)
+		return _source_scores[it-&_source_targets[0]];
+	return getDefaultScore();
+}
+
+template<class Score>
+bool BasicImplicitBipartiteMatchingGraph<Score>::isEdge(unsigned int cid_source, unsigned int cid_target) const
+{
+	return !ScoreTraits<Score>::isForbidden(getScore(cid_source, cid_target));
+}
+
+template<class Score>
+void BasicImplicitBipartiteMatchingGraph<Score>::getSourceExplicitEdges(unsigned int cid_source, const unsigned int* &targets, const Score* &scores, unsigned int &nedges) const
+{
+	nedges = _source_offsets[cid_source+1]-_source_offsets[cid_source];
+	targets = (nedges>0 ? &_source_targets[_source_offsets[cid_source]] : NULL);
+	scores = (nedges>0 ? &_source_scores[_source_offsets[cid_source]] : NULL);
+}
+
+template<class Score>
+void BasicImplicitBipartiteMatchingGraph<Score>::getTargetExplicitEdges(unsigned int cid_target, const unsigned int* &sources, const Score* &scores, unsigned int &nedges) const
+{
+	nedges = _target_offsets[cid_target+1]-_target_offsets[cid_target];
+	sources = (nedges>0 ? &_target_sources[_target_offsets[cid_target]] : NULL);
+	scores = (nedges>0 ? &_target_scores[_target_offsets[cid_target]] : NULL);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+template class BasicImplicitBipartiteMatchingGraph<int>;
+template class BasicImplicitBipartiteMatchingGraph<long long>;
+template class BasicImplicitBipartiteMatchingGraph<double>;
+
+
+
+} //namespace wpm
@@ -0,0 +1,88 @@
+/* ImplicitBipartiteMatchingGraph.h */
+
+#ifndef IMPLICIT_BIPARTITE_MATCHING_GRAPH_H
+#define IMPLICIT_BIPARTITE_MATCHING_GRAPH_H
+
+
+
+#include <utility>
+#include <vector>
+#include "ScoreTraits.h"
+
+
+
+namespace wpm {
+
+
+
+/*! BasicImplicitBipartiteMatchingGraph class, representing the same set of cliques to be matched as a
+ *  BasicBipartiteMatchingGraph, but where every source vertex is implicitly linked to the target vertex of every other
+ *  clique with a default score of zero. Only the pairs of cliques whose score differs from this default (i.e. the
+ *  non-matching constraints) are stored explicitly, so that the memory footprint is O(n+e) instead of O(n^2) for a graph
+ *  with n cliques and e constraints.
+ *  A clique can never be matched with itself, and an explicit score equal to ScoreTraits<Score>::forbidden() means that
+ *  the two cliques cannot be matched. Like the explicit graph, the class is only instantiated for int, long long and
+ *  double scores, and ImplicitBipartiteMatchingGraph is the graph with int scores.
+ */
+template<class Score>
+class BasicImplicitBipartiteMatchingGraph
+{
+private:
+
+	// BasicImplicitBipartiteMatchingGraph data members
+	unsigned int _ncliques;						//!< Number of cliques in the graph.
+	unsigned int _building_cid;					//!< Clique ID of the source vertex whose explicit edges are being set, before the graph is finalized.
+	std::vector<unsigned int> _source_offsets;	//!< Array containing, for each source vertex, the offset of its first explicit edge (compressed row storage).
+	std::vector<unsigned int> _source_targets;	//!< Array containing, for each explicit edge sorted by source vertex, the clique ID of the target vertex.
+	std::vector<Score> _source_scores;			//!< Array containing, for each explicit edge sorted by source vertex, the score of the edge.
+	std::vector<unsigned int> _target_offsets;	//!< Array containing, for each target vertex, the offset of its first explicit edge (compressed column storage).
+	std::vector<unsigned int> _target_sources;	//!< Array containing, for each explicit edge sorted by target vertex, the clique ID of the source vertex.
+	std::vector<Score> _target_scores;			//!< Array containing, for each explicit edge sorted by target vertex, the score of the edge.
+	std::vector< std::pair<unsigned int, unsigned int> > _sorted_row;	//!< Explicit edges of the row being sorted by finalize, as (target clique ID, order in which the edge was set) pairs, kept to reuse its memory.
+	std::vector<Score> _sorted_row_scores;		//!< Scores of the explicit edges of the row being sorted by finalize, kept to reuse its memory.
+
+public:
+
+	//! Default constructor.
+	BasicImplicitBipartiteMatchingGraph();
+	//! Destructor.
+	~BasicImplicitBipartiteMatchingGraph();
+
+	// Graph modification functions
+
+	void startNewGraph(unsigned int ncliques);
+	/*! Function to set the score of the edge from a source vertex to a target vertex. The explicit edges must be set
+	 *  by increasing source clique ID, and the last score set for a given pair of cliques prevails.
+	 */
+	void setDirectedEdgeScore(unsigned int cid_source, unsigned int cid_target, Score score);
+	//! Function to be called once all explicit edges have been set, before using the graph.
+	void finalize();
+
+	// Graph getter functions
+
+	inline unsigned int getNumberCliques() const { return _ncliques; }
+	inline unsigned int getNumberExplicitEdges() const { return _source_targets.size(); }
+	//! Function to return the default score of the edges which are not stored explicitly.
+	static inline Score getDefaultScore() { return 0; }
+	//! Function to return the score of the edge from a source vertex to a target vertex.
+	Score getScore(unsigned int cid_source, unsigned int cid_target) const;
+	//! Function to check whether a source vertex and a target vertex can be matched.
+	bool isEdge(unsigned int cid_source, unsigned int cid_target) const;
+	//! Function to retrieve the explicit edges of a source vertex, sorted by increasing target clique ID.
+	void getSourceExplicitEdges(unsigned int cid_source, const unsigned int* &targets, const Score* &scores, unsigned int &nedges) const;
+	//! Function to retrieve the explicit edges of a target vertex, sorted by increasing source clique ID.
+	void getTargetExplicitEdges(unsigned int cid_target, const unsigned int* &sources, const Score* &scores, unsigned int &nedges) const;
+};
+
+
+
+//! Implicit bipartite matching graph with int scores, used by default.
+typedef BasicImplicitBipartiteMatchingGraph<int> ImplicitBipartiteMatchingGraph;
+
+
+
+}	// namespace wpm
+
+
+
+#endif //IMPLICIT_BIPARTITE_MATCHING_GRAPH_H
@@ -0,0 +1,131 @@
+/* MappedFile.cpp */
+
+
+
+#ifdef _WIN32
+#include <Windows.h>
+#else //_WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif //_WIN32
+#include "MappedFile.h"
+
+
+
+namespace wpm {
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+MappedFile::MappedFile()
+	: _data(NULL)
+	, _size(0)
+	, _is_open(false)
+#ifdef _WIN32
+	, _file_handle(INVALID_HANDLE_VALUE)
+	, _mapping_handle(NULL)
+#else //_WIN32
+	, _fd(-1)
+#endif //_WIN32
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &filepath)
+{
+	close();
+	_file_handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(_file_handle==INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(_file_handle, &file_size)) {
+		close();
+		return false;
+	}
+	_size = (size_t)file_size.QuadPart;
+	_is_open = true;
+	if(_size==0)
+		return true;	// An empty file cannot be mapped, but it is a valid empty buffer
+	_mapping_handle = CreateFileMappingA(_file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(_mapping_handle==NULL) {
+		close();
+		return false;
+	}
+	_data = (const char*)MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if(_data==NULL) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if(_data!=NULL)
+		UnmapViewOfFile(_data);
+	if(_mapping_handle!=NULL)
+		CloseHandle(_mapping_handle);
+	if(_file_handle!=INVALID_HANDLE_VALUE)
+		CloseHandle(_file_handle);
+	_data = NULL;
+	_size = 0;
+	_is_open = false;
+	_mapping_handle = NULL;
+	_file_handle = INVALID_HANDLE_VALUE;
+}
+
+#else //_WIN32
+
+bool MappedFile::open(const std::string &filepath)
+{
+	close();
+	_fd = ::open(filepath.c_str(), O_RDONLY);
+	if(_fd<0)
+		return false;
+	struct stat file_stat;
+	if(fstat(_fd, &file_stat)!=0) {
+		close();
+		return false;
+	}
+	_size = (size_t)file_stat.st_size;
+	_is_open = true;
+	if(_size==0)
+		return true;	// An empty file cannot be mapped, but it is a valid empty buffer
+	void *data = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+	if(data==MAP_FAILED) {
+		close();
+		return false;
+	}
+	madvise(data, _size, MADV_SEQUENTIAL);
+	_data = (const char*)data;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if(_data!=NULL)
+		munmap((void*)_data, _size);
+	if(_fd>=0)
+		::close(_fd);
+	_data = NULL;
+	_size = 0;
+	_is_open = false;
+	_fd = -1;
+}
+
+#endif //_WIN32
+
+
+
+} //namespace wpm
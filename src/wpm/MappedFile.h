@@ -0,0 +1,66 @@
+/* MappedFile.h */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+
+
+#include <cstddef>
+#include <string>
+
+
+
+namespace wpm {
+
+
+
+/*! MappedFile class, mapping a whole file read-only in memory, so that its content can be accessed as a contiguous
+ *  buffer without reading it through a stream. The pages are loaded by the operating system when they are accessed.
+ */
+class MappedFile
+{
+private:
+
+	const char *_data;		//!< Pointer to the first byte of the mapped file, or NULL if no file is mapped (or if the file is empty).
+	size_t _size;			//!< Size of the mapped file in bytes.
+	bool _is_open;			//!< Flag indicating whether a file is currently mapped.
+#ifdef _WIN32
+	void *_file_handle;		//!< Handle of the opened file.
+	void *_mapping_handle;	//!< Handle of the file mapping object.
+#else //_WIN32
+	int _fd;				//!< File descriptor of the opened file.
+#endif //_WIN32
+
+public:
+
+	//! Default constructor.
+	MappedFile();
+	//! Destructor, unmapping the file if it is mapped.
+	~MappedFile();
+
+	//! Function to map the specified file in memory, and return false if it cannot be opened or mapped.
+	bool open(const std::string &filepath);
+	//! Function to unmap the file.
+	void close();
+
+	//! Function to indicate whether a file is currently mapped.
+	inline bool isOpen() const { return _is_open; }
+	//! Function to return the pointer to the first byte of the mapped file.
+	inline const char* getData() const { return _data; }
+	//! Function to return the size of the mapped file in bytes.
+	inline size_t getSize() const { return _size; }
+
+private:
+
+	// A mapped file cannot be copied
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //MAPPED_FILE_H
@@ -5,8 +5,9 @@
 #include <sstream>
 #include "NonMatchingGraph.h"
 #include "BipartiteMatchingGraph.h"
+#include "ImplicitBipartiteMatchingGraph.h"
 #include "MatchingGraphConverter.h"
-#include "WPMASSERT.h"
+#include "WPMAssert.h"
 
 
 
@@ -31,45 +32,76 @@ MatchingGraphConverter::~MatchingGraphConverter()
 namespace impl {
 
 //! Converts the cost of a non-matching edge into the score of a bipartite matching edge.
-inline int convertNMCostToBMScore(unsigned int nmcost)
+template<class Score>
+inline Score convertNMCostToBMScore(unsigned int nmcost)
 {
-	if(nmcost==(unsigned int)(-1))
-		return std::numeric_limits<int>::min();
-	return -(int)nmcost;
+	return ScoreTraits<Score>::fromCost(nmcost);
 }
 
 //! Converts the score of a bipartite matching edge into the cost of a non-matching edge.
-inline unsigned int convertBMScoreToNMCost(int bmscore)
+template<class Score>
+inline unsigned int convertBMScoreToNMCost(Score bmscore)
 {
-	if(bmscore==std::numeric_limits<int>::min())
-		return (unsigned int)(-1);
-	return (unsigned int)(-bmscore);
+	return ScoreTraits<Score>::toCost(bmscore);
 }
 
 }
 
 
 
-void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BipartiteMatchingGraph &bmgraph) const
+template<class Score>
+void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph) const
+{
+	std::vector<Score> candidate_scores;
+	toBipartiteMatchingGraph(nmgraph, bmgraph, candidate_scores);
+}
+
+template<class Score>
+void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph, std::vector<Score> &candidate_scores) const
 {
 	// Initialize the BipartiteMatchingGraph
 	unsigned int ncliques = nmgraph.getNumberVertices();
 	bmgraph.startNewGraph(ncliques);
+	candidate_scores.assign(ncliques, 0);
 	// Loop over each vertex of the NonMatchingGraph and enumerate the matching candidates based on the non-matching constraints
 	std::vector<NonMatchingGraph::Vertex>::const_iterator it_nmv, it_nmv_end;
 	nmgraph.getVertexIterators(it_nmv, it_nmv_end);
 	for(; it_nmv!=it_nmv_end; ++it_nmv) {
 		// Eliminate the matching candidates for which a non-matching constraint exist
-		std::vector<int> score_matching_candidates(ncliques, 0);
-		score_matching_candidates[it_nmv->id] = std::numeric_limits<int>::min();
-		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=it_nmv->constraints.begin(); it_e!=it_nmv->constraints.end(); ++it_e)
-			score_matching_candidates[it_e->v_target->id] = impl::convertNMCostToBMScore(it_e->cost);
+		const std::vector<NonMatchingGraph::Edge> &constraints = it_nmv->getConstraints();
+		candidate_scores[it_nmv->id] = ScoreTraits<Score>::forbidden();
+		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=constraints.begin(); it_e!=constraints.end(); ++it_e) {
+			if(!nmgraph.isConstraintExpired(*it_e))
+				candidate_scores[it_e->v_target->id] = impl::convertNMCostToBMScore<Score>(nmgraph.getConstraintCost(*it_e));
+		}
 		// Add one edge in the BipartiteMatchingGraph for each matching candidate
 		for(unsigned int cid=0; cid<ncliques; ++cid) {
-			if(score_matching_candidates[cid]!=std::numeric_limits<int>::min())
-				bmgraph.addDirectedEdge(it_nmv->id, cid, score_matching_candidates[cid]);
+			if(!ScoreTraits<Score>::isForbidden(candidate_scores[cid]))
+				bmgraph.addDirectedEdge(it_nmv->id, cid, candidate_scores[cid]);
+		}
+		// Reset the scores set for this vertex, which is cheaper than filling the whole buffer again
+		candidate_scores[it_nmv->id] = 0;
+		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=constraints.begin(); it_e!=constraints.end(); ++it_e)
+			candidate_scores[it_e->v_target->id] = 0;
+	}
+	bmgraph.finalize();
+}
+
+template<class Score>
+void MatchingGraphConverter::toImplicitBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph) const
+{
+	// Initialize the ImplicitBipartiteMatchingGraph, in which all pairs of different cliques are matching candidates by default
+	ibmgraph.startNewGraph(nmgraph.getNumberVertices());
+	// Loop over each vertex of the NonMatchingGraph and store its non-matching constraints as explicit edges
+	std::vector<NonMatchingGraph::Vertex>::const_iterator it_nmv, it_nmv_end;
+	nmgraph.getVertexIterators(it_nmv, it_nmv_end);
+	for(; it_nmv!=it_nmv_end; ++it_nmv) {
+		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=it_nmv->getConstraints().begin(); it_e!=it_nmv->getConstraints().end(); ++it_e) {
+			if(it_e->v_target->id!=it_nmv->id && !nmgraph.isConstraintExpired(*it_e))	// A clique can never be matched with itself
+				ibmgraph.setDirectedEdgeScore(it_nmv->id, it_e->v_target->id, impl::convertNMCostToBMScore<Score>(nmgraph.getConstraintCost(*it_e)));
 		}
 	}
+	ibmgraph.finalize();
 }
 
 
@@ -77,24 +109,25 @@ void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nm
 namespace impl {
 
 //! Analyzes the edges incident to the input vertex to infer the corresponding non-matching edges in the NonMatchingGraph.
-void bmVertexEdgesToNMEdges(const BipartiteMatchingGraph::Vertex &v, NonMatchingGraph &nmgraph, bool is_source_vertex)
+template<class Score>
+void bmVertexEdgesToNMEdges(unsigned int cid, const std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &edges, NonMatchingGraph &nmgraph, bool is_source_vertex)
 {
 	// Loop over all the matching edges incident to the current vertex
 	unsigned int nvertices = nmgraph.getNumberVertices();
 	std::vector<unsigned int> costs(nvertices, (unsigned int)(-1));
-	for(std::vector<BipartiteMatchingGraph::Edge*>::const_iterator it_e=v.edges.begin(); it_e!=v.edges.end(); ++it_e) {
+	for(typename std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*>::const_iterator it_e=edges.begin(); it_e!=edges.end(); ++it_e) {
 		unsigned int cid_match = (is_source_vertex ? (*it_e)->v_target->parent->cid : (*it_e)->v_source->parent->cid);
 		costs[cid_match] = impl::convertBMScoreToNMCost((*it_e)->score);
 	}
 	// Add edges towards the vertices associated with a strictly positive cost
 	for(unsigned int id=0; id<nvertices; ++id) {
-		if(id==v.parent->cid || costs[id]==0)	// Checks that the edge is a valid non-matching constraint
+		if(id==cid || costs[id]==0)	// Checks that the edge is a valid non-matching constraint
 			continue;
-		if(id<v.parent->cid)	// Avoids adding the same edge twice
+		if(id<cid)	// Avoids adding the same edge twice
 			continue;
 		if(is_source_vertex)
-			nmgraph.addDirectedEdge(v.parent->cid, id, costs[id]);
-		else nmgraph.addDirectedEdge(id, v.parent->cid, costs[id]);
+			nmgraph.addDirectedEdge(cid, id, costs[id]);
+		else nmgraph.addDirectedEdge(id, cid, costs[id]);
 	}
 }
 
@@ -102,21 +135,31 @@ void bmVertexEdgesToNMEdges(const BipartiteMatchingGraph::Vertex &v, NonMatching
 
 
 
-void MatchingGraphConverter::toNonMatchingGraph(const BipartiteMatchingGraph &bmgraph, NonMatchingGraph &nmgraph) const
+template<class Score>
+void MatchingGraphConverter::toNonMatchingGraph(const BasicBipartiteMatchingGraph<Score> &bmgraph, NonMatchingGraph &nmgraph) const
 {
 	// Initialize the NonMatchingGraph
 	unsigned int nvertices = bmgraph.getNumberCliques();
 	nmgraph.startNewGraph(nvertices);
+	// Group the edges by source and by target vertex in their insertion order, from the edge array rather than from the
+	// vertex edges, which are only built when the graph is finalized
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+	std::vector<std::vector<const Edge*> > source_edges(nvertices), target_edges(nvertices);
+	typename std::vector<Edge>::const_iterator it_e, it_e_end;
+	bmgraph.getEdgeIterators(it_e, it_e_end);
+	for(; it_e!=it_e_end; ++it_e) {
+		source_edges[it_e->v_source->parent->cid].push_back(&(*it_e));
+		target_edges[it_e->v_target->parent->cid].push_back(&(*it_e));
+	}
 	// Loop over each vertex of the BipartiteMatchingGraph and enumerate the non-matching constraints based on the existing matching edges
-	std::vector<BipartiteMatchingGraph::Clique>::const_iterator it_bmc, it_bmc_end;
-	bmgraph.getCliqueIterators(it_bmc, it_bmc_end);
-	for(; it_bmc!=it_bmc_end; ++it_bmc) {
-		impl::bmVertexEdgesToNMEdges(it_bmc->v_source, nmgraph, true);
-		impl::bmVertexEdgesToNMEdges(it_bmc->v_target, nmgraph, false);
+	for(unsigned int cid=0; cid<nvertices; ++cid) {
+		impl::bmVertexEdgesToNMEdges<Score>(cid, source_edges[cid], nmgraph, true);
+		impl::bmVertexEdgesToNMEdges<Score>(cid, target_edges[cid], nmgraph, false);
 	}
 }
 
-void MatchingGraphConverter::toGenericMatching(const std::vector<const BipartiteMatchingGraph::Edge*> &bmg_perfect_matching, std::vector<unsigned int> &generic_perfect_matching) const
+template<class Edge>
+void MatchingGraphConverter::toGenericMatching(const std::vector<const Edge*> &bmg_perfect_matching, std::vector<unsigned int> &generic_perfect_matching) const
 {
 	unsigned int size = bmg_perfect_matching.size();
 	generic_perfect_matching.resize(size);
@@ -142,4 +185,18 @@ void MatchingGraphConverter::toStringMatching(const std::vector<unsigned int> &g
 
 
 
+// Explicit instantiations for the supported score types (see ScoreTraits)
+#define WPM_INSTANTIATE_MATCHING_GRAPH_CONVERTER(Score) \
+	template void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph) const; \
+	template void MatchingGraphConverter::toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph, std::vector<Score> &candidate_scores) const; \
+	template void MatchingGraphConverter::toImplicitBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph) const; \
+	template void MatchingGraphConverter::toNonMatchingGraph(const BasicBipartiteMatchingGraph<Score> &bmgraph, NonMatchingGraph &nmgraph) const; \
+	template void MatchingGraphConverter::toGenericMatching(const std::vector<const BasicBipartiteMatchingGraph<Score>::Edge*> &bmg_matching, std::vector<unsigned int> &generic_matching) const;
+WPM_INSTANTIATE_MATCHING_GRAPH_CONVERTER(int)
+WPM_INSTANTIATE_MATCHING_GRAPH_CONVERTER(long long)
+WPM_INSTANTIATE_MATCHING_GRAPH_CONVERTER(double)
+#undef WPM_INSTANTIATE_MATCHING_GRAPH_CONVERTER
+
+
+
 } //namespace wpm
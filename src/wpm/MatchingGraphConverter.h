@@ -5,17 +5,25 @@
 
 
 
+#include <string>
+#include <vector>
+
+
+
 namespace wpm {
 
 
 
 // Predeclarations
 class NonMatchingGraph;
-class BipartiteMatchingGraph;
+template<class Score> class BasicBipartiteMatchingGraph;
+template<class Score> class BasicImplicitBipartiteMatchingGraph;
 
 
 
-//! MatchingGraphConverter class, in charge of converting between different graph or matching formats.
+/*! MatchingGraphConverter class, in charge of converting between different graph or matching formats. The conversions of
+ *  the bipartite matching graphs are templated on their score type, and instantiated for int, long long and double.
+ */
 class MatchingGraphConverter
 {
 public:
@@ -25,14 +33,24 @@ public:
 	//! Destructor.
 	~MatchingGraphConverter();
 
-	//! Function to convert a NonMatchingGraph into a BipartiteMatchingGraph.
-	void toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BipartiteMatchingGraph &bmgraph) const;
+	//! Function to convert a NonMatchingGraph into a BipartiteMatchingGraph, where each cost c gives the score -c (see ScoreTraits::fromCost).
+	template<class Score>
+	void toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph) const;
+	//! Same conversion, with a buffer for the scores of the matching candidates of a vertex owned by the caller, so that repeated conversions do not allocate.
+	template<class Score>
+	void toBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicBipartiteMatchingGraph<Score> &bmgraph, std::vector<Score> &candidate_scores) const;
+
+	//! Function to convert a NonMatchingGraph into an ImplicitBipartiteMatchingGraph, where only the constraints are stored explicitly.
+	template<class Score>
+	void toImplicitBipartiteMatchingGraph(const NonMatchingGraph &nmgraph, BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph) const;
 
-	//! Function to convert a BipartiteMatchingGraph into a NonMatchingGraph.
-	void toNonMatchingGraph(const BipartiteMatchingGraph &bmgraph, NonMatchingGraph &nmgraph) const;
+	//! Function to convert a BipartiteMatchingGraph into a NonMatchingGraph, whether it is finalized or not.
+	template<class Score>
+	void toNonMatchingGraph(const BasicBipartiteMatchingGraph<Score> &bmgraph, NonMatchingGraph &nmgraph) const;
 
-	//! Function to convert a matching on a BipartiteMatchingGraph into a generic matching.
-	void toGenericMatching(const std::vector<const BipartiteMatchingGraph::Edge*> &bmg_matching, std::vector<unsigned int> &generic_matching) const;
+	//! Function to convert a matching on a BipartiteMatchingGraph (i.e. a vector of pointers to its edges) into a generic matching.
+	template<class Edge>
+	void toGenericMatching(const std::vector<const Edge*> &bmg_matching, std::vector<unsigned int> &generic_matching) const;
 
 	//! Function to convert a generic matching into a string matching.
 	void toStringMatching(const std::vector<unsigned int> &generic_matching, std::string &matching_str) const;
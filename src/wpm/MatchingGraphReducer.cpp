@@ -0,0 +1,300 @@
+/* MatchingGraphReducer.cpp */
+
+
+
+#include <algorithm>
+#include "WPMAssert.h"
+#include "CardinalityMatchingFinder.h"
+#include "MatchingGraphReducer.h"
+
+
+
+namespace wpm {
+
+
+
+GraphReductionStatistics::GraphReductionStatistics()
+	: ncliques(0)
+	, nedges(0)
+	, nforced_matches(0)
+	, ndominated_edges(0)
+	, nreduced_cliques(0)
+	, nreduced_edges(0)
+{
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+template<class Score>
+BasicMatchingGraphReducer<Score>::BasicMatchingGraphReducer()
+	: _bmgraph(NULL)
+{
+}
+
+template<class Score>
+BasicMatchingGraphReducer<Score>::~BasicMatchingGraphReducer()
+{
+}
+
+template<class Score>
+bool BasicMatchingGraphReducer<Score>::reduce(const Graph &bmgraph, Graph &reduced_bmgraph)
+{
+	WPMASSERT(bmgraph.isFinalized(), "The graph must be finalized before being reduced!");
+	if(!bmgraph.isFinalized())
+		return false;
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	const unsigned int nedges = bmgraph.getNumberEdges();
+	_bmgraph = &bmgraph;
+	_forced_edges.clear();
+	_statistics = GraphReductionStatistics();
+	_statistics.ncliques = ncliques;
+	_statistics.nedges = nedges;
+	// Build the adjacency of the target vertices, as indices of the adjacent edges of the source vertices
+	_edge_sources.resize(nedges);
+	_target_offsets.assign(ncliques+1, 0);
+	for(unsigned int cid_source=0; cid_source<ncliques; ++cid_source) {
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(cid_source); index<bmgraph.getSourceAdjacencyEnd(cid_source); ++index) {
+			_edge_sources[index] = cid_source;
+			++_target_offsets[bmgraph.getAdjacentEdge(index).target_cid+1];
+		}
+	}
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		_target_offsets[cid+1] += _target_offsets[cid];
+	_target_adjacency.resize(nedges);
+	_target_degrees.assign(ncliques, 0);
+	for(unsigned int index=0; index<nedges; ++index) {
+		const unsigned int cid_target = bmgraph.getAdjacentEdge(index).target_cid;
+		_target_adjacency[_target_offsets[cid_target]+_target_degrees[cid_target]++] = index;
+	}
+	_source_degrees.resize(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		_source_degrees[cid] = bmgraph.getSourceAdjacencyEnd(cid)-bmgraph.getSourceAdjacencyBegin(cid);
+	_is_removed_edge.assign(nedges, 0);
+	_is_matched_source.assign(ncliques, 0);
+	_is_matched_target.assign(ncliques, 0);
+	// Fix the forced matches, then remove the edges of no perfect matching, which leaves new vertices with a single edge
+	_queue.clear();
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		if(_source_degrees[cid]<=1)
+			_queue.push_back(cid);
+		if(_target_degrees[cid]<=1)
+			_queue.push_back(ncliques+cid);
+	}
+	if(!_propagateForcedMatches())
+		return false;
+	_buildReducedGraph(reduced_bmgraph);
+	if(!_removeDominatedEdges(reduced_bmgraph))
+		return false;
+	if(_statistics.ndominated_edges>0) {
+		if(!_propagateForcedMatches())
+			return false;
+		_buildReducedGraph(reduced_bmgraph);
+	}
+	_statistics.nforced_matches = _forced_edges.size();
+	_statistics.nreduced_cliques = reduced_bmgraph.getNumberCliques();
+	_statistics.nreduced_edges = _edge_indices.size();
+	return true;
+}
+
+template<class Score>
+void BasicMatchingGraphReducer<Score>::toOriginalMatching(const Graph &reduced_bmgraph,
+														  const std::vector<const Edge*> &reduced_matching,
+														  std::vector<const Edge*> &matching) const
+{
+	WPMASSERT(_bmgraph!=NULL, "No graph was reduced!");
+	matching.resize(_bmgraph->getNumberCliques());
+	for(typename std::vector<const Edge*>::const_iterator it_e=_forced_edges.begin(); it_e!=_forced_edges.end(); ++it_e)
+		matching[(*it_e)->v_source->parent->cid] = *it_e;
+	typename std::vector<Edge>::const_iterator it_e_begin, it_e_end;
+	reduced_bmgraph.getEdgeIterators(it_e_begin, it_e_end);
+	for(typename std::vector<const Edge*>::const_iterator it_e=reduced_matching.begin(); it_e!=reduced_matching.end(); ++it_e) {
+		const Edge *edge = _bmgraph->getAdjacentEdgePointer(_edge_indices[*it_e-&*it_e_begin]);
+		matching[edge->v_source->parent->cid] = edge;
+	}
+}
+
+template<class Score>
+void BasicMatchingGraphReducer<Score>::_removeEdge(unsigned int index)
+{
+	const unsigned int ncliques = _bmgraph->getNumberCliques();
+	const unsigned int cid_source = _edge_sources[index];
+	const unsigned int cid_target = _bmgraph->getAdjacentEdge(index).target_cid;
+	_is_removed_edge[index] = 1;
+	if(--_source_degrees[cid_source]<=1 && !_is_matched_source[cid_source])
+		_queue.push_back(cid_source);
+	if(--_target_degrees[cid_target]<=1 && !_is_matched_target[cid_target])
+		_queue.push_back(ncliques+cid_target);
+}
+
+template<class Score>
+bool BasicMatchingGraphReducer<Score>::_propagateForcedMatches()
+{
+	const unsigned int ncliques = _bmgraph->getNumberCliques();
+	while(!_queue.empty()) {
+		const unsigned int vertex = _queue.back();
+		_queue.pop_back();
+		// Find the last edge of the vertex, if it is not matched yet
+		unsigned int forced_index = (unsigned int)(-1);
+		if(vertex<ncliques) {
+			if(_is_matched_source[vertex])
+				continue;
+			for(unsigned int index=_bmgraph->getSourceAdjacencyBegin(vertex); index<_bmgraph->getSourceAdjacencyEnd(vertex) && forced_index==(unsigned int)(-1); ++index) {
+				if(!_is_removed_edge[index])
+					forced_index = index;
+			}
+		}
+		else {
+			if(_is_matched_target[vertex-ncliques])
+				continue;
+			for(unsigned int i=_target_offsets[vertex-ncliques]; i<_target_offsets[vertex-ncliques+1] && forced_index==(unsigned int)(-1); ++i) {
+				if(!_is_removed_edge[_target_adjacency[i]])
+					forced_index = _target_adjacency[i];
+			}
+		}
+		if(forced_index==(unsigned int)(-1))
+			return false;	// The vertex cannot be matched anymore
+		// Fix the match, and remove all the edges of its two vertices
+		const unsigned int cid_source = _edge_sources[forced_index];
+		const unsigned int cid_target = _bmgraph->getAdjacentEdge(forced_index).target_cid;
+		_is_matched_source[cid_source] = 1;
+		_is_matched_target[cid_target] = 1;
+		_forced_edges.push_back(_bmgraph->getAdjacentEdgePointer(forced_index));
+		for(unsigned int index=_bmgraph->getSourceAdjacencyBegin(cid_source); index<_bmgraph->getSourceAdjacencyEnd(cid_source); ++index) {
+			if(!_is_removed_edge[index])
+				_removeEdge(index);
+		}
+		for(unsigned int i=_target_offsets[cid_target]; i<_target_offsets[cid_target+1]; ++i) {
+			if(!_is_removed_edge[_target_adjacency[i]])
+				_removeEdge(_target_adjacency[i]);
+		}
+	}
+	return true;
+}
+
+template<class Score>
+void BasicMatchingGraphReducer<Score>::_buildReducedGraph(Graph &reduced_bmgraph)
+{
+	// Keep the cliques whose two vertices remain, then pair the other remaining source and target vertices in increasing order
+	const unsigned int ncliques = _bmgraph->getNumberCliques();
+	_source_cids.clear();
+	_target_cids.clear();
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		if(!_is_matched_source[cid] && !_is_matched_target[cid]) {
+			_source_cids.push_back(cid);
+			_target_cids.push_back(cid);
+		}
+	}
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		if(!_is_matched_source[cid] && _is_matched_target[cid])
+			_source_cids.push_back(cid);
+	}
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		if(_is_matched_source[cid] && !_is_matched_target[cid])
+			_target_cids.push_back(cid);
+	}
+	WPMASSERT(_source_cids.size()==_target_cids.size(), "The fixed matches do not match as many source and target vertices!");
+	const unsigned int nreduced_cliques = _source_cids.size();
+	_reduced_target_cids.assign(ncliques, (unsigned int)(-1));
+	for(unsigned int reduced_cid=0; reduced_cid<nreduced_cliques; ++reduced_cid)
+		_reduced_target_cids[_target_cids[reduced_cid]] = reduced_cid;
+	// Add the remaining edges directly, since an edge may link the two vertices of a clique of the reduced graph (the edges
+	// are added by source vertex, hence their insertion order is also their order in the compressed sparse row layout)
+	reduced_bmgraph.startNewGraph(nreduced_cliques);
+	_edge_indices.clear();
+	for(unsigned int reduced_cid=0; reduced_cid<nreduced_cliques; ++reduced_cid) {
+		const unsigned int cid_source = _source_cids[reduced_cid];
+		for(unsigned int index=_bmgraph->getSourceAdjacencyBegin(cid_source); index<_bmgraph->getSourceAdjacencyEnd(cid_source); ++index) {
+			if(_is_removed_edge[index])
+				continue;
+			const typename Graph::AdjacentEdge &adjacent_edge = _bmgraph->getAdjacentEdge(index);
+			reduced_bmgraph._addEdge(Edge(&reduced_bmgraph._cliques[reduced_cid].v_source, &reduced_bmgraph._cliques[_reduced_target_cids[adjacent_edge.target_cid]].v_target, adjacent_edge.score));
+			_edge_indices.push_back(index);
+		}
+	}
+	reduced_bmgraph.finalize();
+}
+
+template<class Score>
+bool BasicMatchingGraphReducer<Score>::_removeDominatedEdges(const Graph &reduced_bmgraph)
+{
+	// Find a perfect matching M of the reduced graph
+	const unsigned int nreduced_cliques = reduced_bmgraph.getNumberCliques();
+	CardinalityMatchingFinder cmfinder;
+	if(!cmfinder.findMaximumCardinalityMatching(reduced_bmgraph))
+		return false;
+	const std::vector<unsigned int> &source_matches = cmfinder.getSourceMatches();
+	std::vector<unsigned int> target_matches(nreduced_cliques);
+	for(unsigned int cid=0; cid<nreduced_cliques; ++cid)
+		target_matches[source_matches[cid]] = cid;
+	// Compute the strongly connected components of the directed graph on the source vertices, with an arc from s to M(t)
+	// for each edge (s,t) outside M, with the iterative version of the algorithm of Tarjan
+	std::vector<unsigned int> order(nreduced_cliques, (unsigned int)(-1)), lowlinks(nreduced_cliques), components(nreduced_cliques, (unsigned int)(-1));
+	std::vector<unsigned int> stack, call_stack, cursors(nreduced_cliques);
+	unsigned int norders = 0, ncomponents = 0;
+	for(unsigned int root=0; root<nreduced_cliques; ++root) {
+		if(order[root]!=(unsigned int)(-1))
+			continue;
+		call_stack.push_back(root);
+		order[root] = lowlinks[root] = norders++;
+		cursors[root] = reduced_bmgraph.getSourceAdjacencyBegin(root);
+		stack.push_back(root);
+		while(!call_stack.empty()) {
+			const unsigned int s = call_stack.back();
+			if(cursors[s]<reduced_bmgraph.getSourceAdjacencyEnd(s)) {
+				const unsigned int next_s = target_matches[reduced_bmgraph.getAdjacentEdge(cursors[s]++).target_cid];
+				if(order[next_s]==(unsigned int)(-1)) {
+					order[next_s] = lowlinks[next_s] = norders++;
+					cursors[next_s] = reduced_bmgraph.getSourceAdjacencyBegin(next_s);
+					stack.push_back(next_s);
+					call_stack.push_back(next_s);
+				}
+				else if(components[next_s]==(unsigned int)(-1))
+					lowlinks[s] = std::min(lowlinks[s], order[next_s]);
+				continue;
+			}
+			call_stack.pop_back();
+			if(!call_stack.empty())
+				lowlinks[call_stack.back()] = std::min(lowlinks[call_stack.back()], lowlinks[s]);
+			if(lowlinks[s]==order[s]) {
+				unsigned int component_s;
+				do {
+					component_s = stack.back();
+					stack.pop_back();
+					components[component_s] = ncomponents;
+				} while(component_s!=s);
+				++ncomponents;
+			}
+		}
+	}
+	// An edge outside M belongs to another perfect matching iff it lies on an M-alternating cycle, i.e. iff its source
+	// vertex and the source vertex matched with its target vertex are in the same component
+	for(unsigned int s=0; s<nreduced_cliques; ++s) {
+		for(unsigned int reduced_index=reduced_bmgraph.getSourceAdjacencyBegin(s); reduced_index<reduced_bmgraph.getSourceAdjacencyEnd(s); ++reduced_index) {
+			const unsigned int t = reduced_bmgraph.getAdjacentEdge(reduced_index).target_cid;
+			if(t!=source_matches[s] && components[s]!=components[target_matches[t]]) {
+				_removeEdge(_edge_indices[reduced_index]);
+				++_statistics.ndominated_edges;
+			}
+		}
+	}
+	return true;
+}
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+template class BasicMatchingGraphReducer<int>;
+template class BasicMatchingGraphReducer<long long>;
+template class BasicMatchingGraphReducer<double>;
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+}	// namespace wpm
@@ -0,0 +1,126 @@
+/* MatchingGraphReducer.h */
+
+#ifndef MATCHING_GRAPH_REDUCER_H
+#define MATCHING_GRAPH_REDUCER_H
+
+
+
+#include <vector>
+#include "BipartiteMatchingGraph.h"
+
+
+
+namespace wpm {
+
+
+
+//! Statistics of the reduction of a BipartiteMatchingGraph by a MatchingGraphReducer.
+struct GraphReductionStatistics
+{
+	unsigned int ncliques;				//!< Number of cliques in the input graph.
+	unsigned int nedges;				//!< Number of edges in the input graph.
+	unsigned int nforced_matches;		//!< Number of matches fixed because a vertex had a single edge left.
+	unsigned int ndominated_edges;		//!< Number of edges removed because they belong to no perfect matching.
+	unsigned int nreduced_cliques;		//!< Number of cliques in the reduced graph.
+	unsigned int nreduced_edges;		//!< Number of edges in the reduced graph.
+
+	GraphReductionStatistics();
+};
+
+
+
+/*! BasicMatchingGraphReducer class, in charge of shrinking a BipartiteMatchingGraph before searching for a perfect matching,
+ *  between MatchingGraphConverter::toBipartiteMatchingGraph and PerfectMatchingFinder::findRandomPerfectMatching.
+ *  The reduction repeatedly fixes the forced matches, where a source or target vertex has a single edge left, and removes
+ *  the edges which belong to no perfect matching (found with the Dulmage-Mendelsohn decomposition: an edge outside a
+ *  perfect matching M belongs to another perfect matching iff it lies on an M-alternating cycle). Since the perfect
+ *  matchings of the reduced graph are exactly those of the input graph without the forced matches, the matching found
+ *  in the reduced graph is still selected randomly among those with maximal score.
+ *  The reduced graph only contains the vertices which are not matched yet. The source and target vertices of a clique of
+ *  the input graph are kept together when both remain, and the other remaining source and target vertices are paired
+ *  into new cliques, hence an edge of the reduced graph may link the two vertices of the same clique.
+ *  Like the graphs, the class is templated on the score type, and MatchingGraphReducer reduces the graphs with int scores.
+ */
+template<class Score>
+class BasicMatchingGraphReducer
+{
+public:
+
+	// Convenience typedefs
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+
+private:
+
+	const Graph *_bmgraph;								//!< Input graph of the last reduction.
+	std::vector<const Edge*> _forced_edges;			//!< Edges of the input graph fixed in the matching.
+	std::vector<unsigned int> _source_cids;				//!< Array containing, for each clique of the reduced graph, the clique ID of its source vertex in the input graph.
+	std::vector<unsigned int> _target_cids;				//!< Array containing, for each clique of the reduced graph, the clique ID of its target vertex in the input graph.
+	std::vector<unsigned int> _edge_indices;			//!< Array containing, for each edge of the reduced graph in insertion order, the index of the adjacent edge in the input graph.
+	GraphReductionStatistics _statistics;				//!< Statistics of the last reduction.
+	// Workspace of the reduction, on the compressed sparse row layout of the input graph
+	std::vector<unsigned int> _edge_sources;			//!< Array containing, for each adjacent edge of the input graph, the clique ID of its source vertex.
+	std::vector<unsigned int> _target_offsets;			//!< Array containing, for each target vertex, the index of its first edge in _target_adjacency.
+	std::vector<unsigned int> _target_adjacency;		//!< Indices of the adjacent edges of all the target vertices, grouped by target vertex.
+	std::vector<unsigned char> _is_removed_edge;		//!< Array containing, for each adjacent edge of the input graph, a flag indicating whether it was removed.
+	std::vector<unsigned int> _source_degrees;			//!< Array containing, for each source vertex, its number of edges left.
+	std::vector<unsigned int> _target_degrees;			//!< Array containing, for each target vertex, its number of edges left.
+	std::vector<unsigned char> _is_matched_source;		//!< Array containing, for each source vertex, a flag indicating whether its match is fixed.
+	std::vector<unsigned char> _is_matched_target;		//!< Array containing, for each target vertex, a flag indicating whether its match is fixed.
+	std::vector<unsigned int> _queue;					//!< Vertices which may have a single edge left (the target vertices are shifted by the number of cliques).
+	std::vector<unsigned int> _reduced_target_cids;		//!< Array containing, for each target vertex of the input graph, the clique ID of its target vertex in the reduced graph (-1 if it is matched).
+
+public:
+
+	//! Default constructor.
+	BasicMatchingGraphReducer();
+	//! Destructor.
+	~BasicMatchingGraphReducer();
+
+	/*! Function to reduce the specified finalized graph into a finalized graph, which must remain alive as long as the
+	 *  reduction is used. Returns false if the graph is not finalized, or is found to have no perfect matching.
+	 */
+	bool reduce(const Graph &bmgraph, Graph &reduced_bmgraph);
+
+	/*! Function to convert a perfect matching of the reduced graph into a perfect matching of the input graph, made of the
+	 *  forced matches and of the edges corresponding to the matched edges of the reduced graph, ordered by source clique ID.
+	 */
+	void toOriginalMatching(const Graph &reduced_bmgraph,
+							const std::vector<const Edge*> &reduced_matching,
+							std::vector<const Edge*> &matching) const;
+
+	//! Function to return the statistics of the last reduction.
+	inline const GraphReductionStatistics& getStatistics() const { return _statistics; }
+	//! Function to indicate whether the last reduction removed any clique or edge from the input graph.
+	inline bool isReduced() const { return (_statistics.nforced_matches>0 || _statistics.ndominated_edges>0); }
+	//! Function to return the edges of the input graph fixed in the matching by the last reduction.
+	inline const std::vector<const Edge*>& getForcedEdges() const { return _forced_edges; }
+	//! Function to return, for each clique of the reduced graph, the clique ID of its source vertex in the input graph.
+	inline const std::vector<unsigned int>& getSourceCliqueIDs() const { return _source_cids; }
+	//! Function to return, for each clique of the reduced graph, the clique ID of its target vertex in the input graph.
+	inline const std::vector<unsigned int>& getTargetCliqueIDs() const { return _target_cids; }
+
+private:
+
+	//! Function to remove the specified adjacent edge, and queue its vertices if they have a single edge left.
+	void _removeEdge(unsigned int index);
+	//! Function to fix the matches of the queued vertices with a single edge left until none remains, and return false if a vertex has no edge left.
+	bool _propagateForcedMatches();
+	//! Function to build the graph of the vertices which are not matched yet, with the edges which are not removed.
+	void _buildReducedGraph(Graph &reduced_bmgraph);
+	//! Function to remove the edges of the reduced graph which belong to no perfect matching, and return false if it has no perfect matching.
+	bool _removeDominatedEdges(const Graph &reduced_bmgraph);
+};
+
+
+
+//! Reducer of the bipartite matching graphs with int scores, used by default.
+typedef BasicMatchingGraphReducer<int> MatchingGraphReducer;
+
+
+
+}	// namespace wpm
+
+
+
+#endif //MATCHING_GRAPH_REDUCER_H
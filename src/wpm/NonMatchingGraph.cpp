@@ -2,8 +2,13 @@
 
 
 
+#include <algorithm>
 #include <fstream>
-#include "WPMASSERT.h"
+#include "WPMAssert.h"
+#include "BinaryFormat.h"
+#include "MappedFile.h"
+#include "TextParser.h"
+#include "NonMatchingGraphDelta.h"
 #include "NonMatchingGraph.h"
 
 
@@ -20,23 +25,29 @@ NonMatchingGraph:: Edge::Edge()
 	: v_source(NULL)
 	, v_target(NULL)
 	, cost (0)
+	, epoch(0)
 {
 }
 
-NonMatchingGraph::Edge::Edge(Vertex* v_source, Vertex* v_target, unsigned int cost)
+NonMatchingGraph::Edge::Edge(Vertex* v_source, Vertex* v_target, unsigned int cost, unsigned int epoch)
 	: v_source(v_source)
 	, v_target(v_target)
 	, cost(cost)
+	, epoch(epoch)
 {
 }
 
 NonMatchingGraph::Vertex::Vertex()
 	: id(-1)
+	, nindexed_constraints(0)
+	, ncompacted_constraints(0)
 {
 }
 
 NonMatchingGraph::Vertex::Vertex(unsigned int id)
 	: id(id)
+	, nindexed_constraints(0)
+	, ncompacted_constraints(0)
 {
 }
 
@@ -45,11 +56,12 @@ void NonMatchingGraph::Vertex::addNonMatchingConstraint(Edge& e)
 	constraints.push_back(e);
 }
 
-bool NonMatchingGraph::Vertex::serialize(std::ostream &os) const
+bool NonMatchingGraph::Vertex::serialize(std::ostream &os, const NonMatchingGraph &nmgraph) const
 {
 	os << "v " << id;
 	for(std::vector<Edge>::const_iterator it_e=constraints.begin(); it_e!=constraints.end(); ++it_e) {
-		os << " " << it_e->v_target->id << "(" << it_e->cost << ")";
+		if(!nmgraph.isConstraintExpired(*it_e))
+			os << " " << it_e->v_target->id << "(" << nmgraph.getConstraintCost(*it_e) << ")";
 	}
 	os << "\n";
 	return true;
@@ -92,19 +104,72 @@ bool NonMatchingGraph::Vertex::deserialize(std::istream &is, std::vector<Vertex>
 	return true;
 }
 
+bool NonMatchingGraph::Vertex::deserialize(const char *&ptr, const char *end, std::vector<Vertex> &vertices, std::vector<Edge> &tmp_constraints)
+{
+	// First read the vertex ID
+	unsigned int id;
+	if(!impl::parseChar(ptr, end, 'v') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, id)) return false;
+	if(id>=vertices.size()) return false;
+	// Then read the constraints into the buffer shared by all the vertices, which avoids growing the constraints of the vertex
+	Vertex &v = vertices[id];
+	tmp_constraints.clear();
+	while(true) {
+		// Check the next character to see if there are more constraints
+		if(ptr==end) return false;
+		if(*ptr!=' ') {
+			if(!impl::parseEndOfLine(ptr, end)) return false;
+			break;
+		}
+		// Read the constraint properties
+		unsigned int id_target, cost;
+		++ptr;
+		if(!impl::parseUnsignedInt(ptr, end, id_target)) return false;
+		if(id_target>=vertices.size()) return false;
+		if(!impl::parseChar(ptr, end, '(')) return false;
+		if(!impl::parseUnsignedInt(ptr, end, cost)) return false;
+		if(!impl::parseChar(ptr, end, ')')) return false;
+		tmp_constraints.push_back(Edge(&v, &vertices[id_target], cost));
+	}
+	v.constraints.assign(tmp_constraints.begin(), tmp_constraints.end());
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 NonMatchingGraph::NonMatchingGraph()
+	: _epoch(0)
+	, _has_duplicate_constraints(false)
 {
 }
 
+NonMatchingGraph::NonMatchingGraph(const NonMatchingGraph &nmgraph)
+	: _vertices(nmgraph._vertices)
+	, _epoch(nmgraph._epoch)
+	, _has_duplicate_constraints(nmgraph._has_duplicate_constraints)
+{
+	_rebindEdges();
+}
+
 NonMatchingGraph::~NonMatchingGraph()
 {
 }
 
+NonMatchingGraph& NonMatchingGraph::operator=(const NonMatchingGraph &nmgraph)
+{
+	if(this==&nmgraph)
+		return *this;
+	// The vertices are copied with the index of the positions of their constraints, and their counts of indexed and compacted constraints
+	_vertices = nmgraph._vertices;
+	_epoch = nmgraph._epoch;
+	_has_duplicate_constraints = nmgraph._has_duplicate_constraints;
+	_rebindEdges();
+	return *this;
+}
+
 bool NonMatchingGraph::save(const std::string &filepath) const
 {
-	std::ofstream os(filepath, std::ios::out+std::ios::trunc);
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc|std::ios::binary);
 	if(!os.is_open()) return false;
 	if(!serialize(os)) return false;
 	os.close();
@@ -115,7 +180,7 @@ bool NonMatchingGraph::serialize(std::ostream &os) const
 {
 	os << "nv " << _vertices.size() << "\n";
 	for(std::vector<Vertex>::const_iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
-		if(!it_v->serialize(os))
+		if(!it_v->serialize(os, *this))
 			return false;
 	}
 	return true;
@@ -123,11 +188,10 @@ bool NonMatchingGraph::serialize(std::ostream &os) const
 
 bool NonMatchingGraph::load(const std::string &filepath)
 {
-	std::ifstream is(filepath, std::ios::in);
-	if(!is.is_open()) return false;
-	if(!deserialize(is)) return false;
-	is.close();
-	return true;
+	// The file is mapped in memory and parsed as a single buffer
+	MappedFile file;
+	if(!file.open(filepath)) return false;
+	return deserialize(file.getData(), file.getSize());
 }
 
 bool NonMatchingGraph::deserialize(std::istream &is)
@@ -154,10 +218,135 @@ bool NonMatchingGraph::deserialize(std::istream &is)
 	return true;
 }
 
+bool NonMatchingGraph::saveBinary(const std::string &filepath) const
+{
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc|std::ios::binary);
+	if(!os.is_open()) return false;
+	if(!serializeBinary(os)) return false;
+	os.close();
+	return true;
+}
+
+bool NonMatchingGraph::serializeBinary(std::ostream &os) const
+{
+	// The binary layout is the header, followed by the offsets of the constraints of each vertex (nvertices+1 values),
+	// the target vertex IDs of all the constraints, and the costs of all the constraints, written in chunks
+	const unsigned int nvertices = _vertices.size();
+	unsigned int nconstraints = 0;
+	for(std::vector<Vertex>::const_iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
+		for(std::vector<Edge>::const_iterator it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e)
+			nconstraints += (isConstraintExpired(*it_e) ? 0 : 1);
+	}
+	std::vector<char> buffer;
+	buffer.reserve(impl::BINARY_CHUNK_SIZE+impl::BINARY_HEADER_SIZE);
+	impl::appendBinaryHeader(buffer, impl::NON_MATCHING_GRAPH_BINARY_MAGIC, nvertices, nconstraints);
+	unsigned int offset = 0;
+	impl::appendUInt32LE(buffer, offset);
+	for(std::vector<Vertex>::const_iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
+		for(std::vector<Edge>::const_iterator it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e)
+			offset += (isConstraintExpired(*it_e) ? 0 : 1);
+		impl::appendUInt32LE(buffer, offset);
+		if(!impl::writeBinaryChunk(os, buffer)) return false;
+	}
+	for(std::vector<Vertex>::const_iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
+		for(std::vector<Edge>::const_iterator it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e) {
+			if(isConstraintExpired(*it_e))
+				continue;
+			impl::appendUInt32LE(buffer, it_e->v_target->id);
+			if(!impl::writeBinaryChunk(os, buffer)) return false;
+		}
+	}
+	for(std::vector<Vertex>::const_iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
+		for(std::vector<Edge>::const_iterator it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e) {
+			if(isConstraintExpired(*it_e))
+				continue;
+			impl::appendUInt32LE(buffer, getConstraintCost(*it_e));
+			if(!impl::writeBinaryChunk(os, buffer)) return false;
+		}
+	}
+	return impl::writeBinaryChunk(os, buffer, true);
+}
+
+bool NonMatchingGraph::loadBinary(const std::string &filepath)
+{
+	// The file is mapped in memory and decoded in place, without being read through a stream
+	MappedFile file;
+	if(!file.open(filepath)) return false;
+	return deserializeBinary(file.getData(), file.getSize());
+}
+
+bool NonMatchingGraph::deserializeBinary(const char *data, size_t size)
+{
+	// Read the header, and check that the size of the buffer matches the counts before allocating anything
+	unsigned int nvertices, nconstraints;
+	if(!impl::readBinaryHeader(data, size, impl::NON_MATCHING_GRAPH_BINARY_MAGIC, nvertices, nconstraints))
+		return false;
+	if((unsigned long long)size!=impl::BINARY_HEADER_SIZE+4ULL*(nvertices+1ULL)+8ULL*nconstraints)
+		return false;
+	const char *offsets = data+impl::BINARY_HEADER_SIZE;
+	const char *targets = offsets+4*((size_t)nvertices+1);
+	const char *costs = targets+4*(size_t)nconstraints;
+	if(impl::readUInt32LE(offsets)!=0 || impl::readUInt32LE(offsets+4*(size_t)nvertices)!=nconstraints)
+		return false;
+	// Start a new graph with the specified number of vertices, and create the constraints of each vertex at once
+	startNewGraph(nvertices);
+	for(unsigned int id=0; id<nvertices; ++id) {
+		const unsigned int begin = impl::readUInt32LE(offsets+4*(size_t)id);
+		const unsigned int end = impl::readUInt32LE(offsets+4*((size_t)id+1));
+		if(end<begin || end>nconstraints) {
+			startNewGraph(0);
+			return false;
+		}
+		Vertex &v = _vertices[id];
+		v.constraints.reserve(end-begin);
+		for(unsigned int i=begin; i<end; ++i) {
+			const unsigned int id_target = impl::readUInt32LE(targets+4*(size_t)i);
+			if(id_target>=nvertices) {
+				startNewGraph(0);
+				return false;
+			}
+			v.constraints.push_back(Edge(&v, &_vertices[id_target], impl::readUInt32LE(costs+4*(size_t)i)));
+		}
+	}
+	if(!_checkGraphValidity()) {
+		startNewGraph(0);
+		return false;
+	}
+	return true;
+}
+
+bool NonMatchingGraph::deserialize(const char *data, size_t size)
+{
+	const char *ptr = data;
+	const char *end = data+size;
+	// First read the number of vertices
+	unsigned int nvertices;
+	if(!impl::parseChar(ptr, end, 'n') || !impl::parseChar(ptr, end, 'v') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, nvertices)) return false;
+	if(!impl::parseEndOfLine(ptr, end)) return false;
+	// Start a new graph with the specified number of vertices
+	startNewGraph(nvertices);
+	// Then deserialize each vertex
+	std::vector<Edge> tmp_constraints;
+	for(unsigned int n=0; n<nvertices; ++n) {
+		if(!Vertex::deserialize(ptr, end, _vertices, tmp_constraints)) {
+			startNewGraph(0);
+			return false;
+		}
+	}
+	if(!_checkGraphValidity()) {
+		startNewGraph(0);
+		return false;
+	}
+	return true;
+}
+
 void NonMatchingGraph::startNewGraph(unsigned int nvertices)
 {
 	// Clear the graph
 	_vertices.clear();
+	_epoch = 0;
+	_has_duplicate_constraints = false;
 	// Start a new graph
 	_vertices.reserve(nvertices);
 	for(unsigned int id=0; id<nvertices; ++id)
@@ -174,55 +363,96 @@ void NonMatchingGraph::addUndirectedEdge(unsigned int id1, unsigned int id2, uns
 void NonMatchingGraph::addDirectedEdge(unsigned int id_source, unsigned int id_target, unsigned int cost)
 {
 	WPMASSERT(id_source<_vertices.size() && id_target<_vertices.size(), "Input ID does not exist!");
-	Edge e(&_vertices[id_source], &_vertices[id_target], cost);
+	Edge e(&_vertices[id_source], &_vertices[id_target], cost, _epoch);
 	_vertices[id_source].addNonMatchingConstraint(e);
 }
 
-void NonMatchingGraph::updateConstraints(const std::vector<unsigned int> &matching, bool avoid_deterministic_matching)
+void NonMatchingGraph::reserveConstraints(unsigned int id, unsigned int nconstraints)
+{
+	WPMASSERT(id<_vertices.size(), "Input ID does not exist!");
+	_vertices[id].constraints.reserve(nconstraints);
+}
+
+namespace impl {
+
+//! Function to compare an entry of the index of the positions of the constraints of a vertex with a target vertex ID.
+inline bool isBeforeTarget(const std::pair<unsigned int, unsigned int> &constraint_position, unsigned int id_target)
+{
+	return (constraint_position.first<id_target);
+}
+
+//! Function to indicate whether two entries of the index of the positions of the constraints of a vertex have the same target vertex.
+inline bool haveSameTarget(const std::pair<unsigned int, unsigned int> &constraint_position1, const std::pair<unsigned int, unsigned int> &constraint_position2)
+{
+	return (constraint_position1.first==constraint_position2.first);
+}
+
+}
+
+void NonMatchingGraph::updateConstraints(const std::vector<unsigned int> &matching, bool avoid_deterministic_matching, NonMatchingGraphDelta *delta)
 {
 	unsigned int nvertices = _vertices.size();
 	WPMASSERT(nvertices==matching.size(), "The input matching is incompatible with this graph!")
-	// First decrement the cost for each edge with finite cost
+	WPMASSERT(delta==NULL || delta->getNumberVertices()==nvertices, "The delta is incompatible with this graph!")
+	// First decrement the cost for each edge with finite cost, all at once by aging the edges, where the edges whose cost
+	// would be decremented to 0 do not represent a non-matching constraint anymore, hence they expire
+	++_epoch;
+	if(delta!=NULL)
+		delta->addUpdate();
 	unsigned int high_cost = nvertices;
 	for(std::vector<Vertex>::iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
-		// Loop over each edge incident to the current vertex and decrement the cost
-		std::vector<Edge>::iterator it_e = it_v->constraints.begin();
-		while(it_e!=it_v->constraints.end()) {
-			if(it_e->cost<=1) {
-				// This cost would be decremented to 0, hence it would not represent a non-matching constraint anymore, so remove it
-				it_e = it_v->constraints.erase(it_e);
-				continue;
-			}
-			if(it_e->cost!=(unsigned int)(-1))
-				--it_e->cost;
-			++it_e;
-		}
 		// The current vertex has been matched, hence add a new non-matching constraint with a high cost,
 		// in order to avoid matching these two vertices in the near future.
-		unsigned int matched_id = matching[it_v->id];
-		for(it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e) {
-			if(it_e->v_target->id==matched_id)
-				break;
-		}
-		if(it_e!=it_v->constraints.end()) {
-			WPMASSERT(it_e->cost!=(unsigned int)(-1),"The current vertex was matched with a vertex for which the cost was infinte!")
-			it_e->cost = high_cost;
-		}
-		else addDirectedEdge(it_v->id, matched_id, high_cost);
+		_setConstraintCost(*it_v, matching[it_v->id], high_cost);
+		if(delta!=NULL)
+			delta->addSetConstraint(it_v->id, matching[it_v->id], high_cost);
 		// If the number of cost edges becomes equal to nvertices-1, which means that the next matching is (almost) garanteed to select
 		// the remaining one, erase all edges with cost below high_cost*2/3, to introduce some non-determinism for the next matching
-		if(avoid_deterministic_matching && it_v->constraints.size()==nvertices-1) {
-			unsigned int cost_threshold = (high_cost*2)/3;
-			it_e = it_v->constraints.begin();
-			while(it_e!=it_v->constraints.end()) {
-				if(it_e->cost<=cost_threshold) {
-					it_e = it_v->constraints.erase(it_e);
-					continue;
-				}
-				++it_e;
+		if(avoid_deterministic_matching && it_v->constraints.size()>=nvertices-1) {
+			_compactConstraints(*it_v, false, 0);	// The number of edges must not count the expired ones
+			if(it_v->constraints.size()==nvertices-1) {
+				_compactConstraints(*it_v, true, (high_cost*2)/3);
+				if(delta!=NULL)
+					delta->addPruneConstraints(it_v->id, (high_cost*2)/3);
 			}
 		}
+		else if(it_v->constraints.size()>=2*it_v->ncompacted_constraints+8)
+			_compactConstraints(*it_v, false, 0);	// Remove the expired edges once the vertex has doubled in size since the last removal
+	}
+}
+
+bool NonMatchingGraph::applyDelta(const NonMatchingGraphDelta &delta)
+{
+	// Check the whole delta first, so that the graph is left untouched if it does not apply
+	const unsigned int nvertices = _vertices.size();
+	if(delta.getNumberVertices()!=nvertices)
+		return false;
+	const std::vector<NonMatchingGraphDelta::Operation> &operations = delta.getOperations();
+	for(std::vector<NonMatchingGraphDelta::Operation>::const_iterator it_op=operations.begin(); it_op!=operations.end(); ++it_op) {
+		if(it_op->type!=NonMatchingGraphDelta::OpType_Update && it_op->id_source>=nvertices)
+			return false;
+		if(it_op->type==NonMatchingGraphDelta::OpType_SetConstraint && it_op->id_target>=nvertices)
+			return false;
+	}
+	// Then replay the operations, in the same way than updateConstraints
+	for(std::vector<NonMatchingGraphDelta::Operation>::const_iterator it_op=operations.begin(); it_op!=operations.end(); ++it_op) {
+		switch(it_op->type) {
+		case NonMatchingGraphDelta::OpType_Update:
+			++_epoch;
+			break;
+		case NonMatchingGraphDelta::OpType_SetConstraint: {
+			Vertex &v = _vertices[it_op->id_source];
+			_setConstraintCost(v, it_op->id_target, it_op->cost);
+			if(v.constraints.size()>=2*v.ncompacted_constraints+8)
+				_compactConstraints(v, false, 0);
+			break;
+		}
+		case NonMatchingGraphDelta::OpType_PruneConstraints:
+			_compactConstraints(_vertices[it_op->id_source], true, it_op->cost);
+			break;
+		}
 	}
+	return true;
 }
 
 void NonMatchingGraph::getVertexIterators(std::vector<Vertex>::const_iterator &ibegin, std::vector<Vertex>::const_iterator &iend) const
@@ -237,6 +467,86 @@ void NonMatchingGraph::getVertexIterators(std::vector<Vertex>::iterator &ibegin,
 	iend = _vertices.end();
 }
 
+void NonMatchingGraph::_setConstraintCost(Vertex &v, unsigned int id_target, unsigned int cost)
+{
+	_indexNewConstraints(v);
+	std::vector< std::pair<unsigned int, unsigned int> >::iterator it_pos = std::lower_bound(v.constraint_positions.begin(), v.constraint_positions.end(), id_target, impl::isBeforeTarget);
+	bool is_indexed = (it_pos!=v.constraint_positions.end() && it_pos->first==id_target);
+	if(is_indexed && _has_duplicate_constraints && isConstraintExpired(v.constraints[it_pos->second])) {
+		// Another edge towards the target vertex may still exist after the indexed one
+		_compactConstraints(v, false, 0);
+		it_pos = std::lower_bound(v.constraint_positions.begin(), v.constraint_positions.end(), id_target, impl::isBeforeTarget);
+		is_indexed = (it_pos!=v.constraint_positions.end() && it_pos->first==id_target);
+	}
+	if(is_indexed && !isConstraintExpired(v.constraints[it_pos->second])) {
+		Edge &e = v.constraints[it_pos->second];
+		WPMASSERT(e.cost!=(unsigned int)(-1),"The current vertex was matched with a vertex for which the cost was infinte!")
+		e.cost = cost;
+		e.epoch = _epoch;
+	}
+	else {
+		// The expired edge, if any, stays in place until the next compaction, and the new one is indexed instead
+		addDirectedEdge(v.id, id_target, cost);
+		if(is_indexed)
+			it_pos->second = v.nindexed_constraints++;
+		else
+			v.constraint_positions.insert(it_pos, std::make_pair(id_target, v.nindexed_constraints++));
+	}
+}
+
+void NonMatchingGraph::_indexNewConstraints(Vertex &v)
+{
+	// A single new constraint is inserted at its place, while several ones are appended and sorted with the indexed ones, where
+	// the first constraint towards each target vertex is kept since the entries with the same target are sorted by position
+	const unsigned int nconstraints = v.constraints.size();
+	if(nconstraints==v.nindexed_constraints+1) {
+		const unsigned int id_target = v.constraints.back().v_target->id;
+		std::vector< std::pair<unsigned int, unsigned int> >::iterator it_pos = std::lower_bound(v.constraint_positions.begin(), v.constraint_positions.end(), id_target, impl::isBeforeTarget);
+		if(it_pos!=v.constraint_positions.end() && it_pos->first==id_target)
+			_has_duplicate_constraints = true;
+		else
+			v.constraint_positions.insert(it_pos, std::make_pair(id_target, v.nindexed_constraints));
+	}
+	else if(nconstraints>v.nindexed_constraints) {
+		for(unsigned int pos=v.nindexed_constraints; pos<nconstraints; ++pos)
+			v.constraint_positions.push_back(std::make_pair(v.constraints[pos].v_target->id, pos));
+		std::sort(v.constraint_positions.begin(), v.constraint_positions.end());
+		std::vector< std::pair<unsigned int, unsigned int> >::iterator it_end = std::unique(v.constraint_positions.begin(), v.constraint_positions.end(), impl::haveSameTarget);
+		if(it_end!=v.constraint_positions.end()) {
+			_has_duplicate_constraints = true;
+			v.constraint_positions.erase(it_end, v.constraint_positions.end());
+		}
+	}
+	v.nindexed_constraints = nconstraints;
+}
+
+void NonMatchingGraph::_compactConstraints(Vertex &v, bool remove_low_costs, unsigned int cost_threshold)
+{
+	// Clear the index, compact the remaining edges in place without changing their order, and index them again
+	v.constraint_positions.clear();
+	unsigned int nconstraints = 0;
+	for(std::vector<Edge>::const_iterator it_e=v.constraints.begin(); it_e!=v.constraints.end(); ++it_e) {
+		if(isConstraintExpired(*it_e) || (remove_low_costs && getConstraintCost(*it_e)<=cost_threshold))
+			continue;
+		v.constraints[nconstraints++] = *it_e;
+	}
+	v.constraints.resize(nconstraints);
+	v.nindexed_constraints = 0;
+	_indexNewConstraints(v);
+	v.ncompacted_constraints = nconstraints;
+}
+
+void NonMatchingGraph::_rebindEdges()
+{
+	// The copied edges still point to the vertices of the original graph, which are stored at the same positions
+	for(std::vector<Vertex>::iterator it_v=_vertices.begin(); it_v!=_vertices.end(); ++it_v) {
+		for(std::vector<Edge>::iterator it_e=it_v->constraints.begin(); it_e!=it_v->constraints.end(); ++it_e) {
+			it_e->v_source = &(*it_v);
+			it_e->v_target = &_vertices[it_e->v_target->id];
+		}
+	}
+}
+
 bool NonMatchingGraph::_checkGraphValidity() const
 {
 	// Check the existance and unicity of each vertex indice between 0 and _vertices.size()-1
@@ -6,6 +6,7 @@
 
 
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -14,8 +15,21 @@ namespace wpm {
 
 
 
+// Predeclarations
+class NonMatchingGraphDelta;
+
+
+
 /*! NonMatchingGraph class, representing a graph of vertices to be matched, where edges represent non-matching constraints from a
  *  vertex to another one.
+ *  The costs of the constraints decrease by one at each update of the constraints. Instead of decrementing every cost, the graph
+ *  counts its updates in an epoch, and each constraint keeps the cost and the epoch at which it was set, so that its current
+ *  cost is computed on read (see getConstraintCost). The constraints whose cost reached zero are expired: they are ignored by
+ *  the serialization and the conversions, and removed lazily from the vertices.
+ *  The constraint of each matched pair is found by updateConstraints through an index of the positions of the constraints
+ *  of each vertex, sorted by target vertex, which costs 8 bytes per constraint in addition to the 24 bytes of its Edge,
+ *  and whose memory is reused by the successive updates. The constraints of a vertex are indexed lazily, when the cost
+ *  of one of them is first set by an update.
  */
 class NonMatchingGraph
 {
@@ -26,15 +40,18 @@ public:
 	// Predeclarations
 	struct Vertex;
 
-	//! Edge structure, representing a non-matching constraint from one vertices to another.
+	/*! Edge structure, representing a non-matching constraint from one vertices to another. Its cost is only meaningful at the
+	 *  epoch at which it was set, hence it should be read with NonMatchingGraph::getConstraintCost and isConstraintExpired.
+	 */
 	struct Edge
 	{
 		Vertex* v_source;		//!< Pointer to the source vertex.
 		Vertex* v_target;		//!< Pointer to the potentially matched vertex.
-		unsigned int cost;		//!< Integer representing the cost of matching these two vertices (-1 means these vertices cannot be matched).
+		unsigned int cost;		//!< Deprecated: integer representing the cost of matching these two vertices at the epoch of the edge (-1 means these vertices cannot be matched), use NonMatchingGraph::getConstraintCost to read the current cost.
+		unsigned int epoch;		//!< Deprecated: epoch of the graph at which the cost was set, use NonMatchingGraph::isConstraintExpired to check whether the constraint still exists.
 
 		Edge();
-		Edge(Vertex* v_source, Vertex* v_target, unsigned int cost);
+		Edge(Vertex* v_source, Vertex* v_target, unsigned int cost, unsigned int epoch=0);
 	};
 
 	//! Vertex structure, representing something to be matched and its non-matching constraints.
@@ -43,29 +60,43 @@ public:
 		friend class NonMatchingGraph;
 
 		unsigned int id;				//!< Unique positive integer assigned to the vertex.
-		std::vector<Edge> constraints;	//!< Set of non-matching constraints for this vertex.
+		std::vector<Edge> constraints;	//!< Deprecated: set of non-matching constraints for this vertex, possibly including expired ones, use getConstraints to read it and the functions of the graph to modify it.
 
 		Vertex();
 		Vertex(unsigned int id);
 
+		//! Function to add a non-matching constraint, whose epoch must be the current epoch of the graph (see NonMatchingGraph::getEpoch).
 		void addNonMatchingConstraint(Edge& e);
+		//! Function to return the non-matching constraints of this vertex, possibly including expired ones, which must be skipped with NonMatchingGraph::isConstraintExpired.
+		inline const std::vector<Edge>& getConstraints() const { return constraints; }
 
 	private:
-		bool serialize(std::ostream &os) const;
+		std::vector< std::pair<unsigned int, unsigned int> > constraint_positions;	//!< Target vertex ID and position of the first indexed constraint towards each target vertex, sorted by target vertex ID.
+		unsigned int nindexed_constraints;		//!< Number of constraints whose position is indexed.
+		unsigned int ncompacted_constraints;	//!< Number of constraints after the last removal of the expired ones.
+
+		bool serialize(std::ostream &os, const NonMatchingGraph &nmgraph) const;
 		static bool deserialize(std::istream &is, std::vector<Vertex> &vertices);
+		static bool deserialize(const char *&ptr, const char *end, std::vector<Vertex> &vertices, std::vector<Edge> &tmp_constraints);
 	};
 
 private:
 
 	// NonMatchingGraph data members
 	std::vector<Vertex> _vertices;	//!< Set of vertices.
+	unsigned int _epoch;			//!< Number of updates of the constraints since the graph was started, by which the costs of the constraints are decreased.
+	bool _has_duplicate_constraints;	//!< Flag indicating whether some indexed constraints link the same pair of vertices.
 
 public:
 
 	//! Default constructor.
 	NonMatchingGraph();
+	//! Copy constructor, copying the vertices, the epoch and the index of the constraints, whose edges point to the vertices of the copy.
+	NonMatchingGraph(const NonMatchingGraph &nmgraph);
 	//! Destructor.
 	~NonMatchingGraph();
+	//! Assignment operator, copying the vertices, the epoch and the index of the constraints, whose edges point to the vertices of this graph.
+	NonMatchingGraph& operator=(const NonMatchingGraph &nmgraph);
 
 	// Graph I/O functions
 
@@ -73,22 +104,56 @@ public:
 	bool serialize(std::ostream &os) const;
 	bool load(const std::string &filepath);
 	bool deserialize(std::istream &is);
+	//! Function to deserialize the graph from a text buffer, with the same format and validation than deserialize(std::istream&) but much faster, where the lines may end with "\r\n".
+	bool deserialize(const char *data, size_t size);
+
+	// Binary graph I/O functions (versioned little-endian format, see BinaryFormat.h)
+
+	bool saveBinary(const std::string &filepath) const;
+	bool serializeBinary(std::ostream &os) const;
+	bool loadBinary(const std::string &filepath);
+	bool deserializeBinary(const char *data, size_t size);
 
 	// Graph modification functions
 
 	void startNewGraph(unsigned int nvertices);
 	void addUndirectedEdge(unsigned int id1, unsigned int id2, unsigned int cost);
 	void addDirectedEdge(unsigned int id_source, unsigned int id_target, unsigned int cost);
+	//! Function to reserve the specified number of constraints for the specified vertex, before adding them.
+	void reserveConstraints(unsigned int id, unsigned int nconstraints);
 
 	/*! Function to decrease the cost of all edges with finite cost and set the cost of the edges in the
 	 *  matching to the number of vertices in the graph (to prevent matching these two again in the near future).
 	 *  Optionnally, a flag may be set to avoid entering into non-deterministic matching cycles.
+	 *  The costs are decreased by incrementing the epoch of the graph, and the edge of each matched pair is found through the
+	 *  sorted index of the positions of the constraints of its source vertex, hence the update does not visit all the edges.
+	 *  If a delta is specified, the changes made by the update are appended to it (see NonMatchingGraphDelta).
+	 */
+	void updateConstraints(const std::vector<unsigned int> &matching, bool avoid_deterministic_matching, NonMatchingGraphDelta *delta=NULL);
+	/*! Function to apply the updates of the specified delta, as recorded by updateConstraints on another copy of this graph. The graph
+	 *  is left untouched and false is returned if the delta does not apply to a graph with this number of vertices.
 	 */
-	void updateConstraints(const std::vector<unsigned int> &matching, bool avoid_deterministic_matching);
+	bool applyDelta(const NonMatchingGraphDelta &delta);
 
 	// Graph getter functions
 
 	inline unsigned int getNumberVertices() const { return _vertices.size(); };
+	//! Function to return the number of updates of the constraints since the graph was started.
+	inline unsigned int getEpoch() const { return _epoch; }
+	//! Function to indicate whether the cost of the specified constraint was decreased to zero, in which case the constraint does not exist anymore.
+	inline bool isConstraintExpired(const Edge &e) const
+	{
+		const unsigned int age = _epoch-e.epoch;
+		return (e.cost!=(unsigned int)(-1) && age>0 && e.cost<=age);
+	}
+	//! Function to return the current cost of the specified constraint (0 if it is expired, -1 if the vertices cannot be matched).
+	inline unsigned int getConstraintCost(const Edge &e) const
+	{
+		const unsigned int age = _epoch-e.epoch;
+		if(e.cost==(unsigned int)(-1))
+			return e.cost;
+		return (e.cost>age ? e.cost-age : 0);
+	}
 	void getVertexIterators(std::vector<Vertex>::const_iterator &ibegin, std::vector<Vertex>::const_iterator &iend) const;
 	void getVertexIterators(std::vector<Vertex>::iterator &ibegin, std::vector<Vertex>::iterator &iend);
 
@@ -96,6 +161,14 @@ private:
 
 	//! Function used to check the validity of a graph after a deserialization.
 	bool _checkGraphValidity() const;
+	//! Function to make the edges of the vertices point to the vertices of this graph, after they were copied from another graph.
+	void _rebindEdges();
+	//! Function to set the cost of the first constraint from the specified vertex to the specified target, or to add the constraint if there is none.
+	void _setConstraintCost(Vertex &v, unsigned int id_target, unsigned int cost);
+	//! Function to index the positions of the constraints added to the specified vertex since its last indexing.
+	void _indexNewConstraints(Vertex &v);
+	//! Function to remove the expired constraints of the specified vertex, and optionally those whose cost is below the specified threshold, and index the remaining ones.
+	void _compactConstraints(Vertex &v, bool remove_low_costs, unsigned int cost_threshold);
 };
 
 
@@ -0,0 +1,152 @@
+/* NonMatchingGraphDelta.cpp */
+
+
+
+#include "WPMAssert.h"
+#include "TextParser.h"
+#include "NonMatchingGraphDelta.h"
+
+
+
+namespace wpm {
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+NonMatchingGraphDelta::Operation::Operation()
+	: type(OpType_Update)
+	, id_source(-1)
+	, id_target(-1)
+	, cost(0)
+{
+}
+
+NonMatchingGraphDelta::Operation::Operation(OperationType type, unsigned int id_source, unsigned int id_target, unsigned int cost)
+	: type(type)
+	, id_source(id_source)
+	, id_target(id_target)
+	, cost(cost)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+NonMatchingGraphDelta::NonMatchingGraphDelta()
+	: _nvertices(0)
+{
+}
+
+NonMatchingGraphDelta::~NonMatchingGraphDelta()
+{
+}
+
+bool NonMatchingGraphDelta::serialize(std::ostream &os) const
+{
+	os << "nv " << _nvertices << "\n";
+	for(std::vector<Operation>::const_iterator it_op=_operations.begin(); it_op!=_operations.end(); ++it_op) {
+		switch(it_op->type) {
+		case OpType_Update:
+			os << "u\n";
+			break;
+		case OpType_SetConstraint:
+			os << "s " << it_op->id_source << " " << it_op->id_target << "(" << it_op->cost << ")\n";
+			break;
+		case OpType_PruneConstraints:
+			os << "p " << it_op->id_source << " " << it_op->cost << "\n";
+			break;
+		}
+	}
+	return !os.bad();
+}
+
+bool NonMatchingGraphDelta::deserialize(const char *data, size_t size)
+{
+	const char *ptr = data;
+	const char *end = data+size;
+	// First read the number of vertices
+	unsigned int nvertices;
+	if(!impl::parseChar(ptr, end, 'n') || !impl::parseChar(ptr, end, 'v') || !impl::parseChar(ptr, end, ' ')) return false;
+	if(!impl::parseUnsignedInt(ptr, end, nvertices)) return false;
+	if(!impl::parseEndOfLine(ptr, end)) return false;
+	// Then read the operations, into a new delta which is reset if the parsing fails
+	startNewDelta(nvertices);
+	while(ptr!=end) {
+		Operation op;
+		bool success;
+		switch(*ptr++) {
+		case 'u':
+			op.type = OpType_Update;
+			success = true;
+			break;
+		case 's':
+			op.type = OpType_SetConstraint;
+			success = impl::parseChar(ptr, end, ' ') && impl::parseUnsignedInt(ptr, end, op.id_source) && impl::parseChar(ptr, end, ' ')
+				&& impl::parseUnsignedInt(ptr, end, op.id_target) && impl::parseChar(ptr, end, '(') && impl::parseUnsignedInt(ptr, end, op.cost)
+				&& impl::parseChar(ptr, end, ')') && op.id_source<nvertices && op.id_target<nvertices;
+			break;
+		case 'p':
+			op.type = OpType_PruneConstraints;
+			success = impl::parseChar(ptr, end, ' ') && impl::parseUnsignedInt(ptr, end, op.id_source) && impl::parseChar(ptr, end, ' ')
+				&& impl::parseUnsignedInt(ptr, end, op.cost) && op.id_source<nvertices;
+			break;
+		default:
+			success = false;
+		}
+		if(!success || !impl::parseEndOfLine(ptr, end)) {
+			startNewDelta(0);
+			return false;
+		}
+		_operations.push_back(op);
+	}
+	return true;
+}
+
+void NonMatchingGraphDelta::startNewDelta(unsigned int nvertices)
+{
+	_nvertices = nvertices;
+	_operations.clear();
+}
+
+void NonMatchingGraphDelta::addUpdate()
+{
+	_operations.push_back(Operation(OpType_Update, -1, -1, 0));
+}
+
+void NonMatchingGraphDelta::addSetConstraint(unsigned int id_source, unsigned int id_target, unsigned int cost)
+{
+	WPMASSERT(id_source<_nvertices && id_target<_nvertices, "Input ID does not exist!");
+	_operations.push_back(Operation(OpType_SetConstraint, id_source, id_target, cost));
+}
+
+void NonMatchingGraphDelta::addPruneConstraints(unsigned int id_source, unsigned int cost_threshold)
+{
+	WPMASSERT(id_source<_nvertices, "Input ID does not exist!");
+	_operations.push_back(Operation(OpType_PruneConstraints, id_source, -1, cost_threshold));
+}
+
+unsigned int NonMatchingGraphDelta::getNumberUpdates() const
+{
+	unsigned int nupdates = 0;
+	for(std::vector<Operation>::const_iterator it_op=_operations.begin(); it_op!=_operations.end(); ++it_op)
+		nupdates += (it_op->type==OpType_Update ? 1 : 0);
+	return nupdates;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+std::ostream& operator<<(std::ostream &os, const NonMatchingGraphDelta &delta)
+{
+	delta.serialize(os);
+	return os;
+}
+
+
+
+} //namespace wpm
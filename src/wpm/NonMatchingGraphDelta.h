@@ -0,0 +1,98 @@
+/* NonMatchingGraphDelta.h */
+
+#ifndef NON_MATCHING_GRAPH_DELTA_H
+#define NON_MATCHING_GRAPH_DELTA_H
+
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+
+namespace wpm {
+
+
+
+/*! NonMatchingGraphDelta class, representing the changes made to the constraints of a NonMatchingGraph by successive updates (see
+ *  NonMatchingGraph::updateConstraints), so that a copy of the graph can be kept up to date without transferring the whole graph.
+ *  Each update is a sequence of operations, applied in order:
+ *  - the update itself, decreasing the cost of all the finite constraints by one, where those whose cost reaches zero expire,
+ *  - the constraints set by the update, where the first constraint from the source to the target gets the specified cost, or is
+ *    added at the end of the constraints of the source if there is none (the constraints of the matched pairs),
+ *  - the constraints pruned by the update, where the constraints of the source with a cost below or equal to the specified
+ *    threshold are removed (to avoid deterministic matchings).
+ *  Hence the size of a delta is proportional to the number of vertices, instead of the number of constraints of the graph.
+ *  The text format is a "nv <nvertices>" line followed by one line per operation: "u" for an update, "s <source> <target>(<cost>)"
+ *  for a set constraint, and "p <source> <threshold>" for pruned constraints.
+ */
+class NonMatchingGraphDelta
+{
+public:
+
+	//! Possible types of operations.
+	enum OperationType {
+		OpType_Update,				//!< Decrease of the cost of all the finite constraints by one.
+		OpType_SetConstraint,		//!< Constraint from id_source to id_target set to the specified cost, or added.
+		OpType_PruneConstraints		//!< Removal of the constraints of id_source whose cost is below or equal to the specified cost.
+	};
+
+	//! Operation structure, representing a change of the constraints.
+	struct Operation
+	{
+		OperationType type;			//!< Type of the operation.
+		unsigned int id_source;		//!< ID of the source vertex of the changed constraints (unused for an update).
+		unsigned int id_target;		//!< ID of the target vertex of the set constraint (unused otherwise).
+		unsigned int cost;			//!< Cost of the set constraint, or threshold of the pruned constraints (unused for an update).
+
+		Operation();
+		Operation(OperationType type, unsigned int id_source, unsigned int id_target, unsigned int cost);
+	};
+
+private:
+
+	unsigned int _nvertices;				//!< Number of vertices of the graph to which the delta applies.
+	std::vector<Operation> _operations;		//!< Operations of the delta, in the order in which they are applied.
+
+public:
+
+	//! Default constructor.
+	NonMatchingGraphDelta();
+	//! Destructor.
+	~NonMatchingGraphDelta();
+
+	// Delta I/O functions
+
+	bool serialize(std::ostream &os) const;
+	//! Function to deserialize the delta from a text buffer, with the same parsing than NonMatchingGraph::deserialize(const char*, size_t).
+	bool deserialize(const char *data, size_t size);
+
+	// Delta modification functions
+
+	//! Function to start a new empty delta, applying to a graph with the specified number of vertices.
+	void startNewDelta(unsigned int nvertices);
+	void addUpdate();
+	void addSetConstraint(unsigned int id_source, unsigned int id_target, unsigned int cost);
+	void addPruneConstraints(unsigned int id_source, unsigned int cost_threshold);
+
+	// Delta getter functions
+
+	inline unsigned int getNumberVertices() const { return _nvertices; }
+	inline const std::vector<Operation>& getOperations() const { return _operations; }
+	//! Function to return the number of updates in the delta.
+	unsigned int getNumberUpdates() const;
+};
+
+
+
+// Serialization operators
+std::ostream& operator<<(std::ostream &os, const NonMatchingGraphDelta &delta);
+
+
+
+}	// namespace wpm
+
+
+
+#endif //NON_MATCHING_GRAPH_DELTA_H
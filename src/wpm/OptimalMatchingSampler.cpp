@@ -0,0 +1,149 @@
+/* OptimalMatchingSampler.cpp */
+
+
+
+#include <algorithm>
+#include "WPMAssert.h"
+#include "RandomEngine.h"
+#include "OptimalMatchingSampler.h"
+
+
+
+namespace wpm {
+
+
+
+template<class Score>
+BasicOptimalMatchingSampler<Score>::BasicOptimalMatchingSampler()
+	: _bmgraph(NULL)
+	, _nmoves_per_draw(0)
+{
+}
+
+template<class Score>
+BasicOptimalMatchingSampler<Score>::~BasicOptimalMatchingSampler()
+{
+}
+
+template<class Score>
+bool BasicOptimalMatchingSampler<Score>::initialize(const Graph &bmgraph, const std::vector<const Edge*> &matching, const std::vector<Score> &target_labels)
+{
+	_bmgraph = NULL;
+	_tight_offsets.clear();
+	_tight_indices.clear();
+	WPMASSERT(bmgraph.isFinalized(), "The graph must be finalized before sampling its matchings!");
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	if(!bmgraph.isFinalized() || matching.size()!=ncliques || target_labels.size()!=ncliques)
+		return false;
+	// Retrieve the adjacent edge of each matched edge, and check that the matching is perfect
+	_source_matches.assign(ncliques, (unsigned int)(-1));
+	_target_matches.assign(ncliques, (unsigned int)(-1));
+	for(typename std::vector<const Edge*>::const_iterator it_e=matching.begin(); it_e!=matching.end(); ++it_e) {
+		const unsigned int source_cid = (*it_e)->v_source->parent->cid;
+		const unsigned int target_cid = (*it_e)->v_target->parent->cid;
+		if(_source_matches[source_cid]!=(unsigned int)(-1) || _target_matches[target_cid]!=(unsigned int)(-1))
+			return false;
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+			if(bmgraph.getAdjacentEdgePointer(index)==*it_e)
+				_source_matches[source_cid] = index;
+		}
+		if(_source_matches[source_cid]==(unsigned int)(-1))
+			return false;	// The edge does not belong to the graph
+		_target_matches[target_cid] = source_cid;
+	}
+	// Build the equality subgraph, where the label of each source vertex makes its matched edge tight
+	_tight_offsets.resize(ncliques+1, 0);
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+		const typename Graph::AdjacentEdge &matched_edge = bmgraph.getAdjacentEdge(_source_matches[source_cid]);
+		const Score source_label = matched_edge.score-target_labels[matched_edge.target_cid];
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+			const typename Graph::AdjacentEdge &edge = bmgraph.getAdjacentEdge(index);
+			if(index==_source_matches[source_cid]) {
+				_tight_indices.push_back(index);
+				continue;
+			}
+			if(ScoreTraits<Score>::isForbidden(edge.score))
+				continue;
+			const Score slack = source_label+target_labels[edge.target_cid]-edge.score;
+			if(ScoreTraits<Score>::isZero(slack))
+				_tight_indices.push_back(index);
+			else if(slack<0) {
+				_tight_offsets.clear();
+				_tight_indices.clear();
+				return false;	// The labeling is not feasible, hence the matching may not have the maximal score
+			}
+		}
+		_tight_offsets[source_cid+1] = (unsigned int)_tight_indices.size();
+	}
+	_walk_positions.assign(ncliques, (unsigned int)(-1));
+	_bmgraph = &bmgraph;
+	return true;
+}
+
+template<class Score>
+unsigned int BasicOptimalMatchingSampler<Score>::drawMatching(std::vector<const Edge*> &matching, RandomEngine &random_engine)
+{
+	WPMASSERT(_bmgraph!=NULL, "The sampler is not initialized!");
+	const unsigned int ncliques = _bmgraph->getNumberCliques();
+	// By default, the moves are bounded by the number of steps of their walks rather than by their number, so that a draw
+	// stays linear in the size of the equality subgraph, where a walk which stops at once counts as one step
+	const size_t nsteps_max = std::max<size_t>(ncliques, _tight_indices.size());
+	size_t nsteps = 0;
+	unsigned int nswitches = 0;
+	for(unsigned int move=0; (_nmoves_per_draw>0 ? move<_nmoves_per_draw : nsteps<nsteps_max); ++move) {
+		if(_applyRandomMove(random_engine))
+			++nswitches;
+		nsteps += std::max<size_t>(_walk_sources.size(), 1);
+	}
+	matching.resize(ncliques);
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid)
+		matching[source_cid] = _bmgraph->getAdjacentEdgePointer(_source_matches[source_cid]);
+	return nswitches;
+}
+
+template<class Score>
+bool BasicOptimalMatchingSampler<Score>::_applyRandomMove(RandomEngine &random_engine)
+{
+	// Walk from a random source vertex along random tight edges outside the matching and back along the matched edges,
+	// until a source vertex of the walk is met again
+	_walk_sources.clear();
+	_walk_indices.clear();
+	unsigned int source_cid = random_engine.uniform(_bmgraph->getNumberCliques());
+	unsigned int cycle_begin = (unsigned int)(-1);
+	while(cycle_begin==(unsigned int)(-1)) {
+		const unsigned int ntight_edges = _tight_offsets[source_cid+1]-_tight_offsets[source_cid];
+		if(ntight_edges<2)
+			break;	// The matched edge is the only tight edge of this source vertex
+		// Draw one of the tight edges except the matched one, which is swapped with the last one if it is drawn
+		const unsigned int *tight_indices = &_tight_indices[_tight_offsets[source_cid]];
+		unsigned int index = tight_indices[random_engine.uniform(ntight_edges-1)];
+		if(index==_source_matches[source_cid])
+			index = tight_indices[ntight_edges-1];
+		_walk_positions[source_cid] = (unsigned int)_walk_sources.size();
+		_walk_sources.push_back(source_cid);
+		_walk_indices.push_back(index);
+		source_cid = _target_matches[_bmgraph->getAdjacentEdge(index).target_cid];
+		cycle_begin = _walk_positions[source_cid];
+	}
+	// Switch the matching along the cycle, where each source vertex takes the target vertex of the next one
+	if(cycle_begin!=(unsigned int)(-1)) {
+		for(unsigned int pos=cycle_begin; pos<_walk_sources.size(); ++pos) {
+			_source_matches[_walk_sources[pos]] = _walk_indices[pos];
+			_target_matches[_bmgraph->getAdjacentEdge(_walk_indices[pos]).target_cid] = _walk_sources[pos];
+		}
+	}
+	for(std::vector<unsigned int>::const_iterator it_s=_walk_sources.begin(); it_s!=_walk_sources.end(); ++it_s)
+		_walk_positions[*it_s] = (unsigned int)(-1);
+	return (cycle_begin!=(unsigned int)(-1));
+}
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+template class BasicOptimalMatchingSampler<int>;
+template class BasicOptimalMatchingSampler<long long>;
+template class BasicOptimalMatchingSampler<double>;
+
+
+
+}	// namespace wpm
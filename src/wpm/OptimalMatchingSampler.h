@@ -0,0 +1,104 @@
+/* OptimalMatchingSampler.h */
+
+#ifndef OPTIMAL_MATCHING_SAMPLER_H
+#define OPTIMAL_MATCHING_SAMPLER_H
+
+
+
+#include <vector>
+#include "BipartiteMatchingGraph.h"
+
+
+
+namespace wpm {
+
+
+
+// Forward declarations
+class RandomEngine;
+
+
+
+/*! BasicOptimalMatchingSampler class, in charge of drawing many perfect matchings with maximal score in a
+ *  BipartiteMatchingGraph from a single solve (see PerfectMatchingFinder::findOptimalMatchingSampler).
+ *  By complementary slackness, the perfect matchings with maximal score are exactly the perfect matchings of the equality
+ *  subgraph of an optimal vertex labeling, made of the tight edges with l(s)+l(t)=w(s,t). The sampler keeps this subgraph
+ *  and a current perfect matching, and each draw applies random moves to the matching: a random walk starting from a
+ *  random source vertex follows random tight edges outside the matching and the matched edges back, until it meets a
+ *  source vertex of the walk again, and the matching is switched along the closed alternating cycle. Each move costs the
+ *  length of its walk, which is up to n steps for n cliques. By default, a draw applies moves until their walks have
+ *  taken as many steps as the equality subgraph has edges (and at least n), hence it costs O(n+m) for m tight edges,
+ *  instead of the O(n^3) of a new solve. With a fixed number k of moves per draw, a draw costs O(k*n) in the worst case.
+ *  The successive draws form a Markov chain over the perfect matchings with maximal score: they are correlated, and not
+ *  exactly uniform, but every such matching can be reached from any other one, since their symmetric difference is a
+ *  union of alternating cycles in the equality subgraph. The default budget assumes that the chain mixes in a number of
+ *  steps proportional to the size of the equality subgraph, which is not proven: draws which must be less correlated
+ *  should apply more moves.
+ *  Like the graphs, the class is templated on the score type, and OptimalMatchingSampler samples the graphs with int scores.
+ */
+template<class Score>
+class BasicOptimalMatchingSampler
+{
+public:
+
+	// Convenience typedefs
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+
+private:
+
+	const Graph *_bmgraph;							//!< Sampled graph.
+	unsigned int _nmoves_per_draw;					//!< Number of random moves applied to the matching by each draw (0 for a budget of walk steps, see above).
+	std::vector<unsigned int> _tight_offsets;		//!< Array containing, for each source vertex, the offset of its first tight edge in _tight_indices.
+	std::vector<unsigned int> _tight_indices;		//!< Indices of the adjacent edges of the equality subgraph, grouped by source vertex.
+	std::vector<unsigned int> _source_matches;		//!< Array containing, for each source vertex, the index of the adjacent edge of the current matching.
+	std::vector<unsigned int> _target_matches;		//!< Array containing, for each target vertex, the clique ID of the source vertex of the current matching.
+	// Workspace of the moves
+	std::vector<unsigned int> _walk_sources;		//!< Source vertices of the current walk.
+	std::vector<unsigned int> _walk_indices;		//!< Indices of the adjacent edges leaving the source vertices of the current walk.
+	std::vector<unsigned int> _walk_positions;		//!< Array containing, for each source vertex, its position in the current walk (-1 if it is not in the walk).
+
+public:
+
+	//! Default constructor.
+	BasicOptimalMatchingSampler();
+	//! Destructor.
+	~BasicOptimalMatchingSampler();
+
+	/*! Function to initialize the sampler from a finalized graph, which must remain alive as long as the sampler is used, a
+	 *  perfect matching with maximal score and the labels of the target vertices of an optimal vertex labeling (with the
+	 *  convention of the Hungarian algorithm, the labels of the source vertices being deduced from the matching). Returns
+	 *  false if the graph is not finalized, or if the matching is not perfect or not in the equality subgraph of the labeling.
+	 */
+	bool initialize(const Graph &bmgraph, const std::vector<const Edge*> &matching, const std::vector<Score> &target_labels);
+
+	/*! Function to draw a perfect matching with maximal score, by applying random moves to the previous one, and return it
+	 *  ordered by source clique ID. Returns the number of moves which switched the matching along an alternating cycle.
+	 */
+	unsigned int drawMatching(std::vector<const Edge*> &matching, RandomEngine &random_engine);
+
+	//! Function to set the number of random moves applied to the matching by each draw (0 for the default budget of walk steps, see above).
+	inline void setNumberMovesPerDraw(unsigned int nmoves) { _nmoves_per_draw = nmoves; }
+	//! Function to return the number of random moves applied to the matching by each draw (0 for the default budget of walk steps).
+	inline unsigned int getNumberMovesPerDraw() const { return _nmoves_per_draw; }
+	//! Function to return the number of edges of the equality subgraph, which belong to some perfect matching with maximal score only if they lie on an alternating cycle.
+	inline unsigned int getNumberTightEdges() const { return (unsigned int)_tight_indices.size(); }
+
+private:
+
+	//! Function to apply a random move to the current matching, and return false if the walk reached a source vertex without other tight edge.
+	bool _applyRandomMove(RandomEngine &random_engine);
+};
+
+
+
+//! Sampler of the optimal matchings of the bipartite matching graphs with int scores, used by default.
+typedef BasicOptimalMatchingSampler<int> OptimalMatchingSampler;
+
+
+
+}	// namespace wpm
+
+
+
+#endif //OPTIMAL_MATCHING_SAMPLER_H
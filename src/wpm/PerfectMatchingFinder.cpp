@@ -3,11 +3,23 @@
 
 
 #include <algorithm>
-#include <queue>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <sstream>
-#include "WPMASSERT.h"
+#include <thread>
+#include "WPMAssert.h"
 #include "NonMatchingGraph.h"
 #include "BipartiteMatchingGraph.h"
+#include "ImplicitBipartiteMatchingGraph.h"
+#include "MatchingGraphConverter.h"
+#include "RandomEngine.h"
+#include "SmallPerfectMatchingFinder.h"
+#include "CardinalityMatchingFinder.h"
+#include "MatchingGraphReducer.h"
+#include "OptimalMatchingSampler.h"
+#include "ThreadPool.h"
+#include "Tracing.h"
 #include "PerfectMatchingFinder.h"
 
 
@@ -16,13 +28,6 @@ namespace wpm {
 
 
 
-// Convenience typedefs
-typedef BipartiteMatchingGraph::Edge Edge;
-typedef BipartiteMatchingGraph::Vertex Vertex;
-typedef BipartiteMatchingGraph::Clique Clique;
-
-
-
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -31,10 +36,12 @@ namespace impl {
 
 
 // Forward declarations
-class SlackArray;
-class VertexLabeling;
-class Matching;
-class AlternatingTree;
+template<class Score> class SlackArray;
+template<class Score> class VertexLabeling;
+template<class Score> class Matching;
+template<class Score> class AlternatingTree;
+class SourceVertexQueue;
+template<class Score> class HungarianWorkspace;
 
 
 
@@ -43,28 +50,33 @@ const bool VERBOSE = false;
 
 
 //! Internal structure representing a matching over the vertex in the BipartiteMatchingGraph.
+template<class Score>
 class Matching
 {
+public:
+
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+
 private:
 
 	std::vector<unsigned int> _source_matches;	//!< Array containing, for each source vertex, the clique ID of the matched target vertex if it exists and -1 otherwise.
 	std::vector<const Edge*> _source_edges;		//!< Array containing, for each source vertex, the associated edge in the matching if it exists and NULL otherwise.
 	std::vector<unsigned int> _target_matches;	//!< Array containing, for each target vertex, the clique ID of the matched source vertex if it exists and -1 otherwise.
 	std::vector<const Edge*> _target_edges;		//!< Array containing, for each target vertex, the associated edge in the matching if it exists and NULL otherwise.
-	std::vector<const Edge*> _edges;			//!< Array of all the edges in the matching.
+	unsigned int _nedges;						//!< Number of edges in the matching.
 	unsigned int _ncliques;						//!< Number of cliques in the graph.
 
 public:
 
-	//! Constructor, initializing to the empty matching.
-	Matching(size_t ncliques)
+	//! Default constructor, initializing to the empty matching over an empty graph.
+	Matching()
+		: _nedges(0)
+		, _ncliques(0)
 	{
-		_ncliques = ncliques;
-		reset();
 	}
 
 	//! Function to return the number of edges in the matching.
-	inline size_t getNumberEdges() const { return _edges.size(); }
+	inline size_t getNumberEdges() const { return _nedges; }
 
 	//! Function to indicate whether the clique with specified ID is a source in this matching.
 	inline bool isSource(unsigned int source_cid) const { return (_source_matches[source_cid]!=(unsigned int)(-1)); }
@@ -84,28 +96,37 @@ public:
 	//! Function to retrieve the edge in the matching for the input target vertex.
 	inline const Edge* getEdgeFromTarget(unsigned int target_cid) const { return _target_edges[target_cid]; }
 
-	//! Function to retrieve the set of edges in the matching.
+	//! Function to retrieve the set of edges in the matching, ordered by source vertex.
 	void getMatchingEdges(std::vector<const Edge*> &edges) const
 	{
-		edges.resize(_edges.size());
-		std::copy(_edges.begin(), _edges.end(), edges.begin());
+		edges.clear();
+		edges.reserve(_nedges);
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			if(_source_edges[source_cid]!=NULL)
+				edges.push_back(_source_edges[source_cid]);
+		}
+	}
+
+	//! Function to retrieve, for each source vertex, the clique ID of the matched target vertex if it exists and -1 otherwise.
+	void getSourceMatches(std::vector<unsigned int> &source_matches) const
+	{
+		source_matches = _source_matches;
 	}
 
-	//! Function to reset the matching.
-	void reset()
+	//! Function to reset to the empty matching over a graph with the specified number of cliques (the memory is reused).
+	void reset(unsigned int ncliques)
 	{
-		_source_matches.resize(_ncliques, (unsigned int)(-1));
-		_source_edges.resize(_ncliques, NULL);
-		_target_matches.resize(_ncliques, (unsigned int)(-1));
-		_target_edges.resize(_ncliques, NULL);
-		_edges.clear();
-		_edges.reserve(_ncliques);
+		_ncliques = ncliques;
+		_source_matches.assign(_ncliques, (unsigned int)(-1));
+		_source_edges.assign(_ncliques, NULL);
+		_target_matches.assign(_ncliques, (unsigned int)(-1));
+		_target_edges.assign(_ncliques, NULL);
+		_nedges = 0;
 	}
 
 	//! Function to add a new edge to the matching.
 	void addEdge(const Edge *edge)
 	{
-		_edges.push_back(edge);
 		unsigned int s = edge->v_source->parent->cid;
 		unsigned int t = edge->v_target->parent->cid;
 		WPMASSERT(!isSource(s), "The source vertex of this edge is already matched!");
@@ -114,32 +135,22 @@ public:
 		_target_matches[t] = s;
 		_source_edges[s] = edge;
 		_target_edges[t] = edge;
+		++_nedges;
 	}
 
 	//! Function to remove an edge from the matching.
 	void removeEdge(const Edge *edge)
 	{
-		// Find the edge to be removed
-		std::vector<const Edge*>::iterator it_e = _edges.begin();
-		for(; it_e!=_edges.end(); ++it_e) {
-			if(*it_e==edge)
-				break;
-		}
-		if(it_e==_edges.end())
-			return;
-		// Remove the edge from the matching
-		_edges.erase(it_e);
-		// Update the matched vertex and edge sets
 		unsigned int s = edge->v_source->parent->cid;
-		if(_source_edges[s]==edge) {
-			_source_matches[s] = (unsigned int)(-1);
-			_source_edges[s] = NULL;
-		}
 		unsigned int t = edge->v_target->parent->cid;
-		if(_target_edges[t]==edge) {
-			_target_matches[t] = (unsigned int)(-1);
-			_target_edges[t] = NULL;
-		}
+		if(_source_edges[s]!=edge)
+			return;	// The edge is not in the matching
+		WPMASSERT(_target_edges[t]==edge, "The matched vertex and edge sets are inconsistent!");
+		_source_matches[s] = (unsigned int)(-1);
+		_source_edges[s] = NULL;
+		_target_matches[t] = (unsigned int)(-1);
+		_target_edges[t] = NULL;
+		--_nedges;
 	}
 
 	//! Function to convert the matching into a human-readable string.
@@ -158,42 +169,76 @@ public:
  *  Once an exposed target vertex is found, this tree structure enables efficiently computing the path
  *  to the root exposed source vertex. Also, it is called alternating because the edges along the final
  *  path are alternatingly inside and outside the matching.
+ *  The sets S and T are represented by epoch stamps: a vertex belongs to a set if its stamp is equal to the
+ *  current epoch, so that a new tree is started in constant time by incrementing the epoch.
  */
+template<class Score>
 class AlternatingTree
 {
+public:
+
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+
 private:
 
-	std::vector<bool> _set_S;	//!< Set S, containing the source vertices from which candidate exposed target vertices are searched.
-	std::vector<bool> _set_T;	//!< Set T, containing the target vertices which have been checked while looking for an exposed target vertex.
-	std::vector<unsigned int> _source_prev;	//!< For each source vertex, contains the previous target vertex along the alternating tree.
-	std::vector<unsigned int> _target_prev;	//!< For each target vertex, contains the previous source vertex along the alternating tree.
-	std::vector<const Edge*> _source_prev_edge;	//!< For each source vertex, contains the pointer to the previous edge in the alternating tree if it exists or NULL otherwise.
-	std::vector<const Edge*> _target_prev_edge;	//!< For each target vertex, contains the pointer to the previous edge in the alternating tree if it exists or NULL otherwise.
+	std::vector<unsigned int> _source_stamps;	//!< For each source vertex, contains the epoch at which it was added to the set S, containing the source vertices from which candidate exposed target vertices are searched.
+	std::vector<unsigned int> _target_stamps;	//!< For each target vertex, contains the epoch at which it was added to the set T, containing the target vertices which have been checked while looking for an exposed target vertex.
+	unsigned int _epoch;						//!< Current epoch, identifying the current tree.
+	std::vector<unsigned int> _set_S;			//!< Source vertices in the set S.
+	std::vector<unsigned int> _set_T;			//!< Target vertices in the set T.
+	std::vector<unsigned int> _source_prev;		//!< For each source vertex in S, contains the previous target vertex along the alternating tree.
+	std::vector<unsigned int> _target_prev;		//!< For each target vertex in T, contains the previous source vertex along the alternating tree.
+	std::vector<const Edge*> _source_prev_edge;	//!< For each source vertex in S, contains the pointer to the previous edge in the alternating tree if it exists or NULL otherwise.
+	std::vector<const Edge*> _target_prev_edge;	//!< For each target vertex in T, contains the pointer to the previous edge in the alternating tree if it exists or NULL otherwise.
 	unsigned int _root_exposed_source_vertex;	//!< Clique ID for the root exposed source vertex.
 	unsigned int _end_exposed_target_vertex;	//!< Clique ID for the end exposed target vertex.
 
 public:
 
-	//! Constructor, initializing the root source vertex of the alternating tree.
-	AlternatingTree(unsigned int ncliques, unsigned int cid_root_exposed_source_vertex)
+	//! Default constructor, initializing an empty tree.
+	AlternatingTree()
+		: _epoch(0)
+		, _root_exposed_source_vertex((unsigned int)(-1))
+		, _end_exposed_target_vertex((unsigned int)(-1))
+	{
+	}
+
+	//! Function to start a new alternating tree from the specified root source vertex (the memory is reused).
+	void reset(unsigned int ncliques, unsigned int cid_root_exposed_source_vertex)
 	{
-		_set_S.resize(ncliques, false);
-		_set_T.resize(ncliques, false);
-		_source_prev.resize(ncliques, -1);
-		_source_prev_edge.resize(ncliques, NULL);
-		_target_prev.resize(ncliques, -1);
-		_target_prev_edge.resize(ncliques, NULL);
+		if(_source_stamps.size()!=ncliques) {
+			_source_stamps.assign(ncliques, 0);
+			_target_stamps.assign(ncliques, 0);
+			_source_prev.resize(ncliques);
+			_target_prev.resize(ncliques);
+			_source_prev_edge.resize(ncliques);
+			_target_prev_edge.resize(ncliques);
+			_set_S.reserve(ncliques);
+			_set_T.reserve(ncliques);
+			_epoch = 0;
+		}
+		if(++_epoch==0) {
+			// The epoch wrapped around, hence reset the stamps
+			std::fill(_source_stamps.begin(), _source_stamps.end(), 0);
+			std::fill(_target_stamps.begin(), _target_stamps.end(), 0);
+			_epoch = 1;
+		}
+		_set_S.clear();
+		_set_T.clear();
 		_root_exposed_source_vertex = cid_root_exposed_source_vertex;
 		_end_exposed_target_vertex = (unsigned int)(-1);
-		_set_S[_root_exposed_source_vertex] = true;
+		_source_stamps[_root_exposed_source_vertex] = _epoch;
+		_set_S.push_back(_root_exposed_source_vertex);
+		_source_prev[_root_exposed_source_vertex] = (unsigned int)(-1);
+		_source_prev_edge[_root_exposed_source_vertex] = NULL;
 	}
 
 	//! Adds edges (s1,t) and (t,s2) to the alternating tree.
 	void addTwoEdges(unsigned int cid_s1, unsigned int cid_t, unsigned int cid_s2, const Edge *edge_s1_t, const Edge *edge_t_s2)
 	{
-		WPMASSERT(_set_S[cid_s1]==true,"Adding edge from a source vertex which is not in S!");	// s1 should already be in S
-		_set_T[cid_t] = true;
-		_set_S[cid_s2] = true;
+		WPMASSERT(isInS(cid_s1), "Adding edge from a source vertex which is not in S!");	// s1 should already be in S
+		_addToT(cid_t);
+		_addToS(cid_s2);
 		_source_prev[cid_s2] = cid_t;
 		_source_prev_edge[cid_s2] = edge_t_s2;
 		_target_prev[cid_t] = cid_s1;
@@ -203,8 +248,8 @@ public:
 	//! Function to add the input target vertex to set T.
 	void addSingleEdge(unsigned int cid_s1, unsigned int cid_t, const Edge *edge_s1_t)
 	{
-		WPMASSERT(_set_S[cid_s1]==true, "Adding edge from a source vertex which is not in S!");	// s1 should already be in S
-		_set_T[cid_t] = true;
+		WPMASSERT(isInS(cid_s1), "Adding edge from a source vertex which is not in S!");	// s1 should already be in S
+		_addToT(cid_t);
 		_target_prev[cid_t] = cid_s1;
 		_target_prev_edge[cid_t] = edge_s1_t;
 	}
@@ -221,40 +266,39 @@ public:
 	inline bool isAugmentingPathFound() { return (_end_exposed_target_vertex!=(unsigned int)(-1)); }
 
 	//! Function to test whether the input source vertex is in the set S.
-	inline bool isInS(unsigned int source_cid) const { return _set_S[source_cid]; }
+	inline bool isInS(unsigned int source_cid) const { return _source_stamps[source_cid]==_epoch; }
 	//! Function to test whether the input target vertex is in the set T.
-	inline bool isInT(unsigned int target_cid) const { return _set_T[target_cid]; }
+	inline bool isInT(unsigned int target_cid) const { return _target_stamps[target_cid]==_epoch; }
+	//! Function to return the source vertices in the set S.
+	inline const std::vector<unsigned int>& getSetS() const { return _set_S; }
+	//! Function to return the target vertices in the set T.
+	inline const std::vector<unsigned int>& getSetT() const { return _set_T; }
 
 	//! Function to apply the augmenting path to augment the specified matching.
-	void applyAugmentingPath(impl::Matching &matching)
+	void applyAugmentingPath(impl::Matching<Score> &matching)
 	{
 		// Preconditions, in particular an augmenting path must have been found
 		WPMASSERT(_end_exposed_target_vertex!=(unsigned int)(-1), "End target vertex is not defined!");
 		WPMASSERT(!matching.isSource(_root_exposed_source_vertex),"Root source vertex is not an exposed vertex!");
 		WPMASSERT(!matching.isTarget(_end_exposed_target_vertex), "End target vertex is not an exposed vertex!");
 		unsigned int n_edges_matches_before = matching.getNumberEdges();
-		// Loop over all edges in the augmenting path, to determine the edges to remove from the matching and those to add in the matching
-		std::vector<const Edge*> edges_to_be_added, edges_to_be_removed;
+		// Loop over all edges in the augmenting path from its end, and swap them in place: the matched edge of each
+		// source vertex is removed before the edge towards the current target vertex is added, which frees the target
+		// vertex of the next step
 		unsigned int crt_target_cid = _end_exposed_target_vertex;
 		do {
 			const Edge* edge_s_t1 = _target_prev_edge[crt_target_cid];
 			unsigned int matched_source_cid = _target_prev[crt_target_cid];
 			WPMASSERT(matched_source_cid!=(unsigned int)(-1), "Current target vertex has no previous source vertex!");
 			WPMASSERT(edge_s_t1!=NULL, "Current target vertex has no associated edge!");
-			edges_to_be_added.push_back(edge_s_t1);
 			crt_target_cid = _source_prev[matched_source_cid];
 			if(crt_target_cid!=(unsigned int)(-1)) {
 				const Edge* edge_t2_s = _source_prev_edge[matched_source_cid];
 				WPMASSERT(edge_t2_s!=NULL, "Current source vertex has no associated edge!");
-				edges_to_be_removed.push_back(edge_t2_s);
+				matching.removeEdge(edge_t2_s);
 			}
+			matching.addEdge(edge_s_t1);
 		} while(crt_target_cid!=(unsigned int)(-1));
-		// Remove the edges to be removed
-		for(std::vector<const Edge*>::const_iterator it_e=edges_to_be_removed.begin(); it_e!=edges_to_be_removed.end(); ++it_e)
-			matching.removeEdge(*it_e);
-		// Add the edges to be added
-		for(std::vector<const Edge*>::const_iterator it_e=edges_to_be_added.begin(); it_e!=edges_to_be_added.end(); ++it_e)
-			matching.addEdge(*it_e);
 		WPMASSERT(matching.getNumberEdges()==n_edges_matches_before+1, "Applying the augmenting path did not augment the matching!");
 	}
 
@@ -273,72 +317,130 @@ public:
 		} while(crt_target_cid!=(unsigned int)(-1));
 		return ss.str();
 	}
+
+private:
+
+	//! Function to add the specified source vertex to the set S.
+	inline void _addToS(unsigned int source_cid)
+	{
+		if(_source_stamps[source_cid]!=_epoch) {
+			_source_stamps[source_cid] = _epoch;
+			_set_S.push_back(source_cid);
+		}
+	}
+
+	//! Function to add the specified target vertex to the set T.
+	inline void _addToT(unsigned int target_cid)
+	{
+		if(_target_stamps[target_cid]!=_epoch) {
+			_target_stamps[target_cid] = _epoch;
+			_set_T.push_back(target_cid);
+		}
+	}
 };
 
 /*! Internal structure representing a vertex labeling over the graph, which implicitely represent the 'equality subgraph'
  *  for this graph. This enables finding a perfect matching with maximal score, since it was shown that a perfect
  *  matching in the equality subgraph corresponds to a perfect matching with maximal score in the original graph.
+ *  The labels have the type of the scores, hence the graphs whose labels may overflow an int must use wider scores.
  */
+template<class Score>
 class VertexLabeling
 {
+public:
+
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+
 private:
 
-	const unsigned int _ncliques;	//!< Number of cliques in the considered graph.
-	std::vector<int> _ls;	//!< Array containing the labels for each source vertex.
-	std::vector<int> _lt;	//!< Array containing the labels for each target vertex.
+	std::vector<Score> _ls;	//!< Array containing the labels for each source vertex.
+	std::vector<Score> _lt;	//!< Array containing the labels for each target vertex.
 
 public:
 
-	//! Constructor which initializes the vertex labeling to a trivially feasible one.
-	VertexLabeling(const BipartiteMatchingGraph &bmgraph)
-		: _ncliques(bmgraph.getNumberCliques())
+	//! Function to initialize the vertex labeling to a trivially feasible one (the memory is reused).
+	void reset(const Graph &bmgraph)
 	{
 		_setToTriviallyFeasibleVertexLabeling(bmgraph);
 	}
 
+	//! Function to initialize the vertex labeling from the target labels of a previous labeling, and repair the source labels to make it feasible.
+	void reset(const Graph &bmgraph, const std::vector<Score> &target_labels)
+	{
+		_setToFeasibleVertexLabelingFromTargetLabels(bmgraph, target_labels);
+	}
+
+	//! Function to retrieve the labels of all target vertices.
+	void getTargetLabels(std::vector<Score> &target_labels) const
+	{
+		target_labels = _lt;
+	}
+
 	//! Function to return the label of the specified source vertex.
-	inline int getSourceVertexLabel(unsigned int source_cid) const { return _ls[source_cid]; }
+	inline Score getSourceVertexLabel(unsigned int source_cid) const { return _ls[source_cid]; }
 
 	//! Function to return the label of the specified target vertex.
-	inline int getTargetVertexLabel(unsigned int target_cid) const { return _lt[target_cid]; }
+	inline Score getTargetVertexLabel(unsigned int target_cid) const { return _lt[target_cid]; }
 
 	//! Function to update the vertex labeling using the input value.
-	void update(int delta, const AlternatingTree &atree)
+	void update(Score delta, const AlternatingTree<Score> &atree)
 	{
-		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid)
-			if(atree.isInS(source_cid)) _ls[source_cid] -= delta;
-		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid)
-			if(atree.isInT(target_cid)) _lt[target_cid] += delta;
+		const std::vector<unsigned int> &set_S = atree.getSetS();
+		for(std::vector<unsigned int>::const_iterator it_s=set_S.begin(); it_s!=set_S.end(); ++it_s)
+			_ls[*it_s] -= delta;
+		const std::vector<unsigned int> &set_T = atree.getSetT();
+		for(std::vector<unsigned int>::const_iterator it_t=set_T.begin(); it_t!=set_T.end(); ++it_t)
+			_lt[*it_t] += delta;
 	}
 
 private:
 
-	//! Function to compute the maximum score for the incident edges of a given vertex.
-	static int _getVertexMaxEdgeScore(const Vertex &v)
+	//! Function to compute the maximum score for the incident edges of a given source vertex.
+	static Score _getSourceVertexMaxEdgeScore(const Graph &bmgraph, unsigned int source_cid)
 	{
-		int max_score = std::numeric_limits<int>::min();
-		for(std::vector<Edge*>::const_iterator it_e=v.edges.begin(); it_e!=v.edges.end(); ++it_e) {
-			if((*it_e)->score > max_score)
-				max_score = (*it_e)->score;
+		Score max_score = ScoreTraits<Score>::forbidden();
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+			if(bmgraph.getAdjacentEdge(index).score > max_score)
+				max_score = bmgraph.getAdjacentEdge(index).score;
 		}
 		return max_score;
 	}
 
 	//! Function to initialize the vertex labeling to a trivially feasible one.
-	void _setToTriviallyFeasibleVertexLabeling(const BipartiteMatchingGraph &bmgraph)
+	void _setToTriviallyFeasibleVertexLabeling(const Graph &bmgraph)
 	{
-		_ls.resize(_ncliques);
-		_lt.resize(_ncliques);
+		const unsigned int ncliques = bmgraph.getNumberCliques();
+		_ls.resize(ncliques);
+		_lt.resize(ncliques);
 		// A feasible vertex labeling l is such that for any source vertex 's' and target vertex 't'
 		// linked by an edge with score w(s,t), we have l(s)+l(t) >= w(s,t).
 		// This function implements a simple algorithm to obtain a trivially feasible vertex
 		// labeling, which consists in assigning to each source vertex the maximum score of all its
 		// incident edges, and 0 to each target vertex.
-		std::vector<Clique>::const_iterator it_c_begin, it_c_end;
-		bmgraph.getCliqueIterators(it_c_begin, it_c_end);
-		for(std::vector<Clique>::const_iterator it_c=it_c_begin; it_c!=it_c_end; ++it_c) {
-			_ls[it_c->cid] = _getVertexMaxEdgeScore(it_c->v_source);
-			_lt[it_c->cid] = 0;
+		for(unsigned int cid=0; cid<ncliques; ++cid) {
+			_ls[cid] = _getSourceVertexMaxEdgeScore(bmgraph, cid);
+			_lt[cid] = 0;
+		}
+	}
+
+	//! Function to initialize the vertex labeling from previous target labels, by setting each source label to the smallest feasible value.
+	void _setToFeasibleVertexLabelingFromTargetLabels(const Graph &bmgraph, const std::vector<Score> &target_labels)
+	{
+		const unsigned int ncliques = bmgraph.getNumberCliques();
+		WPMASSERT(target_labels.size()==ncliques, "The previous labeling is incompatible with this graph!");
+		_ls.resize(ncliques);
+		_lt = target_labels;
+		// Any target labeling can be completed into a feasible vertex labeling, by assigning to each source vertex 's'
+		// the maximum of w(s,t)-l(t) over its incident edges. For the source vertices whose edges did not change since
+		// the previous labeling was computed, this yields back their previous label, so that their previous matched
+		// edge is still in the equality subgraph.
+		for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+			Score max_score = ScoreTraits<Score>::forbidden();
+			for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+				const typename Graph::AdjacentEdge &edge = bmgraph.getAdjacentEdge(index);
+				max_score = std::max(max_score, edge.score-_lt[edge.target_cid]);
+			}
+			_ls[source_cid] = max_score;
 		}
 	}
 };
@@ -348,50 +450,66 @@ private:
  *  The way this structure is maintained enables reaching a O(n^3) complexity, instead of a O(n^4) one with
  *  the naive approach.
  */
+template<class Score>
 class SlackArray
 {
+public:
+
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+
 private:
 
-	std::vector<int> _min_slack;			//!< Array containing, for each given target vertex 't', the value of the minimum of l(s)+l(t)-w(s,t) for all source vertices 's' in the alternating tree (i.e. set S in AlternatingTree).
+	const Graph *_bmgraph;					//!< Considered graph, whose compressed sparse row layout is used to iterate over the edges of the source vertices.
+	std::vector<Score> _min_slack;			//!< Array containing, for each given target vertex 't', the value of the minimum of l(s)+l(t)-w(s,t) for all source vertices 's' in the alternating tree (i.e. set S in AlternatingTree).
 	std::vector<unsigned int> _source_cid;	//!< Array containing, for each given target vertex 't', the clique ID of a source vertex 's' for which _min_cost[t] = l(s)+l(t)-w(s,t).
-	std::vector<const Edge*> _edge_cid;		//!< Array containing, for each given target vertex 't', the edge linking 't' with '_source_cid[t]'.
+	std::vector<unsigned int> _edge_index;	//!< Array containing, for each given target vertex 't', the index of the adjacent edge linking '_source_cid[t]' with 't'.
 
 public:
 
-	//! Constructor, initializing the slack array using the specified labeling and source vertex.
-	SlackArray(unsigned int ncliques, const Vertex &root_exposed_source_vertex, const VertexLabeling &labeling)
+	//! Default constructor.
+	SlackArray()
+		: _bmgraph(NULL)
+	{
+	}
+
+	//! Function to initialize the slack array using the specified labeling and source vertex (the memory is reused).
+	void reset(const Graph &bmgraph, unsigned int root_exposed_source_cid, const VertexLabeling<Score> &labeling)
 	{
-		_min_slack.resize(ncliques, std::numeric_limits<int>::max());
-		_source_cid.resize(ncliques, -1);
-		_edge_cid.resize(ncliques, NULL);
-		for(std::vector<Edge*>::const_iterator it_e=root_exposed_source_vertex.edges.begin(); it_e!=root_exposed_source_vertex.edges.end(); ++it_e) {
-			const Vertex *target = (*it_e)->v_target;
-			_min_slack[target->parent->cid] = labeling.getSourceVertexLabel(root_exposed_source_vertex.parent->cid)+labeling.getTargetVertexLabel(target->parent->cid)-(*it_e)->score;
-			_source_cid[target->parent->cid] = root_exposed_source_vertex.parent->cid;
-			_edge_cid[target->parent->cid] = *it_e;
+		_bmgraph = &bmgraph;
+		const unsigned int ncliques = bmgraph.getNumberCliques();
+		_min_slack.assign(ncliques, ScoreTraits<Score>::infinity());
+		_source_cid.assign(ncliques, (unsigned int)(-1));
+		_edge_index.assign(ncliques, (unsigned int)(-1));
+		const Score source_label = labeling.getSourceVertexLabel(root_exposed_source_cid);
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(root_exposed_source_cid); index<bmgraph.getSourceAdjacencyEnd(root_exposed_source_cid); ++index) {
+			const typename Graph::AdjacentEdge &edge = bmgraph.getAdjacentEdge(index);
+			_min_slack[edge.target_cid] = source_label+labeling.getTargetVertexLabel(edge.target_cid)-edge.score;
+			_source_cid[edge.target_cid] = root_exposed_source_cid;
+			_edge_index[edge.target_cid] = index;
 		}
 	}
 
 	//! Function to return the slack value, for the specified target vertex.
-	inline int getMinSlackValue(unsigned int target_cid) const { return _min_slack[target_cid]; }
+	inline Score getMinSlackValue(unsigned int target_cid) const { return _min_slack[target_cid]; }
 
 	//! Function to return the source vertex associated to the minimum slack value, for the specified target vertex.
 	inline int getMinSlackVertex(unsigned int target_cid) const { return _source_cid[target_cid]; }
 
 	//! Function to return the edge associated to the minimum slack value, for the specified target vertex.
-	inline const Edge* getMinSlackEdge(unsigned int target_cid) const { return _edge_cid[target_cid]; }
+	inline const Edge* getMinSlackEdge(unsigned int target_cid) const { return (_edge_index[target_cid]!=(unsigned int)(-1) ? _bmgraph->getAdjacentEdgePointer(_edge_index[target_cid]) : NULL); }
 
 	//! Function to calculate the global minimum cost slack and reduce all slack values by this minimum cost slack.
-	void simplifyMinCostSlack(int &delta, const AlternatingTree &atree)
+	void simplifyMinCostSlack(Score &delta, const AlternatingTree<Score> &atree)
 	{
 		// Compute the global minimum cost slack
-		delta = std::numeric_limits<int>::max();
+		delta = ScoreTraits<Score>::infinity();
 		const unsigned int ncliques = _source_cid.size();
 		for(unsigned int target_cid=0; target_cid<ncliques; ++target_cid) {
 			if(_source_cid[target_cid]!=(unsigned int)(-1) && !atree.isInT(target_cid))
 				delta = std::min(delta, _min_slack[target_cid]);
 		}
-		WPMASSERT(delta!=std::numeric_limits<int>::max(), "Failed to compute the global minimum cost slack!");
+		WPMASSERT(delta!=ScoreTraits<Score>::infinity(), "Failed to compute the global minimum cost slack!");
 		// Update the slack array
 		for(unsigned int target_cid=0; target_cid<ncliques; ++target_cid) {
 			if(_source_cid[target_cid]!=(unsigned int)(-1) && !atree.isInT(target_cid))
@@ -400,39 +518,160 @@ public:
 	}
 
 	//! Function to update all slack values after a new source vertex was added to the alternating tree.
-	void updateWithNewSourceVertex(const Vertex &added_source_vertex, const VertexLabeling &labeling)
+	void updateWithNewSourceVertex(unsigned int added_source_cid, const VertexLabeling<Score> &labeling)
 	{
-		for(std::vector<Edge*>::const_iterator it_e=added_source_vertex.edges.begin(); it_e!=added_source_vertex.edges.end(); ++it_e) {
-			const Vertex *target = (*it_e)->v_target;
-			int tmp_slack_value = labeling.getSourceVertexLabel(added_source_vertex.parent->cid)+labeling.getTargetVertexLabel(target->parent->cid)-(*it_e)->score;
-			if(tmp_slack_value < _min_slack[target->parent->cid]) {
-				_min_slack[target->parent->cid] = tmp_slack_value;
-				_source_cid[target->parent->cid] = added_source_vertex.parent->cid;
-				_edge_cid[target->parent->cid] = *it_e;
+		const Score source_label = labeling.getSourceVertexLabel(added_source_cid);
+		for(unsigned int index=_bmgraph->getSourceAdjacencyBegin(added_source_cid); index<_bmgraph->getSourceAdjacencyEnd(added_source_cid); ++index) {
+			const typename Graph::AdjacentEdge &edge = _bmgraph->getAdjacentEdge(index);
+			const Score tmp_slack_value = source_label+labeling.getTargetVertexLabel(edge.target_cid)-edge.score;
+			if(tmp_slack_value < _min_slack[edge.target_cid]) {
+				_min_slack[edge.target_cid] = tmp_slack_value;
+				_source_cid[edge.target_cid] = added_source_cid;
+				_edge_index[edge.target_cid] = index;
 			}
 		}
 	}
 };
 
-//! Function to find a source vertex which is exposed under the specified matching.
-void findExposedSourceVertex(const BipartiteMatchingGraph &bmgraph, const impl::Matching &matching, const Vertex* &root_vertex)
+//! Internal structure representing the queue of candidate source vertices of the breadth-first search, stored in a reusable array since each source vertex enters the queue at most once per alternating tree.
+class SourceVertexQueue
+{
+private:
+
+	std::vector<unsigned int> _source_cids;	//!< Clique IDs of the source vertices which entered the queue.
+	size_t _front;							//!< Index of the front of the queue in _source_cids.
+
+public:
+
+	//! Default constructor, initializing an empty queue.
+	SourceVertexQueue() : _front(0) {}
+
+	//! Function to empty the queue (the memory is reused).
+	inline void reset(unsigned int ncliques) { _source_cids.clear(); _source_cids.reserve(ncliques); _front = 0; }
+	//! Function to indicate whether the queue is empty.
+	inline bool empty() const { return _front==_source_cids.size(); }
+	//! Function to add the specified source vertex at the back of the queue.
+	inline void push(unsigned int source_cid) { _source_cids.push_back(source_cid); }
+	//! Function to remove and return the source vertex at the front of the queue.
+	inline unsigned int pop() { return _source_cids[_front++]; }
+};
+
+/*! Internal structure gathering the data structures of the Hungarian algorithm. It is owned by the PerfectMatchingFinder
+ *  and reused by successive searches, so that once the arrays reached the size of the graphs, a search does not
+ *  allocate any memory.
+ */
+template<class Score>
+class HungarianWorkspace
+{
+public:
+
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+
+	impl::Matching<Score> matching;				//!< Current matching.
+	impl::VertexLabeling<Score> labeling;		//!< Current vertex labeling.
+	impl::AlternatingTree<Score> atree;			//!< Alternating tree of the current augmentation.
+	impl::SlackArray<Score> slack;				//!< Slack array of the current augmentation.
+	impl::SourceVertexQueue queue;				//!< Queue of candidate source vertices of the current augmentation.
+	std::vector<unsigned int> random_sources;	//!< Source vertices in random order, drawn once per search and used to select the root exposed source vertex of each augmentation.
+	unsigned int random_sources_pos;			//!< Position in random_sources before which all the source vertices are matched.
+	std::vector<const Edge*> matching_edges;	//!< Edges of the final matching.
+
+	//! Default constructor.
+	HungarianWorkspace() : random_sources_pos(0) {}
+};
+
+//! Statistics policy of the Hungarian engine gathering nothing, whose empty functions compile to nothing.
+class NoSolverStatistics
+{
+public:
+
+	inline SolverStatistics* getStatistics() const { return NULL; }
+	inline void addAugmentation(unsigned int) {}
+	inline void addLabelUpdate() {}
+	inline void addScannedEdge() {}
+	inline void addCliqueRescan() {}
+};
+
+//! Statistics policy of the Hungarian engine gathering its counters into a SolverStatistics.
+class SolverStatisticsRecorder
+{
+private:
+
+	SolverStatistics &_statistics;	//!< Statistics in which the counters are gathered.
+
+public:
+
+	//! Constructor gathering the counters into the specified statistics.
+	explicit SolverStatisticsRecorder(SolverStatistics &statistics) : _statistics(statistics) {}
+
+	inline SolverStatistics* getStatistics() const { return &_statistics; }
+	inline void addAugmentation(unsigned int tree_size)
+	{
+		++_statistics.naugmentations;
+		_statistics.total_tree_size += tree_size;
+		_statistics.max_tree_size = std::max(_statistics.max_tree_size, tree_size);
+	}
+	inline void addLabelUpdate() { ++_statistics.nlabel_updates; }
+	inline void addScannedEdge() { ++_statistics.nscanned_edges; }
+	inline void addCliqueRescan() { ++_statistics.nclique_rescans; }
+};
+
+/*! Internal structure measuring the wall time of a phase of a search, from its construction to its destruction (or to the
+ *  call to stop), and adding it to the specified field of the statistics. It does nothing if the statistics are NULL.
+ */
+class PhaseTimer
+{
+private:
+
+	double *_phase_time;								//!< Time of the phase in the statistics, or NULL if the phase is not measured.
+	std::chrono::steady_clock::time_point _start;		//!< Start of the phase.
+
+public:
+
+	//! Constructor starting the measure of the specified phase.
+	PhaseTimer(SolverStatistics *statistics, double SolverStatistics::*phase_time)
+		: _phase_time(statistics!=NULL ? &(statistics->*phase_time) : NULL)
+	{
+		if(_phase_time!=NULL)
+			_start = std::chrono::steady_clock::now();
+	}
+
+	//! Destructor, ending the measure if it was not stopped.
+	~PhaseTimer() { stop(); }
+
+	//! Function to end the measure of the phase.
+	void stop()
+	{
+		if(_phase_time!=NULL)
+			*_phase_time += std::chrono::duration<double>(std::chrono::steady_clock::now()-_start).count();
+		_phase_time = NULL;
+	}
+};
+
+/*! Function to find a source vertex which is exposed under the specified matching. The source vertices are visited in
+ *  the random order drawn for the search, from the position reached by the previous call, since a matched source
+ *  vertex remains matched when the matching is augmented. Selecting the first exposed one hence selects a uniformly
+ *  random exposed source vertex, in O(n) time over the whole search.
+ */
+template<class Score>
+void findExposedSourceVertex(impl::HungarianWorkspace<Score> &workspace, unsigned int &root_source_cid)
 {
-	root_vertex = NULL;
-	std::vector<const Clique*> random_cliques;
-	bmgraph.getCliquesInRandomOrder(random_cliques);
-	for(std::vector<const Clique*>::const_iterator it_c=random_cliques.begin(); it_c!=random_cliques.end(); ++it_c) {
-		if(matching.isSource((*it_c)->cid)==false) {
-			root_vertex = &((*it_c)->v_source);
+	root_source_cid = (unsigned int)(-1);
+	const std::vector<unsigned int> &random_sources = workspace.random_sources;
+	for(; workspace.random_sources_pos<random_sources.size(); ++workspace.random_sources_pos) {
+		if(workspace.matching.isSource(random_sources[workspace.random_sources_pos])==false) {
+			root_source_cid = random_sources[workspace.random_sources_pos];
 			break;
 		}
 	}
 }
 
 //! Function to update the labeling from the current state of the slack array, and then update the slack array.
-bool updateLabelingAndSlack(const AlternatingTree &atree, SlackArray &slack, VertexLabeling &labeling)
+template<class Score>
+bool updateLabelingAndSlack(const AlternatingTree<Score> &atree, SlackArray<Score> &slack, VertexLabeling<Score> &labeling)
 {
 	// Calculate delta using the slack
-	int delta;
+	Score delta;
 	slack.simplifyMinCostSlack(delta, atree);
 	// If the global minimum cost slack is zero, then we cannot update the labeling
 	if(delta==0)
@@ -443,34 +682,38 @@ bool updateLabelingAndSlack(const AlternatingTree &atree, SlackArray &slack, Ver
 }
 
 //! Function to update the alternating tree and slack array until the queue is empty or augmenting path is found.
-bool findAugmentingPathAroundCandidatesSourceVertices(std::queue<const Vertex*> &queue_candidates_source_vertices,
-													  AlternatingTree &atree,
-													  impl::SlackArray &slack,
-													  const impl::Matching &matching,
-													  const impl::VertexLabeling &labeling)
+template<class Score, class Statistics>
+bool findAugmentingPathAroundCandidatesSourceVertices(impl::SourceVertexQueue &queue_candidates_source_vertices,
+													  AlternatingTree<Score> &atree,
+													  impl::SlackArray<Score> &slack,
+													  const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													  const impl::Matching<Score> &matching,
+													  const impl::VertexLabeling<Score> &labeling,
+													  Statistics &statistics)
 {
 	// Loop over each source vertex in the queue
 	while(!atree.isAugmentingPathFound() && !queue_candidates_source_vertices.empty()) {
-		const Vertex *source_v = queue_candidates_source_vertices.front();
-		queue_candidates_source_vertices.pop();
+		const unsigned int source_cid = queue_candidates_source_vertices.pop();
+		const Score source_label = labeling.getSourceVertexLabel(source_cid);
 		// Iterate over each edge incident to the current source vertex in the current equality subgraph
-		for(std::vector<Edge*>::const_iterator it_e=source_v->edges.begin(); it_e!=source_v->edges.end(); ++it_e) {
-			const Vertex *target_v = (*it_e)->v_target;
-			int slack_value = labeling.getSourceVertexLabel(source_v->parent->cid)+labeling.getTargetVertexLabel(target_v->parent->cid)-(*it_e)->score;
-			if(!atree.isInT(target_v->parent->cid) && slack_value==0) {
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+			const typename BasicBipartiteMatchingGraph<Score>::AdjacentEdge &edge = bmgraph.getAdjacentEdge(index);
+			const Score slack_value = source_label+labeling.getTargetVertexLabel(edge.target_cid)-edge.score;
+			statistics.addScannedEdge();
+			if(!atree.isInT(edge.target_cid) && ScoreTraits<Score>::isZero(slack_value)) {
 				// If this target vertex is exposed, we found the augmenting path !
-				if(!matching.isTarget(target_v->parent->cid)) {
-					atree.setEndExposedTargetVertex(source_v->parent->cid, target_v->parent->cid, *it_e);
+				if(!matching.isTarget(edge.target_cid)) {
+					atree.setEndExposedTargetVertex(source_cid, edge.target_cid, bmgraph.getAdjacentEdgePointer(index));
 					break;
 				}
 				// Otherwise, update the alternating tree with the edges (source_v,target_v) and (target_v,matched_v)
-				const Edge *edge_t_s2 = matching.getEdgeFromTarget(target_v->parent->cid);
+				const typename BasicBipartiteMatchingGraph<Score>::Edge *edge_t_s2 = matching.getEdgeFromTarget(edge.target_cid);
 				WPMASSERT(edge_t_s2!=NULL, "Matching structure has no edge for a matched target vertex!");
-				const Vertex *matched_v = edge_t_s2->v_source;
-				queue_candidates_source_vertices.push(matched_v);
-				atree.addTwoEdges(source_v->parent->cid, target_v->parent->cid, matched_v->parent->cid, *it_e, edge_t_s2);
-				// The source vertex matched_v has been added to S, hence update the slack array
-				slack.updateWithNewSourceVertex(*matched_v, labeling);
+				const unsigned int matched_source_cid = edge_t_s2->v_source->parent->cid;
+				queue_candidates_source_vertices.push(matched_source_cid);
+				atree.addTwoEdges(source_cid, edge.target_cid, matched_source_cid, bmgraph.getAdjacentEdgePointer(index), edge_t_s2);
+				// The matched source vertex has been added to S, hence update the slack array
+				slack.updateWithNewSourceVertex(matched_source_cid, labeling);
 			}
 		}
 	}
@@ -478,138 +721,2082 @@ bool findAugmentingPathAroundCandidatesSourceVertices(std::queue<const Vertex*>
 }
 
 //! Function to search for an exposed target vertex among the newly reachable target vertices. This is done after the vertex labeling was updated, leading to new edges in the equality subgraph.
-bool findAugmentingPathFromNewReachableTargetVertices(std::queue<const Vertex*> &queue_candidates_source_vertices,
-													  AlternatingTree &atree,
-													  impl::SlackArray &slack,
-													  const BipartiteMatchingGraph &bmgraph,
-													  const impl::Matching &matching,
-													  const impl::VertexLabeling &labeling)
+template<class Score>
+bool findAugmentingPathFromNewReachableTargetVertices(impl::SourceVertexQueue &queue_candidates_source_vertices,
+													  AlternatingTree<Score> &atree,
+													  impl::SlackArray<Score> &slack,
+													  const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													  const impl::Matching<Score> &matching,
+													  const impl::VertexLabeling<Score> &labeling)
 {
 	// Loop over all target vertices in the graph
-	std::vector<Clique>::const_iterator it_c, it_c_end;
-	bmgraph.getCliqueIterators(it_c,it_c_end);
-	for(; !atree.isAugmentingPathFound() && it_c!=it_c_end; ++it_c) {
-		const Vertex *target_v = &it_c->v_target;
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	for(unsigned int target_cid=0; !atree.isAugmentingPathFound() && target_cid<ncliques; ++target_cid) {
 		// Check if this target vertex is a newly reachable one in the equality subgraph
-		if(!atree.isInT(it_c->cid) && slack.getMinSlackValue(it_c->cid)==0) {
+		if(!atree.isInT(target_cid) && ScoreTraits<Score>::isZero(slack.getMinSlackValue(target_cid))) {
 			// If it is, retrieve the source vertex from which it is reachable and the associated edge
-			unsigned int min_slack_vertex_cid = slack.getMinSlackVertex(it_c->cid);
-			WPMASSERT(min_slack_vertex_cid!=(unsigned int)(-1), "The min slack vertex does not exist!");	// This should never happen since we checked that 'slack.getMinSlackValue(it_c->cid)==0'.
-			const Edge* edge_s1_t = slack.getMinSlackEdge(it_c->cid);
+			unsigned int min_slack_vertex_cid = slack.getMinSlackVertex(target_cid);
+			WPMASSERT(min_slack_vertex_cid!=(unsigned int)(-1), "The min slack vertex does not exist!");	// This should never happen since we checked that the min slack value is zero.
+			const typename BasicBipartiteMatchingGraph<Score>::Edge* edge_s1_t = slack.getMinSlackEdge(target_cid);
 			WPMASSERT(edge_s1_t!=NULL, "The SlackArray structure has no edge for the specified target vertex!");
 			// If the target vertex is exposed, we found the augmenting path !
-			if(!matching.isTarget(it_c->cid)) {
-				atree.setEndExposedTargetVertex(min_slack_vertex_cid, target_v->parent->cid, edge_s1_t);
+			if(!matching.isTarget(target_cid)) {
+				atree.setEndExposedTargetVertex(min_slack_vertex_cid, target_cid, edge_s1_t);
 				break;
 			}
 			// Otherwise, check if the matched source vertex is already inside the alternating tree
-			const Edge *edge_t_s2 = matching.getEdgeFromTarget(target_v->parent->cid);
+			const typename BasicBipartiteMatchingGraph<Score>::Edge *edge_t_s2 = matching.getEdgeFromTarget(target_cid);
 			WPMASSERT(edge_t_s2!=NULL, "The matching structure has no edge for a matched target vertex!");
-			const Vertex *matched_v = edge_t_s2->v_source;
-			if(!atree.isInS(matched_v->parent->cid)) {
+			const unsigned int matched_source_cid = edge_t_s2->v_source->parent->cid;
+			if(!atree.isInS(matched_source_cid)) {
 				// If it is not, add the matched source vertex to the candidates queue and update the alternating tree with the edges (source_v,target_v) and (target_v, matched_v)
-				queue_candidates_source_vertices.push(matched_v);
-				atree.addTwoEdges(min_slack_vertex_cid, target_v->parent->cid, matched_v->parent->cid, edge_s1_t, edge_t_s2);
-				slack.updateWithNewSourceVertex(*matched_v, labeling);
+				queue_candidates_source_vertices.push(matched_source_cid);
+				atree.addTwoEdges(min_slack_vertex_cid, target_cid, matched_source_cid, edge_s1_t, edge_t_s2);
+				slack.updateWithNewSourceVertex(matched_source_cid, labeling);
 			}
 			else {
 				// Otherwise, just update the alternating tree with the edges (target_v, matched_v)
-				atree.addSingleEdge(min_slack_vertex_cid, it_c->cid, edge_s1_t);
+				atree.addSingleEdge(min_slack_vertex_cid, target_cid, edge_s1_t);
 			}
 		}
 	}
 	return atree.isAugmentingPathFound();
 }
 
-//! Function to augment the specified matching by finding an augmenting path.
-bool augmentMatching(const BipartiteMatchingGraph &bmgraph, impl::Matching &matching, impl::VertexLabeling &labeling)
+//! Function to augment the current matching of the workspace by finding an augmenting path.
+template<class Score, class Statistics>
+bool augmentMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph, impl::HungarianWorkspace<Score> &workspace, Statistics &statistics)
 {
+	impl::Matching<Score> &matching = workspace.matching;
+	impl::VertexLabeling<Score> &labeling = workspace.labeling;
+	impl::AlternatingTree<Score> &atree = workspace.atree;
+	impl::SlackArray<Score> &slack = workspace.slack;
+	impl::SourceVertexQueue &queue_candidates_source_vertices = workspace.queue;
 	unsigned int ncliques = bmgraph.getNumberCliques();
 	if(matching.getNumberEdges()==ncliques)	// If the matching is perfect, it cannot be augmented.
 		return false;
 	if(VERBOSE) std::cout << " augmentMatching (|matching|=" << matching.getNumberEdges() << "):" << std::endl;
 	// Since the matching is not perfect, there is an exposed source vertex, so find it
-	const Vertex* root_exposed_source_vertex = NULL;
-	impl::findExposedSourceVertex(bmgraph, matching, root_exposed_source_vertex);
-	WPMASSERT(root_exposed_source_vertex!=NULL, "Found no exposed source vertex!");	// Since the matching is not perfect, this should never happen.
-	if(VERBOSE) std::cout << "  root_exposed_source_vertex = s" << root_exposed_source_vertex->parent->cid << std::endl;
+	unsigned int root_source_cid;
+	impl::findExposedSourceVertex(workspace, root_source_cid);
+	WPMASSERT(root_source_cid!=(unsigned int)(-1), "Found no exposed source vertex!");	// Since the matching is not perfect, this should never happen.
+	if(VERBOSE) std::cout << "  root_exposed_source_vertex = s" << root_source_cid << std::endl;
 	// Initialize the slack array and alternating tree using the root exposed source vertex
-	SlackArray slack(ncliques, *root_exposed_source_vertex, labeling);
-	AlternatingTree atree(ncliques, root_exposed_source_vertex->parent->cid);
+	slack.reset(bmgraph, root_source_cid, labeling);
+	atree.reset(ncliques, root_source_cid);
 	// Iteratively update the vertex labeling and build the alternating tree, until an augmenting path along the equality subgraph is found
-	std::queue<const Vertex*> queue_candidates_source_vertices;
-	queue_candidates_source_vertices.push(root_exposed_source_vertex);
+	queue_candidates_source_vertices.reset(ncliques);
+	queue_candidates_source_vertices.push(root_source_cid);
 	while(!atree.isAugmentingPathFound()) {
 		// Breadth-first search on the equality subgraph for the current labeling, in order to find an exposed target vertex
-		if(findAugmentingPathAroundCandidatesSourceVertices(queue_candidates_source_vertices, atree, slack, matching, labeling))
+		if(findAugmentingPathAroundCandidatesSourceVertices(queue_candidates_source_vertices, atree, slack, bmgraph, matching, labeling, statistics))
 			break;	// An augmenting path has been found!
 		// Update the labeling, or return and indicate that we failed to augment the matching
+		statistics.addLabelUpdate();
 		if(!updateLabelingAndSlack(atree, slack, labeling))
 			return false;
 		// Updating the labeling added new edges in the equality subgraph, so check them to find an augmenting path
 		WPMASSERT(queue_candidates_source_vertices.empty(), "The graph search queue is not empty!");	// We did not find an augmenting path yet, this should never happen.
+		statistics.addCliqueRescan();
 		if(findAugmentingPathFromNewReachableTargetVertices(queue_candidates_source_vertices, atree, slack, bmgraph, matching, labeling))
 			break;	// An augmenting path has been found!
 		WPMASSERT(!queue_candidates_source_vertices.empty(), "The graph search queue is empty!");
 	}
 	// An augmenting path was found, hence augment the matching
 	if(VERBOSE) std::cout << "  Augmenting path found: " << atree.serializeAugmentingPath() << std::endl;
+	statistics.addAugmentation(atree.getSetS().size()+atree.getSetT().size()+1);	// The exposed target vertex ending the path is not in T
 	atree.applyAugmentingPath(matching);
 	if(VERBOSE) std::cout << "  New matching: " << matching.serialize() << std::endl;
 	return true;
 }
 
-//! Function to iteratively augment the matching until a perfect matching is found.
-bool findPerfectMatching(const BipartiteMatchingGraph &bmgraph,
-						 std::vector<const Edge*> &matching)
+//! Function to check whether the specified previous labeling and matching can be used to warm start a search in the specified graph.
+template<class Graph, class Score>
+inline bool isWarmStartStateUsable(const Graph &bmgraph, const std::vector<Score> *warm_target_labels, const std::vector<unsigned int> *warm_source_matches)
+{
+	return (warm_target_labels!=NULL && warm_source_matches!=NULL
+		&& warm_target_labels->size()==bmgraph.getNumberCliques() && warm_source_matches->size()==bmgraph.getNumberCliques());
+}
+
+//! Function to initialize the matching with the previous matches, which are still edges of the equality subgraph for the specified labeling.
+template<class Score>
+void seedMatchingFromPreviousMatches(const BasicBipartiteMatchingGraph<Score> &bmgraph, const std::vector<unsigned int> &source_matches, const impl::VertexLabeling<Score> &labeling, impl::Matching<Score> &matching)
+{
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	for(unsigned int source_cid=0; source_cid<ncliques; ++source_cid) {
+		const unsigned int target_cid = source_matches[source_cid];
+		if(target_cid==(unsigned int)(-1) || matching.isTarget(target_cid))
+			continue;
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(source_cid); index<bmgraph.getSourceAdjacencyEnd(source_cid); ++index) {
+			const typename BasicBipartiteMatchingGraph<Score>::AdjacentEdge &edge = bmgraph.getAdjacentEdge(index);
+			if(edge.target_cid==target_cid) {
+				if(ScoreTraits<Score>::isZero(labeling.getSourceVertexLabel(source_cid)+labeling.getTargetVertexLabel(target_cid)-edge.score))
+					matching.addEdge(bmgraph.getAdjacentEdgePointer(index));
+				break;
+			}
+		}
+	}
+}
+
+/*! Function to iteratively augment the matching until a perfect matching is found, using the data structures of the
+ *  specified workspace. If a previous labeling and matching are specified, they are used as a starting point, and they
+ *  are replaced by the final ones. The edges of the perfect matching are returned in workspace.matching_edges. The
+ *  statistics policy is either NoSolverStatistics or SolverStatisticsRecorder.
+ */
+template<class Score, class Statistics>
+bool findPerfectMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+						 impl::HungarianWorkspace<Score> &workspace,
+						 RandomEngine &random_engine,
+						 Statistics &statistics,
+						 std::vector<Score> *warm_target_labels=NULL,
+						 std::vector<unsigned int> *warm_source_matches=NULL)
 {
 	if(VERBOSE) std::cout << "findPerfectMatching:" << std::endl;
-	// Initialize the Hungarian algorithm
+	impl::PhaseTimer initialization_timer(statistics.getStatistics(), &SolverStatistics::initialization_time);
+	// Initialize the Hungarian algorithm, either from scratch or from the previous labeling and matching
 	unsigned int ncliques = bmgraph.getNumberCliques();
-	impl::VertexLabeling labeling(bmgraph);	// Initialized to a trivially feasible matching
-	impl::Matching tmp_matching(ncliques);	// Initialized to an empty matching
-	for(unsigned int i=0; i<ncliques; ++i) {	// Each iteration augments the matching by one edge
-		if(!impl::augmentMatching(bmgraph, tmp_matching, labeling))
+	const bool is_warm_start = isWarmStartStateUsable(bmgraph, warm_target_labels, warm_source_matches);
+	if(is_warm_start)
+		workspace.labeling.reset(bmgraph, *warm_target_labels);
+	else workspace.labeling.reset(bmgraph);	// Initialized to a feasible labeling
+	workspace.matching.reset(ncliques);	// Initialized to an empty matching
+	if(is_warm_start)
+		impl::seedMatchingFromPreviousMatches(bmgraph, *warm_source_matches, workspace.labeling, workspace.matching);
+	// Draw the random order in which the exposed source vertices are augmented
+	workspace.random_sources.resize(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		workspace.random_sources[cid] = cid;
+	random_engine.shuffle(workspace.random_sources.begin(), workspace.random_sources.end());
+	workspace.random_sources_pos = 0;
+	initialization_timer.stop();
+	impl::PhaseTimer augmentation_timer(statistics.getStatistics(), &SolverStatistics::augmentation_time);
+	for(unsigned int i=workspace.matching.getNumberEdges(); i<ncliques; ++i) {	// Each iteration augments the matching by one edge
+		if(!impl::augmentMatching(bmgraph, workspace, statistics))
 			return false;
 	}
-	// Retrieve the set of edges in the matching
-	tmp_matching.getMatchingEdges(matching);
+	augmentation_timer.stop();
+	// Retrieve the set of edges in the matching, and memorize the final labeling and matching
+	workspace.matching.getMatchingEdges(workspace.matching_edges);
+	if(warm_target_labels!=NULL && warm_source_matches!=NULL) {
+		workspace.labeling.getTargetLabels(*warm_target_labels);
+		workspace.matching.getSourceMatches(*warm_source_matches);
+	}
 	return true;
 }
 
 
 
-}	// namespace impl
+/*! Internal structure implementing the shortest augmenting path algorithm of Jonker and Volgenant (see "A shortest
+ *  augmenting path algorithm for dense and sparse linear assignment problems", Computing 38, 1987). The matching
+ *  problem is expressed as a minimal cost assignment, with cost c(s,t)=-w(s,t), of the source vertices (rows) to the
+ *  target vertices (columns). Only column duals v(t) are stored, the row duals being implicitly defined by
+ *  u(s)=c(s,x(s))-v(x(s)) for matched source vertices. The solution is initialized by a column reduction followed by
+ *  a reduction transfer, and the remaining exposed source vertices are matched one by one along shortest augmenting
+ *  paths for the reduced costs c(s,t)-u(s)-v(t), which are computed with a Dijkstra-like search.
+ */
+template<class Score>
+class ShortestAugmentingPathSolver
+{
+public:
 
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
 
+private:
 
-/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Vertex states during the shortest augmenting path search (the locked target vertices are never reached)
+	enum ColumnState { Column_Unreached=0, Column_Todo=1, Column_Scanned=2, Column_Locked=3 };
+
+	const unsigned int _ncliques;				//!< Number of cliques in the considered graph.
+	std::vector<unsigned int> _row_offsets;		//!< Array containing, for each source vertex, the offset of its first edge in the row arrays (compressed row storage).
+	std::vector<unsigned int> _row_targets;		//!< Array containing, for each edge in the row arrays, the clique ID of the target vertex.
+	std::vector<Score> _row_costs;				//!< Array containing, for each edge in the row arrays, the cost c(s,t)=-w(s,t).
+	std::vector<const Edge*> _row_edges;		//!< Array containing, for each edge in the row arrays, the pointer to the edge in the graph.
+	std::vector<unsigned int> _col_offsets;		//!< Array containing, for each target vertex, the offset of its first edge in the column arrays (compressed column storage).
+	std::vector<unsigned int> _col_slots;		//!< Array containing, for each edge in the column arrays, the index of the same edge in the row arrays.
+	std::vector<unsigned int> _col_sources;		//!< Array containing, for each edge in the column arrays, the clique ID of the source vertex.
+	std::vector<Score> _v;						//!< Array containing the dual value of each target vertex.
+	std::vector<unsigned int> _x;				//!< Array containing, for each source vertex, the clique ID of the matched target vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _x_slot;			//!< Array containing, for each matched source vertex, the index of the matched edge in the row arrays.
+	std::vector<unsigned int> _y;				//!< Array containing, for each target vertex, the clique ID of the matched source vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _random_order;	//!< Clique IDs in random order, used to randomly select the matching among those with minimal cost.
+	bool _is_warm_started;						//!< Flag indicating whether the duals and matching were initialized from a previous solution.
+	std::vector<unsigned char> _is_excluded_slot;	//!< Array containing, for each edge in the row arrays, a flag indicating whether it is excluded from the searches (empty if no edge was ever excluded).
+	std::vector<unsigned int> _excluded_slots;	//!< Indices in the row arrays of the excluded edges.
+	std::vector<unsigned int> _locked_targets;	//!< Target vertices whose match is fixed, hence which are never reached by the searches.
+	// Workspace of the shortest augmenting path search
+	std::vector<Score> _d;						//!< Array containing, for each reached target vertex, the length of the shortest known alternating path.
+	std::vector<unsigned int> _pred;			//!< Array containing, for each reached target vertex, the clique ID of the previous source vertex along the shortest known path.
+	std::vector<unsigned int> _pred_slot;		//!< Array containing, for each reached target vertex, the index in the row arrays of the edge from the previous source vertex.
+	std::vector<unsigned char> _state;			//!< Array containing the state of each target vertex (see ColumnState).
+	std::vector<unsigned int> _todo;			//!< Reached target vertices which have not been scanned yet.
+	std::vector<unsigned int> _scanned;			//!< Scanned target vertices, whose shortest path length is final.
+	std::vector<unsigned int> _touched;			//!< Target vertices reached during the current search, to be reset afterwards.
+
+public:
 
+	//! Constructor, building the compressed row and column storages of the costs with edges in random order.
+	ShortestAugmentingPathSolver(const Graph &bmgraph, RandomEngine &random_engine)
+		: _ncliques(bmgraph.getNumberCliques())
+		, _is_warm_started(false)
+	{
+		// Draw a random order of the cliques, used both to store the edges and to process the vertices
+		std::vector<const typename Graph::Clique*> random_cliques;
+		bmgraph.getCliquesInRandomOrder(random_cliques, random_engine);
+		_random_order.resize(_ncliques);
+		for(unsigned int i=0; i<_ncliques; ++i)
+			_random_order[i] = random_cliques[i]->cid;
+		// Build the compressed row storage from the one of the graph, with the edges of each source vertex in random order
+		_row_offsets.resize(_ncliques+1, 0);
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			_row_offsets[cid+1] = bmgraph.getSourceAdjacencyEnd(cid);
+		const unsigned int nedges = _row_offsets[_ncliques];
+		std::vector<unsigned int> row_indices(nedges);
+		for(unsigned int slot=0; slot<nedges; ++slot)
+			row_indices[slot] = slot;
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			random_engine.shuffle(row_indices.begin()+_row_offsets[cid], row_indices.begin()+_row_offsets[cid+1]);
+		_row_targets.resize(nedges);
+		_row_costs.resize(nedges);
+		_row_edges.resize(nedges);
+		for(unsigned int slot=0; slot<nedges; ++slot) {
+			const typename Graph::AdjacentEdge &edge = bmgraph.getAdjacentEdge(row_indices[slot]);
+			_row_targets[slot] = edge.target_cid;
+			_row_costs[slot] = -edge.score;
+			_row_edges[slot] = bmgraph.getAdjacentEdgePointer(row_indices[slot]);
+		}
+		// Build the compressed column storage, with the source vertices of each target vertex in random order
+		_col_offsets.resize(_ncliques+1, 0);
+		for(unsigned int slot=0; slot<nedges; ++slot)
+			++_col_offsets[_row_targets[slot]+1];
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			_col_offsets[cid+1] += _col_offsets[cid];
+		_col_slots.resize(nedges);
+		_col_sources.resize(nedges);
+		std::vector<unsigned int> col_fill(_col_offsets.begin(), _col_offsets.end()-1);
+		for(std::vector<unsigned int>::const_iterator it_s=_random_order.begin(); it_s!=_random_order.end(); ++it_s) {
+			for(unsigned int slot=_row_offsets[*it_s]; slot<_row_offsets[*it_s+1]; ++slot) {
+				unsigned int &fill = col_fill[_row_targets[slot]];
+				_col_slots[fill] = slot;
+				_col_sources[fill] = *it_s;
+				++fill;
+			}
+		}
+		// Initialize the empty matching and the search workspace
+		_v.resize(_ncliques, 0);
+		_x.resize(_ncliques, (unsigned int)(-1));
+		_x_slot.resize(_ncliques, (unsigned int)(-1));
+		_y.resize(_ncliques, (unsigned int)(-1));
+		_d.resize(_ncliques, 0);
+		_pred.resize(_ncliques, (unsigned int)(-1));
+		_pred_slot.resize(_ncliques, (unsigned int)(-1));
+		_state.resize(_ncliques, Column_Unreached);
+	}
+
+	/*! Function to initialize the duals and the matching from a previous solution, instead of the column reduction.
+	 *  The previous target labels l(t) give the column duals v(t)=-l(t), and each previous match is kept if it still
+	 *  has the minimal reduced cost c(s,t)-v(t) among the edges of its source vertex, which keeps the duals feasible.
+	 */
+	void warmStart(const std::vector<Score> &target_labels, const std::vector<unsigned int> &source_matches)
+	{
+		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid)
+			_v[target_cid] = -target_labels[target_cid];
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			const unsigned int target_cid = source_matches[source_cid];
+			if(target_cid==(unsigned int)(-1) || _y[target_cid]!=(unsigned int)(-1))
+				continue;
+			unsigned int matched_slot = (unsigned int)(-1);
+			bool is_tight = true;
+			for(unsigned int slot=_row_offsets[source_cid]; slot<_row_offsets[source_cid+1]; ++slot) {
+				if(_row_targets[slot]==target_cid)
+					matched_slot = slot;
+			}
+			if(matched_slot==(unsigned int)(-1))
+				continue;	// The previously matched edge does not exist anymore
+			const Score u = _row_costs[matched_slot]-_v[target_cid];
+			for(unsigned int slot=_row_offsets[source_cid]; is_tight && slot<_row_offsets[source_cid+1]; ++slot)
+				is_tight = (_row_costs[slot]-_v[_row_targets[slot]]>=u);
+			if(is_tight)
+				_assign(source_cid, target_cid, matched_slot);
+		}
+		_is_warm_started = true;
+	}
+
+	//! Function to find a perfect matching with minimal cost, and return false if the graph has no perfect matching.
+	bool solve()
+	{
+		if(!_is_warm_started) {
+			if(!_reduceColumns())
+				return false;
+			_transferReductions();
+		}
+		for(std::vector<unsigned int>::const_iterator it_s=_random_order.begin(); it_s!=_random_order.end(); ++it_s) {
+			if(_x[*it_s]==(unsigned int)(-1) && !_augmentFromRow(*it_s))
+				return false;
+		}
+		return true;
+	}
+
+	//! Function to retrieve the set of edges in the matching.
+	void getMatchingEdges(std::vector<const Edge*> &edges) const
+	{
+		edges.clear();
+		edges.reserve(_ncliques);
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			if(_x[source_cid]!=(unsigned int)(-1))
+				edges.push_back(_row_edges[_x_slot[source_cid]]);
+		}
+	}
+
+	//! Function to retrieve the final duals, as target labels with the convention of the Hungarian algorithm, and the final matching.
+	void getWarmStartState(std::vector<Score> &target_labels, std::vector<unsigned int> &source_matches) const
+	{
+		target_labels.resize(_ncliques);
+		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid)
+			target_labels[target_cid] = -_v[target_cid];
+		source_matches = _x;
+	}
+
+	//! Function to return the cost of the perfect matching, i.e. the opposite of its score.
+	Score getMatchingCost() const
+	{
+		Score cost = 0;
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid)
+			cost += _row_costs[_x_slot[source_cid]];
+		return cost;
+	}
+
+	//! Function to retrieve the column duals and, for each source vertex, the index in the row arrays of its matched edge.
+	void getSolution(std::vector<Score> &v, std::vector<unsigned int> &x_slots) const
+	{
+		v = _v;
+		x_slots = _x_slot;
+	}
+
+	//! Function to restore a perfect matching and its column duals, retrieved from this solver by getSolution.
+	void setSolution(const std::vector<Score> &v, const std::vector<unsigned int> &x_slots)
+	{
+		_v = v;
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid)
+			_assign(source_cid, _row_targets[x_slots[source_cid]], x_slots[source_cid]);
+	}
+
+	//! Function to fix the match of the specified matched source vertex, which is not changed by the next augmentations.
+	void lockSource(unsigned int source_cid)
+	{
+		WPMASSERT(_x[source_cid]!=(unsigned int)(-1), "The source vertex is not matched!");
+		_state[_x[source_cid]] = Column_Locked;
+		_locked_targets.push_back(_x[source_cid]);
+	}
+
+	//! Function to remove the specified edge, given by its index in the row arrays, from the next augmentations.
+	void excludeEdge(unsigned int slot)
+	{
+		if(_is_excluded_slot.empty())
+			_is_excluded_slot.resize(_row_targets.size(), 0);
+		_is_excluded_slot[slot] = 1;
+		_excluded_slots.push_back(slot);
+	}
+
+	//! Function to unlock all the source vertices and restore all the excluded edges.
+	void releaseConstraints()
+	{
+		for(std::vector<unsigned int>::const_iterator it_t=_locked_targets.begin(); it_t!=_locked_targets.end(); ++it_t)
+			_state[*it_t] = Column_Unreached;
+		for(std::vector<unsigned int>::const_iterator it_slot=_excluded_slots.begin(); it_slot!=_excluded_slots.end(); ++it_slot)
+			_is_excluded_slot[*it_slot] = 0;
+		_locked_targets.clear();
+		_excluded_slots.clear();
+	}
+
+	/*! Function to compute a lower bound of the increase of the cost of the matching when the specified source vertex is
+	 *  matched again without its matched edge, under the current constraints: the minimal reduced cost c(s,t)-u(s)-v(t)
+	 *  of its other edges, since the increase is the length of a shortest augmenting path for the reduced costs. Returns
+	 *  false, with an infinite lower bound, if the source vertex has no other edge.
+	 */
+	bool getRematchLowerBound(unsigned int source_cid, Score &lower_bound) const
+	{
+		const Score u = _row_costs[_x_slot[source_cid]]-_v[_x[source_cid]];
+		lower_bound = ScoreTraits<Score>::infinity();
+		bool found = false;
+		for(unsigned int slot=_row_offsets[source_cid]; slot<_row_offsets[source_cid+1]; ++slot) {
+			if(slot==_x_slot[source_cid] || _state[_row_targets[slot]]==Column_Locked || _isExcluded(slot))
+				continue;
+			const Score reduced_cost = _row_costs[slot]-u-_v[_row_targets[slot]];
+			if(!found || reduced_cost<lower_bound) {
+				lower_bound = reduced_cost;
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	/*! Function to unmatch the specified source vertex and match it again along a shortest augmenting path, which keeps the
+	 *  matching perfect with minimal cost under the current constraints, in O(n^2) instead of the O(n^3) of a new solve.
+	 *  If a maximal increase of the cost is specified, the search stops as soon as the path would exceed it. Returns false
+	 *  if the source vertex cannot be matched again, in which case the matching is not perfect anymore.
+	 */
+	bool rematchSource(unsigned int source_cid, const Score *max_cost_increase=NULL)
+	{
+		// The path lengths of the search start from the reduced costs without u(s), hence the limit is shifted by u(s)
+		const Score u = _row_costs[_x_slot[source_cid]]-_v[_x[source_cid]];
+		_y[_x[source_cid]] = (unsigned int)(-1);
+		_x[source_cid] = (unsigned int)(-1);
+		if(max_cost_increase==NULL)
+			return _augmentFromRow(source_cid);
+		const Score max_dist = u+*max_cost_increase;
+		return _augmentFromRow(source_cid, &max_dist);
+	}
+
+	//! Function to return the clique IDs in the random order used to process the vertices.
+	inline const std::vector<unsigned int>& getRandomOrder() const { return _random_order; }
+
+private:
+
+	//! Function to match the source vertex and target vertex linked by the specified edge.
+	inline void _assign(unsigned int source_cid, unsigned int target_cid, unsigned int slot)
+	{
+		_x[source_cid] = target_cid;
+		_x_slot[source_cid] = slot;
+		_y[target_cid] = source_cid;
+	}
+
+	/*! Function implementing the column reduction, which sets each column dual to the minimal cost of the column and
+	 *  matches the column to the corresponding source vertex if it is still exposed. In case of ties, exposed source
+	 *  vertices are preferred, which directly yields a perfect matching when all costs are equal.
+	 */
+	bool _reduceColumns()
+	{
+		for(std::vector<unsigned int>::const_reverse_iterator it_t=_random_order.rbegin(); it_t!=_random_order.rend(); ++it_t) {
+			const unsigned int target_cid = *it_t;
+			unsigned int imin = (unsigned int)(-1);
+			for(unsigned int k=_col_offsets[target_cid]; k<_col_offsets[target_cid+1]; ++k) {
+				if(imin==(unsigned int)(-1)
+					|| _row_costs[_col_slots[k]]<_row_costs[_col_slots[imin]]
+					|| (_row_costs[_col_slots[k]]==_row_costs[_col_slots[imin]] && _x[_col_sources[imin]]!=(unsigned int)(-1) && _x[_col_sources[k]]==(unsigned int)(-1)))
+					imin = k;
+			}
+			if(imin==(unsigned int)(-1))
+				return false;	// This target vertex has no incident edge, hence the graph has no perfect matching
+			_v[target_cid] = _row_costs[_col_slots[imin]];
+			if(_x[_col_sources[imin]]==(unsigned int)(-1))
+				_assign(_col_sources[imin], target_cid, _col_slots[imin]);
+		}
+		return true;
+	}
+
+	/*! Function implementing the reduction transfer, which moves to each matched source vertex the minimal reduced cost
+	 *  of its other edges, by decreasing the dual of its matched target vertex. This makes more edges tight for the
+	 *  following shortest path searches, while preserving the dual feasibility.
+	 */
+	void _transferReductions()
+	{
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			const unsigned int matched_target_cid = _x[source_cid];
+			if(matched_target_cid==(unsigned int)(-1))
+				continue;
+			bool found = false;
+			Score min_reduced_cost = 0;
+			for(unsigned int slot=_row_offsets[source_cid]; slot<_row_offsets[source_cid+1]; ++slot) {
+				if(slot==_x_slot[source_cid])
+					continue;
+				Score reduced_cost = _row_costs[slot]-_v[_row_targets[slot]];
+				if(!found || reduced_cost<min_reduced_cost) {
+					min_reduced_cost = reduced_cost;
+					found = true;
+				}
+			}
+			if(found)
+				_v[matched_target_cid] -= min_reduced_cost;
+		}
+	}
+
+	//! Function to indicate whether the specified edge, given by its index in the row arrays, is excluded from the searches.
+	inline bool _isExcluded(unsigned int slot) const { return (!_is_excluded_slot.empty() && _is_excluded_slot[slot]!=0); }
+
+	//! Function to reach the specified target vertex from the specified source vertex, with the specified path length.
+	inline void _reach(unsigned int target_cid, unsigned int source_cid, unsigned int slot, Score dist)
+	{
+		if(_state[target_cid]==Column_Unreached) {
+			_state[target_cid] = Column_Todo;
+			_todo.push_back(target_cid);
+			_touched.push_back(target_cid);
+		}
+		_d[target_cid] = dist;
+		_pred[target_cid] = source_cid;
+		_pred_slot[target_cid] = slot;
+	}
+
+	/*! Function to augment the matching along a shortest augmenting path starting from the specified exposed source vertex.
+	 *  If a maximal path length is specified, returns false as soon as the shortest augmenting path is known to be longer.
+	 */
+	bool _augmentFromRow(unsigned int free_source_cid, const Score *max_dist=NULL)
+	{
+		WPMASSERT(_x[free_source_cid]==(unsigned int)(-1), "The source vertex is not exposed!");
+		_todo.clear();
+		_scanned.clear();
+		_touched.clear();
+		// Initialize the path lengths with the edges of the exposed source vertex
+		for(unsigned int slot=_row_offsets[free_source_cid]; slot<_row_offsets[free_source_cid+1]; ++slot) {
+			const unsigned int target_cid = _row_targets[slot];
+			if(_state[target_cid]==Column_Locked || _isExcluded(slot))
+				continue;
+			const Score dist = _row_costs[slot]-_v[target_cid];
+			if(_state[target_cid]==Column_Unreached || dist<_d[target_cid])
+				_reach(target_cid, free_source_cid, slot, dist);
+		}
+		// Dijkstra-like search, until an exposed target vertex is reached
+		unsigned int end_target_cid = (unsigned int)(-1);
+		Score mu = 0;
+		while(end_target_cid==(unsigned int)(-1)) {
+			if(_todo.empty()) {
+				_resetSearch();
+				return false;	// No exposed target vertex can be reached, hence the graph has no perfect matching
+			}
+			// Select the closest reached target vertex which has not been scanned yet
+			unsigned int imin = 0;
+			for(unsigned int i=1; i<_todo.size(); ++i) {
+				if(_d[_todo[i]]<_d[_todo[imin]])
+					imin = i;
+			}
+			const unsigned int target_cid = _todo[imin];
+			_todo[imin] = _todo.back();
+			_todo.pop_back();
+			mu = _d[target_cid];
+			if(max_dist!=NULL && mu>*max_dist) {
+				_resetSearch();
+				return false;
+			}
+			if(_y[target_cid]==(unsigned int)(-1)) {
+				end_target_cid = target_cid;
+				break;
+			}
+			// Scan the matched source vertex of this target vertex
+			_state[target_cid] = Column_Scanned;
+			_scanned.push_back(target_cid);
+			const unsigned int source_cid = _y[target_cid];
+			const Score u = _row_costs[_x_slot[source_cid]]-_v[target_cid];
+			for(unsigned int slot=_row_offsets[source_cid]; slot<_row_offsets[source_cid+1]; ++slot) {
+				const unsigned int next_target_cid = _row_targets[slot];
+				if(_state[next_target_cid]>=Column_Scanned || _isExcluded(slot))
+					continue;
+				const Score dist = mu+_row_costs[slot]-u-_v[next_target_cid];
+				if(_state[next_target_cid]==Column_Unreached || dist<_d[next_target_cid]) {
+					_reach(next_target_cid, source_cid, slot, dist);
+					// If an exposed target vertex is reached at the minimal distance, the shortest augmenting path is found
+					if(dist==mu && _y[next_target_cid]==(unsigned int)(-1)) {
+						end_target_cid = next_target_cid;
+						break;
+					}
+				}
+			}
+		}
+		// Update the duals of the scanned target vertices, to keep the reduced costs non-negative and the path tight
+		for(std::vector<unsigned int>::const_iterator it_t=_scanned.begin(); it_t!=_scanned.end(); ++it_t)
+			_v[*it_t] += _d[*it_t]-mu;
+		// Augment the matching along the path, from the exposed target vertex back to the exposed source vertex
+		unsigned int target_cid = end_target_cid;
+		unsigned int source_cid;
+		do {
+			source_cid = _pred[target_cid];
+			const unsigned int previous_target_cid = _x[source_cid];
+			_assign(source_cid, target_cid, _pred_slot[target_cid]);
+			target_cid = previous_target_cid;
+		} while(source_cid!=free_source_cid);
+		_resetSearch();
+		return true;
+	}
+
+	//! Function to reset the state of the target vertices reached during the last search.
+	void _resetSearch()
+	{
+		for(std::vector<unsigned int>::const_iterator it_t=_touched.begin(); it_t!=_touched.end(); ++it_t)
+			_state[*it_t] = Column_Unreached;
+	}
+};
+
+/*! Function to find a perfect matching with the shortest augmenting path engine. If a previous labeling and matching
+ *  are specified, they are used as a starting point, and they are replaced by the final ones. If statistics are
+ *  specified, the wall times of the phases are added to them.
+ */
+template<class Score>
+bool findPerfectMatchingWithShortestAugmentingPaths(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching,
+													RandomEngine &random_engine,
+													std::vector<Score> *warm_target_labels=NULL,
+													std::vector<unsigned int> *warm_source_matches=NULL,
+													SolverStatistics *statistics=NULL)
+{
+	if(VERBOSE) std::cout << "findPerfectMatchingWithShortestAugmentingPaths:" << std::endl;
+	impl::PhaseTimer initialization_timer(statistics, &SolverStatistics::initialization_time);
+	impl::ShortestAugmentingPathSolver<Score> solver(bmgraph, random_engine);
+	if(isWarmStartStateUsable(bmgraph, warm_target_labels, warm_source_matches))
+		solver.warmStart(*warm_target_labels, *warm_source_matches);
+	initialization_timer.stop();
+	impl::PhaseTimer augmentation_timer(statistics, &SolverStatistics::augmentation_time);
+	if(!solver.solve())
+		return false;
+	augmentation_timer.stop();
+	solver.getMatchingEdges(matching);
+	if(warm_target_labels!=NULL && warm_source_matches!=NULL)
+		solver.getWarmStartState(*warm_target_labels, *warm_source_matches);
+	return true;
+}
 
+//! Internal structure holding a subproblem of the ranking of the perfect matchings, with its perfect matching of minimal cost.
+template<class Score>
+struct RankingSubproblem
+{
+	Score cost;									//!< Cost of the perfect matching of the subproblem, i.e. the opposite of its score.
+	std::vector<Score> v;						//!< Column duals at the end of the solve, used to warm start the children subproblems.
+	std::vector<unsigned int> x_slots;			//!< Array containing, for each source vertex, the index in the row arrays of the matched edge.
+	std::vector<unsigned int> forced_sources;	//!< Source vertices whose matched edge is fixed in the subproblem.
+	std::vector<unsigned int> excluded_slots;	//!< Indices in the row arrays of the edges removed from the subproblem.
+};
 
-PerfectMatchingFinder::PerfectMatchingFinder()
+//! Function to compare two subproblems by decreasing cost, so that the best subproblem is at the back of a sorted vector.
+template<class Score>
+inline bool isMoreCostlySubproblem(const RankingSubproblem<Score> *subproblem1, const RankingSubproblem<Score> *subproblem2)
 {
+	return (subproblem1->cost>subproblem2->cost);
 }
 
-PerfectMatchingFinder::~PerfectMatchingFinder()
+//! Function to compare two free source vertices by increasing lower bound of the increase of cost of their child subproblem.
+template<class Score>
+inline bool hasLowerBound(const std::pair<Score, unsigned int> &source1, const std::pair<Score, unsigned int> &source2)
 {
+	return (source1.first<source2.first);
 }
 
-bool PerfectMatchingFinder::findRandomPerfectMatching(const BipartiteMatchingGraph &bmgraph,
-													  std::vector<const Edge*> &matching)
+/*! Function to find the perfect matchings with the highest scores, by decreasing score, with the partitioning of Murty
+ *  (see "An algorithm for ranking all the assignments in order of increasing cost", Operations Research 16, 1968).
+ *  Each subproblem is defined by forced and excluded edges, and its best perfect matching M is partitioned into children
+ *  subproblems, where the i-th one forces the first i-1 free edges of M and excludes the i-th one. Instead of being
+ *  solved from scratch, each child starts from the matching and the duals of its parent, which stay feasible when edges
+ *  are removed: only the source vertex of the excluded edge is exposed, and a single shortest augmenting path matches it
+ *  again in O(n^2). The subproblems are kept in a priority queue, which never holds more subproblems than the number of
+ *  matchings still to find, since the worse ones cannot be reached anymore. Once the queue is full, the children whose
+ *  lower bound of cost is not below its worst subproblem are skipped, and the searches of the others stop as soon as
+ *  their cost exceeds it, hence most children cost O(n) only.
+ */
+template<class Score>
+bool findBestPerfectMatchingsWithShortestAugmentingPaths(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+														 unsigned int nmatchings,
+														 std::vector< std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> > &matchings,
+														 RandomEngine &random_engine)
 {
-	// Find a perfect matching in the graph
-	std::vector<const Edge*> tmp_matching;
-	bool success = impl::findPerfectMatching(bmgraph, tmp_matching);
-	// Check if it is a perfect matching (a perfect matching spans all the
-	// vertices in the graph, hence the number of edges in the perfect matching
-	// is equal to the number of cliques in the bipartite graph)
-	if(!success || tmp_matching.size()<bmgraph.getNumberCliques())
+	if(VERBOSE) std::cout << "findBestPerfectMatchingsWithShortestAugmentingPaths:" << std::endl;
+	matchings.clear();
+	impl::ShortestAugmentingPathSolver<Score> solver(bmgraph, random_engine);
+	if(!solver.solve())
 		return false;
-	matching.swap(tmp_matching);
+	if(nmatchings==0)
+		return true;
+	const std::vector<unsigned int> &random_order = solver.getRandomOrder();
+	std::vector<RankingSubproblem<Score>*> queue;	// Sorted by decreasing cost
+	RankingSubproblem<Score> *root = new RankingSubproblem<Score>();
+	root->cost = solver.getMatchingCost();
+	solver.getSolution(root->v, root->x_slots);
+	queue.push_back(root);
+	std::vector<unsigned char> is_forced_source(bmgraph.getNumberCliques(), 0);
+	std::vector<unsigned int> forced_sources;
+	std::vector< std::pair<Score, unsigned int> > free_sources;	// Lower bound of the increase of cost of the child and clique ID of each free source vertex
+	while(!queue.empty() && matchings.size()<nmatchings) {
+		// The best subproblem gives the next perfect matching
+		RankingSubproblem<Score> *best = queue.back();
+		queue.pop_back();
+		solver.setSolution(best->v, best->x_slots);
+		matchings.resize(matchings.size()+1);
+		solver.getMatchingEdges(matchings.back());
+		const unsigned int nremaining = nmatchings-(unsigned int)matchings.size();
+		if(nremaining==0) {
+			delete best;
+			break;
+		}
+		// Bound the increase of cost of the child excluding the matched edge of each free source vertex, and force these
+		// edges by increasing bound, so that the most promising children are solved first and the others can be skipped
+		for(std::vector<unsigned int>::const_iterator it_f=best->forced_sources.begin(); it_f!=best->forced_sources.end(); ++it_f) {
+			solver.lockSource(*it_f);
+			is_forced_source[*it_f] = 1;
+		}
+		for(std::vector<unsigned int>::const_iterator it_slot=best->excluded_slots.begin(); it_slot!=best->excluded_slots.end(); ++it_slot)
+			solver.excludeEdge(*it_slot);
+		free_sources.clear();
+		for(std::vector<unsigned int>::const_iterator it_s=random_order.begin(); it_s!=random_order.end(); ++it_s) {
+			if(is_forced_source[*it_s])
+				continue;
+			// The lower bound stays infinite if the source vertex has no other edge, i.e. if the child has no perfect matching
+			Score lower_bound = ScoreTraits<Score>::infinity();
+			solver.getRematchLowerBound(*it_s, lower_bound);
+			free_sources.push_back(std::make_pair(lower_bound, *it_s));
+		}
+		for(std::vector<unsigned int>::const_iterator it_f=best->forced_sources.begin(); it_f!=best->forced_sources.end(); ++it_f)
+			is_forced_source[*it_f] = 0;
+		solver.releaseConstraints();
+		std::stable_sort(free_sources.begin(), free_sources.end(), hasLowerBound<Score>);
+		// Partition the rest of the subproblem, by forcing its free matched edges one after the other
+		forced_sources = best->forced_sources;
+		for(typename std::vector< std::pair<Score, unsigned int> >::const_iterator it_s=free_sources.begin(); it_s!=free_sources.end(); ++it_s) {
+			const unsigned int source_cid = it_s->second;
+			// Once the queue is full, the children whose cost cannot be lower than the worst subproblem are useless
+			const bool is_queue_full = (queue.size()>=nremaining);
+			const Score max_cost_increase = (is_queue_full ? queue.front()->cost-best->cost : 0);
+			if(is_queue_full && it_s->first>=max_cost_increase)
+				break;	// The next children have larger bounds
+			// Exclude the matched edge of this source vertex, and match it again from the solution of the parent
+			solver.setSolution(best->v, best->x_slots);
+			for(std::vector<unsigned int>::const_iterator it_f=forced_sources.begin(); it_f!=forced_sources.end(); ++it_f)
+				solver.lockSource(*it_f);
+			for(std::vector<unsigned int>::const_iterator it_slot=best->excluded_slots.begin(); it_slot!=best->excluded_slots.end(); ++it_slot)
+				solver.excludeEdge(*it_slot);
+			solver.excludeEdge(best->x_slots[source_cid]);
+			if(solver.rematchSource(source_cid, (is_queue_full ? &max_cost_increase : NULL))) {
+				const Score cost = solver.getMatchingCost();
+				if(!is_queue_full || cost<queue.front()->cost) {
+					RankingSubproblem<Score> *child = new RankingSubproblem<Score>();
+					child->cost = cost;
+					solver.getSolution(child->v, child->x_slots);
+					child->forced_sources = forced_sources;
+					child->excluded_slots = best->excluded_slots;
+					child->excluded_slots.push_back(best->x_slots[source_cid]);
+					queue.insert(std::upper_bound(queue.begin(), queue.end(), child, isMoreCostlySubproblem<Score>), child);
+					if(queue.size()>nremaining) {
+						delete queue.front();
+						queue.erase(queue.begin());
+					}
+				}
+			}
+			solver.releaseConstraints();
+			forced_sources.push_back(source_cid);
+		}
+		delete best;
+	}
+	for(typename std::vector<RankingSubproblem<Score>*>::const_iterator it_p=queue.begin(); it_p!=queue.end(); ++it_p)
+		delete *it_p;
 	return true;
 }
 
+/*! Internal structure implementing the shortest augmenting path algorithm of Jonker and Volgenant on an
+ *  ImplicitBipartiteMatchingGraph. This is the dense variant of the algorithm, where every target vertex is scanned
+ *  for each source vertex added to the shortest path tree, and where the costs of a source vertex are obtained by
+ *  scattering its explicit edges over the default cost. The memory footprint is thus O(n+e), while the running time is
+ *  the one of the dense algorithm.
+ */
+template<class Score>
+class ImplicitShortestAugmentingPathSolver
+{
+public:
+
+	typedef BasicImplicitBipartiteMatchingGraph<Score> Graph;
+
+private:
+
+	const Graph *_ibmgraph;						//!< Graph in which the perfect matching is searched.
+	unsigned int _ncliques;						//!< Number of cliques in the considered graph.
+	const Score _default_cost;					//!< Cost of the edges which are not stored explicitly in the graph.
+	std::vector<Score> _v;						//!< Array containing the dual value of each target vertex.
+	std::vector<unsigned int> _x;				//!< Array containing, for each source vertex, the clique ID of the matched target vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _y;				//!< Array containing, for each target vertex, the clique ID of the matched source vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _random_order;	//!< Clique IDs in random order, used to randomly select the matching among those with minimal cost.
+	std::vector<unsigned int> _free_rows;		//!< Exposed source vertices, in random order.
+	std::vector<unsigned int> _free_rows_pos;	//!< Array containing, for each exposed source vertex, its position in _free_rows.
+	bool _is_warm_started;						//!< Flag indicating whether the duals and matching were initialized from a previous solution.
+	// Workspace of the solver
+	std::vector<Score> _row_costs;				//!< Costs of the edges of the currently loaded source vertex.
+	std::vector<unsigned char> _row_forbidden;	//!< Flags indicating the forbidden target vertices for the currently loaded source vertex.
+	std::vector<Score> _d;						//!< Array containing, for each target vertex, the length of the shortest known alternating path.
+	std::vector<unsigned int> _pred;			//!< Array containing, for each target vertex, the clique ID of the previous source vertex along the shortest known path.
+	std::vector<unsigned int> _collist;			//!< Target vertices, partitioned into scanned ones, ones at the current minimal distance and the remaining ones.
+
+public:
+
+	//! Default constructor, initializing the solver over an empty graph.
+	ImplicitShortestAugmentingPathSolver()
+		: _ibmgraph(NULL)
+		, _ncliques(0)
+		, _default_cost(-Graph::getDefaultScore())
+		, _is_warm_started(false)
+	{
+	}
+
+	//! Function to start a new search in the specified graph, initializing the empty matching and the workspace while reusing the memory of the previous search.
+	void reset(const Graph &ibmgraph, RandomEngine &random_engine)
+	{
+		_ibmgraph = &ibmgraph;
+		_ncliques = ibmgraph.getNumberCliques();
+		_is_warm_started = false;
+		_random_order.resize(_ncliques);
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			_random_order[cid] = cid;
+		random_engine.shuffle(_random_order.begin(), _random_order.end());
+		_free_rows = _random_order;
+		_free_rows_pos.resize(_ncliques);
+		for(unsigned int i=0; i<_ncliques; ++i)
+			_free_rows_pos[_free_rows[i]] = i;
+		_v.assign(_ncliques, 0);
+		_x.assign(_ncliques, (unsigned int)(-1));
+		_y.assign(_ncliques, (unsigned int)(-1));
+		_row_costs.assign(_ncliques, _default_cost);
+		_row_forbidden.assign(_ncliques, 0);
+		_d.assign(_ncliques, 0);
+		_pred.assign(_ncliques, (unsigned int)(-1));
+		_collist.resize(_ncliques);
+	}
+
+	//! Function to initialize the duals and the matching from a previous solution, instead of the column reduction.
+	void warmStart(const std::vector<Score> &target_labels, const std::vector<unsigned int> &source_matches)
+	{
+		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid)
+			_v[target_cid] = -target_labels[target_cid];
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			const unsigned int target_cid = source_matches[source_cid];
+			if(target_cid==(unsigned int)(-1) || _y[target_cid]!=(unsigned int)(-1))
+				continue;
+			// Keep the previous match if it still has the minimal reduced cost among the edges of its source vertex
+			_loadRow(source_cid);
+			bool is_tight = !_row_forbidden[target_cid];
+			const Score u = _row_costs[target_cid]-_v[target_cid];
+			for(unsigned int cid=0; is_tight && cid<_ncliques; ++cid)
+				is_tight = (_row_forbidden[cid] || _row_costs[cid]-_v[cid]>=u);
+			_unloadRow(source_cid);
+			if(is_tight)
+				_assign(source_cid, target_cid);
+		}
+		_is_warm_started = true;
+	}
+
+	//! Function to find a perfect matching with minimal cost, and return false if the graph has no perfect matching.
+	bool solve()
+	{
+		if(!_is_warm_started) {
+			if(!_reduceColumns())
+				return false;
+			_transferReductions();
+		}
+		for(std::vector<unsigned int>::const_iterator it_s=_random_order.begin(); it_s!=_random_order.end(); ++it_s) {
+			if(_x[*it_s]==(unsigned int)(-1) && !_augmentFromRow(*it_s))
+				return false;
+		}
+		return true;
+	}
+
+	//! Function to retrieve the matching, as the clique ID of the matched target vertex for each source vertex.
+	void getGenericMatching(std::vector<unsigned int> &matching) const
+	{
+		matching = _x;
+	}
+
+	//! Function to retrieve the final duals, as target labels with the convention of the Hungarian algorithm, and the final matching.
+	void getWarmStartState(std::vector<Score> &target_labels, std::vector<unsigned int> &source_matches) const
+	{
+		target_labels.resize(_ncliques);
+		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid)
+			target_labels[target_cid] = -_v[target_cid];
+		source_matches = _x;
+	}
+
+private:
+
+	//! Function to match the specified source and target vertices.
+	inline void _assign(unsigned int source_cid, unsigned int target_cid)
+	{
+		if(_x[source_cid]==(unsigned int)(-1)) {
+			// Remove the source vertex from the exposed ones
+			unsigned int pos = _free_rows_pos[source_cid];
+			_free_rows[pos] = _free_rows.back();
+			_free_rows_pos[_free_rows[pos]] = pos;
+			_free_rows.pop_back();
+		}
+		_x[source_cid] = target_cid;
+		_y[target_cid] = source_cid;
+	}
+
+	//! Function to scatter the explicit edges of a source vertex into the row workspace.
+	void _loadRow(unsigned int source_cid)
+	{
+		const unsigned int* targets;
+		const Score* scores;
+		unsigned int nedges;
+		_ibmgraph->getSourceExplicitEdges(source_cid, targets, scores, nedges);
+		for(unsigned int e=0; e<nedges; ++e) {
+			if(ScoreTraits<Score>::isForbidden(scores[e]))
+				_row_forbidden[targets[e]] = 1;
+			else _row_costs[targets[e]] = -scores[e];
+		}
+		_row_forbidden[source_cid] = 1;
+	}
+
+	//! Function to restore the row workspace after a source vertex was loaded.
+	void _unloadRow(unsigned int source_cid)
+	{
+		const unsigned int* targets;
+		const Score* scores;
+		unsigned int nedges;
+		_ibmgraph->getSourceExplicitEdges(source_cid, targets, scores, nedges);
+		for(unsigned int e=0; e<nedges; ++e) {
+			_row_forbidden[targets[e]] = 0;
+			_row_costs[targets[e]] = _default_cost;
+		}
+		_row_forbidden[source_cid] = 0;
+	}
+
+	/*! Function implementing the column reduction, which sets each column dual to the minimal cost of the column and
+	 *  matches the column to the corresponding source vertex if it is still exposed, preferring exposed source
+	 *  vertices in case of ties.
+	 */
+	bool _reduceColumns()
+	{
+		for(std::vector<unsigned int>::const_reverse_iterator it_t=_random_order.rbegin(); it_t!=_random_order.rend(); ++it_t) {
+			const unsigned int target_cid = *it_t;
+			const unsigned int* sources;
+			const Score* scores;
+			unsigned int nedges;
+			_ibmgraph->getTargetExplicitEdges(target_cid, sources, scores, nedges);
+			// Find the minimal explicit cost
+			unsigned int emin = (unsigned int)(-1);
+			for(unsigned int e=0; e<nedges; ++e) {
+				if(ScoreTraits<Score>::isForbidden(scores[e]))
+					continue;
+				if(emin==(unsigned int)(-1) || scores[e]>scores[emin] || (scores[e]==scores[emin] && _x[sources[emin]]!=(unsigned int)(-1) && _x[sources[e]]==(unsigned int)(-1)))
+					emin = e;
+			}
+			// Compare it with the default cost, which applies to all source vertices without explicit edge except the one of the same clique
+			const bool has_default = (nedges+1<_ncliques);
+			if(emin==(unsigned int)(-1) && !has_default)
+				return false;	// This target vertex cannot be matched, hence the graph has no perfect matching
+			if(has_default && (emin==(unsigned int)(-1) || _default_cost<-scores[emin] || (_default_cost==-scores[emin] && _x[sources[emin]]!=(unsigned int)(-1)))) {
+				_v[target_cid] = _default_cost;
+				// Look for an exposed source vertex with the default cost, i.e. without explicit edge towards this target vertex
+				for(unsigned int e=0; e<nedges; ++e)
+					_row_forbidden[sources[e]] = 1;
+				_row_forbidden[target_cid] = 1;
+				for(std::vector<unsigned int>::const_iterator it_s=_free_rows.begin(); it_s!=_free_rows.end(); ++it_s) {
+					if(!_row_forbidden[*it_s]) {
+						_assign(*it_s, target_cid);
+						break;
+					}
+				}
+				for(unsigned int e=0; e<nedges; ++e)
+					_row_forbidden[sources[e]] = 0;
+				_row_forbidden[target_cid] = 0;
+			}
+			else {
+				_v[target_cid] = -scores[emin];
+				if(_x[sources[emin]]==(unsigned int)(-1))
+					_assign(sources[emin], target_cid);
+			}
+		}
+		return true;
+	}
+
+	//! Function implementing the reduction transfer from each matched source vertex to its matched target vertex.
+	void _transferReductions()
+	{
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			const unsigned int matched_target_cid = _x[source_cid];
+			if(matched_target_cid==(unsigned int)(-1))
+				continue;
+			_loadRow(source_cid);
+			bool found = false;
+			Score min_reduced_cost = 0;
+			for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid) {
+				if(target_cid==matched_target_cid || _row_forbidden[target_cid])
+					continue;
+				Score reduced_cost = _row_costs[target_cid]-_v[target_cid];
+				if(!found || reduced_cost<min_reduced_cost) {
+					min_reduced_cost = reduced_cost;
+					found = true;
+				}
+			}
+			_unloadRow(source_cid);
+			if(found)
+				_v[matched_target_cid] -= min_reduced_cost;
+		}
+	}
+
+	//! Function to augment the matching along a shortest augmenting path starting from the specified exposed source vertex.
+	bool _augmentFromRow(unsigned int free_source_cid)
+	{
+		const Score inf = ScoreTraits<Score>::infinity();
+		// Initialize the path lengths with the edges of the exposed source vertex
+		_loadRow(free_source_cid);
+		for(unsigned int target_cid=0; target_cid<_ncliques; ++target_cid) {
+			_collist[target_cid] = target_cid;
+			_d[target_cid] = (_row_forbidden[target_cid] ? inf : _row_costs[target_cid]-_v[target_cid]);
+			_pred[target_cid] = free_source_cid;
+		}
+		_unloadRow(free_source_cid);
+		// Dijkstra-like search, where _collist[0,low) are the scanned target vertices, _collist[low,up) the ones at the
+		// current minimal distance which are still to be scanned, and _collist[up,n) the remaining ones
+		unsigned int low = 0, up = 0, last = 0;
+		unsigned int end_target_cid = (unsigned int)(-1);
+		Score mu = 0;
+		do {
+			if(up==low) {
+				// Collect the target vertices at the new minimal distance
+				last = low;
+				mu = _d[_collist[up++]];
+				for(unsigned int k=up; k<_ncliques; ++k) {
+					const unsigned int target_cid = _collist[k];
+					const Score h = _d[target_cid];
+					if(h<=mu) {
+						if(h<mu) {
+							up = low;
+							mu = h;
+						}
+						_collist[k] = _collist[up];
+						_collist[up++] = target_cid;
+					}
+				}
+				if(mu==inf)
+					return false;	// No exposed target vertex can be reached, hence the graph has no perfect matching
+				for(unsigned int k=low; k<up; ++k) {
+					if(_y[_collist[k]]==(unsigned int)(-1)) {
+						end_target_cid = _collist[k];
+						break;
+					}
+				}
+			}
+			if(end_target_cid==(unsigned int)(-1)) {
+				// Scan the matched source vertex of the next target vertex at the minimal distance
+				const unsigned int scanned_target_cid = _collist[low++];
+				const unsigned int source_cid = _y[scanned_target_cid];
+				_loadRow(source_cid);
+				const Score h = _row_costs[scanned_target_cid]-_v[scanned_target_cid]-mu;
+				for(unsigned int k=up; k<_ncliques; ++k) {
+					const unsigned int target_cid = _collist[k];
+					if(_row_forbidden[target_cid])
+						continue;
+					const Score dist = _row_costs[target_cid]-_v[target_cid]-h;
+					if(dist<_d[target_cid]) {
+						_d[target_cid] = dist;
+						_pred[target_cid] = source_cid;
+						if(dist==mu) {
+							if(_y[target_cid]==(unsigned int)(-1)) {
+								end_target_cid = target_cid;
+								break;
+							}
+							_collist[k] = _collist[up];
+							_collist[up++] = target_cid;
+						}
+					}
+				}
+				_unloadRow(source_cid);
+			}
+		} while(end_target_cid==(unsigned int)(-1));
+		// Update the duals of the scanned target vertices
+		for(unsigned int k=0; k<last; ++k)
+			_v[_collist[k]] += _d[_collist[k]]-mu;
+		// Augment the matching along the path, from the exposed target vertex back to the exposed source vertex
+		unsigned int target_cid = end_target_cid;
+		unsigned int source_cid;
+		do {
+			source_cid = _pred[target_cid];
+			const unsigned int previous_target_cid = _x[source_cid];
+			_assign(source_cid, target_cid);
+			target_cid = previous_target_cid;
+		} while(source_cid!=free_source_cid);
+		return true;
+	}
+};
+
+/*! Function to find a perfect matching in an ImplicitBipartiteMatchingGraph with the shortest augmenting path engine,
+ *  using the data structures of the specified solver. If a previous labeling and matching are specified, they are used
+ *  as a starting point, and they are replaced by the final ones. If statistics are specified, the wall times of the
+ *  phases are added to them.
+ */
+template<class Score>
+bool findPerfectMatchingWithShortestAugmentingPaths(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph,
+													impl::ImplicitShortestAugmentingPathSolver<Score> &solver,
+													std::vector<unsigned int> &matching,
+													RandomEngine &random_engine,
+													std::vector<Score> *warm_target_labels=NULL,
+													std::vector<unsigned int> *warm_source_matches=NULL,
+													SolverStatistics *statistics=NULL)
+{
+	if(VERBOSE) std::cout << "findPerfectMatchingWithShortestAugmentingPaths (implicit graph):" << std::endl;
+	impl::PhaseTimer initialization_timer(statistics, &SolverStatistics::initialization_time);
+	solver.reset(ibmgraph, random_engine);
+	if(warm_target_labels!=NULL && warm_source_matches!=NULL
+		&& warm_target_labels->size()==ibmgraph.getNumberCliques() && warm_source_matches->size()==ibmgraph.getNumberCliques())
+		solver.warmStart(*warm_target_labels, *warm_source_matches);
+	initialization_timer.stop();
+	impl::PhaseTimer augmentation_timer(statistics, &SolverStatistics::augmentation_time);
+	if(!solver.solve())
+		return false;
+	augmentation_timer.stop();
+	solver.getGenericMatching(matching);
+	if(warm_target_labels!=NULL && warm_source_matches!=NULL)
+		solver.getWarmStartState(*warm_target_labels, *warm_source_matches);
+	return true;
+}
+
+//! Minimal number of bidders per thread for a bidding round to be split among several threads.
+const unsigned int AUCTION_MIN_BIDDERS_PER_THREAD = 512;
+//! Factor by which epsilon is divided between two successive phases of the auction algorithm.
+const long long AUCTION_EPSILON_SCALING_FACTOR = 4;
+//! Bound on the prices of the auction algorithm, leaving a margin for the bids.
+const long long AUCTION_MAX_PRICE = std::numeric_limits<long long>::max()/8;
+
+/*! Internal structure implementing the forward auction algorithm of Bertsekas with epsilon-scaling.
+ *  The source vertices are the bidders and the target vertices are the objects, with the benefit of the edge (s,t)
+ *  given by a(s,t)=(n+1)*w(s,t). Each phase starts from an empty matching and the prices of the previous phase, and
+ *  runs Jacobi bidding rounds until the matching is perfect: all the exposed source vertices compute their bid
+ *  simultaneously from the same prices, then each target vertex is assigned to its highest bidder. Both steps are split
+ *  into contiguous chunks of bidders, run on a thread pool owned by the solver for the whole solve: the highest bidder
+ *  of each target vertex is selected with an atomic maximum while bidding (the first bidder in case of ties), and each
+ *  chunk then assigns the target vertices won by its bidders, which are disjoint. The bidders of the next round are
+ *  gathered in the order of the bidders, hence the matching does not depend on the number of threads. Since the
+ *  benefits are integer multiples of n+1, the last phase with epsilon=1 gives a matching with maximal score. If the
+ *  graph has a perfect matching, following an alternating path to a target vertex without bid shows that the prices
+ *  never exceed the maximal price at the beginning of the phase plus n*(C+epsilon), where C is the benefit range.
+ *  Otherwise, the prices of the neighbours of a Hall violator grow unboundedly, hence the graph is declared without
+ *  perfect matching as soon as a price exceeds this bound.
+ *  The benefits are computed on 64-bit integers, hence the solver only applies to the graphs with integer scores which
+ *  are small enough (see isAuctionApplicable).
+ */
+template<class Score>
+class AuctionSolver
+{
+public:
+
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+
+private:
+
+	const unsigned int _ncliques;				//!< Number of cliques in the considered graph.
+	const unsigned int _nthreads;				//!< Maximal number of threads used for the bidding rounds.
+	std::vector<unsigned int> _row_offsets;		//!< Array containing, for each source vertex, the offset of its first edge in the row arrays (compressed row storage).
+	std::vector<unsigned int> _row_targets;		//!< Array containing, for each edge in the row arrays, the clique ID of the target vertex.
+	std::vector<long long> _row_benefits;		//!< Array containing, for each edge in the row arrays, the benefit a(s,t)=(n+1)*w(s,t).
+	std::vector<const Edge*> _row_edges;		//!< Array containing, for each edge in the row arrays, the pointer to the edge in the graph.
+	long long _benefit_range;					//!< Difference between the maximal and the minimal benefit.
+	std::vector<long long> _prices;				//!< Array containing the price of each target vertex.
+	std::vector<unsigned int> _x_slot;			//!< Array containing, for each matched source vertex, the index of the matched edge in the row arrays, and -1 otherwise.
+	std::vector<unsigned int> _y;				//!< Array containing, for each target vertex, the clique ID of the matched source vertex if it exists and -1 otherwise.
+	std::vector<unsigned int> _random_order;	//!< Clique IDs in random order, used to randomly select the matching among those with maximal score.
+	// Workspace of the bidding rounds
+	std::vector<unsigned int> _bidders;			//!< Exposed source vertices bidding in the current round.
+	std::vector<unsigned int> _bid_slots;		//!< Array containing, for each bidder of the current round, the index in the row arrays of the edge to the target vertex it bids for.
+	std::vector<long long> _bid_prices;			//!< Array containing, for each bidder of the current round, its bid.
+	std::unique_ptr<std::atomic<unsigned long long>[]> _best_bids;	//!< Array containing, for each target vertex, the round (high 32 bits) and the index (low 32 bits) of its highest bidder in that round.
+	unsigned int _round;						//!< Index of the current bidding round, by which the outdated highest bidders are recognized.
+	std::vector< std::vector<unsigned int> > _chunk_next_bidders;	//!< Array containing, for each chunk of bidders, the source vertices which bid again in the next round.
+	std::vector<unsigned char> _chunk_diverged;	//!< Array containing, for each chunk of bidders, a flag indicating whether one of its winning bids exceeded the bound on the prices.
+	std::unique_ptr<ThreadPool> _pool;			//!< Thread pool running the chunks of bidders, started once for the whole solve if several threads are used.
+
+public:
+
+	//! Constructor, building the compressed row storage of the benefits with edges in random order.
+	AuctionSolver(const Graph &bmgraph, unsigned int nthreads, RandomEngine &random_engine)
+		: _ncliques(bmgraph.getNumberCliques())
+		, _nthreads(std::max(nthreads, 1u))
+		, _benefit_range(0)
+	{
+		// Draw a random order of the cliques, used both to store the edges and to process the vertices
+		std::vector<const typename Graph::Clique*> random_cliques;
+		bmgraph.getCliquesInRandomOrder(random_cliques, random_engine);
+		_random_order.resize(_ncliques);
+		for(unsigned int i=0; i<_ncliques; ++i)
+			_random_order[i] = random_cliques[i]->cid;
+		// Build the compressed row storage from the one of the graph, with the edges of each source vertex in random order
+		_row_offsets.resize(_ncliques+1, 0);
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			_row_offsets[cid+1] = bmgraph.getSourceAdjacencyEnd(cid);
+		const unsigned int nedges = _row_offsets[_ncliques];
+		std::vector<unsigned int> row_indices(nedges);
+		for(unsigned int slot=0; slot<nedges; ++slot)
+			row_indices[slot] = slot;
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			random_engine.shuffle(row_indices.begin()+_row_offsets[cid], row_indices.begin()+_row_offsets[cid+1]);
+		_row_targets.resize(nedges);
+		_row_benefits.resize(nedges);
+		_row_edges.resize(nedges);
+		long long min_benefit = std::numeric_limits<long long>::max();
+		long long max_benefit = std::numeric_limits<long long>::min();
+		for(unsigned int slot=0; slot<nedges; ++slot) {
+			const typename Graph::AdjacentEdge &edge = bmgraph.getAdjacentEdge(row_indices[slot]);
+			_row_targets[slot] = edge.target_cid;
+			_row_benefits[slot] = (long long)(_ncliques+1)*(long long)edge.score;
+			_row_edges[slot] = bmgraph.getAdjacentEdgePointer(row_indices[slot]);
+			min_benefit = std::min(min_benefit, _row_benefits[slot]);
+			max_benefit = std::max(max_benefit, _row_benefits[slot]);
+		}
+		if(nedges>0)
+			_benefit_range = max_benefit-min_benefit;
+		// Initialize the prices, the empty matching and the workspace
+		_prices.resize(_ncliques, 0);
+		_x_slot.resize(_ncliques, (unsigned int)(-1));
+		_y.resize(_ncliques, (unsigned int)(-1));
+		_bid_slots.reserve(_ncliques);
+		_bid_prices.reserve(_ncliques);
+		_best_bids.reset(new std::atomic<unsigned long long>[_ncliques]);
+		for(unsigned int cid=0; cid<_ncliques; ++cid)
+			_best_bids[cid].store(0, std::memory_order_relaxed);
+		_round = 0;
+		const unsigned int max_nchunks = _getNumberChunks(_ncliques);
+		_chunk_next_bidders.resize(max_nchunks);
+		_chunk_diverged.resize(max_nchunks, 0);
+		if(max_nchunks>1)
+			_pool.reset(new ThreadPool(max_nchunks));
+	}
+
+	//! Function to find a perfect matching with maximal score, and return false if the graph has no perfect matching.
+	bool solve()
+	{
+		for(unsigned int cid=0; cid<_ncliques; ++cid) {
+			if(_row_offsets[cid]==_row_offsets[cid+1])
+				return false;	// This source vertex cannot be matched
+		}
+		long long epsilon = std::max(_benefit_range/AUCTION_EPSILON_SCALING_FACTOR, 1LL);
+		while(true) {
+			if(!_runPhase(epsilon))
+				return false;
+			if(epsilon==1)
+				return true;
+			epsilon = std::max(epsilon/AUCTION_EPSILON_SCALING_FACTOR, 1LL);
+		}
+	}
+
+	//! Function to retrieve the set of edges in the matching.
+	void getMatchingEdges(std::vector<const Edge*> &edges) const
+	{
+		edges.clear();
+		edges.reserve(_ncliques);
+		for(unsigned int source_cid=0; source_cid<_ncliques; ++source_cid) {
+			if(_x_slot[source_cid]!=(unsigned int)(-1))
+				edges.push_back(_row_edges[_x_slot[source_cid]]);
+		}
+	}
+
+private:
+
+	//! Function to run the bidding rounds of one phase, from an empty matching until the matching is perfect.
+	bool _runPhase(long long epsilon)
+	{
+		std::fill(_x_slot.begin(), _x_slot.end(), (unsigned int)(-1));
+		std::fill(_y.begin(), _y.end(), (unsigned int)(-1));
+		// Compute the bound on the prices, saturated to avoid overflows with huge scores
+		const long long max_price = *std::max_element(_prices.begin(), _prices.end());
+		const long long max_margin = std::numeric_limits<long long>::max()/4;
+		const long long price_step = std::min(_benefit_range+epsilon, max_margin);
+		const long long price_margin = (price_step>max_margin/(long long)(_ncliques+1) ? max_margin : (long long)(_ncliques+1)*price_step);
+		const long long price_limit = (max_price>max_margin ? max_price : max_price+price_margin);
+		_bidders = _random_order;
+		while(!_bidders.empty()) {
+			// Compute the bids and select the highest bidder of each target vertex, then assign the target vertices to them
+			const unsigned int nbidders = _bidders.size();
+			const unsigned int nchunks = _getNumberChunks(nbidders);
+			_bid_slots.resize(nbidders);
+			_bid_prices.resize(nbidders);
+			++_round;
+			_runChunks(nchunks, [&](unsigned int begin, unsigned int end, unsigned int) { _computeBidsInRange(begin, end, epsilon); });
+			_runChunks(nchunks, [&](unsigned int begin, unsigned int end, unsigned int chunk) { _assignTargetsInRange(begin, end, chunk, price_limit); });
+			// Gather the bidders of the next round, chunk after chunk (a copy of at most n indices, negligible against the bids)
+			unsigned int nnext_bidders = 0;
+			for(unsigned int chunk=0; chunk<nchunks; ++chunk) {
+				if(_chunk_diverged[chunk]!=0)
+					return false;	// The prices diverge, hence there is no perfect matching
+				nnext_bidders += _chunk_next_bidders[chunk].size();
+			}
+			if(nchunks==1)
+				_bidders.swap(_chunk_next_bidders[0]);
+			else {
+				_bidders.resize(nnext_bidders);
+				std::vector<unsigned int>::iterator it_next = _bidders.begin();
+				for(unsigned int chunk=0; chunk<nchunks; ++chunk)
+					it_next = std::copy(_chunk_next_bidders[chunk].begin(), _chunk_next_bidders[chunk].end(), it_next);
+			}
+		}
+		return true;
+	}
+
+	//! Function to return the number of chunks into which the specified number of bidders is split.
+	inline unsigned int _getNumberChunks(unsigned int nbidders) const
+	{
+		return std::max(std::min(_nthreads, nbidders/AUCTION_MIN_BIDDERS_PER_THREAD), 1u);
+	}
+
+	//! Function to run the specified function on each of the specified number of contiguous chunks of the bidders, on the thread pool if there are several chunks.
+	template<class ChunkFunction>
+	void _runChunks(unsigned int nchunks, const ChunkFunction &function)
+	{
+		const unsigned long long nbidders = _bidders.size();
+		if(nchunks==1) {
+			function(0, (unsigned int)nbidders, 0);
+			return;
+		}
+		_pool->run(nchunks, [&](unsigned int chunk, unsigned int) {
+			function((unsigned int)((chunk*nbidders)/nchunks), (unsigned int)(((chunk+1)*nbidders)/nchunks), chunk);
+		});
+	}
+
+	//! Function to indicate whether the bid of the first specified bidder beats the one of the second specified bidder (the first one wins the ties).
+	inline bool _isBetterBid(unsigned int i, unsigned int j) const
+	{
+		return (_bid_prices[i]>_bid_prices[j] || (_bid_prices[i]==_bid_prices[j] && i<j));
+	}
+
+	/*! Function to assign the target vertices won by the bidders in the specified range to them, raise their prices, and gather
+	 *  the losers and the evicted source vertices in the next bidders of the chunk, in the order of the bidders. Since each target
+	 *  vertex has a single winner and each evicted source vertex a single target vertex, the chunks write disjoint entries.
+	 */
+	void _assignTargetsInRange(unsigned int begin, unsigned int end, unsigned int chunk, long long price_limit)
+	{
+		std::vector<unsigned int> &next_bidders = _chunk_next_bidders[chunk];
+		next_bidders.clear();
+		_chunk_diverged[chunk] = 0;
+		for(unsigned int i=begin; i<end; ++i) {
+			const unsigned int target_cid = _row_targets[_bid_slots[i]];
+			if((unsigned int)_best_bids[target_cid].load(std::memory_order_relaxed)!=i) {
+				next_bidders.push_back(_bidders[i]);
+				continue;
+			}
+			if(_bid_prices[i]>price_limit) {
+				_chunk_diverged[chunk] = 1;
+				return;
+			}
+			_prices[target_cid] = _bid_prices[i];
+			if(_y[target_cid]!=(unsigned int)(-1)) {
+				_x_slot[_y[target_cid]] = (unsigned int)(-1);
+				next_bidders.push_back(_y[target_cid]);
+			}
+			_y[target_cid] = _bidders[i];
+			_x_slot[_bidders[i]] = _bid_slots[i];
+		}
+	}
+
+	/*! Function to compute the bids of the bidders in the specified range. Each bidder bids for the target vertex with the
+	 *  best value a(s,t)-p(t), and raises its price by the difference with the second best value plus epsilon, where this
+	 *  difference is capped at C. Any such bid preserves epsilon-complementary slackness, and the cap bounds the prices
+	 *  of a feasible problem. Only the workspace entries of the range are written, and the highest bidder of each target
+	 *  vertex is raised with a compare-and-swap loop, so that the ranges can be processed concurrently.
+	 */
+	void _computeBidsInRange(unsigned int begin, unsigned int end, long long epsilon)
+	{
+		for(unsigned int i=begin; i<end; ++i) {
+			const unsigned int source_cid = _bidders[i];
+			unsigned int best_slot = _row_offsets[source_cid];
+			long long best_value = _row_benefits[best_slot]-_prices[_row_targets[best_slot]];
+			long long second_value = std::numeric_limits<long long>::min();
+			for(unsigned int slot=best_slot+1; slot<_row_offsets[source_cid+1]; ++slot) {
+				const long long value = _row_benefits[slot]-_prices[_row_targets[slot]];
+				if(value>best_value) {
+					second_value = best_value;
+					best_value = value;
+					best_slot = slot;
+				}
+				else if(value>second_value)
+					second_value = value;
+			}
+			const long long increment = (second_value==std::numeric_limits<long long>::min() ? _benefit_range : std::min(best_value-second_value, _benefit_range));
+			_bid_slots[i] = best_slot;
+			_bid_prices[i] = _prices[_row_targets[best_slot]]+increment+epsilon;
+			// The price of the bid is written before the release of the compare-and-swap, hence it is visible to the other bidders
+			std::atomic<unsigned long long> &best_bid = _best_bids[_row_targets[best_slot]];
+			const unsigned long long stamped_bid = (((unsigned long long)_round)<<32)|i;
+			unsigned long long current_bid = best_bid.load(std::memory_order_acquire);
+			while((unsigned int)(current_bid>>32)!=_round || _isBetterBid(i, (unsigned int)current_bid)) {
+				if(best_bid.compare_exchange_weak(current_bid, stamped_bid, std::memory_order_acq_rel, std::memory_order_acquire))
+					break;
+			}
+		}
+	}
+};
+
+/*! Function to indicate whether the auction engine applies to a graph, whose scores must be integers small enough for the
+ *  prices, which may reach n times the benefit range of 2(n+1)|w|, not to overflow.
+ */
+template<class Score>
+bool isAuctionApplicable(const BasicBipartiteMatchingGraph<Score> &bmgraph)
+{
+	if(!ScoreTraits<Score>::is_integer)
+		return false;
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	const long long max_abs_score = AUCTION_MAX_PRICE/((long long)ncliques+1)/((long long)ncliques+1);
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(cid); index<bmgraph.getSourceAdjacencyEnd(cid); ++index) {
+			const long long score = (long long)bmgraph.getAdjacentEdge(index).score;
+			if(score>max_abs_score || score<-max_abs_score)
+				return false;
+		}
+	}
+	return true;
+}
+
+//! Function to find a perfect matching with the auction engine. If statistics are specified, the wall times of the phases are added to them.
+template<class Score>
+bool findPerfectMatchingWithAuction(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+									std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching,
+									unsigned int nthreads,
+									RandomEngine &random_engine,
+									SolverStatistics *statistics=NULL)
+{
+	if(VERBOSE) std::cout << "findPerfectMatchingWithAuction:" << std::endl;
+	impl::PhaseTimer initialization_timer(statistics, &SolverStatistics::initialization_time);
+	impl::AuctionSolver<Score> solver(bmgraph, nthreads, random_engine);
+	initialization_timer.stop();
+	impl::PhaseTimer augmentation_timer(statistics, &SolverStatistics::augmentation_time);
+	if(!solver.solve())
+		return false;
+	augmentation_timer.stop();
+	solver.getMatchingEdges(matching);
+	return true;
+}
+
+
+
+//! Maximal number of vertices of the graphs solved by a SmallPerfectMatchingFinder with the smallest arrays.
+const unsigned int TINY_GRAPH_MAX_NVERTICES = 16;
+//! Maximal number of vertices of the graphs solved by a SmallPerfectMatchingFinder (one bit per vertex in a 64-bit mask).
+const unsigned int SMALL_GRAPH_MAX_NVERTICES = 64;
+//! Number of vertices from which the graph is converted into an ImplicitBipartiteMatchingGraph, whose size does not grow quadratically.
+const unsigned int IMPLICIT_GRAPH_MIN_NVERTICES = 1000;
+
+//! Function to load a NonMatchingGraph into a SmallPerfectMatchingFinder, with the same cost to score conversion as the MatchingGraphConverter.
+template<unsigned int MAX_NCLIQUES, class Score>
+void toSmallPerfectMatchingFinder(const NonMatchingGraph &nmgraph, SmallPerfectMatchingFinder<MAX_NCLIQUES, Score> &small_pmfinder)
+{
+	small_pmfinder.startNewGraph(nmgraph.getNumberVertices());
+	std::vector<NonMatchingGraph::Vertex>::const_iterator it_nmv, it_nmv_end;
+	nmgraph.getVertexIterators(it_nmv, it_nmv_end);
+	for(; it_nmv!=it_nmv_end; ++it_nmv) {
+		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=it_nmv->getConstraints().begin(); it_e!=it_nmv->getConstraints().end(); ++it_e) {
+			if(!nmgraph.isConstraintExpired(*it_e))
+				small_pmfinder.setDirectedEdgeScore(it_nmv->id, it_e->v_target->id, ScoreTraits<Score>::fromCost(nmgraph.getConstraintCost(*it_e)));
+		}
+	}
+}
+
+//! Function to return the root of the set of the specified clique in a union-find forest, halving the path on the way.
+inline unsigned int findComponentRoot(std::vector<unsigned int> &parents, unsigned int cid)
+{
+	while(parents[cid]!=cid) {
+		parents[cid] = parents[parents[cid]];
+		cid = parents[cid];
+	}
+	return cid;
+}
+
+/*! Function to compute the connected components of the cliques of a graph, where the cliques are connected by the edges
+ *  between their vertices, and return their number. Since an edge never links two components, a perfect matching of the
+ *  graph is the union of perfect matchings of its components. The components are numbered in increasing order of their
+ *  smallest clique ID.
+ */
+template<class Score>
+unsigned int computeCliqueComponents(const BasicBipartiteMatchingGraph<Score> &bmgraph, std::vector<unsigned int> &component_ids)
+{
+	// Merge the sets of the cliques linked by each edge, the root of each set being its smallest clique ID
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	std::vector<unsigned int> parents(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid)
+		parents[cid] = cid;
+	for(unsigned int cid_source=0; cid_source<ncliques; ++cid_source) {
+		for(unsigned int index=bmgraph.getSourceAdjacencyBegin(cid_source); index<bmgraph.getSourceAdjacencyEnd(cid_source); ++index) {
+			const unsigned int root_source = findComponentRoot(parents, cid_source);
+			const unsigned int root_target = findComponentRoot(parents, bmgraph.getAdjacentEdge(index).target_cid);
+			if(root_source<root_target)
+				parents[root_target] = root_source;
+			else if(root_target<root_source)
+				parents[root_source] = root_target;
+		}
+	}
+	// Number the sets, whose root is always met before their other cliques
+	unsigned int ncomponents = 0;
+	component_ids.resize(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		const unsigned int root = findComponentRoot(parents, cid);
+		component_ids[cid] = (root==cid ? ncomponents++ : component_ids[root]);
+	}
+	return ncomponents;
+}
+
+
+
+//! Maximal finite cost of the NonMatchingGraphs converted into graphs with int scores, leaving a wide margin for the labels of the engines.
+const unsigned int INT_SCORE_MAX_COST = (1u<<24);
+
+//! Function to indicate whether the finite costs of a NonMatchingGraph are small enough to be converted into int scores.
+bool hasIntScoreCosts(const NonMatchingGraph &nmgraph)
+{
+	std::vector<NonMatchingGraph::Vertex>::const_iterator it_nmv, it_nmv_end;
+	nmgraph.getVertexIterators(it_nmv, it_nmv_end);
+	for(; it_nmv!=it_nmv_end; ++it_nmv) {
+		for(std::vector<NonMatchingGraph::Edge>::const_iterator it_e=it_nmv->getConstraints().begin(); it_e!=it_nmv->getConstraints().end(); ++it_e) {
+			const unsigned int cost = nmgraph.getConstraintCost(*it_e);	// Zero for the expired edges
+			if(cost!=(unsigned int)(-1) && cost>INT_SCORE_MAX_COST)
+				return false;
+		}
+	}
+	return true;
+}
+
+
+
+/*! Internal class holding the data of a PerfectMatchingFinder which depend on the score type of the graphs. The finder
+ *  only keeps the data of the score type of its last search, through this base class.
+ */
+class ScoreWorkspace
+{
+public:
+
+	//! Destructor.
+	virtual ~ScoreWorkspace() {}
+	//! Function to return a new workspace of the same score type, holding a copy of the warm start state only.
+	virtual ScoreWorkspace* cloneWarmStartState() const = 0;
+	//! Function to forget the labels kept from the previous search.
+	virtual void resetWarmStart() = 0;
+};
+
+//! Internal class holding the data of a PerfectMatchingFinder for the graphs with the specified score type.
+template<class Score>
+class TypedScoreWorkspace : public ScoreWorkspace
+{
+public:
+
+	std::vector<Score> warm_target_labels;			//!< Labels of the target vertices at the end of the previous search (with the convention of the Hungarian algorithm).
+	impl::HungarianWorkspace<Score> hungarian;		//!< Data structures of the Hungarian algorithm, reused from one search to the next.
+	impl::ImplicitShortestAugmentingPathSolver<Score> implicit_solver;	//!< Data structures of the shortest augmenting path engine on the implicit graphs, reused from one search to the next.
+	BasicMatchingGraphReducer<Score> reducer;		//!< Reducer of the graphs, reused from one search to the next.
+	BasicBipartiteMatchingGraph<Score> bmgraph;		//!< Graph converted from the last non-matching graph searched, rebuilt in place by the next conversion.
+	BasicImplicitBipartiteMatchingGraph<Score> ibmgraph;	//!< Implicit graph converted from the last large non-matching graph searched, rebuilt in place by the next conversion.
+	std::vector<Score> candidate_scores;			//!< Scores of the matching candidates of a vertex, used by the conversion of the non-matching graphs.
+	std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> bmg_matching;	//!< Matching found in the converted graph.
+	std::vector<unsigned int> tmp_matching;			//!< Matching found by the shortest augmenting path engine, before being swapped into the output.
+
+	ScoreWorkspace* cloneWarmStartState() const
+	{
+		TypedScoreWorkspace<Score> *workspace = new TypedScoreWorkspace<Score>();
+		workspace->warm_target_labels = warm_target_labels;
+		return workspace;
+	}
+
+	void resetWarmStart()
+	{
+		warm_target_labels.clear();
+	}
+};
+
+
+
+}	// namespace impl
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+SolverStatistics::SolverStatistics()
+	: naugmentations(0)
+	, nlabel_updates(0)
+	, nscanned_edges(0)
+	, nclique_rescans(0)
+	, total_tree_size(0)
+	, max_tree_size(0)
+	, conversion_time(0.0)
+	, feasibility_time(0.0)
+	, reduction_time(0.0)
+	, initialization_time(0.0)
+	, augmentation_time(0.0)
+{
+}
+
+double SolverStatistics::getAverageTreeSize() const
+{
+	return (naugmentations>0 ? (double)total_tree_size/naugmentations : 0.0);
+}
+
+void SolverStatistics::add(const SolverStatistics &statistics)
+{
+	naugmentations += statistics.naugmentations;
+	nlabel_updates += statistics.nlabel_updates;
+	nscanned_edges += statistics.nscanned_edges;
+	nclique_rescans += statistics.nclique_rescans;
+	total_tree_size += statistics.total_tree_size;
+	max_tree_size = std::max(max_tree_size, statistics.max_tree_size);
+	conversion_time += statistics.conversion_time;
+	feasibility_time += statistics.feasibility_time;
+	reduction_time += statistics.reduction_time;
+	initialization_time += statistics.initialization_time;
+	augmentation_time += statistics.augmentation_time;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+PerfectMatchingFinder::PerfectMatchingFinder(Engine engine)
+	: _engine(engine)
+	, _nthreads(0)
+	, _decompose_components(false)
+	, _reduce_graphs(false)
+	, _warm_start(false)
+	, _score_workspace(NULL)
+	, _cardinality_finder(NULL)
+	, _gather_solver_statistics(false)
+{
+}
+
+PerfectMatchingFinder::PerfectMatchingFinder(const PerfectMatchingFinder &pmfinder)
+	: _engine(pmfinder._engine)
+	, _nthreads(pmfinder._nthreads)
+	, _decompose_components(pmfinder._decompose_components)
+	, _reduce_graphs(pmfinder._reduce_graphs)
+	, _warm_start(pmfinder._warm_start)
+	, _warm_source_matches(pmfinder._warm_source_matches)
+	, _random_engine(pmfinder._random_engine)
+	, _score_workspace(pmfinder._score_workspace!=NULL ? pmfinder._score_workspace->cloneWarmStartState() : NULL)
+	, _cardinality_finder(NULL)
+	, _hall_violator_sources(pmfinder._hall_violator_sources)
+	, _hall_violator_targets(pmfinder._hall_violator_targets)
+	, _reduction_statistics(pmfinder._reduction_statistics)
+	, _gather_solver_statistics(pmfinder._gather_solver_statistics)
+	, _solver_statistics(pmfinder._solver_statistics)
+{
+}
+
+PerfectMatchingFinder::~PerfectMatchingFinder()
+{
+	delete _score_workspace;
+	delete _cardinality_finder;
+}
+
+PerfectMatchingFinder& PerfectMatchingFinder::operator=(const PerfectMatchingFinder &pmfinder)
+{
+	if(this==&pmfinder)
+		return *this;
+	// The cardinality finder is kept, since its content is only valid during a search, while the data depending on the
+	// score type are replaced, since they hold the labels of the warm start
+	_engine = pmfinder._engine;
+	_nthreads = pmfinder._nthreads;
+	_decompose_components = pmfinder._decompose_components;
+	_reduce_graphs = pmfinder._reduce_graphs;
+	_warm_start = pmfinder._warm_start;
+	_warm_source_matches = pmfinder._warm_source_matches;
+	_random_engine = pmfinder._random_engine;
+	delete _score_workspace;
+	_score_workspace = (pmfinder._score_workspace!=NULL ? pmfinder._score_workspace->cloneWarmStartState() : NULL);
+	_hall_violator_sources = pmfinder._hall_violator_sources;
+	_hall_violator_targets = pmfinder._hall_violator_targets;
+	_reduction_statistics = pmfinder._reduction_statistics;
+	_gather_solver_statistics = pmfinder._gather_solver_statistics;
+	_solver_statistics = pmfinder._solver_statistics;
+	return *this;
+}
+
+void PerfectMatchingFinder::setWarmStart(bool enable)
+{
+	_warm_start = enable;
+	if(!enable)
+		resetWarmStart();
+}
+
+void PerfectMatchingFinder::resetWarmStart()
+{
+	if(_score_workspace!=NULL)
+		_score_workspace->resetWarmStart();
+	_warm_source_matches.clear();
+}
+
+bool PerfectMatchingFinder::getHallViolator(std::vector<unsigned int> &sources, std::vector<unsigned int> &targets) const
+{
+	sources = _hall_violator_sources;
+	targets = _hall_violator_targets;
+	return !_hall_violator_sources.empty();
+}
+
+template<class Score>
+impl::TypedScoreWorkspace<Score>& PerfectMatchingFinder::_getScoreWorkspace()
+{
+	impl::TypedScoreWorkspace<Score> *workspace = dynamic_cast<impl::TypedScoreWorkspace<Score>*>(_score_workspace);
+	if(workspace==NULL) {
+		// The labels of another score type cannot be used to warm start the search
+		delete _score_workspace;
+		_warm_source_matches.clear();
+		workspace = new impl::TypedScoreWorkspace<Score>();
+		_score_workspace = workspace;
+	}
+	return *workspace;
+}
+
+template<class Score>
+bool PerfectMatchingFinder::_findRandomPerfectMatchingInComponents(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+																   const std::vector<unsigned int> &component_ids,
+																   unsigned int ncomponents,
+																   std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching)
+{
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+	// The components are solved without warm start, since their labelings are not kept
+	resetWarmStart();
+	// List the cliques of each component, and give them consecutive clique IDs in the graph of their component
+	const unsigned int ncliques = bmgraph.getNumberCliques();
+	std::vector< std::vector<unsigned int> > component_cliques(ncomponents);
+	std::vector<unsigned int> local_cids(ncliques);
+	for(unsigned int cid=0; cid<ncliques; ++cid) {
+		std::vector<unsigned int> &cliques = component_cliques[component_ids[cid]];
+		local_cids[cid] = cliques.size();
+		cliques.push_back(cid);
+	}
+	// Solve the components on a thread pool, each with its own finder seeded from one draw of the random engine of this
+	// finder and the index of the component, so that the matching only depends on the seed and not on the scheduling
+	const unsigned long long seed = _random_engine.next64();
+	matching.resize(ncliques);
+	std::vector<unsigned char> successes(ncomponents, 0);
+	std::vector<GraphReductionStatistics> component_statistics(ncomponents);
+	std::vector<SolverStatistics> component_solver_statistics(ncomponents);
+	ThreadPool pool(std::min(_nthreads>0 ? _nthreads : std::max(std::thread::hardware_concurrency(), 1u), ncomponents));
+	pool.run(ncomponents, [&](unsigned int c, unsigned int) {
+		// Build the graph of the component, remembering the edge of the whole graph corresponding to each of its edges
+		const std::vector<unsigned int> &cliques = component_cliques[c];
+		Graph component_bmgraph;
+		std::vector<const Edge*> component_edges;
+		component_bmgraph.startNewGraph(cliques.size());
+		for(unsigned int local_cid=0; local_cid<cliques.size(); ++local_cid) {
+			for(unsigned int index=bmgraph.getSourceAdjacencyBegin(cliques[local_cid]); index<bmgraph.getSourceAdjacencyEnd(cliques[local_cid]); ++index) {
+				const typename Graph::AdjacentEdge &adjacent_edge = bmgraph.getAdjacentEdge(index);
+				component_bmgraph.addDirectedEdge(local_cid, local_cids[adjacent_edge.target_cid], adjacent_edge.score);
+				component_edges.push_back(bmgraph.getAdjacentEdgePointer(index));
+			}
+		}
+		component_bmgraph.finalize();
+		// Find the matching of the component, and store its edges in the matching of the whole graph, ordered by source clique ID
+		PerfectMatchingFinder pmfinder(_engine);
+		pmfinder.setNumberThreads(1);
+		pmfinder.setGraphReduction(_reduce_graphs);
+		pmfinder.setSolverStatistics(_gather_solver_statistics);
+		pmfinder.setSeed(RandomEngine::deriveSeed(seed, c));
+		std::vector<const Edge*> component_matching;
+		const bool success = pmfinder.findRandomPerfectMatching(component_bmgraph, component_matching);
+		component_statistics[c] = pmfinder.getReductionStatistics();
+		component_solver_statistics[c] = pmfinder.getSolverStatistics();
+		if(!success)
+			return;
+		typename std::vector<Edge>::const_iterator it_e_begin, it_e_end;
+		component_bmgraph.getEdgeIterators(it_e_begin, it_e_end);
+		for(typename std::vector<const Edge*>::const_iterator it_e=component_matching.begin(); it_e!=component_matching.end(); ++it_e) {
+			const Edge *edge = component_edges[*it_e-&*it_e_begin];
+			matching[edge->v_source->parent->cid] = edge;
+		}
+		successes[c] = 1;
+	});
+	if(_reduce_graphs) {
+		// The statistics of the reductions of the components are summed, as if the whole graph was reduced
+		_reduction_statistics.ncliques = ncliques;
+		_reduction_statistics.nedges = bmgraph.getNumberEdges();
+		for(unsigned int c=0; c<ncomponents; ++c) {
+			_reduction_statistics.nforced_matches += component_statistics[c].nforced_matches;
+			_reduction_statistics.ndominated_edges += component_statistics[c].ndominated_edges;
+			_reduction_statistics.nreduced_cliques += component_statistics[c].nreduced_cliques;
+			_reduction_statistics.nreduced_edges += component_statistics[c].nreduced_edges;
+		}
+	}
+	// The statistics of the searches of the components are summed too, including their times, although they ran in parallel
+	for(unsigned int c=0; c<ncomponents; ++c)
+		_solver_statistics.add(component_solver_statistics[c]);
+	if(std::find(successes.begin(), successes.end(), 0)!=successes.end()) {
+		matching.clear();
+		return false;
+	}
+	return true;
+}
+
+template<class Graph>
+bool PerfectMatchingFinder::_checkPerfectMatchingExists(const Graph &graph)
+{
+	if(_cardinality_finder==NULL)
+		_cardinality_finder = new CardinalityMatchingFinder();
+	if(_cardinality_finder->findMaximumCardinalityMatching(graph))
+		return true;
+	_hall_violator_sources = _cardinality_finder->getHallViolatorSources();
+	_hall_violator_targets = _cardinality_finder->getHallViolatorTargets();
+	resetWarmStart();
+	return false;
+}
+
+template<class Score>
+bool PerfectMatchingFinder::findRandomPerfectMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													  std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching)
+{
+	typedef BasicBipartiteMatchingGraph<Score> Graph;
+	typedef typename Graph::Edge Edge;
+	// The engines iterate over the compressed sparse row layout of the graph, which is only built by finalize()
+	// Forget the Hall violator of the previous search first, so that a graph which is not finalized reports none
+	_hall_violator_sources.clear();
+	_hall_violator_targets.clear();
+	WPMASSERT(bmgraph.isFinalized(), "The graph must be finalized before searching for a perfect matching!");
+	if(!bmgraph.isFinalized())
+		return false;
+	// Check that the graph has a perfect matching, since the weighted engines only find out late that it has none
+	_reduction_statistics = GraphReductionStatistics();
+	_solver_statistics = SolverStatistics();
+	SolverStatistics *statistics = (_gather_solver_statistics ? &_solver_statistics : NULL);
+	impl::PhaseTimer feasibility_timer(statistics, &SolverStatistics::feasibility_time);
+	if(!_checkPerfectMatchingExists(bmgraph))
+		return false;
+	feasibility_timer.stop();
+	// Solve the independent components of the graph separately, since the engines are cubic in the number of cliques
+	if(_decompose_components) {
+		std::vector<unsigned int> component_ids;
+		const unsigned int ncomponents = impl::computeCliqueComponents(bmgraph, component_ids);
+		if(ncomponents>1)
+			return _findRandomPerfectMatchingInComponents(bmgraph, component_ids, ncomponents, matching);
+	}
+	// Solve the reduced graph instead, if the reduction fixes some matches or removes some edges
+	if(_reduce_graphs) {
+		BasicMatchingGraphReducer<Score> &reducer = _getScoreWorkspace<Score>().reducer;
+		Graph reduced_bmgraph;
+		impl::PhaseTimer reduction_timer(statistics, &SolverStatistics::reduction_time);
+		const bool is_reducible = reducer.reduce(bmgraph, reduced_bmgraph);
+		reduction_timer.stop();
+		_reduction_statistics = reducer.getStatistics();
+		if(!is_reducible)
+			return false;
+		if(reducer.isReduced()) {
+			// The cliques of the reduced graph change from one search to the next, hence its labeling is not kept
+			resetWarmStart();
+			std::vector<const Edge*> reduced_matching;
+			const bool success = (reduced_bmgraph.getNumberCliques()==0 || _findPerfectMatchingWithEngine(reduced_bmgraph, reduced_matching));
+			resetWarmStart();
+			if(!success)
+				return false;
+			reducer.toOriginalMatching(reduced_bmgraph, reduced_matching, matching);
+			return true;
+		}
+	}
+	return _findPerfectMatchingWithEngine(bmgraph, matching);
+}
+
+template<class Score>
+bool PerfectMatchingFinder::_findPerfectMatchingWithEngine(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+														   std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching)
+{
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+	// Find a perfect matching in the graph (the Hungarian engine returns it in the buffer of its workspace)
+	impl::TypedScoreWorkspace<Score> &workspace = _getScoreWorkspace<Score>();
+	std::vector<const Edge*> tmp_matching;
+	std::vector<const Edge*> *found_matching = &tmp_matching;
+	std::vector<Score> *warm_target_labels = (_warm_start ? &workspace.warm_target_labels : NULL);
+	std::vector<unsigned int> *warm_source_matches = (_warm_start ? &_warm_source_matches : NULL);
+	// The auction engine falls back to the shortest augmenting paths for the scores which do not fit its benefits
+	Engine engine = _engine;
+	if(engine==Engine_Auction && !impl::isAuctionApplicable(bmgraph))
+		engine = Engine_ShortestAugmentingPath;
+	SolverStatistics *statistics = (_gather_solver_statistics ? &_solver_statistics : NULL);
+	bool success = false;
+	switch(engine) {
+	case Engine_Hungarian:
+		// The Hungarian engine is instantiated with or without the counting code, depending on whether the statistics are gathered
+		if(statistics!=NULL) {
+			impl::SolverStatisticsRecorder recorder(*statistics);
+			success = impl::findPerfectMatching(bmgraph, workspace.hungarian, _random_engine, recorder, warm_target_labels, warm_source_matches);
+		}
+		else {
+			impl::NoSolverStatistics no_statistics;
+			success = impl::findPerfectMatching(bmgraph, workspace.hungarian, _random_engine, no_statistics, warm_target_labels, warm_source_matches);
+		}
+		found_matching = &workspace.hungarian.matching_edges;
+		break;
+	case Engine_ShortestAugmentingPath:
+		success = impl::findPerfectMatchingWithShortestAugmentingPaths(bmgraph, tmp_matching, _random_engine, warm_target_labels, warm_source_matches, statistics);
+		break;
+	case Engine_Auction:
+		// The prices of the auction are not exact duals, hence they cannot be used to warm start the other engines
+		resetWarmStart();
+		success = impl::findPerfectMatchingWithAuction(bmgraph, tmp_matching, (_nthreads>0 ? _nthreads : std::thread::hardware_concurrency()), _random_engine, statistics);
+		break;
+	}
+	if(!success)
+		resetWarmStart();
+	// Check if it is a perfect matching (a perfect matching spans all the
+	// vertices in the graph, hence the number of edges in the perfect matching
+	// is equal to the number of cliques in the bipartite graph)
+	if(!success || found_matching->size()<bmgraph.getNumberCliques())
+		return false;
+	if(found_matching==&tmp_matching)
+		matching.swap(tmp_matching);
+	else matching.assign(found_matching->begin(), found_matching->end());	// Copied to keep the buffers of both the workspace and the output
+	return true;
+}
+
+template<class Score>
+bool PerfectMatchingFinder::findOptimalMatchingSampler(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													   BasicOptimalMatchingSampler<Score> &sampler)
+{
+	typedef typename BasicBipartiteMatchingGraph<Score>::Edge Edge;
+	_hall_violator_sources.clear();
+	_hall_violator_targets.clear();
+	WPMASSERT(bmgraph.isFinalized(), "The graph must be finalized before searching for a perfect matching!");
+	if(!bmgraph.isFinalized())
+		return false;
+	_reduction_statistics = GraphReductionStatistics();
+	if(!_checkPerfectMatchingExists(bmgraph))
+		return false;
+	// Solve the graph with an engine producing an optimal vertex labeling, from scratch since the labels are empty
+	std::vector<Score> target_labels;
+	std::vector<unsigned int> source_matches;
+	std::vector<const Edge*> matching;
+	bool success;
+	if(_engine==Engine_Hungarian) {
+		impl::TypedScoreWorkspace<Score> &workspace = _getScoreWorkspace<Score>();
+		impl::NoSolverStatistics no_statistics;
+		success = impl::findPerfectMatching(bmgraph, workspace.hungarian, _random_engine, no_statistics, &target_labels, &source_matches);
+		matching = workspace.hungarian.matching_edges;
+	}
+	else success = impl::findPerfectMatchingWithShortestAugmentingPaths(bmgraph, matching, _random_engine, &target_labels, &source_matches);
+	return (success && sampler.initialize(bmgraph, matching, target_labels));
+}
+
+template<class Score>
+bool PerfectMatchingFinder::findBestPerfectMatchings(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+													 unsigned int nmatchings,
+													 std::vector< std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> > &matchings)
+{
+	matchings.clear();
+	_hall_violator_sources.clear();
+	_hall_violator_targets.clear();
+	WPMASSERT(bmgraph.isFinalized(), "The graph must be finalized before searching for a perfect matching!");
+	if(!bmgraph.isFinalized())
+		return false;
+	_reduction_statistics = GraphReductionStatistics();
+	if(!_checkPerfectMatchingExists(bmgraph))
+		return false;
+	return impl::findBestPerfectMatchingsWithShortestAugmentingPaths(bmgraph, nmatchings, matchings, _random_engine);
+}
+
+bool PerfectMatchingFinder::findRandomPerfectMatching(const NonMatchingGraph &nmgraph,
+													  std::vector<unsigned int> &matching)
+{
+	// The int scores are faster, but the labels of the engines may overflow them when the costs are too wide
+	if(impl::hasIntScoreCosts(nmgraph))
+		return _findRandomPerfectMatchingInNonMatchingGraph<int>(nmgraph, matching);
+	return _findRandomPerfectMatchingInNonMatchingGraph<long long>(nmgraph, matching);
+}
+
+template<class Score>
+bool PerfectMatchingFinder::_findRandomPerfectMatchingInNonMatchingGraph(const NonMatchingGraph &nmgraph,
+																		 std::vector<unsigned int> &matching)
+{
+	const unsigned int nvertices = nmgraph.getNumberVertices();
+	MatchingGraphConverter gconverter;
+	// The conversion is measured apart, since the search in the converted graph starts new statistics
+	SolverStatistics conversion_statistics;
+	SolverStatistics *statistics = (_gather_solver_statistics ? &conversion_statistics : NULL);
+	if(nvertices<=impl::SMALL_GRAPH_MAX_NVERTICES) {
+		// The search on the small graph does not produce a labeling in the convention of the other engines
+		resetWarmStart();
+		_hall_violator_sources.clear();
+		_hall_violator_targets.clear();
+		_solver_statistics = SolverStatistics();
+		statistics = (_gather_solver_statistics ? &_solver_statistics : NULL);
+		bool success;
+		if(nvertices<=impl::TINY_GRAPH_MAX_NVERTICES) {
+			SmallPerfectMatchingFinder<impl::TINY_GRAPH_MAX_NVERTICES, Score> small_pmfinder;
+			ScopedTraceSpan conversion_span("toSmallPerfectMatchingFinder");
+			impl::PhaseTimer conversion_timer(statistics, &SolverStatistics::conversion_time);
+			impl::toSmallPerfectMatchingFinder(nmgraph, small_pmfinder);
+			conversion_timer.stop();
+			conversion_span.end();
+			ScopedTraceSpan solving_span("solve");
+			impl::PhaseTimer augmentation_timer(statistics, &SolverStatistics::augmentation_time);
+			success = small_pmfinder.findRandomPerfectMatching(matching, _random_engine);
+		}
+		else {
+			SmallPerfectMatchingFinder<impl::SMALL_GRAPH_MAX_NVERTICES, Score> small_pmfinder;
+			ScopedTraceSpan conversion_span("toSmallPerfectMatchingFinder");
+			impl::PhaseTimer conversion_timer(statistics, &SolverStatistics::conversion_time);
+			impl::toSmallPerfectMatchingFinder(nmgraph, small_pmfinder);
+			conversion_timer.stop();
+			conversion_span.end();
+			ScopedTraceSpan solving_span("solve");
+			impl::PhaseTimer augmentation_timer(statistics, &SolverStatistics::augmentation_time);
+			success = small_pmfinder.findRandomPerfectMatching(matching, _random_engine);
+		}
+		if(!success) {
+			// The small graph has no perfect matching, hence build its Hall violator from the implicit representation of the graph
+			BasicImplicitBipartiteMatchingGraph<Score> ibmgraph;
+			gconverter.toImplicitBipartiteMatchingGraph(nmgraph, ibmgraph);
+			_checkPerfectMatchingExists(ibmgraph);
+		}
+		return success;
+	}
+	// The converted graphs are kept in the workspace, so that they are rebuilt in place by the next search
+	impl::TypedScoreWorkspace<Score> &workspace = _getScoreWorkspace<Score>();
+	if(nvertices>=impl::IMPLICIT_GRAPH_MIN_NVERTICES) {
+		// Convert the non-matching graph into an implicit bipartite matching graph, whose size does not grow quadratically
+		BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph = workspace.ibmgraph;
+		ScopedTraceSpan conversion_span("toImplicitBipartiteMatchingGraph");
+		impl::PhaseTimer conversion_timer(statistics, &SolverStatistics::conversion_time);
+		gconverter.toImplicitBipartiteMatchingGraph(nmgraph, ibmgraph);
+		conversion_timer.stop();
+		conversion_span.end();
+		ScopedTraceSpan solving_span("solve");
+		const bool success = findRandomPerfectMatching(ibmgraph, matching);
+		_solver_statistics.conversion_time = conversion_statistics.conversion_time;
+		return success;
+	}
+	// Convert the non-matching graph into a bipartite matching graph, and convert back the matching
+	BasicBipartiteMatchingGraph<Score> &bmgraph = workspace.bmgraph;
+	ScopedTraceSpan conversion_span("toBipartiteMatchingGraph");
+	impl::PhaseTimer conversion_timer(statistics, &SolverStatistics::conversion_time);
+	gconverter.toBipartiteMatchingGraph(nmgraph, bmgraph, workspace.candidate_scores);
+	conversion_timer.stop();
+	conversion_span.end();
+	ScopedTraceSpan solving_span("solve");
+	std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &bmg_matching = workspace.bmg_matching;
+	const bool success = findRandomPerfectMatching(bmgraph, bmg_matching);
+	solving_span.end();
+	_solver_statistics.conversion_time = conversion_statistics.conversion_time;
+	if(!success)
+		return false;
+	gconverter.toGenericMatching(bmg_matching, matching);
+	return true;
+}
+
+template<class Score>
+bool PerfectMatchingFinder::findRandomPerfectMatching(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph,
+													  std::vector<unsigned int> &matching)
+{
+	// Check that the graph has a perfect matching, since the weighted engines only find out late that it has none
+	_hall_violator_sources.clear();
+	_hall_violator_targets.clear();
+	_solver_statistics = SolverStatistics();
+	SolverStatistics *statistics = (_gather_solver_statistics ? &_solver_statistics : NULL);
+	impl::PhaseTimer feasibility_timer(statistics, &SolverStatistics::feasibility_time);
+	if(!_checkPerfectMatchingExists(ibmgraph))
+		return false;
+	feasibility_timer.stop();
+	// The implicit graph is always processed by the shortest augmenting path engine, since the Hungarian engine
+	// requires the edges to be stored explicitly
+	impl::TypedScoreWorkspace<Score> &workspace = _getScoreWorkspace<Score>();
+	std::vector<unsigned int> &tmp_matching = workspace.tmp_matching;
+	std::vector<Score> *warm_target_labels = (_warm_start ? &workspace.warm_target_labels : NULL);
+	std::vector<unsigned int> *warm_source_matches = (_warm_start ? &_warm_source_matches : NULL);
+	if(!impl::findPerfectMatchingWithShortestAugmentingPaths(ibmgraph, workspace.implicit_solver, tmp_matching, _random_engine, warm_target_labels, warm_source_matches, statistics)) {
+		resetWarmStart();
+		return false;
+	}
+	matching.swap(tmp_matching);
+	return true;
+}
+
+
+
+// Explicit instantiations for the supported score types (see ScoreTraits)
+#define WPM_INSTANTIATE_PERFECT_MATCHING_FINDER(Score) \
+	template bool PerfectMatchingFinder::findRandomPerfectMatching<Score>(const BasicBipartiteMatchingGraph<Score>&, std::vector<const BasicBipartiteMatchingGraph<Score>::Edge*>&); \
+	template bool PerfectMatchingFinder::findRandomPerfectMatching<Score>(const BasicImplicitBipartiteMatchingGraph<Score>&, std::vector<unsigned int>&); \
+	template bool PerfectMatchingFinder::findOptimalMatchingSampler<Score>(const BasicBipartiteMatchingGraph<Score>&, BasicOptimalMatchingSampler<Score>&); \
+	template bool PerfectMatchingFinder::findBestPerfectMatchings<Score>(const BasicBipartiteMatchingGraph<Score>&, unsigned int, std::vector< std::vector<const BasicBipartiteMatchingGraph<Score>::Edge*> >&);
+WPM_INSTANTIATE_PERFECT_MATCHING_FINDER(int)
+WPM_INSTANTIATE_PERFECT_MATCHING_FINDER(long long)
+WPM_INSTANTIATE_PERFECT_MATCHING_FINDER(double)
+#undef WPM_INSTANTIATE_PERFECT_MATCHING_FINDER
+
 
 
 } //namespace wpm
@@ -5,31 +5,236 @@
 
 
 
+#include <vector>
+#include "RandomEngine.h"
+#include "MatchingGraphReducer.h"
+
+
+
 namespace wpm {
 
 
 
 // Forward declarations
 class NonMatchingGraph;
-class BipartiteMatchingGraph;
+template<class Score> class BasicImplicitBipartiteMatchingGraph;
+template<class Score> class BasicOptimalMatchingSampler;
+class CardinalityMatchingFinder;
+namespace impl { class ScoreWorkspace; template<class Score> class TypedScoreWorkspace; }
+
+
+
+/*! Statistics of the last search of a PerfectMatchingFinder, gathered only when enabled (see setSolverStatistics), e.g. to
+ *  find out which graphs need pathological numbers of label updates. The counters of the alternating trees are only
+ *  gathered by the Hungarian engine, while the wall times of the phases are measured for all the engines.
+ */
+struct SolverStatistics
+{
+	unsigned long long naugmentations;		//!< Number of augmenting paths applied to the matching.
+	unsigned long long nlabel_updates;		//!< Number of updates of the vertex labeling (calls to updateLabelingAndSlack).
+	unsigned long long nscanned_edges;		//!< Number of edges scanned by the breadth-first searches in the equality subgraph.
+	unsigned long long nclique_rescans;		//!< Number of scans of all the cliques for the target vertices newly reachable after a label update.
+	unsigned long long total_tree_size;		//!< Sum of the numbers of vertices of the alternating trees, when their augmenting path is found.
+	unsigned int max_tree_size;				//!< Maximal number of vertices of an alternating tree.
+	double conversion_time;					//!< Wall time in seconds of the conversion of the NonMatchingGraph (if the search started from one).
+	double feasibility_time;				//!< Wall time in seconds of the check that the graph has a perfect matching.
+	double reduction_time;					//!< Wall time in seconds of the reduction of the graph (if enabled).
+	double initialization_time;				//!< Wall time in seconds of the initialization of the engine (initial labeling, warm start and random order).
+	double augmentation_time;				//!< Wall time in seconds of the augmentations of the matching by the engine.
+
+	SolverStatistics();
+	//! Function to return the average number of vertices of the alternating trees.
+	double getAverageTreeSize() const;
+	//! Function to add the statistics of another search, e.g. of another component of the same graph.
+	void add(const SolverStatistics &statistics);
+};
 
 
 
 /*! PerfectMatchingFinder class, in charge of finding a perfect matching with maximal score in a BipartiteMatchingGraph.
- *  This class implements the Hungarian algorithm (see https://en.wikipedia.org/wiki/Hungarian_algorithm).
+ *  By default, this class implements the Hungarian algorithm (see https://en.wikipedia.org/wiki/Hungarian_algorithm).
+ *  A shortest augmenting path engine from the Jonker-Volgenant family can be selected instead, which is usually much
+ *  faster on large graphs and finds a matching with the same maximal score. An auction engine is also available, whose
+ *  bidding rounds are computed in parallel, for very large graphs on machines with many cores.
+ *  The graphs may have int, long long or double scores (see ScoreTraits). The Hungarian and shortest augmenting path
+ *  engines work on labels of the type of the scores, while the auction engine only applies to integer scores small
+ *  enough for its 64-bit benefits, and the shortest augmenting path engine is used for the other graphs.
  */
 class PerfectMatchingFinder
 {
+public:
+
+	//! Engines which can be used to find the perfect matching.
+	enum Engine {
+		Engine_Hungarian,				//!< Hungarian algorithm, growing alternating trees in the equality subgraph.
+		Engine_ShortestAugmentingPath,	//!< Jonker-Volgenant algorithm, with column reduction, reduction transfer and Dijkstra-like shortest augmenting paths.
+		Engine_Auction					//!< Forward auction algorithm of Bertsekas with epsilon-scaling, with bidding rounds split among several threads.
+	};
+
+private:
+
+	Engine _engine;										//!< Engine used to find the perfect matching.
+	unsigned int _nthreads;								//!< Maximal number of threads used by the auction engine and by the components of the graph (0 for the number of hardware threads).
+	bool _decompose_components;							//!< Flag indicating whether the connected components of the graphs are solved independently.
+	bool _reduce_graphs;								//!< Flag indicating whether the graphs are reduced before running the engines.
+	bool _warm_start;									//!< Flag indicating whether the labeling and matching of the previous search are reused.
+	std::vector<unsigned int> _warm_source_matches;		//!< Clique ID of the matched target vertex for each source vertex at the end of the previous search.
+	RandomEngine _random_engine;						//!< Random engine used to select the perfect matching among those with maximal score.
+	impl::ScoreWorkspace *_score_workspace;				//!< Data depending on the score type (labels of the warm start, Hungarian workspace, reducer), allocated by the first search and replaced when the score type changes (NULL before).
+	CardinalityMatchingFinder *_cardinality_finder;		//!< Finder checking that the graphs have a perfect matching, allocated by the first search and reused by the next ones (NULL before).
+	std::vector<unsigned int> _hall_violator_sources;	//!< Source vertices of the Hall violator, if the last graph has no perfect matching.
+	std::vector<unsigned int> _hall_violator_targets;	//!< Target vertices linked to the source vertices of the Hall violator, if the last graph has no perfect matching.
+	GraphReductionStatistics _reduction_statistics;		//!< Statistics of the reduction of the last graph.
+	bool _gather_solver_statistics;						//!< Flag indicating whether the statistics of the searches are gathered.
+	SolverStatistics _solver_statistics;				//!< Statistics of the last search, if they are gathered.
+
 public:
 
 	//! Default constructor.
-	PerfectMatchingFinder();
+	PerfectMatchingFinder(Engine engine=Engine_Hungarian);
+	//! Copy constructor, copying the settings, warm start state and random engine, but not the workspaces of the engines.
+	PerfectMatchingFinder(const PerfectMatchingFinder &pmfinder);
 	//! Destructor.
 	~PerfectMatchingFinder();
-
-	//! Function to find a perfect matching in a BipartiteMatchingGraph, selected randomly among those with maximal score.
-	bool findRandomPerfectMatching(const BipartiteMatchingGraph &bmgraph,
-								   std::vector<const BipartiteMatchingGraph::Edge*> &matching);
+	//! Assignment operator, copying the settings, warm start state and random engine, but not the workspaces of the engines.
+	PerfectMatchingFinder& operator=(const PerfectMatchingFinder &pmfinder);
+
+	//! Function to select the engine used to find the perfect matching.
+	inline void setEngine(Engine engine) { _engine = engine; }
+	//! Function to return the engine used to find the perfect matching.
+	inline Engine getEngine() const { return _engine; }
+	//! Function to set the maximal number of threads used by the auction engine and by the components of the graph (0 for the number of hardware threads).
+	inline void setNumberThreads(unsigned int nthreads) { _nthreads = nthreads; }
+	//! Function to return the maximal number of threads used by the auction engine and by the components of the graph (0 for the number of hardware threads).
+	inline unsigned int getNumberThreads() const { return _nthreads; }
+	/*! Function to enable or disable the decomposition of the BipartiteMatchingGraph into its connected components, where the
+	 *  cliques are connected by the edges between their vertices (e.g. disjoint pools of cliques, which can only be matched
+	 *  within their pool). Since the engines are cubic in the number of cliques, each component is solved independently,
+	 *  on a thread pool with the number of threads of the finder, and their matchings are merged. The components are
+	 *  found with a union-find over the edges, and graphs with a single component are solved as usual. The matching only
+	 *  depends on the seed of the finder, whatever the number of threads. Warm starts are not used for decomposed graphs.
+	 */
+	inline void setComponentDecomposition(bool enable) { _decompose_components = enable; }
+	//! Function to indicate whether the graphs are decomposed into their connected components.
+	inline bool isComponentDecompositionEnabled() const { return _decompose_components; }
+	/*! Function to enable or disable the reduction of the BipartiteMatchingGraph before running the engines (see
+	 *  MatchingGraphReducer): the forced matches are fixed and the edges of no perfect matching are removed, then the
+	 *  engine only runs on the remaining cliques. The matching is still selected randomly among those with maximal score.
+	 *  When the graph is decomposed into its components, each component is reduced. Warm starts are not used for graphs
+	 *  whose reduction removes anything.
+	 */
+	inline void setGraphReduction(bool enable) { _reduce_graphs = enable; }
+	//! Function to indicate whether the graphs are reduced before running the engines.
+	inline bool isGraphReductionEnabled() const { return _reduce_graphs; }
+	//! Function to return the statistics of the reduction of the last graph (summed over its components if it was decomposed, and zero if the reduction is disabled).
+	inline const GraphReductionStatistics& getReductionStatistics() const { return _reduction_statistics; }
+	/*! Function to enable or disable the statistics of the searches (see SolverStatistics). The engines are instantiated
+	 *  with a statistics policy, hence when the statistics are disabled, their loops do not contain any counting code.
+	 */
+	inline void setSolverStatistics(bool enable) { _gather_solver_statistics = enable; }
+	//! Function to indicate whether the statistics of the searches are gathered.
+	inline bool isSolverStatisticsEnabled() const { return _gather_solver_statistics; }
+	//! Function to return the statistics of the last search (summed over its components if it was decomposed, and zero if the statistics are disabled).
+	inline const SolverStatistics& getSolverStatistics() const { return _solver_statistics; }
+	/*! Function to seed the random engine of the finder (seeded non-deterministically by default). Each finder has its own
+	 *  random engine, hence several finders may be used concurrently, and a given seed always gives the same matchings.
+	 */
+	inline void setSeed(unsigned long long seed) { _random_engine.seed(seed); }
+	//! Function to return the random engine of the finder.
+	inline RandomEngine& getRandomEngine() { return _random_engine; }
+
+	/*! Function to enable or disable warm starts. When enabled, the finder keeps the vertex labeling and the matching found
+	 *  by each search, and uses them as a starting point for the next search in a graph with the same number of cliques
+	 *  (e.g. the next round after NonMatchingGraph::updateConstraints). The source labels are repaired to make the
+	 *  labeling feasible, the previous matches which are not in the equality subgraph anymore are dropped, and only the
+	 *  corresponding source vertices are augmented again. The auction engine does not use warm starts, and a search in a
+	 *  graph whose score type differs from the previous one starts from scratch.
+	 */
+	void setWarmStart(bool enable);
+	//! Function to indicate whether warm starts are enabled.
+	inline bool isWarmStartEnabled() const { return _warm_start; }
+	//! Function to forget the labeling and matching kept from the previous search.
+	void resetWarmStart();
+
+	/*! Function to retrieve the Hall violator of the graph of the last search, if the search failed because this graph has no
+	 *  perfect matching: a minimal set of source vertices, which are linked to fewer target vertices than their number. The
+	 *  graph can only have a perfect matching if some of the missing edges from these source vertices are added. Every
+	 *  search first checks that the graph has a perfect matching, with the cardinality matching algorithm of Hopcroft and
+	 *  Karp, so that the weighted engines never run on such graphs. Returns false if the last graph has a perfect matching.
+	 */
+	bool getHallViolator(std::vector<unsigned int> &sources, std::vector<unsigned int> &targets) const;
+
+	/*! Function to find a perfect matching in a BipartiteMatchingGraph, selected randomly among those with maximal score.
+	 *  The Hungarian engine reuses its data structures from one search to the next, so that successive searches in graphs
+	 *  of the same size and score type, with the same output vector, do not allocate any memory.
+	 */
+	template<class Score>
+	bool findRandomPerfectMatching(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+								   std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching);
+
+	/*! Function to solve a BipartiteMatchingGraph once, and initialize the specified sampler with the perfect matching and the
+	 *  vertex labeling found, so that it draws many perfect matchings with maximal score without solving the graph again
+	 *  (see OptimalMatchingSampler). Since the sampler needs the final labels, the graph is neither decomposed nor reduced,
+	 *  and the auction engine is replaced by the shortest augmenting path engine. The warm start state is not used.
+	 */
+	template<class Score>
+	bool findOptimalMatchingSampler(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+									BasicOptimalMatchingSampler<Score> &sampler);
+
+	/*! Function to find the perfect matchings with the highest scores in a BipartiteMatchingGraph, ranked by decreasing score
+	 *  with the partitioning of Murty (the ties being ordered randomly), e.g. to propose several alternatives to the best
+	 *  matching. Each subproblem of the partitioning is solved from the matching and the vertex labeling of its parent, with
+	 *  a single shortest augmenting path instead of a new solve, and only the subproblems which may still give one of the
+	 *  requested matchings are kept. Fewer matchings are returned if the graph does not have as many perfect matchings.
+	 *  Whatever the selected engine, the shortest augmenting path engine is used, without any decomposition or reduction,
+	 *  and the warm start state is not used.
+	 */
+	template<class Score>
+	bool findBestPerfectMatchings(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+								  unsigned int nmatchings,
+								  std::vector< std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> > &matchings);
+
+	/*! Function to find a perfect matching in the BipartiteMatchingGraph equivalent to a NonMatchingGraph, selected randomly
+	 *  among those with maximal score. The matching contains the clique ID of the matched target vertex for each source
+	 *  vertex. The representation of the graph is selected automatically from its size: graphs with at most 64 vertices
+	 *  are solved by a SmallPerfectMatchingFinder on fixed arrays (whatever the selected engine, and without warm starts),
+	 *  graphs with at least 1000 vertices are converted into an ImplicitBipartiteMatchingGraph, and the others into a
+	 *  BipartiteMatchingGraph. The scores are int, unless the finite costs are wide enough for the labels of the engines
+	 *  to overflow an int, in which case they are long long.
+	 */
+	bool findRandomPerfectMatching(const NonMatchingGraph &nmgraph,
+								   std::vector<unsigned int> &matching);
+
+	/*! Function to find a perfect matching in an ImplicitBipartiteMatchingGraph, selected randomly among those with maximal
+	 *  score. The matching contains the clique ID of the matched target vertex for each source vertex. The shortest
+	 *  augmenting path engine is always used for implicit graphs.
+	 */
+	template<class Score>
+	bool findRandomPerfectMatching(const BasicImplicitBipartiteMatchingGraph<Score> &ibmgraph,
+								   std::vector<unsigned int> &matching);
+
+private:
+
+	//! Function to return the data of the finder for the specified score type, replacing the one of another score type.
+	template<class Score>
+	impl::TypedScoreWorkspace<Score>& _getScoreWorkspace();
+	//! Function to find a perfect matching in the graph with the specified score type equivalent to a NonMatchingGraph.
+	template<class Score>
+	bool _findRandomPerfectMatchingInNonMatchingGraph(const NonMatchingGraph &nmgraph,
+													  std::vector<unsigned int> &matching);
+	//! Function to find a perfect matching in a BipartiteMatchingGraph with the selected engine, without any decomposition or reduction.
+	template<class Score>
+	bool _findPerfectMatchingWithEngine(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+										std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching);
+	//! Function to find a perfect matching in each connected component of a BipartiteMatchingGraph in parallel, and merge them into the matching of the graph.
+	template<class Score>
+	bool _findRandomPerfectMatchingInComponents(const BasicBipartiteMatchingGraph<Score> &bmgraph,
+												const std::vector<unsigned int> &component_ids,
+												unsigned int ncomponents,
+												std::vector<const typename BasicBipartiteMatchingGraph<Score>::Edge*> &matching);
+	//! Function to check that the specified graph has a perfect matching, or memorize its Hall violator and return false.
+	template<class Graph>
+	bool _checkPerfectMatchingExists(const Graph &graph);
 };
 
 
@@ -0,0 +1,100 @@
+/* RandomEngine.h */
+
+#ifndef RANDOM_ENGINE_H
+#define RANDOM_ENGINE_H
+
+
+
+#include <algorithm>
+#include <random>
+
+
+
+namespace wpm {
+
+
+
+/*! RandomEngine class, a cheap pseudo-random generator (splitmix64) used to draw the random choices of the solvers.
+ *  Unlike std::rand, each engine has its own state, so that concurrent solves do not share any state, and a given seed
+ *  gives the same sequence on every platform (the shuffles do not rely on implementation-defined distributions).
+ *  The class satisfies the requirements of a uniform random bit generator, so it may also be used with <random>.
+ */
+class RandomEngine
+{
+public:
+
+	typedef unsigned int result_type;
+
+private:
+
+	unsigned long long _state;	//!< Current state of the generator.
+
+public:
+
+	//! Default constructor, seeding the engine with a non-deterministic seed.
+	RandomEngine() : _state(generateSeed()) {}
+	//! Constructor seeding the engine with the specified seed.
+	explicit RandomEngine(unsigned long long seed) : _state(seed) {}
+
+	//! Function to reset the engine with the specified seed.
+	inline void seed(unsigned long long seed) { _state = seed; }
+
+	//! Function to draw the next 64-bit value.
+	inline unsigned long long next64()
+	{
+		unsigned long long z = (_state += 0x9E3779B97F4A7C15ULL);
+		z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+		z = (z^(z>>27))*0x94D049BB133111EBULL;
+		return z^(z>>31);
+	}
+
+	//! Function to draw the next 32-bit value.
+	inline result_type operator()() { return (result_type)(next64()>>32); }
+
+	//! Function to draw a value uniformly in [0,bound), with bound>0 (multiply-shift method with rejection, see Lemire 2019).
+	inline unsigned int uniform(unsigned int bound)
+	{
+		unsigned long long m = (unsigned long long)(*this)()*bound;
+		if((unsigned int)m<bound) {
+			const unsigned int threshold = (0u-bound)%bound;
+			while((unsigned int)m<threshold)
+				m = (unsigned long long)(*this)()*bound;
+		}
+		return (unsigned int)(m>>32);
+	}
+
+	//! Function to shuffle the specified range uniformly (Fisher-Yates shuffle).
+	template<class RandomIt>
+	void shuffle(RandomIt ibegin, RandomIt iend)
+	{
+		const unsigned int n = (unsigned int)(iend-ibegin);
+		for(unsigned int i=n; i>1; --i)
+			std::iter_swap(ibegin+(i-1), ibegin+uniform(i));
+	}
+
+	//! Function to derive the seed of an independent stream (e.g. one per task of a batch) from a seed and a stream index.
+	static inline unsigned long long deriveSeed(unsigned long long seed, unsigned long long stream)
+	{
+		RandomEngine engine(seed^(stream*0xD1B54A32D192ED03ULL));
+		return engine.next64();
+	}
+
+	//! Function to generate a non-deterministic seed.
+	static inline unsigned long long generateSeed()
+	{
+		std::random_device device;
+		return ((unsigned long long)device()<<32)^device();
+	}
+
+	// Bounds of the drawn values (in parentheses to avoid the min/max macros of Windows.h)
+	static inline result_type (min)() { return 0; }
+	static inline result_type (max)() { return (result_type)(-1); }
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //RANDOM_ENGINE_H
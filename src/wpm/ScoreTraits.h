@@ -0,0 +1,101 @@
+/* ScoreTraits.h
+ * This file defines the compile-time traits of the score types of the matching graphs. */
+
+#ifndef SCORE_TRAITS_H
+#define SCORE_TRAITS_H
+
+
+
+#include <cmath>
+#include <limits>
+
+
+
+namespace wpm {
+
+
+
+/*! ScoreTraits class, defining the special values and the arithmetic of a score type of the matching graphs. It is only
+ *  specialized for the score types with which the graphs and the finder are instantiated:
+ *   - int, the default, which is faster and takes half the memory, but whose labels l(s)+l(t)-w(s,t) may overflow with
+ *     wide scores (the PerfectMatchingFinder uses long long scores for the NonMatchingGraphs with costs above 2^24),
+ *   - long long, for the wide ranges of scores,
+ *   - double, for the fractional scores, where the edges whose slack is within the rounding tolerance are considered tight.
+ */
+template<class Score>
+struct ScoreTraits;
+
+
+
+namespace impl {
+
+//! Traits shared by the integer score types, for which all the computations are exact.
+template<class Integer>
+struct IntegerScoreTraits
+{
+	//! Flag indicating whether the scores are integers, hence whether the comparisons of the labels are exact.
+	static const bool is_integer = true;
+
+	//! Function to return the score of the edges which cannot be matched, lower than any other score.
+	static inline Integer forbidden() { return std::numeric_limits<Integer>::min(); }
+	//! Function to return a value greater than any slack, used to initialize the minimums.
+	static inline Integer infinity() { return std::numeric_limits<Integer>::max(); }
+	//! Function to indicate whether the specified score is the one of the edges which cannot be matched.
+	static inline bool isForbidden(Integer score) { return score==forbidden(); }
+	//! Function to indicate whether the specified slack is zero.
+	static inline bool isZero(Integer slack) { return slack==0; }
+
+	//! Function to convert the cost of a non-matching edge into a score, where the cost -1 means that the edge is forbidden.
+	static inline Integer fromCost(unsigned int cost) { return (cost==(unsigned int)(-1) ? forbidden() : -(Integer)cost); }
+	//! Function to convert a score back into the cost of a non-matching edge.
+	static inline unsigned int toCost(Integer score) { return (isForbidden(score) ? (unsigned int)(-1) : (unsigned int)(-score)); }
+};
+
+}	// namespace impl
+
+
+
+//! Traits of the 32-bit integer scores.
+template<>
+struct ScoreTraits<int> : public impl::IntegerScoreTraits<int>
+{
+};
+
+//! Traits of the 64-bit integer scores.
+template<>
+struct ScoreTraits<long long> : public impl::IntegerScoreTraits<long long>
+{
+};
+
+//! Traits of the floating-point scores, whose forbidden score is minus infinity.
+template<>
+struct ScoreTraits<double>
+{
+	//! Flag indicating whether the scores are integers, hence whether the comparisons of the labels are exact.
+	static const bool is_integer = false;
+
+	//! Function to return the tolerance under which a slack is considered zero, to absorb the rounding errors on the labels.
+	static inline double tolerance() { return 1e-9; }
+
+	//! Function to return the score of the edges which cannot be matched, lower than any other score.
+	static inline double forbidden() { return -std::numeric_limits<double>::infinity(); }
+	//! Function to return a value greater than any slack, used to initialize the minimums.
+	static inline double infinity() { return std::numeric_limits<double>::infinity(); }
+	//! Function to indicate whether the specified score is the one of the edges which cannot be matched.
+	static inline bool isForbidden(double score) { return score==forbidden(); }
+	//! Function to indicate whether the specified slack is zero, up to the rounding tolerance.
+	static inline bool isZero(double slack) { return std::fabs(slack)<=tolerance(); }
+
+	//! Function to convert the cost of a non-matching edge into a score, where the cost -1 means that the edge is forbidden.
+	static inline double fromCost(unsigned int cost) { return (cost==(unsigned int)(-1) ? forbidden() : -(double)cost); }
+	//! Function to convert a score back into the cost of a non-matching edge, rounded to the nearest integer.
+	static inline unsigned int toCost(double score) { return (isForbidden(score) ? (unsigned int)(-1) : (unsigned int)std::floor(0.5-score)); }
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //SCORE_TRAITS_H
@@ -0,0 +1,210 @@
+/* SmallPerfectMatchingFinder.h */
+
+#ifndef SMALL_PERFECT_MATCHING_FINDER_H
+#define SMALL_PERFECT_MATCHING_FINDER_H
+
+
+
+#include <limits>
+#include <vector>
+#include "WPMAssert.h"
+#include "BitOperations.h"
+#include "RandomEngine.h"
+#include "ScoreTraits.h"
+
+
+
+namespace wpm {
+
+
+
+/*! SmallPerfectMatchingFinder class, in charge of finding a perfect matching with maximal score in a small graph, whose
+ *  number of cliques is bounded at compile time (at most 64). The graph is stored as a dense matrix of scores in fixed
+ *  arrays, with one bitmask of matchable target vertices per source vertex, and the sets of the augmenting path search
+ *  are bitmasks too, so that a search does not allocate any memory and only touches a few cache lines.
+ *  As in an ImplicitBipartiteMatchingGraph, every source vertex is linked to the target vertex of every other clique with
+ *  a default score of zero, and an explicit score equal to ScoreTraits<Score>::forbidden() means that the two cliques
+ *  cannot be matched. The matching is found with the O(n^3) shortest augmenting path variant of the Hungarian
+ *  algorithm on the dense matrix, after the source and target vertices were randomly permuted. The scores are int by
+ *  default, and may be of any type supported by ScoreTraits.
+ */
+template<unsigned int MAX_NCLIQUES, class Score=int>
+class SmallPerfectMatchingFinder
+{
+	static_assert(MAX_NCLIQUES>0 && MAX_NCLIQUES<=64, "The cliques of a small graph must fit in a 64-bit mask!");
+
+private:
+
+	unsigned int _ncliques;								//!< Number of cliques in the graph.
+	Score _scores[MAX_NCLIQUES][MAX_NCLIQUES];			//!< Matrix containing the score of the edge from each source vertex to each target vertex.
+	unsigned long long _edge_masks[MAX_NCLIQUES];		//!< Array containing, for each source vertex, the mask of the target vertices which can be matched with it.
+	// Workspace of the search, on the randomly permuted source and target vertices
+	unsigned int _source_order[MAX_NCLIQUES];			//!< Clique ID of the source vertex at each position of the random permutation.
+	unsigned int _target_order[MAX_NCLIQUES];			//!< Clique ID of the target vertex at each position of the random permutation.
+	Score _costs[MAX_NCLIQUES][MAX_NCLIQUES];			//!< Matrix containing the cost c(s,t)=-w(s,t) of each edge between permuted vertices.
+	unsigned long long _cost_masks[MAX_NCLIQUES];		//!< Array containing, for each permuted source vertex, the mask of the permuted target vertices which can be matched with it.
+	Score _u[MAX_NCLIQUES];								//!< Array containing the dual value of each permuted source vertex.
+	Score _v[MAX_NCLIQUES];								//!< Array containing the dual value of each permuted target vertex.
+	unsigned int _x[MAX_NCLIQUES];						//!< Array containing, for each permuted source vertex, the matched permuted target vertex if it exists and -1 otherwise.
+	unsigned int _y[MAX_NCLIQUES];						//!< Array containing, for each permuted target vertex, the matched permuted source vertex if it exists and -1 otherwise.
+	unsigned long long _matched_mask;					//!< Mask of the matched permuted target vertices.
+	Score _min_slack[MAX_NCLIQUES];						//!< Array containing, for each permuted target vertex, the minimal reduced cost from the source vertices of the current search.
+	unsigned int _pred[MAX_NCLIQUES];					//!< Array containing, for each permuted target vertex, the permuted source vertex associated to its minimal reduced cost.
+
+public:
+
+	//! Default constructor, initializing an empty graph.
+	SmallPerfectMatchingFinder() : _ncliques(0) {}
+
+	//! Function to return the maximal number of cliques of the graphs handled by this finder.
+	static inline unsigned int getMaxNumberCliques() { return MAX_NCLIQUES; }
+
+	//! Function to start a new graph with the specified number of cliques, in which all pairs of different cliques can be matched with a score of zero.
+	void startNewGraph(unsigned int ncliques)
+	{
+		WPMASSERT(ncliques<=MAX_NCLIQUES, "The graph is too large for this finder!");
+		_ncliques = ncliques;
+		const unsigned long long all_mask = (ncliques==64 ? ~0ULL : (1ULL<<ncliques)-1);
+		for(unsigned int cid_source=0; cid_source<_ncliques; ++cid_source) {
+			for(unsigned int cid_target=0; cid_target<_ncliques; ++cid_target)
+				_scores[cid_source][cid_target] = 0;
+			_edge_masks[cid_source] = all_mask&~(1ULL<<cid_source);	// A clique can never be matched with itself
+		}
+	}
+
+	//! Function to set the score of the edge from a source vertex to a target vertex (ScoreTraits<Score>::forbidden() if they cannot be matched).
+	void setDirectedEdgeScore(unsigned int cid_source, unsigned int cid_target, Score score)
+	{
+		WPMASSERT(cid_source<_ncliques && cid_target<_ncliques, "Input clique ID does not exist!");
+		if(cid_source==cid_target)
+			return;	// A clique can never be matched with itself
+		_scores[cid_source][cid_target] = score;
+		if(ScoreTraits<Score>::isForbidden(score))
+			_edge_masks[cid_source] &= ~(1ULL<<cid_target);
+		else _edge_masks[cid_source] |= (1ULL<<cid_target);
+	}
+
+	//! Function to return the number of cliques in the graph.
+	inline unsigned int getNumberCliques() const { return _ncliques; }
+
+	/*! Function to find a perfect matching in the graph, selected randomly among those with maximal score. The matching
+	 *  contains the clique ID of the matched target vertex for each source vertex.
+	 */
+	bool findRandomPerfectMatching(std::vector<unsigned int> &matching, RandomEngine &random_engine)
+	{
+		_permuteVertices(random_engine);
+		for(unsigned int s=0; s<_ncliques; ++s) {
+			if(!_augment(s))
+				return false;	// No augmenting path exists, hence the graph has no perfect matching
+		}
+		matching.resize(_ncliques);
+		for(unsigned int s=0; s<_ncliques; ++s)
+			matching[_source_order[s]] = _target_order[_x[s]];
+		return true;
+	}
+
+private:
+
+	//! Function to draw a random permutation of the source and target vertices, and initialize the search on the permuted costs.
+	void _permuteVertices(RandomEngine &random_engine)
+	{
+		for(unsigned int cid=0; cid<_ncliques; ++cid) {
+			_source_order[cid] = cid;
+			_target_order[cid] = cid;
+		}
+		random_engine.shuffle(_source_order, _source_order+_ncliques);
+		random_engine.shuffle(_target_order, _target_order+_ncliques);
+		_matched_mask = 0;
+		for(unsigned int s=0; s<_ncliques; ++s) {
+			const unsigned int cid_source = _source_order[s];
+			unsigned long long mask = 0;
+			for(unsigned int t=0; t<_ncliques; ++t) {
+				const unsigned int cid_target = _target_order[t];
+				if(_edge_masks[cid_source]&(1ULL<<cid_target)) {
+					_costs[s][t] = -_scores[cid_source][cid_target];
+					mask |= (1ULL<<t);
+				}
+			}
+			_cost_masks[s] = mask;
+			_u[s] = 0;
+			_v[s] = 0;
+			_x[s] = (unsigned int)(-1);
+			_y[s] = (unsigned int)(-1);
+		}
+	}
+
+	/*! Function to match the specified exposed source vertex along a shortest augmenting path for the reduced costs
+	 *  c(s,t)-u(s)-v(t), updating the duals so that the matched edges remain tight. The set of scanned target vertices
+	 *  is a bitmask, and the loops only visit the set bits of the masks.
+	 */
+	bool _augment(unsigned int root_s)
+	{
+		const unsigned long long all_mask = (_ncliques==64 ? ~0ULL : (1ULL<<_ncliques)-1);
+		unsigned long long scanned_mask = 0;	// Target vertices whose matched source vertex is in the alternating tree
+		for(unsigned int t=0; t<_ncliques; ++t)
+			_min_slack[t] = ScoreTraits<Score>::infinity();
+		unsigned int s = root_s;
+		unsigned int end_t;
+		while(true) {
+			// Update the minimal reduced costs with the edges of the last source vertex added to the alternating tree
+			for(unsigned long long mask=_cost_masks[s]&~scanned_mask; mask!=0; mask&=mask-1) {
+				const unsigned int t = impl::findLowestSetBit(mask);
+				const Score reduced_cost = _costs[s][t]-_u[s]-_v[t];
+				if(reduced_cost<_min_slack[t]) {
+					_min_slack[t] = reduced_cost;
+					_pred[t] = s;
+				}
+			}
+			// Select the closest target vertex which is not scanned yet, preferring the exposed ones in case of ties since they end the path
+			Score delta = ScoreTraits<Score>::infinity();
+			unsigned int closest_t = (unsigned int)(-1);
+			for(unsigned long long mask=all_mask&~scanned_mask; mask!=0; mask&=mask-1) {
+				const unsigned int t = impl::findLowestSetBit(mask);
+				if(_min_slack[t]<delta || (_min_slack[t]==delta && closest_t!=(unsigned int)(-1) && (_matched_mask&(1ULL<<closest_t))!=0 && (_matched_mask&(1ULL<<t))==0)) {
+					delta = _min_slack[t];
+					closest_t = t;
+				}
+			}
+			if(closest_t==(unsigned int)(-1))
+				return false;	// No target vertex can be reached anymore
+			// Update the duals, so that the edge towards the closest target vertex becomes tight
+			_u[root_s] += delta;
+			for(unsigned long long mask=scanned_mask; mask!=0; mask&=mask-1) {
+				const unsigned int t = impl::findLowestSetBit(mask);
+				_u[_y[t]] += delta;
+				_v[t] -= delta;
+			}
+			for(unsigned long long mask=all_mask&~scanned_mask; mask!=0; mask&=mask-1) {
+				const unsigned int t = impl::findLowestSetBit(mask);
+				if(_min_slack[t]!=ScoreTraits<Score>::infinity())
+					_min_slack[t] -= delta;
+			}
+			// If the closest target vertex is exposed, the shortest augmenting path is found, otherwise grow the tree
+			scanned_mask |= (1ULL<<closest_t);
+			if(_y[closest_t]==(unsigned int)(-1)) {
+				end_t = closest_t;
+				break;
+			}
+			s = _y[closest_t];
+		}
+		// Augment the matching along the path, from its end exposed target vertex
+		unsigned int t = end_t;
+		while(t!=(unsigned int)(-1)) {
+			const unsigned int pred_s = _pred[t];
+			const unsigned int next_t = _x[pred_s];
+			_x[pred_s] = t;
+			_y[t] = pred_s;
+			t = next_t;
+		}
+		_matched_mask |= (1ULL<<end_t);
+		return true;
+	}
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //SMALL_PERFECT_MATCHING_FINDER_H
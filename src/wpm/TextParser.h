@@ -0,0 +1,162 @@
+/* TextParser.h
+ * This file defines the helpers used to parse the text graph formats directly from a contiguous buffer. */
+
+#ifndef TEXT_PARSER_H
+#define TEXT_PARSER_H
+
+
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "BitOperations.h"
+
+
+
+namespace wpm {
+namespace impl {
+
+
+
+/*! Function to parse the specified character at the current position, and advance the position past it. The parsing
+ *  functions below return false without guarantee on the position if the expected token is not found.
+ */
+inline bool parseChar(const char *&ptr, const char *end, char c)
+{
+	if(ptr==end || *ptr!=c)
+		return false;
+	++ptr;
+	return true;
+}
+
+/*! Function to parse the end of a line at the current position, made of a line feed optionally preceded by a carriage
+ *  return, since the files written on Windows in text mode end their lines with "\r\n".
+ */
+inline bool parseEndOfLine(const char *&ptr, const char *end)
+{
+	if(ptr!=end && *ptr=='\r')
+		++ptr;
+	return parseChar(ptr, end, '\n');
+}
+
+/*! Function to read eight characters as a little-endian 64-bit word, the first character being the lowest byte. The bytes
+ *  are assembled explicitly, which the compilers turn into a single load on little-endian targets.
+ */
+inline unsigned long long loadEightCharsLE(const char *ptr)
+{
+	const unsigned char *bytes = (const unsigned char*)ptr;
+	return (unsigned long long)bytes[0] | ((unsigned long long)bytes[1]<<8) | ((unsigned long long)bytes[2]<<16) | ((unsigned long long)bytes[3]<<24)
+		| ((unsigned long long)bytes[4]<<32) | ((unsigned long long)bytes[5]<<40) | ((unsigned long long)bytes[6]<<48) | ((unsigned long long)bytes[7]<<56);
+}
+
+/*! Function to parse the leading decimal digits of eight characters loaded by loadEightCharsLE, without any branch
+ *  depending on the number of digits. The number of leading digits (between 0 and 8) is returned in ndigits.
+ */
+inline unsigned int parseEightCharsDigits(unsigned long long chars, unsigned int &ndigits)
+{
+	// The bytes which are not digits are the non-zero bytes of 'non_digits': a digit has 0x3 as high nibble, and keeps it
+	// when adding 6 to its low nibble. The carries of the addition only go into the bytes after a non-digit.
+	const unsigned long long non_digits = ((chars & 0xF0F0F0F0F0F0F0F0ULL) | (((chars+0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL)>>4)) ^ 0x3333333333333333ULL;
+	ndigits = (non_digits!=0 ? findLowestSetBit(non_digits)/8 : 8);
+	if(ndigits==0)
+		return 0;
+	// The digits are moved to the highest bytes, the lowest ones becoming leading zeros, and combined pairwise
+	unsigned long long digits = (chars<<(8*(8-ndigits))) & 0x0F0F0F0F0F0F0F0FULL;
+	digits = (digits*(1+(10<<8)))>>8;
+	digits = ((digits & 0x00FF00FF00FF00FFULL)*(1+(100<<16)))>>16;
+	return (unsigned int)(((digits & 0x0000FFFF0000FFFFULL)*(1+(10000ULL<<32)))>>32);
+}
+
+/*! Function to parse an unsigned integer at the current position, with the same rules as the stream extraction used by
+ *  the text deserializers: an optional sign followed by at least one digit, a negative value being wrapped modulo 2^32
+ *  (e.g. "-1" gives 4294967295). Values whose magnitude does not fit in 32 bits are rejected.
+ *  When at least eight characters remain, the first eight digits are parsed at once with parseEightCharsDigits, since a
+ *  loop over the digits mispredicts its exit for numbers of random lengths.
+ */
+inline bool parseUnsignedInt(const char *&ptr, const char *end, unsigned int &value)
+{
+	bool is_negative = false;
+	if(ptr!=end && (*ptr=='-' || *ptr=='+'))
+		is_negative = (*(ptr++)=='-');
+	unsigned long long magnitude = 0;
+	if(end-ptr>=8) {
+		unsigned int ndigits;
+		magnitude = parseEightCharsDigits(loadEightCharsLE(ptr), ndigits);
+		if(ndigits==0)
+			return false;
+		ptr += ndigits;
+	}
+	else {
+		if(ptr==end || *ptr<'0' || *ptr>'9')
+			return false;
+		magnitude = (unsigned int)(*(ptr++)-'0');
+	}
+	// The remaining digits, if any, are parsed one by one
+	while(ptr!=end && *ptr>='0' && *ptr<='9') {
+		magnitude = 10*magnitude+(unsigned int)(*ptr-'0');
+		if(magnitude>std::numeric_limits<unsigned int>::max())
+			return false;
+		++ptr;
+	}
+	value = (is_negative ? (unsigned int)(0ULL-magnitude) : (unsigned int)magnitude);
+	return true;
+}
+
+//! Function to parse a signed integer at the current position: an optional sign followed by at least one digit, within the range of the integer type.
+template<class Integer>
+inline bool parseSignedInteger(const char *&ptr, const char *end, Integer &value)
+{
+	bool is_negative = false;
+	if(ptr!=end && (*ptr=='-' || *ptr=='+'))
+		is_negative = (*(ptr++)=='-');
+	if(ptr==end || *ptr<'0' || *ptr>'9')
+		return false;
+	const unsigned long long max_magnitude = (is_negative ? 1ULL+(unsigned long long)std::numeric_limits<Integer>::max() : (unsigned long long)std::numeric_limits<Integer>::max());
+	unsigned long long magnitude = 0;
+	do {
+		const unsigned int digit = (unsigned int)(*ptr-'0');
+		if(magnitude>(max_magnitude-digit)/10)
+			return false;
+		magnitude = 10*magnitude+digit;
+		++ptr;
+	} while(ptr!=end && *ptr>='0' && *ptr<='9');
+	value = (is_negative ? (Integer)(0ULL-magnitude) : (Integer)magnitude);
+	return true;
+}
+
+//! Function to parse a signed integer at the current position: an optional sign followed by at least one digit, within the range of int.
+inline bool parseInt(const char *&ptr, const char *end, int &value)
+{
+	return parseSignedInteger(ptr, end, value);
+}
+
+/*! Function to parse a floating-point number at the current position, in the decimal notation written by the stream
+ *  insertion (e.g. "-12", "0.5", "1.5e-07", "-inf"). The token is copied into a small buffer, since the buffer to parse
+ *  is not null-terminated.
+ */
+inline bool parseDouble(const char *&ptr, const char *end, double &value)
+{
+	char token[64];
+	size_t length = 0;
+	while(ptr+length!=end && length<sizeof(token)-1 && std::strchr("+-.0123456789eEinfINF", ptr[length])!=NULL && ptr[length]!='\0') {
+		token[length] = ptr[length];
+		++length;
+	}
+	if(length==0 || length==sizeof(token)-1)
+		return false;
+	token[length] = '\0';
+	char *token_end;
+	value = std::strtod(token, &token_end);
+	if(token_end!=token+length)
+		return false;
+	ptr += length;
+	return true;
+}
+
+
+}	// namespace impl
+}	// namespace wpm
+
+
+
+#endif //TEXT_PARSER_H
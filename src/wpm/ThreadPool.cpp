@@ -0,0 +1,139 @@
+/* ThreadPool.cpp */
+
+
+
+#include <algorithm>
+#include "WPMAssert.h"
+#include "ThreadPool.h"
+
+
+
+namespace wpm {
+
+
+
+ThreadPool::ThreadPool(unsigned int nthreads)
+	: _nthreads(nthreads>0 ? nthreads : std::max(std::thread::hardware_concurrency(), 1u))
+	, _queues(_nthreads)
+	, _task(NULL)
+	, _batch_id(0)
+	, _nbusy_threads(0)
+	, _is_stopping(false)
+{
+	_threads.reserve(_nthreads-1);
+	for(unsigned int worker=1; worker<_nthreads; ++worker)
+		_threads.push_back(std::thread(&ThreadPool::_workerLoop, this, worker));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_is_stopping = true;
+	}
+	_cv_start.notify_all();
+	for(std::vector<std::thread>::iterator it_t=_threads.begin(); it_t!=_threads.end(); ++it_t)
+		it_t->join();
+}
+
+void ThreadPool::run(unsigned int ntasks, const Task &task)
+{
+	if(ntasks==0)
+		return;
+	// Split the tasks into contiguous blocks, one per worker
+	for(unsigned int worker=0; worker<_nthreads; ++worker) {
+		const unsigned int begin = (unsigned int)((unsigned long long)ntasks*worker/_nthreads);
+		const unsigned int end = (unsigned int)((unsigned long long)ntasks*(worker+1)/_nthreads);
+		std::lock_guard<std::mutex> lock(_queues[worker].mutex);
+		for(unsigned int task_index=begin; task_index<end; ++task_index)
+			_queues[worker].tasks.push_back(task_index);
+	}
+	// Start the batch on the worker threads, and process the tasks in the calling thread
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_exception = std::exception_ptr();
+		_nbusy_threads = _nthreads-1;
+		++_batch_id;
+	}
+	_cv_start.notify_all();
+	_processTasks(0);
+	// Wait until the worker threads are done, since they may still be running stolen tasks
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		while(_nbusy_threads>0)
+			_cv_done.wait(lock);
+		_task = NULL;
+		exception = _exception;
+	}
+	if(exception)
+		std::rethrow_exception(exception);
+}
+
+void ThreadPool::_workerLoop(unsigned int worker)
+{
+	unsigned int last_batch_id = 0;
+	while(true) {
+		// Wait for the next batch
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			while(!_is_stopping && _batch_id==last_batch_id)
+				_cv_start.wait(lock);
+			if(_is_stopping)
+				return;
+			last_batch_id = _batch_id;
+		}
+		// Process the tasks, then notify the calling thread
+		_processTasks(worker);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_nbusy_threads;
+		}
+		_cv_done.notify_one();
+	}
+}
+
+void ThreadPool::_processTasks(unsigned int worker)
+{
+	unsigned int task_index;
+	while(_popTask(worker, task_index)) {
+		try {
+			(*_task)(task_index, worker);
+		}
+		catch(...) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if(!_exception)
+				_exception = std::current_exception();
+		}
+	}
+}
+
+bool ThreadPool::_popTask(unsigned int worker, unsigned int &task_index)
+{
+	// First process the own tasks of the worker, in order
+	{
+		WorkerQueue &queue = _queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if(!queue.tasks.empty()) {
+			task_index = queue.tasks.front();
+			queue.tasks.pop_front();
+			return true;
+		}
+	}
+	// Then steal the last task of another worker, starting with the next one
+	for(unsigned int offset=1; offset<_nthreads; ++offset) {
+		WorkerQueue &queue = _queues[(worker+offset)%_nthreads];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if(!queue.tasks.empty()) {
+			task_index = queue.tasks.back();
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+}	// namespace wpm
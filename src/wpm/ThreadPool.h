@@ -0,0 +1,91 @@
+/* ThreadPool.h */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace wpm {
+
+
+
+/*! ThreadPool class, running batches of independent tasks on a fixed set of worker threads with work stealing.
+ *  The tasks of a batch are split into contiguous blocks, one per worker. Each worker processes its own block from the
+ *  front, and once it is empty, it steals tasks from the back of the blocks of the other workers, so that the load
+ *  remains balanced when the tasks have very different durations. The thread calling run() takes part in the batch as
+ *  the first worker, hence a pool with a single thread runs the tasks sequentially without starting any thread.
+ */
+class ThreadPool
+{
+public:
+
+	//! Type of the function called for each task, with the task index and the index of the worker running it.
+	typedef std::function<void(unsigned int /*task index*/, unsigned int /*worker index*/)> Task;
+
+private:
+
+	//! Queue structure, containing the indices of the tasks which remain to be processed by one worker.
+	struct WorkerQueue
+	{
+		std::mutex mutex;					//!< Mutex protecting the queue.
+		std::deque<unsigned int> tasks;		//!< Indices of the remaining tasks.
+	};
+
+	const unsigned int _nthreads;			//!< Number of workers, including the thread calling run().
+	std::vector<std::thread> _threads;		//!< Worker threads (all workers but the first one).
+	std::vector<WorkerQueue> _queues;		//!< Queue of each worker.
+	std::mutex _mutex;						//!< Mutex protecting the state of the current batch.
+	std::condition_variable _cv_start;		//!< Condition variable notified when a batch starts or when the pool is destroyed.
+	std::condition_variable _cv_done;		//!< Condition variable notified when a worker thread is done with the current batch.
+	const Task *_task;						//!< Function of the current batch.
+	unsigned int _batch_id;					//!< Identifier of the current batch, incremented for each batch.
+	unsigned int _nbusy_threads;			//!< Number of worker threads which are not done with the current batch.
+	std::exception_ptr _exception;			//!< First exception thrown by a task of the current batch.
+	bool _is_stopping;						//!< Flag indicating whether the worker threads must stop.
+
+public:
+
+	//! Constructor, starting the worker threads (0 for the number of hardware threads).
+	ThreadPool(unsigned int nthreads=0);
+	//! Destructor, stopping the worker threads.
+	~ThreadPool();
+
+	//! Function to return the number of workers, including the thread calling run().
+	inline unsigned int getNumberThreads() const { return _nthreads; }
+
+	/*! Function to run the specified function for each task index in [0,ntasks), and return once all the tasks are done.
+	 *  If some tasks throw an exception, the remaining tasks are still run and the first exception is rethrown.
+	 */
+	void run(unsigned int ntasks, const Task &task);
+
+private:
+
+	//! Function executed by each worker thread.
+	void _workerLoop(unsigned int worker);
+	//! Function to process the tasks of the current batch, first from the queue of the specified worker, then from the others.
+	void _processTasks(unsigned int worker);
+	//! Function to pop the next task from the queue of the specified worker, or steal one from another worker.
+	bool _popTask(unsigned int worker, unsigned int &task_index);
+
+	// A thread pool cannot be copied
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //THREAD_POOL_H
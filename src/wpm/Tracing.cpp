@@ -0,0 +1,151 @@
+/* Tracing.cpp */
+
+
+
+#include <fstream>
+#include "WPMAssert.h"
+#include "Tracing.h"
+
+
+
+namespace wpm {
+
+
+
+namespace impl {
+
+std::atomic<TraceSink> current_trace_sink(NULL);
+
+//! User data passed to the installed sink.
+static std::atomic<void*> current_trace_user_data(NULL);
+
+//! Number of threads which have reported a span so far, used to give a small identifier to each thread.
+static std::atomic<unsigned int> ntraced_threads(0);
+
+//! Function to return the identifier of the calling thread in the spans, given on its first span.
+static unsigned int getTraceThreadId()
+{
+	static thread_local unsigned int thread_id = 0;
+	if(thread_id==0)
+		thread_id = ++ntraced_threads;
+	return thread_id;
+}
+
+void reportTraceSpan(TraceSink sink, const char *name, const std::chrono::steady_clock::time_point &start)
+{
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	TraceSpan span;
+	span.name = name;
+	span.start_us = std::chrono::duration<double, std::micro>(start.time_since_epoch()).count();
+	span.duration_us = std::chrono::duration<double, std::micro>(end-start).count();
+	span.thread_id = getTraceThreadId();
+	sink(span, current_trace_user_data.load(std::memory_order_acquire));
+}
+
+//! Function to write the specified string as a JSON string.
+static void writeJSONString(std::ostream &os, const char *str)
+{
+	os << '"';
+	for(; *str!='\0'; ++str) {
+		if(*str=='"' || *str=='\\')
+			os << '\\';
+		if((unsigned char)*str>=0x20)
+			os << *str;
+	}
+	os << '"';
+}
+
+}
+
+
+
+void setTraceSink(TraceSink sink, void *user_data)
+{
+	impl::current_trace_user_data.store(user_data, std::memory_order_release);
+	impl::current_trace_sink.store(sink, std::memory_order_release);
+}
+
+bool isTracingEnabled()
+{
+	return impl::current_trace_sink.load(std::memory_order_acquire)!=NULL;
+}
+
+
+
+TraceRecorder::TraceRecorder()
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+	uninstall();
+}
+
+void TraceRecorder::install()
+{
+	setTraceSink(&TraceRecorder::record, this);
+}
+
+void TraceRecorder::uninstall()
+{
+	if(impl::current_trace_sink.load(std::memory_order_acquire)==&TraceRecorder::record
+	   && impl::current_trace_user_data.load(std::memory_order_acquire)==this)
+		setTraceSink(NULL);
+}
+
+void TraceRecorder::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_spans.clear();
+}
+
+void TraceRecorder::getSpans(std::vector<TraceSpan> &spans) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	spans = _spans;
+}
+
+bool TraceRecorder::exportChromeTrace(std::ostream &os) const
+{
+	std::vector<TraceSpan> spans;
+	getSpans(spans);
+
+	double origin_us = 0.0;
+	for(unsigned int s=0; s<spans.size(); ++s)
+		if(s==0 || spans[s].start_us<origin_us)
+			origin_us = spans[s].start_us;
+
+	os << "{\"traceEvents\":[";
+	const std::streamsize precision = os.precision(3);
+	const std::ios::fmtflags flags = os.setf(std::ios::fixed, std::ios::floatfield);
+	for(unsigned int s=0; s<spans.size(); ++s) {
+		os << (s>0 ? ",\n" : "\n") << "{\"name\":";
+		impl::writeJSONString(os, spans[s].name);
+		os << ",\"cat\":\"wpm\",\"ph\":\"X\",\"ts\":" << spans[s].start_us-origin_us << ",\"dur\":" << spans[s].duration_us
+		   << ",\"pid\":1,\"tid\":" << spans[s].thread_id << "}";
+	}
+	os.precision(precision);
+	os.flags(flags);
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return os.good();
+}
+
+bool TraceRecorder::saveChromeTrace(const std::string &filepath) const
+{
+	std::ofstream os(filepath, std::ios::out|std::ios::trunc);
+	if(!os.is_open())
+		return false;
+	return exportChromeTrace(os);
+}
+
+void TraceRecorder::record(const TraceSpan &span, void *recorder)
+{
+	WPMASSERT(recorder!=NULL, "The trace recorder must be passed as user data!");
+	TraceRecorder &self = *(TraceRecorder*)recorder;
+	std::lock_guard<std::mutex> lock(self._mutex);
+	self._spans.push_back(span);
+}
+
+
+
+}	// namespace wpm
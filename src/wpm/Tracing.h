@@ -0,0 +1,141 @@
+/* Tracing.h */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+
+namespace wpm {
+
+
+
+//! Span of time spent in a stage of the matching pipeline, reported to the trace sink when the stage ends.
+struct TraceSpan
+{
+	const char *name;			//!< Name of the stage (static string, e.g. "deserialize" or "solve").
+	double start_us;			//!< Start of the stage, in microseconds since the epoch of the steady clock.
+	double duration_us;			//!< Duration of the stage, in microseconds.
+	unsigned int thread_id;		//!< Small integer identifying the thread which ran the stage (1 for the first traced thread).
+};
+
+//! Callback receiving the spans of the stages, possibly from several threads at once, with the user data specified when it was installed.
+typedef void (*TraceSink)(const TraceSpan &span, void *user_data);
+
+/*! Function to install the sink receiving the spans of all the stages which start afterwards, or to disable tracing with
+ *  NULL (the default). Tracing is global to the library, and the sink should be replaced while no search is running.
+ */
+void setTraceSink(TraceSink sink, void *user_data=NULL);
+//! Function to indicate whether a trace sink is installed.
+bool isTracingEnabled();
+
+
+
+namespace impl {
+
+//! Sink currently installed (NULL if tracing is disabled), read by each traced stage.
+extern std::atomic<TraceSink> current_trace_sink;
+//! Function to report the span of a stage ending now to the specified sink.
+void reportTraceSpan(TraceSink sink, const char *name, const std::chrono::steady_clock::time_point &start);
+
+}
+
+
+
+/*! ScopedTraceSpan class, recording the span of a stage of the pipeline from its construction to its destruction (or to the
+ *  call to end). When tracing is disabled, the span only reads the installed sink once, and does not read the clock.
+ */
+class ScopedTraceSpan
+{
+private:
+
+	const char *_name;								//!< Name of the stage.
+	TraceSink _sink;								//!< Sink installed when the stage started, or NULL if the stage is not traced.
+	std::chrono::steady_clock::time_point _start;	//!< Start of the stage.
+
+public:
+
+	//! Constructor starting the span of the specified stage, whose name must be a static string.
+	explicit ScopedTraceSpan(const char *name)
+		: _name(name)
+		, _sink(impl::current_trace_sink.load(std::memory_order_acquire))
+	{
+		if(_sink!=NULL)
+			_start = std::chrono::steady_clock::now();
+	}
+
+	//! Destructor, ending the span if it was not ended.
+	~ScopedTraceSpan() { end(); }
+
+	//! Function to end the span of the stage, and report it to the sink.
+	inline void end()
+	{
+		if(_sink!=NULL)
+			impl::reportTraceSpan(_sink, _name, _start);
+		_sink = NULL;
+	}
+
+private:
+
+	ScopedTraceSpan(const ScopedTraceSpan&);
+	ScopedTraceSpan& operator=(const ScopedTraceSpan&);
+};
+
+
+
+/*! TraceRecorder class, a trace sink keeping all the spans in memory, e.g. over the requests of a benchmark or of a slow
+ *  production run, and exporting them in the trace event format of Chrome, which can be opened in chrome://tracing or in
+ *  the Perfetto UI. The spans are recorded under a mutex, hence from any number of threads.
+ */
+class TraceRecorder
+{
+private:
+
+	mutable std::mutex _mutex;			//!< Mutex protecting the recorded spans.
+	std::vector<TraceSpan> _spans;		//!< Spans recorded so far.
+
+public:
+
+	//! Default constructor.
+	TraceRecorder();
+	//! Destructor, uninstalling the recorder if it is the installed sink.
+	~TraceRecorder();
+
+	//! Function to install this recorder as the trace sink.
+	void install();
+	//! Function to uninstall this recorder, if it is the installed sink.
+	void uninstall();
+	//! Function to forget the recorded spans.
+	void clear();
+	//! Function to return a copy of the recorded spans, in the order in which they ended.
+	void getSpans(std::vector<TraceSpan> &spans) const;
+
+	//! Function to write the recorded spans as a Chrome trace event JSON document, with the times relative to the first span.
+	bool exportChromeTrace(std::ostream &os) const;
+	//! Function to save the recorded spans as a Chrome trace event JSON file.
+	bool saveChromeTrace(const std::string &filepath) const;
+
+	//! Trace sink recording the specified span into the recorder passed as user data.
+	static void record(const TraceSpan &span, void *recorder);
+
+private:
+
+	TraceRecorder(const TraceRecorder&);
+	TraceRecorder& operator=(const TraceRecorder&);
+};
+
+
+
+}	// namespace wpm
+
+
+
+#endif //TRACING_H
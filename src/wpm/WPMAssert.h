@@ -1,6 +1,7 @@
 /* WPMASSERT.h (created on 04/06/2016 by Nicolas) */
 
 #include <iostream>
+#include <stdexcept>
 
 #ifdef _DEBUG
 #define WPMASSERT(prop, msg) if(!(prop)){std::cout << "FAILED ASSERTION in '" << __FILE__ << "':" << __LINE__ << ": " << msg << std::endl; std::cout.flush(); throw std::runtime_error(msg);}
@@ -6,7 +6,13 @@
 
 
 
+#include <stdint.h>
+
+
+
+#ifdef __cplusplus
 extern "C" {
+#endif
 
 
 
@@ -17,10 +23,12 @@ extern "C" {
 #define RESCODE_INVALID_MATCHING 3
 #define RESCODE_KNOWN_EXCEPTION 4
 #define RESCODE_UNKNOWN_EXCEPTION 5
+#define RESCODE_INFEASIBLE_GRAPH 6
+#define RESCODE_INVALID_ARGUMENT 7
 
 
 
-//! Declaration of callback invokers (called by the library to pass results).
+//! Declaration of callback invokers (called by the library to pass results). With RESCODE_INFEASIBLE_GRAPH, the third argument describes the vertices preventing a perfect matching.
 typedef void(*invoke_oncomplete_callback_t)(int /*error code*/, const char* /*matching*/, const char* /*updated graph or known exception message*/);
 
 
@@ -28,9 +36,54 @@ typedef void(*invoke_oncomplete_callback_t)(int /*error code*/, const char* /*ma
 //! Find a perfect matching over the specified graph, which is selected randomly among those with minimal cost. The error code, matching string and updated graph string are passed via the specified callback.
 void findBestPerfectMatching(const char* graph_str, invoke_oncomplete_callback_t callback);
 
+//! Same as above, with the random choices drawn from the specified seed, so that the same graph and seed always give the same matching.
+void findBestPerfectMatchingWithSeed(const char* graph_str, unsigned long long seed, invoke_oncomplete_callback_t callback);
+
+
+
+/*! Opaque handle to an in-memory graph, built from integer arrays, and to the solver state reused by its successive matchings. The functions below
+ *  return their result code directly and work on buffers owned by the caller, hence no text is parsed or formatted. The getters do not allocate any
+ *  memory, and neither do the successful searches once the first ones have sized the working graphs and workspaces of the solver, which are kept in
+ *  the handle and rebuilt in place (a search which adds new constraints to the graph may still enlarge its storage). A handle may not be
+ *  used by several threads at once, but distinct handles may be used concurrently.
+ */
+typedef struct matching_graph_s* matching_graph_t;
+
+/*! Create a graph with the specified number of vertices and non-matching constraints, where the constraint i goes from sources[i] to targets[i] with
+ *  the cost costs[i] (0xFFFFFFFF if these vertices cannot be matched), as in the graph strings. The handle is returned in graph, and must be released
+ *  with destroyMatchingGraph. RESCODE_INVALID_GRAPH is returned if a vertex ID is not below nvertices.
+ */
+int createMatchingGraph(uint32_t nvertices, uint32_t nconstraints, const uint32_t* sources, const uint32_t* targets, const uint32_t* costs, matching_graph_t* graph);
+
+//! Release the specified graph (NULL is ignored).
+void destroyMatchingGraph(matching_graph_t graph);
+
+//! Return the number of vertices of the specified graph.
+uint32_t getMatchingGraphNumberVertices(matching_graph_t graph);
+
+//! Return the number of constraints of the specified graph, i.e. the size of the arrays filled by getMatchingGraphConstraints.
+uint32_t getMatchingGraphNumberConstraints(matching_graph_t graph);
+
+//! Copy the current constraints of the specified graph into the specified arrays of the specified capacity, in the format of createMatchingGraph.
+int getMatchingGraphConstraints(matching_graph_t graph, uint32_t* sources, uint32_t* targets, uint32_t* costs, uint32_t capacity);
+
+/*! Find a perfect matching over the specified graph, which is selected randomly among those with minimal cost, and update the constraints of the graph in
+ *  place, as with the in-memory graphs of the C++ interface. The vertex matched with each vertex is written into matching, whose size must be at least the
+ *  number of vertices. On failure, the graph is left untouched, and getMatchingGraphLastError describes the failure.
+ */
+int findBestPerfectMatchingInGraph(matching_graph_t graph, uint32_t* matching, uint32_t matching_size);
+
+//! Same as above, with the random choices drawn from the specified seed, so that the same graph and seed always give the same matching.
+int findBestPerfectMatchingInGraphWithSeed(matching_graph_t graph, unsigned long long seed, uint32_t* matching, uint32_t matching_size);
+
+//! Return the description of the last failure on the specified graph (known exception message or vertices preventing a perfect matching), valid until the next call on the graph.
+const char* getMatchingGraphLastError(matching_graph_t graph);
+
 
 
+#ifdef __cplusplus
 }
+#endif
 
 
 
@@ -11,6 +11,13 @@
 
 
 
+// Predeclarations
+namespace wpm {
+	class NonMatchingGraph;
+}
+
+
+
 //! Possible result codes
 enum ResultCode {
 	ResCode_Success,
@@ -18,7 +25,8 @@ enum ResultCode {
 	ResCode_MatchingFailure,
 	ResCode_InvalidMatching,
 	ResCode_KnownException,
-	ResCode_UnknownException
+	ResCode_UnknownException,
+	ResCode_InfeasibleGraph		//!< The graph has no perfect matching, because of a set of vertices which can only be matched with fewer vertices than their number.
 };
 
 
@@ -26,6 +34,69 @@ enum ResultCode {
 //! Find a perfect matching over the specified graph, which is selected randomly among those with minimal cost. The result code is passed as return value, and the matching vector and updated graph string are passed via reference arguments.
 ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, std::string &updated_graph_str);
 
+/*! Same as above, with the random choices drawn from the specified seed instead of a non-deterministic one. The same graph and seed always give
+ *  the same matching, on every platform and whatever the other computations running concurrently, so that any matching can be replayed.
+ */
+ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, std::string &updated_graph_str, unsigned long long seed);
+
+/*! Find a perfect matching over the specified in-memory graph (see wpm/NonMatchingGraph.h), which is selected randomly among those with minimal cost.
+ *  On success, the constraints of the graph are updated in place, so that successive calls never go through the text format. The graph is left
+ *  untouched on failure, and the exception message is copied into exception_msg (if not NULL) when ResCode_KnownException is returned.
+ */
+ResultCode findBestPerfectMatching(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string *exception_msg=NULL);
+
+/*! Same as above, with the random choices drawn from the specified seed (see the seeded overload for graph strings). The function is not an overload
+ *  of the one above, where a call with 0 or NULL as third argument would be ambiguous.
+ */
+ResultCode findBestPerfectMatchingWithSeed(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, unsigned long long seed, std::string *exception_msg=NULL);
+
+/*! Find a perfect matching over the specified in-memory graph, as with the function above, and return the changes made by the update of its constraints
+ *  in delta_str (see wpm/NonMatchingGraphDelta.h), in place of the whole updated graph. The size of the delta is proportional to the number of vertices
+ *  instead of the number of constraints, and applying it with applyGraphDelta to a copy of the graph before the call gives the updated graph.
+ */
+ResultCode findBestPerfectMatchingDelta(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string &delta_str, std::string *exception_msg=NULL);
+
+//! Same as above, with the random choices drawn from the specified seed (named differently for the same reason as findBestPerfectMatchingWithSeed).
+ResultCode findBestPerfectMatchingDeltaWithSeed(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string &delta_str, unsigned long long seed, std::string *exception_msg=NULL);
+
+//! Apply the specified delta string, as returned by the function above, to the specified in-memory graph. ResCode_InvalidGraph is returned, and the graph is left untouched, if the delta is malformed or was computed on a graph with another number of vertices.
+ResultCode applyGraphDelta(wpm::NonMatchingGraph &graph, const std::string &delta_str);
+
+/*! Find the perfect matchings of the specified number of successive rounds over the specified in-memory graph, as if the function above was called once
+ *  per round, but with a single finder whose labeling and matching warm start the next round. The constraints of the graph are updated in place after
+ *  each round, hence the graph is the one of the next round on return. If a round fails, its result code is returned, and the matchings and the graph
+ *  are the ones of the previous rounds.
+ */
+ResultCode findBestPerfectMatchingRounds(wpm::NonMatchingGraph &graph, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string *exception_msg=NULL);
+
+//! Same as above, with the random choices drawn from the specified seed (named differently for the same reason as findBestPerfectMatchingWithSeed).
+ResultCode findBestPerfectMatchingRoundsWithSeed(wpm::NonMatchingGraph &graph, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, unsigned long long seed, std::string *exception_msg=NULL);
+
+/*! Find the perfect matchings of the specified number of successive rounds over the specified graph string, which is only parsed once, and return the
+ *  updated graph string after the last round (see above). The rounds are computed in memory, without serializing the graph between them.
+ */
+ResultCode findBestPerfectMatchingRounds(const std::string &graph_str, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string &updated_graph_str);
+
+//! Same as above, with the random choices drawn from the specified seed (see the seeded overload for graph strings).
+ResultCode findBestPerfectMatchingRounds(const std::string &graph_str, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string &updated_graph_str, unsigned long long seed);
+
+/*! Find perfect matchings over a batch of independent in-memory graphs, solved in parallel on a work-stealing thread pool with the specified number
+ *  of threads (0 for the number of hardware threads). Each graph is processed as with the function above, with its own random engine seeded from
+ *  the batch seed and the index of the graph, hence the results only depend on the seed and never on the number of threads. The matching and
+ *  result code of each graph are returned in the vectors of the same size than the batch.
+ */
+void findBestPerfectMatchingBatch(const std::vector<wpm::NonMatchingGraph*> &graphs, std::vector< std::vector<unsigned int> > &matchings, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads=0);
+
+//! Find perfect matchings over a batch of independent graph strings, in parallel and deterministically for a given seed (see above). The updated graph string, or the exception message, of each graph is returned in updated_graph_strs.
+void findBestPerfectMatchingBatch(const std::vector<std::string> &graph_strs, std::vector< std::vector<unsigned int> > &matchings, std::vector<std::string> &updated_graph_strs, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads=0);
+
+/*! Find why the specified in-memory graph has no perfect matching, in which case ResCode_InfeasibleGraph is returned (ResCode_Success otherwise, with empty
+ *  vectors). The violating vertices form a minimal set of vertices which can only be matched with the allowed vertices, which are one less than them, hence
+ *  the constraints between some of these vertices and the other ones must be relaxed. The finding functions above return ResCode_InfeasibleGraph in the
+ *  same case, with a human-readable description of these vertices in place of the updated graph string (or in exception_msg).
+ */
+ResultCode findHallViolator(const wpm::NonMatchingGraph &graph, std::vector<unsigned int> &violating_vertices, std::vector<unsigned int> &allowed_vertices);
+
 
 
 
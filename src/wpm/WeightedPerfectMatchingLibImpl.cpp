@@ -5,11 +5,18 @@
 #include "WeightedPerfectMatchingLib.h"
 #include "WeightedPerfectMatchingCLib.h"
 
+#include <algorithm>
+#include <memory>
 #include <sstream>
 #include "NonMatchingGraph.h"
+#include "NonMatchingGraphDelta.h"
 #include "BipartiteMatchingGraph.h"
 #include "MatchingGraphConverter.h"
+#include "ImplicitBipartiteMatchingGraph.h"
 #include "PerfectMatchingFinder.h"
+#include "CardinalityMatchingFinder.h"
+#include "ThreadPool.h"
+#include "Tracing.h"
 
 
 
@@ -17,64 +24,120 @@
 
 
 
+//! Graph behind the handles of the C interface, with the finder and matching reused by its successive matchings.
+struct matching_graph_s
+{
+	wpm::NonMatchingGraph nmg;				//!< Graph, whose constraints are updated in place by each matching.
+	wpm::PerfectMatchingFinder pmfinder;	//!< Finder, whose workspaces are reused by the successive matchings.
+	std::vector<unsigned int> matching;		//!< Last matching, whose buffer is reused by the successive matchings.
+	std::vector<unsigned char> clique_flags;	//!< Flags of the cliques checking the last matching, whose buffer is reused by the successive matchings.
+	std::string last_error;					//!< Description of the last failure.
+};
+
+
+
 namespace impl {
 
 
 
-//! Function to check the validity of the specified matching.
-bool checkPerfectMatchingValidity(unsigned int ncliques, const std::vector<unsigned int> &matching)
+//! Function to check the validity of the specified matching, with a buffer for the flags of the cliques (internal linkage, since it is only used in this file).
+static bool checkPerfectMatchingValidity(unsigned int ncliques, const std::vector<unsigned int> &matching, std::vector<unsigned char> &clique_flags)
 {
-	std::vector< std::pair<bool, bool> > clique_flags(ncliques, std::make_pair(false, false));
+	static const unsigned char IS_SOURCE = 1, IS_TARGET = 2;
+	clique_flags.assign(ncliques, 0);
 	for(std::vector<unsigned int>::const_iterator it_m=matching.begin(); it_m!=matching.end(); ++it_m) {
 		unsigned int id_source = std::distance(matching.begin(), it_m);
 		unsigned int id_target = matching[id_source];
-		if(clique_flags[id_source].first)
+		if(clique_flags[id_source] & IS_SOURCE)
 			return false;	// The matching is not valid: the vertex with id 'id_source' is already a source for another target vertex
-		if(clique_flags[id_target].second)
+		if(clique_flags[id_target] & IS_TARGET)
 			return false;	// The matching is not valid: the vertex with id 'id_target' is already a target for another source vertex
-		clique_flags[id_source].first = true;
-		clique_flags[id_target].second = true;
+		clique_flags[id_source] |= IS_SOURCE;
+		clique_flags[id_target] |= IS_TARGET;
 	}
 	for(unsigned int id=0; id<ncliques; ++id) {
-		const std::pair<bool, bool> &clique_flag = clique_flags[id];
-		if(!clique_flag.first)
+		if(!(clique_flags[id] & IS_SOURCE))
 			return false;	// The matching is not valid: the vertex with id 'id' has no target vertex
-		if(!clique_flag.second)
+		if(!(clique_flags[id] & IS_TARGET))
 			return false;	// The matching is not valid: the vertex with id 'id' has no source vertex
 	}
 	return true;
 }
 
-//! Find a random perfect matching with minimal cost in the specified graph, and return the results via the specified callback.
-ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, std::string &updated_graph_str)
+//! Function to describe the specified Hall violator, as the vertices which can only be matched with fewer vertices than their number (internal linkage).
+static std::string describeHallViolator(const std::vector<unsigned int> &violating_vertices, const std::vector<unsigned int> &allowed_vertices)
 {
-	std::stringstream updated_graph_ss;
-	try {
-
-		// Deserialize the input graph
-		std::istringstream is(graph_str);
-		wpm::NonMatchingGraph nmg;
-		if(!nmg.deserialize(is))
-			return ResCode_InvalidGraph;
+	std::ostringstream oss;
+	oss << "The " << violating_vertices.size() << " vertices {";
+	for(size_t i=0; i<violating_vertices.size(); ++i)
+		oss << (i>0 ? "," : "") << violating_vertices[i];
+	oss << "} can only be matched with the " << allowed_vertices.size() << " vertices {";
+	for(size_t i=0; i<allowed_vertices.size(); ++i)
+		oss << (i>0 ? "," : "") << allowed_vertices[i];
+	oss << "}, hence the graph has no perfect matching";
+	return oss.str();
+}
 
-		// Convert the non-matching graph into a bipartite matching graph
-		wpm::MatchingGraphConverter gconverter;
-		wpm::BipartiteMatchingGraph bmg;
-		gconverter.toBipartiteMatchingGraph(nmg, bmg);
+//! Find a random perfect matching with minimal cost in the specified in-memory graph with the specified finder, and update the constraints of the graph in place (recording the changes into the delta, if any).
+//! The flags checking the matching are stored into the specified buffer, if any, so that the successive matchings do not allocate.
+ResultCode findBestPerfectMatching(wpm::NonMatchingGraph &nmg, std::vector<unsigned int> &matching, wpm::PerfectMatchingFinder &pmfinder, std::string *exception_msg, wpm::NonMatchingGraphDelta *delta=NULL, std::vector<unsigned char> *clique_flags=NULL)
+{
+	wpm::ScopedTraceSpan trace_span("findBestPerfectMatching");
+	try {
 
-		// Find a random perfect matching
-		wpm::PerfectMatchingFinder pmfinder;
-		std::vector<const wpm::BipartiteMatchingGraph::Edge*> bmg_matching;
-		if(!pmfinder.findRandomPerfectMatching(bmg, bmg_matching))
-			return ResCode_MatchingFailure;
+		// Find a random perfect matching, in the graph representation suited to its size
+		wpm::ScopedTraceSpan finding_span("findRandomPerfectMatching");
+		if(!pmfinder.findRandomPerfectMatching(nmg, matching)) {
+			std::vector<unsigned int> violating_vertices, allowed_vertices;
+			if(!pmfinder.getHallViolator(violating_vertices, allowed_vertices))
+				return ResCode_MatchingFailure;
+			if(exception_msg!=NULL)
+				*exception_msg = describeHallViolator(violating_vertices, allowed_vertices);
+			return ResCode_InfeasibleGraph;
+		}
+		finding_span.end();
 
-		// Convert the matching to a generic matching and update the graph
-		gconverter.toGenericMatching(bmg_matching, matching);
-		if(!checkPerfectMatchingValidity(bmg.getNumberCliques(), matching))
+		// Check the validity of the matching
+		wpm::ScopedTraceSpan checking_span("checkPerfectMatchingValidity");
+		std::vector<unsigned char> local_clique_flags;
+		if(!checkPerfectMatchingValidity(nmg.getNumberVertices(), matching, (clique_flags!=NULL ? *clique_flags : local_clique_flags)))
 			return ResCode_InvalidMatching;
+		checking_span.end();
 
 		// Update the constraints in the non-matching graph
-		nmg.updateConstraints(matching,true);
+		wpm::ScopedTraceSpan updating_span("updateConstraints");
+		nmg.updateConstraints(matching,true,delta);
+
+	}
+	catch(const std::exception &e) {
+		if(exception_msg!=NULL)
+			*exception_msg = e.what();
+		return ResCode_KnownException;
+	}
+	catch(...) {
+		return ResCode_UnknownException;
+	}
+	return ResCode_Success;
+}
+
+//! Find a random perfect matching with minimal cost in the specified graph string with the specified finder, and return the matching and the updated graph string.
+ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, wpm::PerfectMatchingFinder &pmfinder, std::string &updated_graph_str)
+{
+	std::stringstream updated_graph_ss;
+	try {
+
+		// Deserialize the input graph, directly from the string buffer
+		wpm::NonMatchingGraph nmg;
+		wpm::ScopedTraceSpan deserializing_span("deserialize");
+		if(!nmg.deserialize(graph_str.data(), graph_str.size()))
+			return ResCode_InvalidGraph;
+		deserializing_span.end();
+
+		// Find the matching and update the graph in place (the exception message is returned in place of the updated graph)
+		ResultCode rescode = findBestPerfectMatching(nmg, matching, pmfinder, &updated_graph_str);
+		if(rescode!=ResCode_Success)
+			return rescode;
+		wpm::ScopedTraceSpan serializing_span("serialize");
 		updated_graph_ss << nmg;
 
 	}
@@ -91,15 +154,216 @@ ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<uns
 	return ResCode_Success;
 }
 
+//! Find a random perfect matching with minimal cost in the specified in-memory graph with the specified finder, update the constraints of the graph in place, and return the changes as a delta string.
+ResultCode findBestPerfectMatchingDelta(wpm::NonMatchingGraph &nmg, std::vector<unsigned int> &matching, wpm::PerfectMatchingFinder &pmfinder, std::string &delta_str, std::string *exception_msg)
+{
+	try {
+
+		// Find the matching and record the update of the graph, which only changes the constraints of the matched pairs besides the decrease of the costs
+		wpm::NonMatchingGraphDelta delta;
+		delta.startNewDelta(nmg.getNumberVertices());
+		ResultCode rescode = findBestPerfectMatching(nmg, matching, pmfinder, exception_msg, &delta);
+		if(rescode!=ResCode_Success)
+			return rescode;
+		wpm::ScopedTraceSpan serializing_span("serializeDelta");
+		std::ostringstream delta_ss;
+		delta_ss << delta;
+		delta_str = delta_ss.str();
+
+	}
+	catch(const std::exception &e) {
+		if(exception_msg!=NULL)
+			*exception_msg = e.what();
+		return ResCode_KnownException;
+	}
+	catch(...) {
+		return ResCode_UnknownException;
+	}
+	return ResCode_Success;
+}
+
+//! Apply the specified delta string to the specified in-memory graph, which is left untouched if the delta is invalid.
+ResultCode applyGraphDelta(wpm::NonMatchingGraph &nmg, const std::string &delta_str)
+{
+	try {
+
+		// Deserialize the delta, directly from the string buffer, and replay its updates
+		wpm::ScopedTraceSpan applying_span("applyGraphDelta");
+		wpm::NonMatchingGraphDelta delta;
+		if(!delta.deserialize(delta_str.data(), delta_str.size()))
+			return ResCode_InvalidGraph;
+		if(!nmg.applyDelta(delta))
+			return ResCode_InvalidGraph;
+
+	}
+	catch(const std::exception &) {
+		return ResCode_KnownException;
+	}
+	catch(...) {
+		return ResCode_UnknownException;
+	}
+	return ResCode_Success;
+}
+
+//! Find random perfect matchings with minimal cost in the specified number of successive rounds over the specified in-memory graph, warm starting each round from the previous one.
+ResultCode findBestPerfectMatchingRounds(wpm::NonMatchingGraph &nmg, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, wpm::PerfectMatchingFinder &pmfinder, std::string *exception_msg)
+{
+	matchings.clear();
+	matchings.reserve(nrounds);
+	pmfinder.setWarmStart(true);
+	for(unsigned int round=0; round<nrounds; ++round) {
+		// Each round updates the constraints of the graph in place, which gives the graph of the next round
+		std::vector<unsigned int> matching;
+		ResultCode rescode = findBestPerfectMatching(nmg, matching, pmfinder, exception_msg);
+		if(rescode!=ResCode_Success)
+			return rescode;
+		matchings.push_back(std::vector<unsigned int>());
+		matchings.back().swap(matching);
+	}
+	return ResCode_Success;
+}
+
+//! Find random perfect matchings with minimal cost in the specified number of successive rounds over the specified graph string, and return the matchings and the updated graph string after the last round.
+ResultCode findBestPerfectMatchingRounds(const std::string &graph_str, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, wpm::PerfectMatchingFinder &pmfinder, std::string &updated_graph_str)
+{
+	matchings.clear();
+	try {
+
+		// Deserialize the input graph once, directly from the string buffer
+		wpm::NonMatchingGraph nmg;
+		wpm::ScopedTraceSpan deserializing_span("deserialize");
+		if(!nmg.deserialize(graph_str.data(), graph_str.size()))
+			return ResCode_InvalidGraph;
+		deserializing_span.end();
+
+		// Find the matchings of all the rounds in memory (the exception message is returned in place of the updated graph)
+		ResultCode rescode = findBestPerfectMatchingRounds(nmg, nrounds, matchings, pmfinder, &updated_graph_str);
+		if(rescode!=ResCode_Success)
+			return rescode;
+		wpm::ScopedTraceSpan serializing_span("serialize");
+		std::ostringstream updated_graph_ss;
+		updated_graph_ss << nmg;
+		updated_graph_str = updated_graph_ss.str();
+
+	}
+	catch(const std::exception &e) {
+		updated_graph_str = e.what();
+		return ResCode_KnownException;
+	}
+	catch(...) {
+		return ResCode_UnknownException;
+	}
+	return ResCode_Success;
+}
+
+//! Find random perfect matchings with minimal cost in the specified in-memory graphs on a thread pool, with one random engine per graph seeded from the batch seed.
+void findBestPerfectMatchingBatch(const std::vector<wpm::NonMatchingGraph*> &graphs, std::vector< std::vector<unsigned int> > &matchings, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads)
+{
+	const unsigned int ngraphs = graphs.size();
+	matchings.resize(ngraphs);
+	rescodes.resize(ngraphs);
+	wpm::ThreadPool pool(std::min(nthreads>0 ? nthreads : std::max(std::thread::hardware_concurrency(), 1u), std::max(ngraphs, 1u)));
+	pool.run(ngraphs, [&](unsigned int i, unsigned int) {
+		// The seed of each graph only depends on its index, so that the results do not depend on the scheduling
+		wpm::PerfectMatchingFinder pmfinder;
+		pmfinder.setSeed(wpm::RandomEngine::deriveSeed(seed, i));
+		rescodes[i] = (graphs[i]!=NULL ? findBestPerfectMatching(*graphs[i], matchings[i], pmfinder, NULL) : ResCode_InvalidGraph);
+	});
+}
+
+//! Find random perfect matchings with minimal cost in the specified graph strings on a thread pool, with one random engine per graph seeded from the batch seed.
+void findBestPerfectMatchingBatch(const std::vector<std::string> &graph_strs, std::vector< std::vector<unsigned int> > &matchings, std::vector<std::string> &updated_graph_strs, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads)
+{
+	const unsigned int ngraphs = graph_strs.size();
+	matchings.resize(ngraphs);
+	updated_graph_strs.resize(ngraphs);
+	rescodes.resize(ngraphs);
+	wpm::ThreadPool pool(std::min(nthreads>0 ? nthreads : std::max(std::thread::hardware_concurrency(), 1u), std::max(ngraphs, 1u)));
+	pool.run(ngraphs, [&](unsigned int i, unsigned int) {
+		try {
+			// Deserialize the graph, find the matching and serialize the updated graph (the exception message is returned in place of the updated graph)
+			wpm::NonMatchingGraph nmg;
+			wpm::ScopedTraceSpan deserializing_span("deserialize");
+			if(!nmg.deserialize(graph_strs[i].data(), graph_strs[i].size())) {
+				rescodes[i] = ResCode_InvalidGraph;
+				return;
+			}
+			deserializing_span.end();
+			wpm::PerfectMatchingFinder pmfinder;
+			pmfinder.setSeed(wpm::RandomEngine::deriveSeed(seed, i));
+			rescodes[i] = findBestPerfectMatching(nmg, matchings[i], pmfinder, &updated_graph_strs[i]);
+			if(rescodes[i]==ResCode_Success) {
+				wpm::ScopedTraceSpan serializing_span("serialize");
+				std::ostringstream updated_graph_ss;
+				updated_graph_ss << nmg;
+				updated_graph_strs[i] = updated_graph_ss.str();
+			}
+		}
+		catch(const std::exception &e) {
+			updated_graph_strs[i] = e.what();
+			rescodes[i] = ResCode_KnownException;
+		}
+		catch(...) {
+			rescodes[i] = ResCode_UnknownException;
+		}
+	});
+}
+
+//! Find the Hall violator of the specified in-memory graph, if it has no perfect matching.
+ResultCode findHallViolator(const wpm::NonMatchingGraph &nmg, std::vector<unsigned int> &violating_vertices, std::vector<unsigned int> &allowed_vertices)
+{
+	// The implicit representation is used whatever the size of the graph, since the scores are not needed
+	wpm::MatchingGraphConverter gconverter;
+	wpm::ImplicitBipartiteMatchingGraph ibmgraph;
+	gconverter.toImplicitBipartiteMatchingGraph(nmg, ibmgraph);
+	wpm::CardinalityMatchingFinder cmfinder;
+	if(cmfinder.findMaximumCardinalityMatching(ibmgraph)) {
+		violating_vertices.clear();
+		allowed_vertices.clear();
+		return ResCode_Success;
+	}
+	violating_vertices = cmfinder.getHallViolatorSources();
+	allowed_vertices = cmfinder.getHallViolatorTargets();
+	return ResCode_InfeasibleGraph;
+}
+
+//! Function to convert a result code of the C++ interface into the one of the C interface.
+int toCResultCode(ResultCode rescode)
+{
+	switch(rescode) {
+	case ResCode_Success:			return RESCODE_SUCCESS;
+	case ResCode_InvalidGraph:		return RESCODE_INVALID_GRAPH;
+	case ResCode_MatchingFailure:	return RESCODE_MATCHING_FAILURE;
+	case ResCode_InvalidMatching:	return RESCODE_INVALID_MATCHING;
+	case ResCode_KnownException:	return RESCODE_KNOWN_EXCEPTION;
+	case ResCode_UnknownException:	return RESCODE_UNKNOWN_EXCEPTION;
+	case ResCode_InfeasibleGraph:	return RESCODE_INFEASIBLE_GRAPH;
+	}
+	return RESCODE_UNKNOWN_EXCEPTION;
+}
+
+//! Wrapper function for the C library interface working on graph handles, writing the matching into the caller buffer.
+int findBestPerfectMatchingInGraph_CWrapper(matching_graph_t graph, uint32_t* matching, uint32_t matching_size)
+{
+	if(graph==NULL || matching==NULL || matching_size<graph->nmg.getNumberVertices())
+		return RESCODE_INVALID_ARGUMENT;
+	graph->last_error.clear();
+	ResultCode rescode = findBestPerfectMatching(graph->nmg, graph->matching, graph->pmfinder, &graph->last_error, NULL, &graph->clique_flags);
+	if(rescode!=ResCode_Success)
+		return toCResultCode(rescode);
+	std::copy(graph->matching.begin(), graph->matching.end(), matching);
+	return RESCODE_SUCCESS;
+}
+
 //! Wrapper function for the C library interface.
-void findBestPerfectMatching_CWrapper(const char* graph_str, invoke_oncomplete_callback_t callback)
+void findBestPerfectMatching_CWrapper(const char* graph_str, wpm::PerfectMatchingFinder &pmfinder, invoke_oncomplete_callback_t callback)
 {
 	// Compute the matching and updated graph
 	std::string matching_str, updated_graph_str;
 	try {
 		// Compute the matching and updated graph string
 		std::vector<unsigned int> matching;
-		ResultCode rescode = impl::findBestPerfectMatching(std::string(graph_str), matching, updated_graph_str);
+		ResultCode rescode = impl::findBestPerfectMatching(std::string(graph_str), matching, pmfinder, updated_graph_str);
 		if(rescode!=ResCode_Success) {
 			switch(rescode) {
 			case ResCode_InvalidGraph:
@@ -117,6 +381,9 @@ void findBestPerfectMatching_CWrapper(const char* graph_str, invoke_oncomplete_c
 			case ResCode_UnknownException:
 				callback(RESCODE_UNKNOWN_EXCEPTION, "", "");
 				break;
+			case ResCode_InfeasibleGraph:
+				callback(RESCODE_INFEASIBLE_GRAPH, "", updated_graph_str.c_str());
+				break;
 			}
 			return;
 		}
@@ -151,7 +418,110 @@ void findBestPerfectMatching_CWrapper(const char* graph_str, invoke_oncomplete_c
 //! C++ function exposed by the library.
 ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, std::string &updated_graph_str)
 {
-	return impl::findBestPerfectMatching(graph_str, matching, updated_graph_str);
+	wpm::PerfectMatchingFinder pmfinder;
+	return impl::findBestPerfectMatching(graph_str, matching, pmfinder, updated_graph_str);
+}
+
+//! C++ function exposed by the library, with an explicit seed.
+ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<unsigned int> &matching, std::string &updated_graph_str, unsigned long long seed)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatching(graph_str, matching, pmfinder, updated_graph_str);
+}
+
+//! C++ function exposed by the library, working on an in-memory graph.
+ResultCode findBestPerfectMatching(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	return impl::findBestPerfectMatching(graph, matching, pmfinder, exception_msg);
+}
+
+//! C++ function exposed by the library, working on an in-memory graph with an explicit seed.
+ResultCode findBestPerfectMatchingWithSeed(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, unsigned long long seed, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatching(graph, matching, pmfinder, exception_msg);
+}
+
+//! C++ function exposed by the library, working on an in-memory graph and returning the changes of the graph.
+ResultCode findBestPerfectMatchingDelta(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string &delta_str, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	return impl::findBestPerfectMatchingDelta(graph, matching, pmfinder, delta_str, exception_msg);
+}
+
+//! C++ function exposed by the library, working on an in-memory graph and returning the changes of the graph, with an explicit seed.
+ResultCode findBestPerfectMatchingDeltaWithSeed(wpm::NonMatchingGraph &graph, std::vector<unsigned int> &matching, std::string &delta_str, unsigned long long seed, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatchingDelta(graph, matching, pmfinder, delta_str, exception_msg);
+}
+
+//! C++ function exposed by the library, applying the changes of a graph to an in-memory copy of it.
+ResultCode applyGraphDelta(wpm::NonMatchingGraph &graph, const std::string &delta_str)
+{
+	return impl::applyGraphDelta(graph, delta_str);
+}
+
+//! C++ function exposed by the library, computing successive rounds over an in-memory graph.
+ResultCode findBestPerfectMatchingRounds(wpm::NonMatchingGraph &graph, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	return impl::findBestPerfectMatchingRounds(graph, nrounds, matchings, pmfinder, exception_msg);
+}
+
+//! C++ function exposed by the library, computing successive rounds over an in-memory graph with an explicit seed.
+ResultCode findBestPerfectMatchingRoundsWithSeed(wpm::NonMatchingGraph &graph, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, unsigned long long seed, std::string *exception_msg)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatchingRounds(graph, nrounds, matchings, pmfinder, exception_msg);
+}
+
+//! C++ function exposed by the library, computing successive rounds over a graph string.
+ResultCode findBestPerfectMatchingRounds(const std::string &graph_str, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string &updated_graph_str)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	return impl::findBestPerfectMatchingRounds(graph_str, nrounds, matchings, pmfinder, updated_graph_str);
+}
+
+//! C++ function exposed by the library, computing successive rounds over a graph string with an explicit seed.
+ResultCode findBestPerfectMatchingRounds(const std::string &graph_str, unsigned int nrounds, std::vector< std::vector<unsigned int> > &matchings, std::string &updated_graph_str, unsigned long long seed)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatchingRounds(graph_str, nrounds, matchings, pmfinder, updated_graph_str);
+}
+
+//! C++ function exposed by the library, solving a batch of in-memory graphs in parallel.
+void findBestPerfectMatchingBatch(const std::vector<wpm::NonMatchingGraph*> &graphs, std::vector< std::vector<unsigned int> > &matchings, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads)
+{
+	impl::findBestPerfectMatchingBatch(graphs, matchings, rescodes, seed, nthreads);
+}
+
+//! C++ function exposed by the library, solving a batch of graph strings in parallel.
+void findBestPerfectMatchingBatch(const std::vector<std::string> &graph_strs, std::vector< std::vector<unsigned int> > &matchings, std::vector<std::string> &updated_graph_strs, std::vector<ResultCode> &rescodes, unsigned long long seed, unsigned int nthreads)
+{
+	impl::findBestPerfectMatchingBatch(graph_strs, matchings, updated_graph_strs, rescodes, seed, nthreads);
+}
+
+
+
+//! C++ function exposed by the library, explaining why an in-memory graph has no perfect matching.
+ResultCode findHallViolator(const wpm::NonMatchingGraph &graph, std::vector<unsigned int> &violating_vertices, std::vector<unsigned int> &allowed_vertices)
+{
+	try {
+		return impl::findHallViolator(graph, violating_vertices, allowed_vertices);
+	}
+	catch(const std::exception &) {
+		return ResCode_KnownException;
+	}
+	catch(...) {
+		return ResCode_UnknownException;
+	}
 }
 
 
@@ -163,5 +533,115 @@ ResultCode findBestPerfectMatching(const std::string &graph_str, std::vector<uns
 //! C function exposed by the library.
 void findBestPerfectMatching(const char* graph_str, invoke_oncomplete_callback_t callback)
 {
-	impl::findBestPerfectMatching_CWrapper(graph_str, callback);
+	wpm::PerfectMatchingFinder pmfinder;
+	impl::findBestPerfectMatching_CWrapper(graph_str, pmfinder, callback);
+}
+
+//! C function exposed by the library, with an explicit seed.
+void findBestPerfectMatchingWithSeed(const char* graph_str, unsigned long long seed, invoke_oncomplete_callback_t callback)
+{
+	wpm::PerfectMatchingFinder pmfinder;
+	pmfinder.setSeed(seed);
+	impl::findBestPerfectMatching_CWrapper(graph_str, pmfinder, callback);
+}
+
+//! C function exposed by the library, building a graph handle from integer arrays.
+int createMatchingGraph(uint32_t nvertices, uint32_t nconstraints, const uint32_t* sources, const uint32_t* targets, const uint32_t* costs, matching_graph_t* graph)
+{
+	if(graph==NULL || (nconstraints>0 && (sources==NULL || targets==NULL || costs==NULL)))
+		return RESCODE_INVALID_ARGUMENT;
+	*graph = NULL;
+	for(uint32_t i=0; i<nconstraints; ++i) {
+		if(sources[i]>=nvertices || targets[i]>=nvertices)
+			return RESCODE_INVALID_GRAPH;
+	}
+	try {
+		// Reserve the constraints of each vertex before adding them, as when deserializing a graph
+		std::unique_ptr<matching_graph_s> new_graph(new matching_graph_s());
+		new_graph->nmg.startNewGraph(nvertices);
+		std::vector<unsigned int> nvertex_constraints(nvertices, 0);
+		for(uint32_t i=0; i<nconstraints; ++i)
+			++nvertex_constraints[sources[i]];
+		for(uint32_t id=0; id<nvertices; ++id)
+			new_graph->nmg.reserveConstraints(id, nvertex_constraints[id]);
+		for(uint32_t i=0; i<nconstraints; ++i)
+			new_graph->nmg.addDirectedEdge(sources[i], targets[i], costs[i]);
+		new_graph->matching.reserve(nvertices);
+		*graph = new_graph.release();
+	}
+	catch(const std::bad_alloc &) {
+		return RESCODE_KNOWN_EXCEPTION;
+	}
+	catch(...) {
+		return RESCODE_UNKNOWN_EXCEPTION;
+	}
+	return RESCODE_SUCCESS;
+}
+
+//! C function exposed by the library, releasing a graph handle.
+void destroyMatchingGraph(matching_graph_t graph)
+{
+	delete graph;
+}
+
+//! C function exposed by the library, returning the number of vertices of a graph handle.
+uint32_t getMatchingGraphNumberVertices(matching_graph_t graph)
+{
+	return (graph!=NULL ? graph->nmg.getNumberVertices() : 0);
+}
+
+//! C function exposed by the library, returning the number of constraints of a graph handle.
+uint32_t getMatchingGraphNumberConstraints(matching_graph_t graph)
+{
+	if(graph==NULL)
+		return 0;
+	uint32_t nconstraints = 0;
+	std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_begin, it_end;
+	((const wpm::NonMatchingGraph&)graph->nmg).getVertexIterators(it_begin, it_end);
+	for(std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v=it_begin; it_v!=it_end; ++it_v) {
+		for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e)
+			nconstraints += (graph->nmg.isConstraintExpired(*it_e) ? 0 : 1);
+	}
+	return nconstraints;
+}
+
+//! C function exposed by the library, copying the constraints of a graph handle into integer arrays.
+int getMatchingGraphConstraints(matching_graph_t graph, uint32_t* sources, uint32_t* targets, uint32_t* costs, uint32_t capacity)
+{
+	if(graph==NULL || capacity<getMatchingGraphNumberConstraints(graph) || (capacity>0 && (sources==NULL || targets==NULL || costs==NULL)))
+		return RESCODE_INVALID_ARGUMENT;
+	uint32_t i = 0;
+	std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_begin, it_end;
+	((const wpm::NonMatchingGraph&)graph->nmg).getVertexIterators(it_begin, it_end);
+	for(std::vector<wpm::NonMatchingGraph::Vertex>::const_iterator it_v=it_begin; it_v!=it_end; ++it_v) {
+		for(std::vector<wpm::NonMatchingGraph::Edge>::const_iterator it_e=it_v->getConstraints().begin(); it_e!=it_v->getConstraints().end(); ++it_e) {
+			if(graph->nmg.isConstraintExpired(*it_e))
+				continue;
+			sources[i] = it_v->id;
+			targets[i] = it_e->v_target->id;
+			costs[i] = graph->nmg.getConstraintCost(*it_e);
+			++i;
+		}
+	}
+	return RESCODE_SUCCESS;
+}
+
+//! C function exposed by the library, working on a graph handle.
+int findBestPerfectMatchingInGraph(matching_graph_t graph, uint32_t* matching, uint32_t matching_size)
+{
+	return impl::findBestPerfectMatchingInGraph_CWrapper(graph, matching, matching_size);
+}
+
+//! C function exposed by the library, working on a graph handle with an explicit seed.
+int findBestPerfectMatchingInGraphWithSeed(matching_graph_t graph, unsigned long long seed, uint32_t* matching, uint32_t matching_size)
+{
+	if(graph!=NULL)
+		graph->pmfinder.setSeed(seed);
+	return impl::findBestPerfectMatchingInGraph_CWrapper(graph, matching, matching_size);
+}
+
+//! C function exposed by the library, describing the last failure on a graph handle.
+const char* getMatchingGraphLastError(matching_graph_t graph)
+{
+	return (graph!=NULL ? graph->last_error.c_str() : "");
 }